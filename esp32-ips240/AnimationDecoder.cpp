@@ -0,0 +1,188 @@
+#include "AnimationDecoder.h"
+
+const uint16_t AnimationDecoder::OP_SKIP;
+const uint16_t AnimationDecoder::OP_LITERAL;
+const uint16_t AnimationDecoder::OP_FILL;
+const uint16_t AnimationDecoder::OP_END;
+const uint16_t AnimationDecoder::OP_MASK;
+const uint16_t AnimationDecoder::COUNT_MASK;
+const uint16_t AnimationDecoder::FRAME_KEY;
+
+AnimationDecoder::AnimationDecoder() {
+  pFrameBuffer = nullptr;
+  pTFT = nullptr;
+  animation = nullptr;
+  cursor = nullptr;
+  originX = 0;
+  originY = 0;
+  nextFrame = 0;
+  frameIndex = 0;
+  frameDuration = 0;
+  changedPixels = 0;
+}
+
+void AnimationDecoder::begin(const CompressedAnimation* anim, int16_t x,
+                             int16_t y) {
+  animation = nullptr;
+  if (anim == nullptr || anim->stream == nullptr || anim->frameCount == 0) {
+    return;
+  }
+  if (!(anim->stream[0] & FRAME_KEY)) {
+    Serial.println("AnimationDecoder: 第 0 帧不是关键帧");
+    return;
+  }
+
+  animation = anim;
+  cursor = anim->stream;
+  originX = x;
+  originY = y;
+  nextFrame = 0;
+  frameIndex = 0;
+  frameDuration = 0;
+  changedPixels = 0;
+}
+
+bool AnimationDecoder::direct() const {
+  return pFrameBuffer == nullptr || pFrameBuffer->getMode() == BUFFER_MODE_DIRECT;
+}
+
+// ========== 解码 ==========
+
+bool AnimationDecoder::decodeNext() {
+  if (animation == nullptr) return false;
+  if (direct() ? pTFT == nullptr
+               : pFrameBuffer->getBackBuffer() == nullptr &&
+                     !pFrameBuffer->isIndexed()) {
+    return false;
+  }
+
+  if (nextFrame >= animation->frameCount) {
+    if (!animation->loop) {
+      animation = nullptr;
+      return false;
+    }
+    // 回到第 0 帧（关键帧）
+    cursor = animation->stream;
+    nextFrame = 0;
+  }
+
+  uint16_t flags = *cursor++;
+  frameDuration = *cursor++;
+  bool key = (flags & FRAME_KEY) != 0;
+
+  uint32_t framePixels = (uint32_t)animation->width * animation->height;
+  uint32_t pos = 0;
+  changedPixels = 0;
+
+  // 直接模式下完整可见的关键帧只开一个地址窗口，按顺序写入
+  bool window = false;
+  if (direct()) {
+    pTFT->startWrite();
+    window = key && originX >= 0 && originY >= 0 &&
+             originX + animation->width <= pTFT->width() &&
+             originY + animation->height <= pTFT->height();
+    if (window) {
+      pTFT->setAddrWindow(originX, originY, animation->width,
+                          animation->height);
+    }
+  }
+
+  while (true) {
+    uint16_t op = *cursor++;
+    uint16_t type = op & OP_MASK;
+    uint32_t count = op & COUNT_MASK;
+    if (type == OP_END) break;
+
+    if (pos + count > framePixels) {
+      Serial.printf("AnimationDecoder: 第 %u 帧数据越界\n", nextFrame);
+      animation = nullptr;
+      break;
+    }
+
+    if (type == OP_LITERAL) {
+      if (window) {
+        pTFT->writePixels((uint16_t*)cursor, count);
+      } else {
+        writeSpan(pos, cursor, count, false, !key);
+      }
+      cursor += count;
+      changedPixels += count;
+    } else if (type == OP_FILL) {
+      if (window) {
+        pTFT->writeColor(*cursor, count);
+      } else {
+        writeSpan(pos, cursor, count, true, !key);
+      }
+      cursor++;
+      changedPixels += count;
+    }
+    pos += count;
+  }
+
+  if (direct()) {
+    pTFT->endWrite();
+  } else if (key && animation != nullptr) {
+    // 关键帧覆盖整帧，整块标记一次
+    pFrameBuffer->markDirty(originX, originY, animation->width,
+                            animation->height);
+  }
+
+  if (animation == nullptr) return false;
+  frameIndex = nextFrame++;
+  return true;
+}
+
+void AnimationDecoder::writeSpan(uint32_t pos, const uint16_t* pixels,
+                                 uint32_t count, bool fill, bool markRows) {
+  uint16_t frameW = animation->width;
+  int16_t screenW = direct() ? pTFT->width() : pFrameBuffer->getWidth();
+  int16_t screenH = direct() ? pTFT->height() : pFrameBuffer->getHeight();
+  uint16_t* buffer = direct() ? nullptr : pFrameBuffer->getBackBuffer();
+
+  while (count > 0) {
+    uint16_t fx = pos % frameW;
+    uint16_t fy = pos / frameW;
+    uint32_t len = frameW - fx;
+    if (len > count) len = count;
+
+    // 裁剪到屏幕
+    int16_t sx = originX + fx;
+    int16_t sy = originY + fy;
+    int16_t skip = sx < 0 ? -sx : 0;
+    int16_t visible = (int16_t)len - skip;
+    if (sx + (int16_t)len > screenW) visible -= sx + (int16_t)len - screenW;
+
+    if (sy >= 0 && sy < screenH && visible > 0) {
+      const uint16_t* src = fill ? pixels : pixels + skip;
+      int16_t dx = sx + skip;
+      if (buffer != nullptr) {
+        uint16_t* dst = &buffer[sy * screenW + dx];
+        if (fill) {
+          for (int16_t i = 0; i < visible; i++) dst[i] = *src;
+        } else {
+          memcpy(dst, src, visible * sizeof(uint16_t));
+        }
+        if (markRows) pFrameBuffer->markDirty(dx, sy, visible, 1);
+      } else if (!direct()) {
+        // 调色板索引模式：由帧缓冲转换为索引
+        if (fill) {
+          pFrameBuffer->fillRow(dx, sy, visible, *src);
+        } else {
+          pFrameBuffer->writeRow(dx, sy, visible, src);
+        }
+        if (markRows) pFrameBuffer->markDirty(dx, sy, visible, 1);
+      } else {
+        pTFT->setAddrWindow(dx, sy, visible, 1);
+        if (fill) {
+          pTFT->writeColor(*src, visible);
+        } else {
+          pTFT->writePixels((uint16_t*)src, visible);
+        }
+      }
+    }
+
+    if (!fill) pixels += len;
+    pos += len;
+    count -= len;
+  }
+}
@@ -0,0 +1,81 @@
+#ifndef ANIMATION_DECODER_H
+#define ANIMATION_DECODER_H
+
+#include <Arduino.h>
+#include <Adafruit_ST7789.h>
+#include "FrameBuffer.h"
+
+/**
+ * 压缩动画（关键帧 + 差分帧）
+ *
+ * 编码流由 uint16_t 组成，按帧顺序存放，每帧为：
+ *   [标志] [持续时间 ms] [操作 ...] [OP_END]
+ * 标志 bit0 = 1 表示关键帧（不依赖上一帧，覆盖整帧）。
+ * 操作字高 2 位为类型、低 14 位为像素数，按行优先顺序推进帧内位置：
+ *   OP_SKIP    n        与上一帧相同，跳过 n 个像素
+ *   OP_LITERAL n p...   后跟 n 个 RGB565 像素
+ *   OP_FILL    n c      n 个像素都是颜色 c
+ * 由主机端工具 host/anim_encode 从一组图片生成
+ */
+struct CompressedAnimation {
+  const uint16_t* stream;  // 编码数据
+  uint16_t width;
+  uint16_t height;
+  uint16_t frameCount;
+  int16_t x;               // -1 表示居中
+  int16_t y;               // -1 表示居中
+  bool loop;
+};
+
+/**
+ * 压缩动画流式解码器
+ * 缓冲模式下直接写入后台缓冲，只把变化的行段标记为脏；
+ * 直接模式下每个变化行段一次地址窗口 + 写入
+ */
+class AnimationDecoder {
+public:
+  static const uint16_t OP_SKIP = 0x0000;
+  static const uint16_t OP_LITERAL = 0x4000;
+  static const uint16_t OP_FILL = 0x8000;
+  static const uint16_t OP_END = 0xC000;
+  static const uint16_t OP_MASK = 0xC000;
+  static const uint16_t COUNT_MASK = 0x3FFF;
+  static const uint16_t FRAME_KEY = 0x0001;
+
+  AnimationDecoder();
+
+  void setFrameBuffer(FrameBuffer* fb) { pFrameBuffer = fb; }
+  void setTFT(Adafruit_ST7789* tft) { pTFT = tft; }
+
+  // 从第 0 帧开始播放，(x, y) 为帧左上角
+  void begin(const CompressedAnimation* anim, int16_t x, int16_t y);
+  void end() { animation = nullptr; }
+  bool isActive() const { return animation != nullptr; }
+
+  // 解码下一帧；播放完（不循环）或数据错误时返回 false
+  bool decodeNext();
+
+  uint16_t getFrameIndex() const { return frameIndex; }
+  uint16_t getFrameDuration() const { return frameDuration; }
+  uint32_t getChangedPixels() const { return changedPixels; }  // 上一帧变化像素
+
+private:
+  FrameBuffer* pFrameBuffer;
+  Adafruit_ST7789* pTFT;
+
+  const CompressedAnimation* animation;
+  const uint16_t* cursor;  // 下一帧在编码流中的位置
+  int16_t originX;
+  int16_t originY;
+  uint16_t nextFrame;
+  uint16_t frameIndex;
+  uint16_t frameDuration;
+  uint32_t changedPixels;
+
+  bool direct() const;
+  // 把帧内 [pos, pos + count) 的像素写出（按行拆分）；fill 时 pixels 只有一个
+  void writeSpan(uint32_t pos, const uint16_t* pixels, uint32_t count,
+                 bool fill, bool markRows);
+};
+
+#endif // ANIMATION_DECODER_H
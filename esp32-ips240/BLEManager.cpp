@@ -15,6 +15,9 @@ BLEManager::BLEManager() {
 
   commandCallback = nullptr;
   wifiCallback = nullptr;
+  connectionCallback = nullptr;
+  linkEvents.store(0);
+  handledLinkEvents = 0;
 
   ssidReceived = false;
   passwordReceived = false;
@@ -27,6 +30,11 @@ void BLEManager::begin(const char* deviceName) {
 
   // 创建BLE设备
   BLEDevice::init(deviceName);
+  // 大 MTU 让图片数据帧一次写入携带更多像素（实际值由手机在连接后协商）
+  BLEDevice::setMTU(PREFERRED_MTU);
+
+  // 指令队列：回调任务只入队，主循环执行
+  commandQueue.begin();
 
   // 创建BLE服务器
   pServer = BLEDevice::createServer();
@@ -46,10 +54,11 @@ void BLEManager::setupService() {
   // 创建BLE服务
   pService = pServer->createService(SERVICE_UUID);
 
-  // 创建指令特征值 (Write)
+  // 创建指令特征值 (Write + Write Without Response)
+  // 图片数据帧用无响应写入，一个连接事件内可连续发送多个
   pCharCommand = pService->createCharacteristic(
     CHAR_COMMAND_UUID,
-    BLECharacteristic::PROPERTY_WRITE
+    BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_WRITE_NR
   );
   pCharCommand->setCallbacks(new MyCommandCallbacks(this));
 
@@ -127,24 +136,67 @@ String BLEManager::getDeviceName() {
   return deviceName;
 }
 
+uint16_t BLEManager::getMTU() {
+  if (!deviceConnected || !pServer) {
+    return DEFAULT_MTU;
+  }
+  uint16_t mtu = pServer->getPeerMTU(pServer->getConnId());
+  return mtu >= DEFAULT_MTU ? mtu : DEFAULT_MTU;
+}
+
 bool BLEManager::sendData(const String& data) {
+  return sendData((const uint8_t*)data.c_str(), data.length());
+}
+
+bool BLEManager::sendData(const char* text) {
+  return sendData((const uint8_t*)text, strlen(text));
+}
+
+bool BLEManager::sendData(const uint8_t* data, size_t length) {
   if (!deviceConnected || !pCharData) {
     return false;
   }
-
-  pCharData->setValue(data.c_str());
-  pCharData->notify();
-  return true;
+  return notifyQueue.push(data, length);
 }
 
-bool BLEManager::sendData(const uint8_t* data, size_t length) {
+void BLEManager::poll() {
   if (!deviceConnected || !pCharData) {
+    commandQueue.dropPendingReplies();
+    return;
+  }
+  if (notifyQueue.isEmpty()) {
+    return;
+  }
+
+  // 每个通知最多 MTU - 3 字节；本连接间隔的配额用完后留到下一次
+  uint8_t packet[PREFERRED_MTU - 3];
+  size_t maxLength = min((size_t)(getMTU() - 3), sizeof(packet));
+  size_t length;
+  while ((length = notifyQueue.take(micros(), packet, maxLength)) > 0) {
+    pCharData->setValue(packet, length);
+    pCharData->notify();
+  }
+  commandQueue.onRepliesSent(notifyQueue.getRetiredCount());
+}
+
+bool BLEManager::sendFrame(uint8_t opcode, const uint8_t* payload,
+                           uint16_t length) {
+  uint8_t frame[FrameParser::MAX_FRAME];
+  size_t frameLength = FrameParser::encode(opcode, payload, length, frame,
+                                           sizeof(frame));
+  if (frameLength == 0) {
     return false;
   }
+  return sendData(frame, frameLength);
+}
 
-  pCharData->setValue((uint8_t*)data, length);
-  pCharData->notify();
-  return true;
+void BLEManager::flush(unsigned long timeoutMs) {
+  unsigned long start = millis();
+  while (deviceConnected && !notifyQueue.isEmpty() &&
+         millis() - start < timeoutMs) {
+    poll();
+    delay(1);
+  }
 }
 
 bool BLEManager::updateStatus(const String& status) {
@@ -163,19 +215,37 @@ void BLEManager::setCommandCallback(CommandCallback callback) {
   commandCallback = callback;
 }
 
+void BLEManager::setFrameCallback(FrameCallback callback) {
+  frameParser.setCallback(callback);
+}
+
 void BLEManager::setWiFiCredentialsCallback(WiFiCredentialsCallback callback) {
   wifiCallback = callback;
 }
 
-void BLEManager::handleConnection() {
+void BLEManager::setConnectionCallback(ConnectionCallback callback) {
+  connectionCallback = callback;
+}
+
+void BLEManager::handleConnection(uint16_t intervalUnits) {
   deviceConnected = true;
   connectedCount++;
-  Serial.println("设备已连接");
+  // 上一个连接可能断在帧中间：生产端重新找帧头，消费端经 resync 丢弃残帧
+  commandQueue.resetFrames();
+  linkEvents.fetch_add(1);
+  uint32_t intervalMicros = intervalUnits > 0
+      ? intervalUnits * 1250UL : NotifyQueue::DEFAULT_INTERVAL_MICROS;
+  notifyQueue.clear();
+  notifyQueue.setPacing(intervalMicros, NotifyQueue::DEFAULT_PACKETS_PER_INTERVAL);
+  Serial.printf("设备已连接，连接间隔 %.2f ms\n", intervalMicros / 1000.0f);
   updateStatus("connected");
 }
 
 void BLEManager::handleDisconnection() {
   deviceConnected = false;
+  notifyQueue.clear();
+  commandQueue.resetFrames();
+  linkEvents.fetch_add(1);
   Serial.println("设备已断开连接");
 
   // 断开后重新开始广播
@@ -184,15 +254,129 @@ void BLEManager::handleDisconnection() {
   updateStatus("ready");
 }
 
-void BLEManager::handleCommandReceived(String command) {
-  Serial.println("收到指令: " + command);
+void BLEManager::handleWriteReceived(const uint8_t* data, size_t length) {
+  // BLE 回调任务：只复制进指令队列，由 processCommands() 在主循环中执行
+  uint8_t kind;
+  uint8_t frameOpcode;
+  CommandPushResult result = commandQueue.push(data, length, &kind, &frameOpcode);
+  signalPushResult(result, kind, frameOpcode);
+}
+
+void BLEManager::handleWiFiWrite(uint8_t kind, const uint8_t* data,
+                                 size_t length) {
+  signalPushResult(commandQueue.pushValue(kind, data, length), kind, 0);
+}
+
+void BLEManager::signalPushResult(CommandPushResult result, uint8_t kind,
+                                  uint8_t frameOpcode) {
+  if (result == COMMAND_QUEUED_BUSY) {
+    Serial.println("Warning: BLE command queue busy");
+    updateStatus("busy");
+  } else if (result == COMMAND_REJECTED) {
+    rejectWrite(kind, frameOpcode);
+  }
+}
+
+// 队列满：告知手机稍后重发（二进制帧回复 BUSY 状态，文本回复 ERROR:Busy）。
+// 类别按生产端跟踪的帧边界判断，帧的后续写入也回复该帧的操作码
+void BLEManager::rejectWrite(uint8_t kind, uint8_t frameOpcode) {
+  if (kind != COMMAND_KIND_FRAME) {
+    sendData("ERROR:Busy");
+  } else if (frameOpcode != 0) {
+    uint8_t status = FRAME_STATUS_BUSY;
+    sendFrame(frameOpcode | FRAME_REPLY_FLAG, &status, 1);
+  } else {
+    Serial.println("Warning: BLE frame dropped, command queue full");
+  }
+}
+
+void BLEManager::processCommands() {
+  checkConnectionChange();
+
+  const CommandQueue::Entry* entry;
+  while ((entry = commandQueue.front()) != nullptr) {
+    uint32_t pushedBefore = notifyQueue.getPushedCount();
+    executeWrite(*entry);
+    commandQueue.pop();
+    // 有回复时，等它的通知发出再记录回复延迟
+    uint32_t pushedAfter = notifyQueue.getPushedCount();
+    if (pushedAfter != pushedBefore) {
+      commandQueue.expectReply(pushedAfter);
+    }
+  }
+  if (commandQueue.checkResume()) {
+    updateStatus("connected");
+  }
+}
+
+// 连接状态变化后通知主循环（例如中止进行中的图片上传）
+void BLEManager::checkConnectionChange() {
+  uint32_t events = linkEvents.load();
+  if (events == handledLinkEvents) return;
+  handledLinkEvents = events;
+  if (connectionCallback) {
+    connectionCallback(deviceConnected);
+  }
+}
+
+void BLEManager::executeWrite(const CommandQueue::Entry& entry) {
+  // 之前丢弃了一个帧的部分写入：丢弃解析器中的残帧
+  if (entry.resync) {
+    frameParser.reset();
+  }
+
+  switch (entry.kind) {
+    case COMMAND_KIND_FRAME:
+      // 帧的写入交给二进制解析器，不回 ACK：回复帧即确认
+      frameParser.feed(entry.data, entry.length);
+      break;
+    case COMMAND_KIND_WIFI_SSID:
+      if (copyCommandLine(entry.data, entry.length) > 0) {
+        handleWiFiSSIDReceived(String(commandLine));
+      }
+      break;
+    case COMMAND_KIND_WIFI_PASSWORD:
+      if (copyCommandLine(entry.data, entry.length) > 0) {
+        handleWiFiPasswordReceived(String(commandLine));
+      }
+      break;
+    default: {
+      size_t commandLength = copyCommandLine(entry.data, entry.length);
+      if (commandLength > 0) {
+        handleCommandReceived(commandLength);
+      }
+      break;
+    }
+  }
+}
+
+// 文本复制到固定的指令缓冲（到第一个 0 字节为止），不构造 String
+size_t BLEManager::copyCommandLine(const uint8_t* data, size_t length) {
+  size_t commandLength = 0;
+  while (commandLength < length && data[commandLength] != '\0') {
+    commandLength++;
+  }
+  if (commandLength > TextCommandParser::MAX_COMMAND_LENGTH) {
+    Serial.printf("Warning: command truncated to %u bytes\n",
+                  (unsigned)TextCommandParser::MAX_COMMAND_LENGTH);
+    commandLength = TextCommandParser::MAX_COMMAND_LENGTH;
+  }
+  memcpy(commandLine, data, commandLength);
+  commandLine[commandLength] = '\0';
+  return commandLength;
+}
+
+void BLEManager::handleCommandReceived(size_t length) {
+  Serial.printf("收到指令: %s\n", commandLine);
 
-  // 发送确认消息
-  sendData("ACK:" + command);
+  // 发送确认消息（与随后的回复合并在同一个通知中发出）
+  ReplyBuffer ack;
+  ack.append("ACK:").append(commandLine);
+  sendData(ack.c_str());
 
-  // 调用用户设置的回调函数
+  // 调用用户设置的回调函数（在指令缓冲上就地解析）
   if (commandCallback) {
-    commandCallback(command);
+    commandCallback(commandLine, length);
   }
 }
 
@@ -215,7 +399,7 @@ void BLEManager::handleWiFiPasswordReceived(String password) {
 }
 
 void BLEManager::checkWiFiCredentials() {
-  // 当SSID和密码都收到时，触发WiFi配网回调
+  // 当SSID和密码都收到时，触发WiFi配网回调（在主循环中，连接过程会阻塞数秒）
   if (ssidReceived && passwordReceived && wifiCallback) {
     Serial.println("WiFi凭证接收完成，触发配网流程");
     wifiCallback(receivedSSID, receivedPassword);
@@ -2,10 +2,15 @@
 #define BLE_MANAGER_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <BLEDevice.h>
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#include "BinaryProtocol.h"
+#include "TextCommandParser.h"
+#include "NotifyQueue.h"
+#include "CommandQueue.h"
 
 // BLE服务和特征值UUID定义
 #define SERVICE_UUID           "4fafc201-1fb5-459e-8fcc-c5c9c331914b"
@@ -16,11 +21,17 @@
 #define CHAR_STATUS_UUID       "beb5483e-36e1-4688-b7f5-ea07361b26ac"  // 状态
 
 // 回调函数类型定义
-typedef void (*CommandCallback)(String command);
+// 文本指令：command 指向可写缓冲（至少 length + 1 字节），可就地解析
+typedef void (*CommandCallback)(char* command, size_t length);
 typedef void (*WiFiCredentialsCallback)(String ssid, String password);
+// 连接建立 / 断开（在主循环中调用）
+typedef void (*ConnectionCallback)(bool connected);
 
 class BLEManager {
 public:
+  static const uint16_t DEFAULT_MTU = 23;     // 未协商时的 ATT MTU
+  static const uint16_t PREFERRED_MTU = 517;  // 连接后向手机请求的 MTU（BLE 上限）
+
   BLEManager();
 
   // 初始化和控制
@@ -34,15 +45,31 @@ public:
   bool isAdvertising();
   uint32_t getConnectedDeviceCount();
   String getDeviceName();
+  // 本次连接协商的 ATT MTU（一次写入最多 MTU - 3 字节）
+  uint16_t getMTU();
 
-  // 数据发送
+  // 数据发送：消息进入通知队列，由 poll() 按连接间隔合并 / 分片后发出
   bool sendData(const String& data);
+  bool sendData(const char* text);
   bool sendData(const uint8_t* data, size_t length);
+  bool sendFrame(uint8_t opcode, const uint8_t* payload, uint16_t length);
   bool updateStatus(const String& status);
+  // 执行排队的指令与配网请求（主循环周期调用，回调在这里被调用）
+  void processCommands();
+  CommandQueueStats getCommandStats() const { return commandQueue.getStats(); }
+  void printCommandStats() { commandQueue.printStats(); }
+  // 发送排队的通知（主循环周期调用）
+  void poll();
+  // 阻塞发送队列中的通知（重启、OTA 等主循环暂停之前调用）
+  void flush(unsigned long timeoutMs = 500);
+  const NotifyQueueStats& getNotifyStats() const { return notifyQueue.getStats(); }
 
   // 回调函数设置
   void setCommandCallback(CommandCallback callback);
+  void setFrameCallback(FrameCallback callback);  // 二进制帧（见 BinaryProtocol.h）
+  const FrameParserStats& getFrameStats() const { return frameParser.getStats(); }
   void setWiFiCredentialsCallback(WiFiCredentialsCallback callback);
+  void setConnectionCallback(ConnectionCallback callback);
 
   // 内部使用的服务器回调类（需要访问私有成员）
   friend class MyServerCallbacks;
@@ -66,9 +93,17 @@ private:
 
   // 回调函数
   CommandCallback commandCallback;
+  FrameParser frameParser;
+  NotifyQueue notifyQueue;
+  CommandQueue commandQueue;  // BLE 回调任务 → 主循环
+  char commandLine[TextCommandParser::MAX_COMMAND_LENGTH + 1];
   WiFiCredentialsCallback wifiCallback;
+  ConnectionCallback connectionCallback;
+  // 连接 / 断开次数（BLE 任务递增，主循环比较后调用 connectionCallback）
+  std::atomic<uint32_t> linkEvents;
+  uint32_t handledLinkEvents;
 
-  // WiFi凭证临时存储
+  // WiFi凭证临时存储（只在主循环中访问：写入经指令队列传来）
   String receivedSSID;
   String receivedPassword;
   bool ssidReceived;
@@ -76,9 +111,17 @@ private:
 
   // 内部方法
   void setupService();
-  void handleConnection();
+  void handleConnection(uint16_t intervalUnits);
   void handleDisconnection();
-  void handleCommandReceived(String command);
+  void checkConnectionChange();
+  void handleCommandReceived(size_t length);
+  void handleWriteReceived(const uint8_t* data, size_t length);
+  void handleWiFiWrite(uint8_t kind, const uint8_t* data, size_t length);
+  void signalPushResult(CommandPushResult result, uint8_t kind,
+                        uint8_t frameOpcode);
+  void executeWrite(const CommandQueue::Entry& entry);
+  size_t copyCommandLine(const uint8_t* data, size_t length);
+  void rejectWrite(uint8_t kind, uint8_t frameOpcode);
   void handleWiFiSSIDReceived(String ssid);
   void handleWiFiPasswordReceived(String password);
   void checkWiFiCredentials();
@@ -89,8 +132,9 @@ class MyServerCallbacks: public BLEServerCallbacks {
 public:
   MyServerCallbacks(BLEManager* manager) : bleManager(manager) {}
 
-  void onConnect(BLEServer* pServer) {
-    bleManager->handleConnection();
+  void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+    // 连接间隔以 1.25 ms 为单位
+    bleManager->handleConnection(param->connect.conn_params.interval);
   }
 
   void onDisconnect(BLEServer* pServer) {
@@ -107,9 +151,10 @@ public:
   MyCommandCallbacks(BLEManager* manager) : bleManager(manager) {}
 
   void onWrite(BLECharacteristic *pCharacteristic) {
-    String value = String(pCharacteristic->getValue().c_str());
-    if (value.length() > 0) {
-      bleManager->handleCommandReceived(value);
+    // 按原始字节处理：二进制帧中可能有 0 字节。只入队，在主循环中执行
+    size_t length = pCharacteristic->getLength();
+    if (length > 0) {
+      bleManager->handleWriteReceived(pCharacteristic->getData(), length);
     }
   }
 
@@ -123,9 +168,11 @@ public:
   MyWiFiSSIDCallbacks(BLEManager* manager) : bleManager(manager) {}
 
   void onWrite(BLECharacteristic *pCharacteristic) {
-    String value = String(pCharacteristic->getValue().c_str());
-    if (value.length() > 0) {
-      bleManager->handleWiFiSSIDReceived(value);
+    // 入队，由主循环保存（凭证 String 不在回调任务中修改）
+    size_t length = pCharacteristic->getLength();
+    if (length > 0) {
+      bleManager->handleWiFiWrite(COMMAND_KIND_WIFI_SSID,
+                                  pCharacteristic->getData(), length);
     }
   }
 
@@ -139,9 +186,10 @@ public:
   MyWiFiPasswordCallbacks(BLEManager* manager) : bleManager(manager) {}
 
   void onWrite(BLECharacteristic *pCharacteristic) {
-    String value = String(pCharacteristic->getValue().c_str());
-    if (value.length() > 0) {
-      bleManager->handleWiFiPasswordReceived(value);
+    size_t length = pCharacteristic->getLength();
+    if (length > 0) {
+      bleManager->handleWiFiWrite(COMMAND_KIND_WIFI_PASSWORD,
+                                  pCharacteristic->getData(), length);
     }
   }
 
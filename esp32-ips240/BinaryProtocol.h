@@ -0,0 +1,146 @@
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <Arduino.h>
+
+// 帧格式：0xA5 | 操作码 | 载荷长度（2 字节小端）| 载荷 | CRC-16/CCITT（2 字节小端）
+// CRC 覆盖操作码、长度和载荷。文本指令都是可打印字符，首字节 0xA5 即为二进制帧
+#define FRAME_MAGIC       0xA5
+#define FRAME_REPLY_FLAG  0x80  // 回复帧的操作码 = 请求操作码 | 0x80，载荷首字节为 FrameStatus
+
+// 二进制指令操作码
+enum FrameOpcode {
+  FRAME_OP_PING       = 0x01,  // 任意载荷，原样回显
+  FRAME_OP_TEXT       = 0x02,  // UTF-8 文本（1~63 字节）
+  FRAME_OP_BRIGHTNESS = 0x03,  // 亮度 0~255
+  FRAME_OP_CLEAR      = 0x04,
+  FRAME_OP_MODE       = 0x05,  // DisplayMode（0 手动 / 1 演示 / 2 时钟 / 3 自定义 / 4 贪吃蛇）
+  FRAME_OP_STATUS     = 0x06,  // 回复状态 JSON
+  FRAME_OP_SLEEP      = 0x07,
+  FRAME_OP_WAKEUP     = 0x08,
+  FRAME_OP_SET_TIME   = 0x09,  // 时、分、秒
+  FRAME_OP_SET_DATE   = 0x0A,  // 年（2 字节小端）、月、日
+  FRAME_OP_BENCHMARK  = 0x0B,  // 可选：缓冲模式 0~5
+  FRAME_OP_TASKS      = 0x0C,
+  // 图片上传（见 ImageReceiver）
+  FRAME_OP_IMAGE_BEGIN = 0x10,  // x、y、宽、高（各 2 字节小端）、格式（0 RGB565 / 5 RLE）
+  FRAME_OP_IMAGE_DATA  = 0x11,  // 序号（2 字节小端）+ 图片数据，无响应写入
+  FRAME_OP_IMAGE_END   = 0x12   // 中止上传
+};
+
+// 回复状态
+enum FrameStatus {
+  FRAME_STATUS_OK = 0,
+  FRAME_STATUS_BAD_LENGTH,    // 载荷长度不在指令允许的范围内
+  FRAME_STATUS_BAD_VALUE,
+  FRAME_STATUS_UNAVAILABLE,   // 对应模块未初始化
+  FRAME_STATUS_UNKNOWN,       // 未知操作码
+  FRAME_STATUS_OUT_OF_ORDER,  // 数据帧序号跳跃，回复中为期望的序号
+  FRAME_STATUS_BUSY,          // 指令队列已满，写入被丢弃，稍后重发
+  FRAME_STATUS_DEFERRED = 0xFF  // 处理函数不回复（数据帧由累计确认一并确认）
+};
+
+// 指令处理函数：可把回复数据写入 reply（最多 *replyLength 字节）并改写 *replyLength
+typedef uint8_t (*FrameHandler)(void* context, const uint8_t* payload,
+                                uint16_t length, uint8_t* reply,
+                                uint16_t* replyLength);
+
+// 分发表项：操作码、载荷长度范围、处理函数
+struct FrameCommand {
+  uint8_t opcode;
+  uint16_t minLength;
+  uint16_t maxLength;
+  FrameHandler handler;
+};
+
+// 收到一个完整且校验通过的帧
+typedef void (*FrameCallback)(uint8_t opcode, const uint8_t* payload,
+                              uint16_t length);
+
+struct FrameParserStats {
+  uint32_t frames;
+  uint32_t crcErrors;
+  uint32_t lengthErrors;    // 长度字段超过 MAX_PAYLOAD
+  uint32_t discardedBytes;  // 不属于有效帧而被丢弃的字节
+};
+
+/**
+ * 二进制帧解析器
+ *
+ * 字节流可以任意切分（一次 BLE 写入可含多个帧，一个帧也可跨多次写入）。
+ * 完整的帧直接在输入数据上解析，只有跨写入的残余部分复制到固定的帧缓冲，
+ * 不分配内存。长度或 CRC 错误时只丢弃帧头字节，从下一个字节重新查找帧头，
+ * 所以混在坏数据后面的完整帧仍能被收到。
+ * 回调中的载荷指针只在回调期间有效
+ */
+class FrameParser {
+public:
+  static const uint16_t MAX_PAYLOAD = 512;
+  static const uint8_t HEADER_SIZE = 4;
+  static const uint8_t CRC_SIZE = 2;
+  static const uint16_t MAX_FRAME = HEADER_SIZE + MAX_PAYLOAD + CRC_SIZE;
+
+  FrameParser();
+
+  void setCallback(FrameCallback callback) { this->callback = callback; }
+
+  // 送入收到的字节，返回本次解析出的完整帧数
+  size_t feed(const uint8_t* data, size_t length);
+  // 正在接收一个帧（后续写入应继续送入解析器）
+  bool isReceiving() const { return count > 0; }
+  void reset() { count = 0; }
+
+  const FrameParserStats& getStats() const { return stats; }
+  void resetStats();
+
+  // 编码一个帧，返回帧长度（out 容量不足时返回 0）
+  static size_t encode(uint8_t opcode, const uint8_t* payload, uint16_t length,
+                       uint8_t* out, size_t outSize);
+  static uint16_t crc16(const uint8_t* data, size_t length,
+                        uint16_t crc = 0xFFFF);
+
+  // 在分发表中查找操作码并检查载荷长度，然后调用处理函数，返回 FrameStatus
+  static uint8_t dispatch(const FrameCommand* table, uint8_t tableSize,
+                          void* context, uint8_t opcode,
+                          const uint8_t* payload, uint16_t length,
+                          uint8_t* reply, uint16_t* replyLength);
+
+private:
+  uint8_t buffer[MAX_FRAME];
+  uint16_t count;
+  FrameCallback callback;
+  FrameParserStats stats;
+
+  size_t scan(const uint8_t* data, size_t length, size_t* frames);
+};
+
+/**
+ * 帧边界跟踪
+ *
+ * 只读帧头（魔数、操作码、长度），按长度数出载荷与 CRC 的剩余字节，不复制、
+ * 不校验，每个帧的开销是常数。用于在写入到达时判断它是否属于一个进行中的帧，
+ * 真正的解析与校验仍由 FrameParser 完成。
+ * 帧之后不以魔数开头的字节、长度超过 MAX_PAYLOAD 的帧头不跟踪（FrameParser
+ * 会逐字节丢弃并重新查找帧头）
+ */
+class FrameTracker {
+public:
+  FrameTracker() { reset(); }
+
+  void feed(const uint8_t* data, size_t length);
+  // 正在接收一个帧（帧头未收全，或载荷 / CRC 还有剩余字节）
+  bool isReceiving() const { return headerCount > 0; }
+  // 正在接收的帧的操作码（帧头还没收到操作码时为 0）
+  uint8_t receivingOpcode() const { return headerCount >= 2 ? header[1] : 0; }
+  void reset() {
+    headerCount = 0;
+    remaining = 0;
+  }
+
+private:
+  uint8_t header[FrameParser::HEADER_SIZE];
+  uint8_t headerCount;
+  uint16_t remaining;  // 帧头之后还差的载荷与 CRC 字节
+};
+
+#endif // BINARY_PROTOCOL_H
@@ -0,0 +1,58 @@
+#include "BufferAllocator.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <esp_heap_caps.h>
+
+static const uint32_t CAPS_INTERNAL = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+static const uint32_t CAPS_PSRAM = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+static const uint32_t CAPS_LINE_CACHE = MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+
+void* BufferAllocator::allocate(size_t bytes, BufferPlacement placement,
+                                MemoryRegion* region) {
+  void* buffer = nullptr;
+  *region = MEMORY_NONE;
+
+  if (placement != BUFFER_PLACE_INTERNAL && hasPSRAM()) {
+    buffer = heap_caps_malloc(bytes, CAPS_PSRAM);
+    if (buffer != nullptr) {
+      *region = MEMORY_PSRAM;
+      return buffer;
+    }
+  }
+  if (placement != BUFFER_PLACE_PSRAM) {
+    buffer = heap_caps_malloc(bytes, CAPS_INTERNAL);
+    if (buffer != nullptr) *region = MEMORY_INTERNAL;
+  }
+  return buffer;
+}
+
+void* BufferAllocator::allocateLineCache(size_t bytes, MemoryRegion* region) {
+  void* buffer = heap_caps_malloc(bytes, CAPS_LINE_CACHE);
+  *region = buffer != nullptr ? MEMORY_INTERNAL : MEMORY_NONE;
+  return buffer;
+}
+
+void BufferAllocator::release(void* buffer) {
+  heap_caps_free(buffer);
+}
+
+bool BufferAllocator::hasPSRAM() {
+  return heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+}
+
+size_t BufferAllocator::getFreeBytes(MemoryRegion region) {
+  if (region == MEMORY_PSRAM) return heap_caps_get_free_size(CAPS_PSRAM);
+  if (region == MEMORY_INTERNAL) return heap_caps_get_free_size(CAPS_INTERNAL);
+  return 0;
+}
+
+const char* BufferAllocator::regionName(MemoryRegion region) {
+  switch (region) {
+    case MEMORY_INTERNAL: return "internal";
+    case MEMORY_PSRAM: return "PSRAM";
+    default: return "none";
+  }
+}
+
+#endif // ARDUINO_ARCH_ESP32
@@ -0,0 +1,46 @@
+#ifndef BUFFER_ALLOCATOR_H
+#define BUFFER_ALLOCATOR_H
+
+#include <Arduino.h>
+
+// 缓冲所在的内存
+enum MemoryRegion {
+  MEMORY_NONE,       // 未分配
+  MEMORY_INTERNAL,   // 内部 SRAM
+  MEMORY_PSRAM       // 外部 PSRAM
+};
+
+// 帧缓冲放置策略
+enum BufferPlacement {
+  BUFFER_PLACE_AUTO,      // 有 PSRAM 时放 PSRAM，否则内部 SRAM
+  BUFFER_PLACE_INTERNAL,  // 只用内部 SRAM
+  BUFFER_PLACE_PSRAM      // 只用 PSRAM
+};
+
+/**
+ * 按内存能力分配缓冲
+ *
+ * 大的帧缓冲按放置策略分配，把内部 SRAM 留给 BLE / WiFi 协议栈；
+ * 行缓存固定在内部 SRAM 且可被 DMA 访问，实际的 SPI 传输都从这里读取。
+ * 主机端由 host/mock/BufferAllocator.cpp 模拟两块容量可设的内存
+ */
+class BufferAllocator {
+public:
+  // 帧缓冲；region 返回实际所在的内存
+  static void* allocate(size_t bytes, BufferPlacement placement,
+                        MemoryRegion* region);
+  // 行缓存（内部 SRAM，DMA 可访问）
+  static void* allocateLineCache(size_t bytes, MemoryRegion* region);
+  static void release(void* buffer);
+
+  static bool hasPSRAM();
+  static size_t getFreeBytes(MemoryRegion region);
+  static const char* regionName(MemoryRegion region);
+
+#if !defined(ARDUINO_ARCH_ESP32)
+  // 主机模拟：设置两块内存的容量（默认内部不限、没有 PSRAM）
+  static void setHostLimits(size_t internalBytes, size_t psramBytes);
+#endif
+};
+
+#endif // BUFFER_ALLOCATOR_H
@@ -1,7 +1,14 @@
 #include "ClockDisplay.h"
 
-ClockDisplay::ClockDisplay(DisplayManager* display) {
+// 时间数字顶端（分隔线在 80 与 145 行之间）
+static const int16_t TIME_Y = 93;
+
+ClockDisplay::ClockDisplay(DisplayManager* display)
+    : screen(display), digits(display) {
   pDisplay = display;
+  dateLabel = WidgetScreen::NO_WIDGET;
+  uptimeLabel = WidgetScreen::NO_WIDGET;
+  screenBuilt = false;
   hour = 0;
   minute = 0;
   second = 0;
@@ -14,6 +21,7 @@ ClockDisplay::ClockDisplay(DisplayManager* display) {
 }
 
 void ClockDisplay::begin() {
+  digits.begin();
   Serial.println("时钟显示模块已初始化");
 }
 
@@ -71,6 +79,8 @@ void ClockDisplay::update() {
 }
 
 void ClockDisplay::show() {
+  screenBuilt = false;
+
   if (!timeSet) {
     // 显示未设置时间的提示
     pDisplay->clear(ST77XX_BLACK);
@@ -86,20 +96,46 @@ void ClockDisplay::show() {
   lastDisplayTime = millis();
 }
 
+void ClockDisplay::refresh() {
+  if (!timeSet || !screenBuilt) {
+    show();
+    return;
+  }
+
+  // 运行时间（与跨天时的日期）走控件损坏区域，时间只重绘变化的数字
+  updateLabels();
+  screen.render();
+  char time[9];
+  formatTime(time, sizeof(time));
+  digits.draw(time);
+  lastDisplayTime = millis();
+}
+
 bool ClockDisplay::isTimeSet() {
   return timeSet;
 }
 
 String ClockDisplay::getTimeString() {
-  return formatTwoDigits(hour) + ":" +
-         formatTwoDigits(minute) + ":" +
-         formatTwoDigits(second);
+  char time[9];
+  formatTime(time, sizeof(time));
+  return String(time);
 }
 
 String ClockDisplay::getDateString() {
-  return String(year) + "-" +
-         formatTwoDigits(month) + "-" +
-         formatTwoDigits(day);
+  char date[11];
+  formatDate(date, sizeof(date));
+  return String(date);
+}
+
+// 各字段按显示宽度取模，输出长度固定，缓冲区大小与头文件约定一致
+void ClockDisplay::formatTime(char* buffer, size_t size) {
+  snprintf(buffer, size, "%02u:%02u:%02u", (unsigned)(hour % 100),
+           (unsigned)(minute % 100), (unsigned)(second % 100));
+}
+
+void ClockDisplay::formatDate(char* buffer, size_t size) {
+  snprintf(buffer, size, "%04u-%02u-%02u", (unsigned)(year % 10000),
+           (unsigned)(month % 100), (unsigned)(day % 100));
 }
 
 void ClockDisplay::updateTime() {
@@ -119,32 +155,35 @@ void ClockDisplay::updateTime() {
 }
 
 void ClockDisplay::displayClock() {
-  pDisplay->clear(ST77XX_BLACK);
+  screen.begin(ST77XX_BLACK);
 
   // 显示日期（顶部）
-  String dateStr = getDateString();
-  pDisplay->drawCenteredText(dateStr.c_str(), 30, ST77XX_CYAN, 1);
-
-  // 显示时间（大号字体，居中）
-  String timeStr = getTimeString();
-  pDisplay->drawCenteredText(timeStr.c_str(), 100, ST77XX_WHITE, 3);
+  dateLabel = screen.addCenteredLabel("", 30, ST77XX_CYAN, 1);
 
   // 显示星期几的位置（可选，目前显示"Clock Mode"）
-  pDisplay->drawCenteredText("Clock Mode", 160, ST77XX_GREEN, 1);
+  screen.addCenteredLabel("Clock Mode", 160, ST77XX_GREEN, 1);
 
   // 显示分隔线装饰
-  pDisplay->drawLine(40, 80, 200, 80, ST77XX_BLUE);
-  pDisplay->drawLine(40, 145, 200, 145, ST77XX_BLUE);
+  screen.addLine(40, 80, 200, 80, ST77XX_BLUE);
+  screen.addLine(40, 145, 200, 145, ST77XX_BLUE);
 
   // 底部信息
-  char buffer[32];
-  snprintf(buffer, sizeof(buffer), "Uptime: %lus", millis() / 1000);
-  pDisplay->drawCenteredText(buffer, 200, ST77XX_MAGENTA, 1);
+  uptimeLabel = screen.addCenteredLabel("", 200, ST77XX_MAGENTA, 1);
+
+  updateLabels();
+  screen.render();
+
+  // 显示时间（七段大数字，居中于两条分隔线之间）
+  digits.setStyle(TIME_Y, ST77XX_WHITE, ST77XX_BLACK);
+  digits.draw(getTimeString().c_str());
+  screenBuilt = true;
 }
 
-String ClockDisplay::formatTwoDigits(uint8_t value) {
-  if (value < 10) {
-    return "0" + String(value);
-  }
-  return String(value);
+void ClockDisplay::updateLabels() {
+  char buffer[32];
+  formatDate(buffer, sizeof(buffer));
+  screen.setText(dateLabel, buffer);
+
+  snprintf(buffer, sizeof(buffer), "Uptime: %lus", millis() / 1000);
+  screen.setText(uptimeLabel, buffer);
 }
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include "Display.h"
+#include "WidgetScreen.h"
+#include "SegmentDigits.h"
 
 class ClockDisplay {
 public:
@@ -16,16 +18,26 @@ public:
   // 时钟控制
   void begin();
   void update();  // 在loop中调用，更新时间显示
-  void show();    // 显示时钟界面
+  void show();    // 显示时钟界面（进入时钟模式时调用，整屏绘制）
+  void refresh(); // 每秒调用：只重绘变化的数字与文字
 
   // 状态查询
   String getTimeString();
   String getDateString();
+  void formatTime(char* buffer, size_t size);  // HH:MM:SS，至少 9 字节
+  void formatDate(char* buffer, size_t size);  // YYYY-MM-DD，至少 11 字节
   bool isTimeSet();
 
 private:
   DisplayManager* pDisplay;
 
+  // 时钟界面（保留模式）：日期、运行时间文字与装饰；时间用七段数字单独绘制
+  WidgetScreen screen;
+  SegmentDigits digits;
+  uint8_t dateLabel;
+  uint8_t uptimeLabel;
+  bool screenBuilt;
+
   // 时间变量
   uint8_t hour;
   uint8_t minute;
@@ -42,7 +54,7 @@ private:
   // 内部方法
   void updateTime();
   void displayClock();
-  String formatTwoDigits(uint8_t value);
+  void updateLabels();
 };
 
 #endif // CLOCK_DISPLAY_H
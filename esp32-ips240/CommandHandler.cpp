@@ -1,12 +1,18 @@
 #include "CommandHandler.h"
 #include "ClockDisplay.h"
 #include "OTAManager.h"
+#include "DisplayBenchmark.h"
+#include "TaskScheduler.h"
+#include "ImageReceiver.h"
 
 CommandHandler::CommandHandler(DisplayManager* display, BLEManager* ble) {
   pDisplay = display;
   pBLE = ble;
   pClock = nullptr;
   pOTA = nullptr;
+  pBenchmark = nullptr;
+  pScheduler = nullptr;
+  pImage = nullptr;
   currentMode = MODE_DEMO;
 }
 
@@ -22,69 +28,45 @@ void CommandHandler::setOTAManager(OTAManager* ota) {
   pOTA = ota;
 }
 
-void CommandHandler::handleCommand(String command) {
-  command.trim();
+void CommandHandler::setBenchmark(DisplayBenchmark* bench) {
+  pBenchmark = bench;
+}
+
+void CommandHandler::setScheduler(TaskScheduler* scheduler) {
+  pScheduler = scheduler;
+}
+
+void CommandHandler::setImageReceiver(ImageReceiver* receiver) {
+  pImage = receiver;
+}
+
+void CommandHandler::handleCommand(char* command, size_t length) {
+  execute(TextCommandParser::parse(command, length));
+}
 
-  if (command.length() == 0) {
+void CommandHandler::execute(const ParsedCommand& command) {
+  if (command.command[0] == '\0') {
     return;
   }
 
-  Serial.println("处理指令: " + command);
-
-  CommandType cmdType = parseCommandType(command);
-
-  switch (cmdType) {
-    case CMD_SET_TEXT: {
-      String param = extractParameter(command, "TEXT:");
-      if (param.length() == 0) {
-        param = extractParameter(command, "T:");
-      }
-      if (param.length() == 0) {
-        String cmdUpper = command;
-        cmdUpper.toUpperCase();
-        if (cmdUpper.startsWith("T ")) {
-          param = command.substring(2);  // "T " 后面的所有内容
-        }
-      }
-      executeSetText(param);
+  Serial.printf("处理指令: %s\n", command.command);
+
+  switch (command.type) {
+    case CMD_SET_TEXT:
+      executeSetText(command.param, command.paramLength);
       break;
-    }
 
-    case CMD_SET_BRIGHTNESS: {
-      String param = extractParameter(command, "BRIGHTNESS:");
-      if (param.length() == 0) {
-        param = extractParameter(command, "B:");
-      }
-      if (param.length() == 0) {
-        String cmdUpper = command;
-        cmdUpper.toUpperCase();
-        if (cmdUpper.startsWith("B ")) {
-          param = command.substring(2);  // "B " 后面的所有内容
-        }
-      }
-      executeSetBrightness(param);
+    case CMD_SET_BRIGHTNESS:
+      executeSetBrightness(command.param, command.paramLength);
       break;
-    }
 
     case CMD_CLEAR_SCREEN:
       executeClearScreen();
       break;
 
-    case CMD_SET_MODE: {
-      String param = extractParameter(command, "MODE:");
-      if (param.length() == 0) {
-        param = extractParameter(command, "M:");
-      }
-      if (param.length() == 0) {
-        String cmdUpper = command;
-        cmdUpper.toUpperCase();
-        if (cmdUpper.startsWith("M ")) {
-          param = command.substring(2);  // "M " 后面的所有内容
-        }
-      }
-      executeSetMode(param);
+    case CMD_SET_MODE:
+      executeSetMode(command.param);
       break;
-    }
 
     case CMD_GET_STATUS:
       executeGetStatus();
@@ -102,116 +84,280 @@ void CommandHandler::handleCommand(String command) {
       executeRestart();
       break;
 
-    case CMD_SET_TIME: {
-      String param = extractParameter(command, "SETTIME:");
-      if (param.length() == 0) {
-        param = extractParameter(command, "ST:");
-      }
-      if (param.length() == 0) {
-        String cmdUpper = command;
-        cmdUpper.toUpperCase();
-        if (cmdUpper.startsWith("ST ")) {
-          param = command.substring(3);  // "ST " 后面的所有内容
-        }
-      }
-      executeSetTime(param);
+    case CMD_SET_TIME:
+      executeSetTime(command.param, command.paramLength);
       break;
-    }
 
-    case CMD_SET_DATE: {
-      String param = extractParameter(command, "SETDATE:");
-      if (param.length() == 0) {
-        param = extractParameter(command, "SD:");
-      }
-      if (param.length() == 0) {
-        String cmdUpper = command;
-        cmdUpper.toUpperCase();
-        if (cmdUpper.startsWith("SD ")) {
-          param = command.substring(3);  // "SD " 后面的所有内容
-        }
-      }
-      executeSetDate(param);
+    case CMD_SET_DATE:
+      executeSetDate(command.param, command.paramLength);
       break;
-    }
 
-    case CMD_OTA_UPDATE: {
-      String param = extractParameter(command, "OTA:");
-      if (param.length() == 0) {
-        String cmdUpper = command;
-        cmdUpper.toUpperCase();
-        if (cmdUpper.startsWith("OTA ")) {
-          param = command.substring(4);  // "OTA " 后面的所有内容
-        }
-      }
-      executeOTAUpdate(param);
+    case CMD_OTA_UPDATE:
+      executeOTAUpdate(command.param, command.paramLength);
+      break;
+
+    case CMD_BENCHMARK:
+      executeBenchmark(command.param, command.paramLength);
+      break;
+
+    case CMD_TASKS:
+      executeTasks();
       break;
-    }
 
     default:
-      Serial.println("未知指令: " + command);
+      Serial.printf("未知指令: %s\n", command.command);
       pBLE->sendData("ERROR:Unknown command");
       break;
   }
 }
 
-CommandType CommandHandler::parseCommandType(const String& command) {
-  String cmd = command;
-  cmd.toUpperCase();
+void CommandHandler::sendReply() {
+  pBLE->sendData(reply.c_str());
+}
 
-  // 完整格式和简化格式指令
-  if (cmd.startsWith("TEXT:") || cmd.startsWith("T ") || cmd.startsWith("T:")) {
-    return CMD_SET_TEXT;
-  } else if (cmd.startsWith("BRIGHTNESS:") || cmd.startsWith("B ") || cmd.startsWith("B:")) {
-    return CMD_SET_BRIGHTNESS;
-  } else if (cmd == "CLEAR" || cmd == "C") {
-    return CMD_CLEAR_SCREEN;
-  } else if (cmd.startsWith("MODE:") || cmd.startsWith("M ") || cmd.startsWith("M:")) {
-    return CMD_SET_MODE;
-  } else if (cmd == "STATUS" || cmd == "GET_STATUS" || cmd == "S") {
-    return CMD_GET_STATUS;
-  } else if (cmd == "SLEEP") {
-    return CMD_SLEEP;
-  } else if (cmd == "WAKEUP" || cmd == "WAKE" || cmd == "W") {
-    return CMD_WAKEUP;
-  } else if (cmd == "RESTART" || cmd == "REBOOT" || cmd == "R") {
-    return CMD_RESTART;
-  } else if (cmd.startsWith("SETTIME:") || cmd.startsWith("ST ") || cmd.startsWith("ST:")) {
-    return CMD_SET_TIME;
-  } else if (cmd.startsWith("SETDATE:") || cmd.startsWith("SD ") || cmd.startsWith("SD:")) {
-    return CMD_SET_DATE;
-  } else if (cmd.startsWith("OTA:") || cmd.startsWith("OTA ")) {
-    return CMD_OTA_UPDATE;
+// ========== 二进制指令 ==========
+
+const FrameCommand CommandHandler::frameCommands[] = {
+  // 操作码               最短 最长                     处理函数
+  {FRAME_OP_PING,         0, FRAME_REPLY_SIZE - 1,     framePing},
+  {FRAME_OP_TEXT,         1, 63,                       frameText},
+  {FRAME_OP_BRIGHTNESS,   1, 1,                        frameBrightness},
+  {FRAME_OP_CLEAR,        0, 0,                        frameClear},
+  {FRAME_OP_MODE,         1, 1,                        frameMode},
+  {FRAME_OP_STATUS,       0, 0,                        frameStatus},
+  {FRAME_OP_SLEEP,        0, 0,                        frameSleep},
+  {FRAME_OP_WAKEUP,       0, 0,                        frameWakeup},
+  {FRAME_OP_SET_TIME,     3, 3,                        frameSetTime},
+  {FRAME_OP_SET_DATE,     4, 4,                        frameSetDate},
+  {FRAME_OP_BENCHMARK,    0, 1,                        frameBenchmark},
+  {FRAME_OP_TASKS,        0, 0,                        frameTasks},
+  {FRAME_OP_IMAGE_BEGIN,  9, 9,                        frameImageBegin},
+  {FRAME_OP_IMAGE_DATA,   3, FrameParser::MAX_PAYLOAD, frameImageData},
+  {FRAME_OP_IMAGE_END,    0, 0,                        frameImageEnd}
+};
+
+const uint8_t CommandHandler::FRAME_COMMAND_COUNT =
+    sizeof(frameCommands) / sizeof(frameCommands[0]);
+
+void CommandHandler::handleFrame(uint8_t opcode, const uint8_t* payload,
+                                 uint16_t length) {
+  // 回复：状态字节 + 处理函数写入的数据
+  uint8_t response[FRAME_REPLY_SIZE];
+  uint16_t responseLength = FRAME_REPLY_SIZE - 1;
+  response[0] = FrameParser::dispatch(frameCommands, FRAME_COMMAND_COUNT, this,
+                                      opcode, payload, length, response + 1,
+                                      &responseLength);
+  if (response[0] == FRAME_STATUS_DEFERRED) {
+    return;
+  }
+  if (response[0] != FRAME_STATUS_OK) {
+    Serial.printf("二进制指令 0x%02X 失败: %u\n", opcode, response[0]);
   }
+  pBLE->sendFrame(opcode | FRAME_REPLY_FLAG, response, responseLength + 1);
+}
 
-  return CMD_UNKNOWN;
+uint8_t CommandHandler::framePing(void* context, const uint8_t* payload,
+                                  uint16_t length, uint8_t* reply,
+                                  uint16_t* replyLength) {
+  memcpy(reply, payload, length);
+  *replyLength = length;
+  return FRAME_STATUS_OK;
 }
 
-String CommandHandler::extractParameter(const String& command, const String& prefix) {
-  int startIndex = command.indexOf(prefix);
-  if (startIndex == -1) {
-    return "";
+uint8_t CommandHandler::frameText(void* context, const uint8_t* payload,
+                                  uint16_t length, uint8_t* reply,
+                                  uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  char text[64];
+  memcpy(text, payload, length);
+  text[length] = '\0';
+
+  self->pDisplay->clear();
+  self->pDisplay->drawCenteredText(text, 120, ST77XX_WHITE, 2);
+  *replyLength = 0;
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameBrightness(void* context, const uint8_t* payload,
+                                        uint16_t length, uint8_t* reply,
+                                        uint16_t* replyLength) {
+  ((CommandHandler*)context)->pDisplay->setBrightness(payload[0]);
+  *replyLength = 0;
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameClear(void* context, const uint8_t* payload,
+                                   uint16_t length, uint8_t* reply,
+                                   uint16_t* replyLength) {
+  ((CommandHandler*)context)->pDisplay->clear();
+  *replyLength = 0;
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameMode(void* context, const uint8_t* payload,
+                                  uint16_t length, uint8_t* reply,
+                                  uint16_t* replyLength) {
+  *replyLength = 0;
+  if (payload[0] > MODE_SNAKE_DEMO) {
+    return FRAME_STATUS_BAD_VALUE;
+  }
+  ((CommandHandler*)context)->setMode((DisplayMode)payload[0]);
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameStatus(void* context, const uint8_t* payload,
+                                    uint16_t length, uint8_t* reply,
+                                    uint16_t* replyLength) {
+  ReplyBuffer status;
+  ((CommandHandler*)context)->formatStatusJson(status);
+  uint16_t statusLength = min((uint16_t)status.length(), *replyLength);
+  memcpy(reply, status.c_str(), statusLength);
+  *replyLength = statusLength;
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameSleep(void* context, const uint8_t* payload,
+                                   uint16_t length, uint8_t* reply,
+                                   uint16_t* replyLength) {
+  ((CommandHandler*)context)->pDisplay->sleep();
+  *replyLength = 0;
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameWakeup(void* context, const uint8_t* payload,
+                                    uint16_t length, uint8_t* reply,
+                                    uint16_t* replyLength) {
+  ((CommandHandler*)context)->pDisplay->wakeup();
+  *replyLength = 0;
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameSetTime(void* context, const uint8_t* payload,
+                                     uint16_t length, uint8_t* reply,
+                                     uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  *replyLength = 0;
+  if (!self->pClock) {
+    return FRAME_STATUS_UNAVAILABLE;
   }
+  if (payload[0] >= 24 || payload[1] >= 60 || payload[2] >= 60) {
+    return FRAME_STATUS_BAD_VALUE;
+  }
+  self->pClock->setTime(payload[0], payload[1], payload[2]);
+  return FRAME_STATUS_OK;
+}
 
-  String param = command.substring(startIndex + prefix.length());
-  param.trim();
-  return param;
+uint8_t CommandHandler::frameSetDate(void* context, const uint8_t* payload,
+                                     uint16_t length, uint8_t* reply,
+                                     uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  *replyLength = 0;
+  if (!self->pClock) {
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+  uint16_t year = payload[0] | (payload[1] << 8);
+  uint8_t month = payload[2];
+  uint8_t day = payload[3];
+  if (year < 2000 || year > 2099 || month < 1 || month > 12 || day < 1 ||
+      day > 31) {
+    return FRAME_STATUS_BAD_VALUE;
+  }
+  self->pClock->setDate(year, month, day);
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameBenchmark(void* context, const uint8_t* payload,
+                                       uint16_t length, uint8_t* reply,
+                                       uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  *replyLength = 0;
+  if (!self->pBenchmark) {
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+  BufferMode mode = length > 0 ? (BufferMode)payload[0] : BUFFER_MODE_SINGLE;
+  if (mode > BUFFER_MODE_STRIP) {
+    return FRAME_STATUS_BAD_VALUE;
+  }
+  // 结果输出到串口；内存不足以建立该缓冲模式时返回 UNAVAILABLE
+  return self->pBenchmark->runAll(mode) ? FRAME_STATUS_OK
+                                        : FRAME_STATUS_UNAVAILABLE;
 }
 
-void CommandHandler::executeSetText(const String& text) {
-  if (text.length() == 0) {
+uint8_t CommandHandler::frameTasks(void* context, const uint8_t* payload,
+                                   uint16_t length, uint8_t* reply,
+                                   uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  *replyLength = 0;
+  if (!self->pScheduler) {
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+
+  // 回复：任务数、超时总数（4 字节小端）；完整表格输出到串口
+  self->pScheduler->printStats();
+  self->pBLE->printCommandStats();
+  uint32_t overruns = 0;
+  for (uint8_t i = 0; i < self->pScheduler->getTaskCount(); i++) {
+    overruns += self->pScheduler->getStats(i).overruns;
+  }
+  reply[0] = self->pScheduler->getTaskCount();
+  memcpy(reply + 1, &overruns, sizeof(overruns));
+  *replyLength = 1 + sizeof(overruns);
+  self->pScheduler->resetStats();
+  return FRAME_STATUS_OK;
+}
+
+uint8_t CommandHandler::frameImageBegin(void* context, const uint8_t* payload,
+                                        uint16_t length, uint8_t* reply,
+                                        uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  *replyLength = 0;
+  if (!self->pImage) {
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+  // 每个数据帧的大小取决于本次连接协商的 MTU
+  self->pImage->setMTU(self->pBLE->getMTU());
+  return self->pImage->begin(payload, length, reply, replyLength);
+}
+
+uint8_t CommandHandler::frameImageData(void* context, const uint8_t* payload,
+                                       uint16_t length, uint8_t* reply,
+                                       uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  *replyLength = 0;
+  if (!self->pImage) {
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+  return self->pImage->receive(payload, length, reply, replyLength);
+}
+
+uint8_t CommandHandler::frameImageEnd(void* context, const uint8_t* payload,
+                                      uint16_t length, uint8_t* reply,
+                                      uint16_t* replyLength) {
+  CommandHandler* self = (CommandHandler*)context;
+  *replyLength = 0;
+  if (!self->pImage) {
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+  return self->pImage->end(payload, length, reply, replyLength);
+}
+
+// ========== 文本指令执行 ==========
+
+void CommandHandler::executeSetText(const char* text, uint16_t length) {
+  if (length == 0) {
     pBLE->sendData("ERROR:Empty text");
     return;
   }
 
   pDisplay->clear();
-  pDisplay->drawCenteredText(text.c_str(), 120, ST77XX_WHITE, 2);
+  pDisplay->drawCenteredText(text, 120, ST77XX_WHITE, 2);
 
   pBLE->sendData("OK:Text displayed");
-  Serial.println("显示文本: " + text);
+  Serial.printf("显示文本: %s\n", text);
 }
 
-void CommandHandler::executeSetBrightness(const String& value) {
-  int brightness = value.toInt();
+void CommandHandler::executeSetBrightness(const char* value, uint16_t length) {
+  long brightness = TextCommandParser::toNumber(value, length);
 
   if (brightness < 0 || brightness > 255) {
     pBLE->sendData("ERROR:Brightness must be 0-255");
@@ -219,8 +365,9 @@ void CommandHandler::executeSetBrightness(const String& value) {
   }
 
   pDisplay->setBrightness(brightness);
-  pBLE->sendData("OK:Brightness set to " + String(brightness));
-  Serial.println("亮度设置为: " + String(brightness));
+  reply.format("OK:Brightness set to %ld", brightness);
+  sendReply();
+  Serial.printf("亮度设置为: %ld\n", brightness);
 }
 
 void CommandHandler::executeClearScreen() {
@@ -229,30 +376,30 @@ void CommandHandler::executeClearScreen() {
   Serial.println("清屏");
 }
 
-void CommandHandler::executeSetMode(const String& mode) {
-  String modeStr = mode;
-  modeStr.toUpperCase();
-
-  if (modeStr == "MANUAL") {
+void CommandHandler::executeSetMode(const char* mode) {
+  if (TextCommandParser::equalsIgnoreCase(mode, "MANUAL")) {
     setMode(MODE_MANUAL);
-  } else if (modeStr == "DEMO") {
+  } else if (TextCommandParser::equalsIgnoreCase(mode, "DEMO")) {
     setMode(MODE_DEMO);
-  } else if (modeStr == "CLOCK") {
+  } else if (TextCommandParser::equalsIgnoreCase(mode, "DEMO2")) {
+    setMode(MODE_SNAKE_DEMO);
+  } else if (TextCommandParser::equalsIgnoreCase(mode, "CLOCK")) {
     setMode(MODE_CLOCK);
-  } else if (modeStr == "CUSTOM") {
+  } else if (TextCommandParser::equalsIgnoreCase(mode, "CUSTOM")) {
     setMode(MODE_CUSTOM);
   } else {
     pBLE->sendData("ERROR:Unknown mode");
     return;
   }
 
-  pBLE->sendData("OK:Mode set to " + mode);
+  reply.format("OK:Mode set to %s", mode);
+  sendReply();
 }
 
 void CommandHandler::executeGetStatus() {
-  String status = buildStatusJson();
-  pBLE->sendData(status);
-  Serial.println("状态已发送: " + status);
+  formatStatusJson(reply);
+  sendReply();
+  Serial.printf("状态已发送: %s\n", reply.c_str());
 }
 
 void CommandHandler::executeSleep() {
@@ -269,6 +416,7 @@ void CommandHandler::executeWakeup() {
 
 void CommandHandler::executeRestart() {
   pBLE->sendData("OK:Restarting...");
+  pBLE->flush();
   delay(1000);
   Serial.println("重启中...");
   ESP.restart();
@@ -276,7 +424,7 @@ void CommandHandler::executeRestart() {
 
 void CommandHandler::setMode(DisplayMode mode) {
   currentMode = mode;
-  Serial.println("模式切换到: " + String(mode));
+  Serial.printf("模式切换到: %d\n", (int)mode);
 }
 
 DisplayMode CommandHandler::getMode() {
@@ -287,53 +435,48 @@ void CommandHandler::sendStatus() {
   executeGetStatus();
 }
 
-void CommandHandler::executeSetTime(const String& time) {
+void CommandHandler::executeSetTime(const char* time, uint16_t length) {
   if (!pClock) {
     pBLE->sendData("ERROR:Clock not initialized");
     Serial.println("错误: 时钟未初始化");
     return;
   }
 
-  if (time.length() == 0) {
+  if (length == 0) {
     pBLE->sendData("ERROR:Empty time");
     return;
   }
 
-  uint8_t hour, minute, second;
+  long hour, minute, second;
+  const char* firstColon = (const char*)memchr(time, ':', length);
 
   // 检查是否是6位数字格式 (hhmmss)
-  if (time.length() == 6 && time.indexOf(':') == -1) {
-    // 6位数字格式：hhmmss
-    String hourStr = time.substring(0, 2);
-    String minuteStr = time.substring(2, 4);
-    String secondStr = time.substring(4, 6);
-
-    hour = hourStr.toInt();
-    minute = minuteStr.toInt();
-    second = secondStr.toInt();
+  if (length == 6 && firstColon == nullptr) {
+    hour = TextCommandParser::toNumber(time, 2);
+    minute = TextCommandParser::toNumber(time + 2, 2);
+    second = TextCommandParser::toNumber(time + 4, 2);
   }
   // 传统格式 HH:MM:SS
   else {
-    int firstColon = time.indexOf(':');
-    int secondColon = time.indexOf(':', firstColon + 1);
+    const char* end = time + length;
+    const char* secondColon = firstColon == nullptr ? nullptr
+        : (const char*)memchr(firstColon + 1, ':', end - firstColon - 1);
 
-    if (firstColon == -1 || secondColon == -1) {
+    if (firstColon == nullptr || secondColon == nullptr) {
       pBLE->sendData("ERROR:Invalid time format. Use HHMMSS or HH:MM:SS");
       Serial.println("错误: 时间格式错误，应使用 HHMMSS 或 HH:MM:SS");
       return;
     }
 
-    String hourStr = time.substring(0, firstColon);
-    String minuteStr = time.substring(firstColon + 1, secondColon);
-    String secondStr = time.substring(secondColon + 1);
-
-    hour = hourStr.toInt();
-    minute = minuteStr.toInt();
-    second = secondStr.toInt();
+    hour = TextCommandParser::toNumber(time, firstColon - time);
+    minute = TextCommandParser::toNumber(firstColon + 1,
+                                         secondColon - firstColon - 1);
+    second = TextCommandParser::toNumber(secondColon + 1, end - secondColon - 1);
   }
 
   // 验证时间有效性
-  if (hour >= 24 || minute >= 60 || second >= 60) {
+  if (hour < 0 || hour >= 24 || minute < 0 || minute >= 60 || second < 0 ||
+      second >= 60) {
     pBLE->sendData("ERROR:Invalid time values");
     Serial.println("错误: 时间值无效");
     return;
@@ -343,63 +486,56 @@ void CommandHandler::executeSetTime(const String& time) {
   pClock->setTime(hour, minute, second);
 
   // 格式化显示时间（统一为 HH:MM:SS 格式）
-  char timeStr[9];
-  snprintf(timeStr, sizeof(timeStr), "%02d:%02d:%02d", hour, minute, second);
+  reply.format("OK:Time set to %02ld:%02ld:%02ld", hour, minute, second);
+  sendReply();
+  Serial.printf("时间已设置为: %02ld:%02ld:%02ld\n", hour, minute, second);
+}
 
-  pBLE->sendData("OK:Time set to " + String(timeStr));
-  Serial.println("时间已设置为: " + String(timeStr));
+// 在 [start, end) 中查找日期分隔符：优先 '-'，没有时找 '/'
+static const char* findDateSeparator(const char* start, const char* end) {
+  const char* sep = (const char*)memchr(start, '-', end - start);
+  if (sep == nullptr) {
+    sep = (const char*)memchr(start, '/', end - start);
+  }
+  return sep;
 }
 
-void CommandHandler::executeSetDate(const String& date) {
+void CommandHandler::executeSetDate(const char* date, uint16_t length) {
   if (!pClock) {
     pBLE->sendData("ERROR:Clock not initialized");
     Serial.println("错误: 时钟未初始化");
     return;
   }
 
-  if (date.length() == 0) {
+  if (length == 0) {
     pBLE->sendData("ERROR:Empty date");
     return;
   }
 
-  uint16_t year;
-  uint8_t month, day;
+  long year, month, day;
+  const char* end = date + length;
+  const char* firstSep = findDateSeparator(date, end);
 
   // 检查是否是8位数字格式 (YYYYMMDD)
-  if (date.length() == 8 && date.indexOf('-') == -1 && date.indexOf('/') == -1) {
-    // 8位数字格式：YYYYMMDD
-    String yearStr = date.substring(0, 4);
-    String monthStr = date.substring(4, 6);
-    String dayStr = date.substring(6, 8);
-
-    year = yearStr.toInt();
-    month = monthStr.toInt();
-    day = dayStr.toInt();
+  if (length == 8 && firstSep == nullptr) {
+    year = TextCommandParser::toNumber(date, 4);
+    month = TextCommandParser::toNumber(date + 4, 2);
+    day = TextCommandParser::toNumber(date + 6, 2);
   }
   // 传统格式 YYYY-MM-DD 或 YYYY/MM/DD
   else {
-    int firstSep = date.indexOf('-');
-    if (firstSep == -1) {
-      firstSep = date.indexOf('/');
-    }
-    int secondSep = date.indexOf('-', firstSep + 1);
-    if (secondSep == -1) {
-      secondSep = date.indexOf('/', firstSep + 1);
-    }
+    const char* secondSep =
+        firstSep == nullptr ? nullptr : findDateSeparator(firstSep + 1, end);
 
-    if (firstSep == -1 || secondSep == -1) {
+    if (firstSep == nullptr || secondSep == nullptr) {
       pBLE->sendData("ERROR:Invalid date format. Use YYYYMMDD or YYYY-MM-DD");
       Serial.println("错误: 日期格式错误，应使用 YYYYMMDD 或 YYYY-MM-DD");
       return;
     }
 
-    String yearStr = date.substring(0, firstSep);
-    String monthStr = date.substring(firstSep + 1, secondSep);
-    String dayStr = date.substring(secondSep + 1);
-
-    year = yearStr.toInt();
-    month = monthStr.toInt();
-    day = dayStr.toInt();
+    year = TextCommandParser::toNumber(date, firstSep - date);
+    month = TextCommandParser::toNumber(firstSep + 1, secondSep - firstSep - 1);
+    day = TextCommandParser::toNumber(secondSep + 1, end - secondSep - 1);
   }
 
   // 验证日期有效性
@@ -423,55 +559,53 @@ void CommandHandler::executeSetDate(const String& date) {
   pClock->setDate(year, month, day);
 
   // 格式化显示日期（统一为 YYYY-MM-DD 格式）
-  char dateStr[11];
-  snprintf(dateStr, sizeof(dateStr), "%04d-%02d-%02d", year, month, day);
-
-  pBLE->sendData("OK:Date set to " + String(dateStr));
-  Serial.println("日期已设置为: " + String(dateStr));
+  reply.format("OK:Date set to %04ld-%02ld-%02ld", year, month, day);
+  sendReply();
+  Serial.printf("日期已设置为: %04ld-%02ld-%02ld\n", year, month, day);
 }
 
-String CommandHandler::buildStatusJson() {
+void CommandHandler::formatStatusJson(ReplyBuffer& out) {
   // 构建简单的状态字符串（JSON格式）
-  String json = "{";
-  json += "\"mode\":\"";
-
+  const char* mode = "CUSTOM";
   switch (currentMode) {
-    case MODE_MANUAL: json += "MANUAL"; break;
-    case MODE_DEMO:   json += "DEMO"; break;
-    case MODE_CLOCK:  json += "CLOCK"; break;
-    case MODE_CUSTOM: json += "CUSTOM"; break;
+    case MODE_MANUAL:     mode = "MANUAL"; break;
+    case MODE_DEMO:       mode = "DEMO"; break;
+    case MODE_CLOCK:      mode = "CLOCK"; break;
+    case MODE_CUSTOM:     mode = "CUSTOM"; break;
+    case MODE_SNAKE_DEMO: mode = "DEMO2"; break;
   }
 
-  json += "\",";
-  json += "\"uptime\":" + String(millis() / 1000);
-  json += ",\"heap\":" + String(ESP.getFreeHeap());
+  out.format("{\"mode\":\"%s\",\"uptime\":%lu,\"heap\":%lu", mode,
+             (unsigned long)(millis() / 1000),
+             (unsigned long)ESP.getFreeHeap());
 
   // 添加时钟时间（如果有）
   if (pClock && pClock->isTimeSet()) {
-    json += ",\"time\":\"" + pClock->getTimeString() + "\"";
-    json += ",\"date\":\"" + pClock->getDateString() + "\"";
+    char time[9];
+    char date[11];
+    pClock->formatTime(time, sizeof(time));
+    pClock->formatDate(date, sizeof(date));
+    out.appendf(",\"time\":\"%s\",\"date\":\"%s\"", time, date);
   }
 
-  json += "}";
-
-  return json;
+  out.append("}");
 }
 
-void CommandHandler::executeOTAUpdate(const String& url) {
+void CommandHandler::executeOTAUpdate(const char* url, uint16_t length) {
   if (!pOTA) {
     pBLE->sendData("ERROR:OTA not initialized");
     Serial.println("错误: OTA管理器未初始化");
     return;
   }
 
-  if (url.length() == 0) {
+  if (length == 0) {
     pBLE->sendData("ERROR:Empty URL");
     Serial.println("错误: URL为空");
     return;
   }
 
   // 检查URL格式
-  if (!url.startsWith("http://") && !url.startsWith("https://")) {
+  if (strncmp(url, "http://", 7) != 0 && strncmp(url, "https://", 8) != 0) {
     pBLE->sendData("ERROR:Invalid URL. Must start with http:// or https://");
     Serial.println("错误: URL格式无效");
     return;
@@ -479,7 +613,8 @@ void CommandHandler::executeOTAUpdate(const String& url) {
 
   // 通知开始更新
   pBLE->sendData("OK:Starting OTA update...");
-  Serial.println("开始OTA更新: " + url);
+  pBLE->flush();  // 下载期间主循环不运行
+  Serial.printf("开始OTA更新: %s\n", url);
 
   // 显示更新提示
   pDisplay->clear();
@@ -487,21 +622,69 @@ void CommandHandler::executeOTAUpdate(const String& url) {
   pDisplay->drawCenteredText("Please wait", 100, ST77XX_WHITE, 1);
 
   // 执行更新
-  bool success = pOTA->updateFromURL(url.c_str());
+  bool success = pOTA->updateFromURL(url);
 
   if (success) {
     pDisplay->clear();
     pDisplay->drawCenteredText("Update Success!", 80, ST77XX_GREEN, 2);
     pDisplay->drawCenteredText("Restarting...", 120, ST77XX_WHITE, 1);
     pBLE->sendData("OK:Update successful, restarting...");
+    pBLE->flush();
     Serial.println("OTA更新成功，重启中...");
     delay(2000);
     ESP.restart();
   } else {
+    String status = pOTA->getStatusString();
     pDisplay->clear();
     pDisplay->drawCenteredText("Update Failed!", 80, ST77XX_RED, 2);
-    pDisplay->drawCenteredText(pOTA->getStatusString().c_str(), 120, ST77XX_WHITE, 1);
-    pBLE->sendData("ERROR:Update failed - " + pOTA->getStatusString());
-    Serial.println("OTA更新失败: " + pOTA->getStatusString());
+    pDisplay->drawCenteredText(status.c_str(), 120, ST77XX_WHITE, 1);
+    reply.format("ERROR:Update failed - %s", status.c_str());
+    sendReply();
+    Serial.printf("OTA更新失败: %s\n", status.c_str());
+  }
+}
+
+void CommandHandler::executeBenchmark(const char* param, uint16_t length) {
+  if (!pBenchmark) {
+    pBLE->sendData("ERROR:Benchmark not initialized");
+    return;
+  }
+
+  // BENCH:0~5 选择缓冲模式（直接/单缓冲/双缓冲/8 位索引/4 位索引/条带），默认单缓冲
+  BufferMode mode = BUFFER_MODE_SINGLE;
+  if (length > 0) {
+    long value = TextCommandParser::toNumber(param, length);
+    if (value < BUFFER_MODE_DIRECT || value > BUFFER_MODE_STRIP) {
+      pBLE->sendData("ERROR:Buffer mode must be 0-5");
+      return;
+    }
+    mode = (BufferMode)value;
+  }
+
+  pBLE->sendData("OK:Benchmark started, see serial output");
+  if (pBenchmark->runAll(mode)) {
+    pBLE->sendData("OK:Benchmark done");
+  } else {
+    pBLE->sendData("ERROR:Not enough memory for buffer mode");
+  }
+}
+
+void CommandHandler::executeTasks() {
+  if (!pScheduler) {
+    pBLE->sendData("ERROR:Scheduler not initialized");
+    return;
+  }
+
+  // 完整表格输出到串口，BLE 只回复超时汇总
+  pScheduler->printStats();
+  pBLE->printCommandStats();
+  uint32_t overruns = 0;
+  for (uint8_t i = 0; i < pScheduler->getTaskCount(); i++) {
+    overruns += pScheduler->getStats(i).overruns;
   }
+  reply.format("OK:Tasks %u, overruns %lu",
+               (unsigned int)pScheduler->getTaskCount(),
+               (unsigned long)overruns);
+  sendReply();
+  pScheduler->resetStats();
 }
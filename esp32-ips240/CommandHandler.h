@@ -4,33 +4,23 @@
 #include <Arduino.h>
 #include "Display.h"
 #include "BLEManager.h"
+#include "BinaryProtocol.h"
+#include "TextCommandParser.h"
 
 // 前向声明
 class ClockDisplay;
 class OTAManager;
-
-// 支持的指令枚举
-enum CommandType {
-  CMD_UNKNOWN,
-  CMD_SET_TEXT,         // 设置文本显示
-  CMD_SET_BRIGHTNESS,   // 设置亮度
-  CMD_CLEAR_SCREEN,     // 清屏
-  CMD_SET_MODE,         // 设置显示模式
-  CMD_GET_STATUS,       // 获取状态
-  CMD_SLEEP,            // 进入睡眠
-  CMD_WAKEUP,           // 唤醒
-  CMD_RESTART,          // 重启
-  CMD_SET_TIME,         // 设置时间
-  CMD_SET_DATE,         // 设置日期
-  CMD_OTA_UPDATE        // OTA更新
-};
+class DisplayBenchmark;
+class TaskScheduler;
+class ImageReceiver;
 
 // 显示模式枚举
 enum DisplayMode {
   MODE_MANUAL,      // 手动模式（接收指令控制）
   MODE_DEMO,        // 演示模式（自动循环）
   MODE_CLOCK,       // 时钟模式
-  MODE_CUSTOM       // 自定义模式
+  MODE_CUSTOM,      // 自定义模式
+  MODE_SNAKE_DEMO   // 贪吃蛇演示（文本指令 DEMO2）
 };
 
 class CommandHandler {
@@ -40,8 +30,11 @@ public:
   // 初始化
   void begin();
 
-  // 指令处理
-  void handleCommand(String command);
+  // 指令处理：command 为可写缓冲（至少 length + 1 字节），就地解析
+  void handleCommand(char* command, size_t length);
+  void execute(const ParsedCommand& command);
+  // 二进制帧：按分发表执行并回复 操作码|0x80、状态字节、数据
+  void handleFrame(uint8_t opcode, const uint8_t* payload, uint16_t length);
 
   // 模式管理
   void setMode(DisplayMode mode);
@@ -53,6 +46,15 @@ public:
   // OTA管理
   void setOTAManager(OTAManager* ota);
 
+  // 基准测试
+  void setBenchmark(DisplayBenchmark* bench);
+
+  // 任务调度统计
+  void setScheduler(TaskScheduler* scheduler);
+
+  // 图片上传（IMAGE_BEGIN / IMAGE_DATA / IMAGE_END 帧）
+  void setImageReceiver(ImageReceiver* receiver);
+
   // 发送状态到手机
   void sendStatus();
 
@@ -61,27 +63,66 @@ private:
   BLEManager* pBLE;
   ClockDisplay* pClock;
   OTAManager* pOTA;
+  DisplayBenchmark* pBenchmark;
+  TaskScheduler* pScheduler;
+  ImageReceiver* pImage;
   DisplayMode currentMode;
+  ReplyBuffer reply;  // 文本回复在这里格式化后发送
 
-  // 指令解析
-  CommandType parseCommandType(const String& command);
-  String extractParameter(const String& command, const String& prefix);
-
-  // 指令执行
-  void executeSetText(const String& text);
-  void executeSetBrightness(const String& value);
+  // 指令执行（参数以 '\0' 结尾）
+  void executeSetText(const char* text, uint16_t length);
+  void executeSetBrightness(const char* value, uint16_t length);
   void executeClearScreen();
-  void executeSetMode(const String& mode);
+  void executeSetMode(const char* mode);
   void executeGetStatus();
   void executeSleep();
   void executeWakeup();
   void executeRestart();
-  void executeSetTime(const String& time);
-  void executeSetDate(const String& date);
-  void executeOTAUpdate(const String& url);
+  void executeSetTime(const char* time, uint16_t length);
+  void executeSetDate(const char* date, uint16_t length);
+  void executeOTAUpdate(const char* url, uint16_t length);
+  void executeBenchmark(const char* param, uint16_t length);
+  void executeTasks();
+  void sendReply();
+
+  // 二进制指令分发表与处理函数（context 为 CommandHandler*）
+  static const FrameCommand frameCommands[];
+  static const uint8_t FRAME_COMMAND_COUNT;
+  static const uint16_t FRAME_REPLY_SIZE = 160;
+
+  static uint8_t framePing(void* context, const uint8_t* payload, uint16_t length,
+                           uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameText(void* context, const uint8_t* payload, uint16_t length,
+                           uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameBrightness(void* context, const uint8_t* payload, uint16_t length,
+                                 uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameClear(void* context, const uint8_t* payload, uint16_t length,
+                            uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameMode(void* context, const uint8_t* payload, uint16_t length,
+                           uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameStatus(void* context, const uint8_t* payload, uint16_t length,
+                             uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameSleep(void* context, const uint8_t* payload, uint16_t length,
+                            uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameWakeup(void* context, const uint8_t* payload, uint16_t length,
+                             uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameSetTime(void* context, const uint8_t* payload, uint16_t length,
+                              uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameSetDate(void* context, const uint8_t* payload, uint16_t length,
+                              uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameBenchmark(void* context, const uint8_t* payload, uint16_t length,
+                                uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameTasks(void* context, const uint8_t* payload, uint16_t length,
+                            uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameImageBegin(void* context, const uint8_t* payload, uint16_t length,
+                                 uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameImageData(void* context, const uint8_t* payload, uint16_t length,
+                                uint8_t* reply, uint16_t* replyLength);
+  static uint8_t frameImageEnd(void* context, const uint8_t* payload, uint16_t length,
+                               uint8_t* reply, uint16_t* replyLength);
 
   // 辅助方法
-  String buildStatusJson();
+  void formatStatusJson(ReplyBuffer& out);
 };
 
 #endif // COMMAND_HANDLER_H
@@ -0,0 +1,220 @@
+#include "CommandQueue.h"
+#include "BufferAllocator.h"
+
+CommandQueue::CommandQueue()
+  : ring(nullptr), discardingFrame(false), resyncPending(false), head(0),
+    tail(0), busy(false), receivedCount(0), rejectedCount(0),
+    busySignalCount(0), peakDepth(0), executeStart(0),
+    lastReceivedAt(0), lastKind(COMMAND_KIND_TEXT), pendingHead(0),
+    pendingCount(0) {
+  resetStats();
+}
+
+CommandQueue::~CommandQueue() {
+  BufferAllocator::release(ring);
+}
+
+bool CommandQueue::begin() {
+  if (ring != nullptr) return true;
+
+  // BLE 任务与主循环都频繁访问，放在内部 SRAM
+  MemoryRegion region;
+  ring = (Entry*)BufferAllocator::allocate(QUEUE_SIZE * sizeof(Entry),
+                                           BUFFER_PLACE_INTERNAL, &region);
+  if (ring == nullptr) {
+    Serial.println("Failed to allocate BLE command queue");
+    return false;
+  }
+  head.store(0);
+  tail.store(0);
+  busy.store(false);
+  return true;
+}
+
+void CommandQueue::resetStats() {
+  receivedCount.store(0);
+  rejectedCount.store(0);
+  busySignalCount.store(0);
+  peakDepth.store(0);
+  memset(latency, 0, sizeof(latency));
+}
+
+CommandQueueStats CommandQueue::getStats() const {
+  CommandQueueStats stats;
+  stats.received = receivedCount.load();
+  stats.rejected = rejectedCount.load();
+  stats.busySignals = busySignalCount.load();
+  stats.peakDepth = peakDepth.load();
+  memcpy(stats.latency, latency, sizeof(latency));
+  return stats;
+}
+
+// ========== 生产端（BLE 回调任务） ==========
+
+CommandPushResult CommandQueue::push(const uint8_t* data, size_t length,
+                                     uint8_t* kind, uint8_t* frameOpcode) {
+  // 按生产端的帧边界分类：帧的后续写入首字节可以是任意值
+  bool continuation = writeFrames.isReceiving();
+  bool frame = continuation || (length > 0 && data[0] == FRAME_MAGIC);
+  *kind = frame ? COMMAND_KIND_FRAME : COMMAND_KIND_TEXT;
+  *frameOpcode = continuation ? writeFrames.receivingOpcode()
+                              : (frame && length >= 2 ? data[1] : 0);
+  if (frame) {
+    writeFrames.feed(data, length);
+  }
+
+  if (continuation && discardingFrame) {
+    discardingFrame = writeFrames.isReceiving();
+    rejectedCount.fetch_add(1, std::memory_order_relaxed);
+    return COMMAND_DISCARDED;
+  }
+
+  CommandPushResult result = enqueue(data, length, *kind, resyncPending);
+  if (result != COMMAND_REJECTED) {
+    resyncPending = false;
+  } else if (frame) {
+    // 消费端已收到本帧的前半部分：下一条入队的写入先让它丢弃残帧
+    if (continuation) resyncPending = true;
+    // 本帧还有后续写入：一并丢弃，不送给消费端
+    discardingFrame = writeFrames.isReceiving();
+  }
+  return result;
+}
+
+CommandPushResult CommandQueue::pushValue(uint8_t kind, const uint8_t* data,
+                                          size_t length) {
+  return enqueue(data, length, kind, false);
+}
+
+void CommandQueue::resetFrames() {
+  // 上一个连接断在帧中间时，新连接的写入不能再当作该帧的后续
+  writeFrames.reset();
+  discardingFrame = false;
+  resyncPending = true;
+}
+
+CommandPushResult CommandQueue::enqueue(const uint8_t* data, size_t length,
+                                        uint8_t kind, bool resync) {
+  uint32_t slotIndex = head.load(std::memory_order_relaxed);
+  uint32_t used = slotIndex - tail.load(std::memory_order_acquire);
+  if (ring == nullptr || length == 0 || length > MAX_WRITE ||
+      used >= QUEUE_SIZE) {
+    rejectedCount.fetch_add(1, std::memory_order_relaxed);
+    return COMMAND_REJECTED;
+  }
+
+  Entry& entry = ring[slotIndex % QUEUE_SIZE];
+  entry.receivedAt = micros();
+  entry.length = length;
+  entry.kind = kind;
+  entry.resync = resync;
+  memcpy(entry.data, data, length);
+  head.store(slotIndex + 1, std::memory_order_release);
+
+  receivedCount.fetch_add(1, std::memory_order_relaxed);
+  uint8_t depth = used + 1;
+  if (depth > peakDepth.load(std::memory_order_relaxed)) {
+    peakDepth.store(depth, std::memory_order_relaxed);
+  }
+  if (depth >= HIGH_WATER && !busy.exchange(true)) {
+    busySignalCount.fetch_add(1, std::memory_order_relaxed);
+    return COMMAND_QUEUED_BUSY;
+  }
+  return COMMAND_QUEUED;
+}
+
+// ========== 消费端（主循环） ==========
+
+const CommandQueue::Entry* CommandQueue::front() {
+  uint32_t slotIndex = tail.load(std::memory_order_relaxed);
+  if (slotIndex == head.load(std::memory_order_acquire)) return nullptr;
+
+  const Entry& entry = ring[slotIndex % QUEUE_SIZE];
+#if !defined(ARDUINO_ARCH_ESP32)
+  // 主机：不能在写入时刻之前执行（两个线程的模拟时间各自独立）
+  hostWaitUntilMicros(entry.receivedAt);
+#endif
+  executeStart = micros();
+  lastReceivedAt = entry.receivedAt;
+  lastKind = entry.kind;
+  return &entry;
+}
+
+void CommandQueue::pop() {
+  unsigned long done = micros();
+  tail.store(tail.load(std::memory_order_relaxed) + 1,
+             std::memory_order_release);
+
+  CommandLatencyStats& kindLatency = latency[lastKind];
+  uint32_t wait = executeStart - lastReceivedAt;
+  uint32_t execute = done - executeStart;
+  kindLatency.executed++;
+  kindLatency.totalWaitMicros += wait;
+  kindLatency.maxWaitMicros = max(kindLatency.maxWaitMicros, wait);
+  kindLatency.totalExecuteMicros += execute;
+  kindLatency.maxExecuteMicros = max(kindLatency.maxExecuteMicros, execute);
+}
+
+void CommandQueue::expectReply(uint32_t messageIndex) {
+  if (pendingCount == QUEUE_SIZE) {
+    // 跟踪表满：放弃最早的一条
+    pendingHead = (pendingHead + 1) % QUEUE_SIZE;
+    pendingCount--;
+  }
+  PendingReply& reply = pending[(pendingHead + pendingCount) % QUEUE_SIZE];
+  reply.messageIndex = messageIndex;
+  reply.receivedAt = lastReceivedAt;
+  reply.kind = lastKind;
+  pendingCount++;
+}
+
+void CommandQueue::onRepliesSent(uint32_t retiredMessages) {
+  unsigned long now = micros();
+  while (pendingCount > 0) {
+    const PendingReply& reply = pending[pendingHead];
+    if ((int32_t)(retiredMessages - reply.messageIndex) < 0) break;
+
+    CommandLatencyStats& kindLatency = latency[reply.kind];
+    uint32_t elapsed = now - reply.receivedAt;
+    kindLatency.replies++;
+    kindLatency.totalReplyMicros += elapsed;
+    kindLatency.maxReplyMicros = max(kindLatency.maxReplyMicros, elapsed);
+    pendingHead = (pendingHead + 1) % QUEUE_SIZE;
+    pendingCount--;
+  }
+}
+
+void CommandQueue::dropPendingReplies() {
+  pendingHead = 0;
+  pendingCount = 0;
+}
+
+bool CommandQueue::checkResume() {
+  if (!busy.load() || depth() > LOW_WATER) return false;
+  busy.store(false);
+  return true;
+}
+
+void CommandQueue::printStats() {
+  static const char* const kindNames[COMMAND_KIND_COUNT] = {
+    "text", "frame", "ssid", "passwd"
+  };
+  CommandQueueStats stats = getStats();
+  Serial.println("=== BLE Command Queue ===");
+  Serial.printf("received %lu  rejected %lu  busy %lu  peak depth %u/%u\n",
+                (unsigned long)stats.received, (unsigned long)stats.rejected,
+                (unsigned long)stats.busySignals, (unsigned)stats.peakDepth,
+                (unsigned)QUEUE_SIZE);
+  Serial.println("kind    count  wait avg/max us  exec avg/max us  reply avg/max us");
+  for (uint8_t kind = 0; kind < COMMAND_KIND_COUNT; kind++) {
+    const CommandLatencyStats& kindLatency = stats.latency[kind];
+    Serial.printf("%-6s %6lu %7lu/%-7lu %7lu/%-7lu %7lu/%-7lu\n",
+                  kindNames[kind], (unsigned long)kindLatency.executed,
+                  (unsigned long)kindLatency.averageWaitMicros(),
+                  (unsigned long)kindLatency.maxWaitMicros,
+                  (unsigned long)kindLatency.averageExecuteMicros(),
+                  (unsigned long)kindLatency.maxExecuteMicros,
+                  (unsigned long)kindLatency.averageReplyMicros(),
+                  (unsigned long)kindLatency.maxReplyMicros);
+  }
+}
@@ -0,0 +1,159 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "BinaryProtocol.h"
+
+// 写入的类别：指令特征值上的二进制帧（包括帧的后续写入）或文本指令由生产端
+// 在入队时判断；WiFi SSID / 密码特征值的写入也经队列交给主循环
+enum CommandKind {
+  COMMAND_KIND_TEXT,
+  COMMAND_KIND_FRAME,
+  COMMAND_KIND_WIFI_SSID,
+  COMMAND_KIND_WIFI_PASSWORD,
+  COMMAND_KIND_COUNT
+};
+
+enum CommandPushResult {
+  COMMAND_QUEUED,
+  COMMAND_QUEUED_BUSY,  // 已入队，深度刚达到高水位：通知手机暂停发送
+  COMMAND_REJECTED,     // 队列满（或写入超长），写入被丢弃
+  COMMAND_DISCARDED     // 被拒绝的帧的后续写入，不入队也不回复
+};
+
+// 单类指令的延迟统计（微秒）
+struct CommandLatencyStats {
+  uint32_t executed;
+  uint64_t totalWaitMicros;     // 收到 → 开始执行（排队）
+  uint32_t maxWaitMicros;
+  uint64_t totalExecuteMicros;  // 执行耗时
+  uint32_t maxExecuteMicros;
+  uint32_t replies;
+  uint64_t totalReplyMicros;    // 收到 → 回复通知发出
+  uint32_t maxReplyMicros;
+
+  uint32_t averageWaitMicros() const {
+    return executed > 0 ? totalWaitMicros / executed : 0;
+  }
+  uint32_t averageExecuteMicros() const {
+    return executed > 0 ? totalExecuteMicros / executed : 0;
+  }
+  uint32_t averageReplyMicros() const {
+    return replies > 0 ? totalReplyMicros / replies : 0;
+  }
+};
+
+// getStats() 返回的快照
+struct CommandQueueStats {
+  uint32_t received;     // 入队的写入
+  uint32_t rejected;
+  uint32_t busySignals;  // 达到高水位的次数
+  uint8_t peakDepth;
+  CommandLatencyStats latency[COMMAND_KIND_COUNT];
+};
+
+/**
+ * BLE 指令队列
+ *
+ * BLE 回调任务只把收到的写入（原始字节）复制进单生产者 / 单消费者的无锁环，
+ * 解析与执行由主循环的 front() / pop() 完成，绘图、WiFi 连接、OTA 等耗时操作
+ * 不再阻塞协议栈。深度达到 HIGH_WATER 时 push 返回 COMMAND_QUEUED_BUSY，
+ * 降到 LOW_WATER 时 checkResume() 返回 true，调用者据此通知手机暂停 / 恢复；
+ * 环满时新写入被拒绝。
+ * 每条指令记录排队、执行和回复发出三段延迟（回复按通知队列的消息序号跟踪）
+ *
+ * 一个二进制帧可以跨多次写入。生产端用 FrameTracker 按帧头的长度跟踪帧边界
+ * （每次写入的开销是常数），后续写入即使不以 0xA5 开头也归为帧；帧的某次写入被拒绝后，该帧其余的写入直接丢弃，
+ * 之后第一条入队的写入带 resync 标记，消费端据此丢弃解析器中的残帧
+ */
+class CommandQueue {
+public:
+  static const uint8_t QUEUE_SIZE = 16;    // 2 的幂
+  static const uint16_t MAX_WRITE = 514;   // 一次写入最多 MTU 517 - 3 字节
+  static const uint8_t HIGH_WATER = 12;
+  static const uint8_t LOW_WATER = 4;
+
+  struct Entry {
+    unsigned long receivedAt;
+    uint16_t length;
+    uint8_t kind;
+    bool resync;  // 执行前重置帧解析器（之前丢弃了一个帧的部分写入）
+    uint8_t data[MAX_WRITE];
+  };
+
+  CommandQueue();
+  ~CommandQueue();
+
+  // 分配队列（内部 SRAM）
+  bool begin();
+
+  // 生产端（BLE 回调任务）：指令特征值的一次写入。
+  // kind / frameOpcode 返回写入的类别和所属帧的操作码（帧头未收全时为 0），
+  // 被拒绝时调用者据此回复
+  CommandPushResult push(const uint8_t* data, size_t length, uint8_t* kind,
+                         uint8_t* frameOpcode);
+  // 生产端：其他特征值的写入（WiFi SSID / 密码），不经过帧跟踪
+  CommandPushResult pushValue(uint8_t kind, const uint8_t* data, size_t length);
+  // 生产端：连接建立 / 断开时调用。丢弃未收完的帧，下一条入队的写入带 resync
+  void resetFrames();
+
+  // 消费端（主循环）：取队首写入并开始计时，队列为空时返回 nullptr；执行完调用 pop()
+  const Entry* front();
+  void pop();
+  // 刚执行完的指令产生了回复：它是通知队列入队的第 messageIndex 条消息
+  void expectReply(uint32_t messageIndex);
+  // 通知队列已送出（或清除）retiredMessages 条消息：记录对应指令的回复延迟
+  void onRepliesSent(uint32_t retiredMessages);
+  void dropPendingReplies();
+  // 忙状态下深度降到 LOW_WATER：清除忙状态并返回 true
+  bool checkResume();
+
+  uint8_t depth() const { return head.load() - tail.load(); }
+  bool isBusy() const { return busy.load(); }
+
+  CommandQueueStats getStats() const;
+  // 消费端调用；生产端计数是原子量，与 push 并发时不会读写同一块普通内存
+  void resetStats();
+  void printStats();
+
+private:
+  struct PendingReply {
+    uint32_t messageIndex;
+    unsigned long receivedAt;
+    uint8_t kind;
+  };
+
+  Entry* ring;
+
+  // 生产端：写入的帧边界（只跟踪帧头与剩余长度，解析和 CRC 留给消费端）
+  FrameTracker writeFrames;
+  bool discardingFrame;   // 正在丢弃一个被拒绝的帧的后续写入
+  bool resyncPending;     // 消费端解析器中有残帧，下一条入队的写入带 resync
+  std::atomic<uint32_t> head;   // 生产者下一个写入位置
+  std::atomic<uint32_t> tail;   // 消费者下一个读取位置
+  std::atomic<bool> busy;
+
+  // 生产端统计（消费端读取 / 清零）
+  std::atomic<uint32_t> receivedCount;
+  std::atomic<uint32_t> rejectedCount;
+  std::atomic<uint32_t> busySignalCount;
+  std::atomic<uint8_t> peakDepth;
+
+  // 消费端：正在执行的写入
+  unsigned long executeStart;
+  unsigned long lastReceivedAt;
+  uint8_t lastKind;
+
+  PendingReply pending[QUEUE_SIZE];
+  uint8_t pendingHead;
+  uint8_t pendingCount;
+
+  // 消费端统计
+  CommandLatencyStats latency[COMMAND_KIND_COUNT];
+
+  CommandPushResult enqueue(const uint8_t* data, size_t length, uint8_t kind,
+                            bool resync);
+};
+
+#endif // COMMAND_QUEUE_H
@@ -4,16 +4,34 @@ DisplayManager::DisplayManager() {
   spi = new SPIClass(FSPI);
   tft = new Adafruit_ST7789(spi, TFT_CS, TFT_DC, TFT_RST);
   frameBuffer = new FrameBuffer(SCREEN_WIDTH, SCREEN_HEIGHT);
+  dma = new DisplayDMA();
+  canvas = new FrameBufferCanvas(frameBuffer, SCREEN_WIDTH, SCREEN_HEIGHT);
+  textRenderer = new TextRenderer();
+  textRenderer->setFrameBuffer(frameBuffer);
+  decoder = new AnimationDecoder();
+  decoder->setFrameBuffer(frameBuffer);
+  decoder->setTFT(tft);
+  displayList = new DisplayList();
+  framePacer = new FramePacer();
+  framePacing = false;
+  replaying = false;
   currentAnimation = nullptr;
   currentFrame = 0;
   lastFrameTime = 0;
   animationPlaying = false;
   spiFrequency = SPI_FREQUENCY_DEFAULT;
   autoFlush = true;
+  asyncFlush = false;
 }
 
 DisplayManager::~DisplayManager() {
+  delete framePacer;
+  delete displayList;
+  delete decoder;
+  delete textRenderer;
+  delete canvas;
   delete frameBuffer;
+  delete dma;
   delete tft;
   delete spi;
 }
@@ -36,14 +54,24 @@ void DisplayManager::begin(BufferMode bufferMode, uint32_t spiFreq) {
 
   // 初始化帧缓冲
   if (!frameBuffer->begin(bufferMode)) {
-    Serial.println("Warning: FrameBuffer initialization failed");
+    Serial.println("Warning: FrameBuffer initialization failed, using direct mode");
+    frameBuffer->setMode(BUFFER_MODE_DIRECT);
   }
+  textRenderer->begin();
 
   Serial.printf("Display initialized: %d MHz, Buffer mode: %d\n",
                 spiFrequency / 1000000, bufferMode);
 }
 
 void DisplayManager::clear(uint16_t color) {
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_CLEAR, 0, 0, SCREEN_WIDTH,
+                                     SCREEN_HEIGHT, color);
+    cmd.opaque = true;
+    record(cmd);
+    return;
+  }
+
   if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) {
     tft->fillScreen(color);
   } else {
@@ -54,6 +82,24 @@ void DisplayManager::clear(uint16_t color) {
   }
 }
 
+Adafruit_GFX* DisplayManager::beginDraw() {
+  if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) {
+    return tft;
+  }
+  // 缓冲模式：图元画进帧缓冲，整个图元只标记一次脏区域
+  frameBuffer->beginBatch();
+  return canvas;
+}
+
+void DisplayManager::endDraw() {
+  if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) return;
+
+  frameBuffer->endBatch();
+  if (autoFlush) {
+    frameBuffer->flush(tft);
+  }
+}
+
 void DisplayManager::setBrightness(uint8_t level) {
   analogWrite(TFT_BL, level);
 }
@@ -70,38 +116,72 @@ void DisplayManager::wakeup() {
 
 void DisplayManager::drawText(const char* text, int16_t x, int16_t y,
                                uint16_t color, uint8_t size) {
-  tft->setCursor(x, y);
-  tft->setTextColor(color);
-  tft->setTextSize(size);
-  tft->setTextWrap(true);
-  tft->print(text);
+  if (isRecording()) {
+    if (text == nullptr) return;
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_TEXT, x, y, 0, 0, color);
+    cmd.param = size > 0 ? size : 1;
+    setTextBounds(cmd, text);
+    record(cmd, text);
+    return;
+  }
+
+  Adafruit_GFX* gfx = beginDraw();
+  if (gfx == canvas) {
+    textRenderer->drawString(text, x, y, color, size);
+  } else {
+    gfx->setCursor(x, y);
+    gfx->setTextColor(color);
+    gfx->setTextSize(size);
+    gfx->setTextWrap(true);
+    gfx->print(text);
+  }
+  endDraw();
 }
 
 void DisplayManager::drawCenteredText(const char* text, int16_t y,
                                        uint16_t color, uint8_t size) {
-  tft->setTextSize(size);
-  tft->setTextColor(color);
+  // 等宽字体：宽度由字符数算出，不需要 getTextBounds
+  uint16_t w = textRenderer->measure(text, size);
+  int16_t x = (SCREEN_WIDTH - w) / 2;
 
-  int16_t x1, y1;
-  uint16_t w, h;
-  tft->getTextBounds(text, 0, y, &x1, &y1, &w, &h);
+  if (isRecording()) {
+    drawText(text, x, y, color, size);
+    return;
+  }
 
-  int16_t x = (SCREEN_WIDTH - w) / 2;
-  tft->setCursor(x, y);
-  tft->print(text);
+  Adafruit_GFX* gfx = beginDraw();
+  if (gfx == canvas) {
+    textRenderer->drawString(text, x, y, color, size);
+  } else {
+    gfx->setTextSize(size);
+    gfx->setTextColor(color);
+    gfx->setTextWrap(true);
+    gfx->setCursor(x, y);
+    gfx->print(text);
+  }
+  endDraw();
 }
 
 void DisplayManager::drawTextBox(int16_t x, int16_t y, int16_t w, int16_t h,
                                   const char* text, uint16_t textColor,
                                   uint16_t boxColor) {
+  if (isRecording()) {
+    if (text == nullptr) return;
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_TEXT_BOX, x, y, w, h, textColor);
+    cmd.color2 = boxColor;
+    record(cmd, text);
+    return;
+  }
+
+  Adafruit_GFX* gfx = beginDraw();
   // 绘制边框
-  tft->drawRect(x, y, w, h, boxColor);
-  tft->drawRect(x + 1, y + 1, w - 2, h - 2, boxColor);
+  gfx->drawRect(x, y, w, h, boxColor);
+  gfx->drawRect(x + 1, y + 1, w - 2, h - 2, boxColor);
 
   // 显示文字
-  tft->setCursor(x + 5, y + 8);
-  tft->setTextColor(textColor);
-  tft->setTextSize(1);
+  gfx->setCursor(x + 5, y + 8);
+  gfx->setTextColor(textColor);
+  gfx->setTextSize(1);
 
   // 简单的文字换行
   int16_t cursorX = x + 5;
@@ -117,37 +197,79 @@ void DisplayManager::drawTextBox(int16_t x, int16_t y, int16_t w, int16_t h,
 
     if (cursorY > y + h - 10) break;
 
-    tft->setCursor(cursorX, cursorY);
-    tft->print(c);
+    if (gfx == canvas) {
+      // print('\n') / print('\r') 不画字形
+      if (c != '\n' && c != '\r') {
+        textRenderer->drawChar(cursorX, cursorY, c, textColor, 1);
+      }
+    } else {
+      gfx->setCursor(cursorX, cursorY);
+      gfx->print(c);
+    }
     cursorX += 6;
   }
+  endDraw();
 }
 
 // ========== 图形绘制 ==========
 
 void DisplayManager::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
                                uint16_t color) {
-  tft->drawRect(x, y, w, h, color);
+  if (isRecording()) {
+    record(makeCommand(DISPLAY_OP_RECT, x, y, w, h, color));
+    return;
+  }
+  beginDraw()->drawRect(x, y, w, h, color);
+  endDraw();
 }
 
 void DisplayManager::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
                                uint16_t color) {
-  tft->fillRect(x, y, w, h, color);
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_FILL_RECT, x, y, w, h, color);
+    cmd.opaque = true;
+    record(cmd);
+    return;
+  }
+  beginDraw()->fillRect(x, y, w, h, color);
+  endDraw();
 }
 
 void DisplayManager::drawCircle(int16_t x, int16_t y, int16_t r,
                                  uint16_t color) {
-  tft->drawCircle(x, y, r, color);
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_CIRCLE, x, y, r, 0, color);
+    setRectBounds(cmd, x - r, y - r, 2 * r + 1, 2 * r + 1);
+    record(cmd);
+    return;
+  }
+  beginDraw()->drawCircle(x, y, r, color);
+  endDraw();
 }
 
 void DisplayManager::fillCircle(int16_t x, int16_t y, int16_t r,
                                  uint16_t color) {
-  tft->fillCircle(x, y, r, color);
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_FILL_CIRCLE, x, y, r, 0, color);
+    setRectBounds(cmd, x - r, y - r, 2 * r + 1, 2 * r + 1);
+    record(cmd);
+    return;
+  }
+  beginDraw()->fillCircle(x, y, r, color);
+  endDraw();
 }
 
 void DisplayManager::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
                                uint16_t color) {
-  tft->drawLine(x0, y0, x1, y1, color);
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_LINE, x0, y0, x1, y1, color);
+    setRectBounds(cmd, min(x0, x1), min(y0, y1), abs(x1 - x0) + 1,
+                  abs(y1 - y0) + 1);
+    record(cmd);
+    return;
+  }
+  beginDraw()->drawLine(x0, y0, x1, y1, color);
+  endDraw();
 }
 
 // ========== 图片显示 ==========
@@ -155,6 +277,17 @@ void DisplayManager::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
 void DisplayManager::drawImage(const ImageData& img, int16_t x, int16_t y) {
   if (img.data == nullptr) return;
 
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_IMAGE, x, y, img.width,
+                                     img.height, 0);
+    cmd.data = img.data;
+    cmd.srcWidth = img.width;
+    cmd.srcHeight = img.height;
+    cmd.opaque = true;
+    record(cmd);
+    return;
+  }
+
   if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) {
     tft->startWrite();
     tft->setAddrWindow(x, y, img.width, img.height);
@@ -168,65 +301,224 @@ void DisplayManager::drawImage(const ImageData& img, int16_t x, int16_t y) {
   }
 }
 
-void DisplayManager::drawImageScaled(const ImageData& img, int16_t x, int16_t y,
-                                      uint16_t newWidth, uint16_t newHeight) {
-  if (img.data == nullptr) return;
+void DisplayManager::drawImage(const EncodedImage& img, int16_t x, int16_t y) {
+  ImageDecoder decoder;
+  if (!decoder.begin(img)) return;
+
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_ENCODED_IMAGE, x, y, img.width,
+                                     img.height, 0);
+    cmd.data = img.data;
+    cmd.palette = img.palette;
+    cmd.srcWidth = img.width;
+    cmd.srcHeight = img.height;
+    cmd.param = img.encoding;
+    cmd.opaque = true;
+    record(cmd);
+    return;
+  }
+
+  // 可见范围（行需要按顺序解码，被裁掉的行仍要解码跳过；条带模式裁到条带）
+  int16_t x0 = max(x, (int16_t)0);
+  int16_t y0 = max(y, (int16_t)0);
+  int16_t x1 = min((int16_t)(x + img.width), (int16_t)SCREEN_WIDTH);
+  int16_t y1 = min((int16_t)(y + img.height), (int16_t)frameBuffer->getHeight());
+  if (x0 >= x1 || y0 >= y1) return;
+
+  uint16_t rowBuffer[img.width];
+  const uint16_t* visible = rowBuffer + (x0 - x);
+  int16_t visibleW = x1 - x0;
+
+  for (int16_t j = y; j < y0; j++) {
+    decoder.nextRow(rowBuffer);
+  }
 
   if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) {
-    // 直接模式：使用优化的批量写入
     tft->startWrite();
-    tft->setAddrWindow(x, y, newWidth, newHeight);
+    tft->setAddrWindow(x0, y0, visibleW, y1 - y0);
+    for (int16_t j = y0; j < y1; j++) {
+      decoder.nextRow(rowBuffer);
+      tft->writePixels((uint16_t*)visible, visibleW);
+    }
+    tft->endWrite();
+  } else {
+    frameBuffer->beginBatch();
+    for (int16_t j = y0; j < y1; j++) {
+      decoder.nextRow(rowBuffer);
+      frameBuffer->drawRect(x0, j, visibleW, 1, visible);
+    }
+    frameBuffer->endBatch();
+    if (autoFlush) {
+      frameBuffer->flush(tft);
+    }
+  }
+}
 
-    float xRatio = (float)img.width / newWidth;
-    float yRatio = (float)img.height / newHeight;
+void DisplayManager::drawImageScaled(const ImageData& img, int16_t x, int16_t y,
+                                      uint16_t newWidth, uint16_t newHeight,
+                                      ScaleFilter filter) {
+  if (img.data == nullptr) return;
 
-    // 逐行批量写入
-    uint16_t rowBuffer[newWidth];
-    for (uint16_t j = 0; j < newHeight; j++) {
-      uint16_t srcY = j * yRatio;
-      const uint16_t* srcRow = &img.data[srcY * img.width];
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_IMAGE_SCALED, x, y, newWidth,
+                                     newHeight, 0);
+    cmd.data = img.data;
+    cmd.srcWidth = img.width;
+    cmd.srcHeight = img.height;
+    cmd.param = filter;
+    cmd.opaque = true;
+    record(cmd);
+    return;
+  }
 
-      for (uint16_t i = 0; i < newWidth; i++) {
-        uint16_t srcX = i * xRatio;
-        rowBuffer[i] = srcRow[srcX];
-      }
+  if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) {
+    // 直接模式：裁剪到屏幕后逐行批量写入
+    ImageScaler scaler;
+    if (!scaler.begin(img.data, img.width, img.height, x, y, newWidth,
+                      newHeight, tft->width(), tft->height(), filter)) {
+      return;
+    }
 
-      tft->writePixels(rowBuffer, newWidth);
+    int16_t visibleW = scaler.getWidth();
+    uint16_t rowBuffer[visibleW];
+    tft->startWrite();
+    tft->setAddrWindow(scaler.getX(), scaler.getY(), visibleW,
+                       scaler.getHeight());
+    for (int16_t j = 0; j < scaler.getHeight(); j++) {
+      // 源行重复时 rowBuffer 保持上一行内容
+      scaler.scaleRow(j, rowBuffer);
+      tft->writePixels(rowBuffer, visibleW);
     }
     tft->endWrite();
   } else {
     // 缓冲模式：使用 FrameBuffer 的批量缩放
     frameBuffer->drawRectScaled(x, y, newWidth, newHeight,
-                                 img.data, img.width, img.height);
+                                 img.data, img.width, img.height, filter);
     if (autoFlush) {
       frameBuffer->flush(tft);
     }
   }
 }
 
+void DisplayManager::drawBitmap(const uint8_t* bitmap, int16_t x, int16_t y,
+                                uint16_t w, uint16_t h, uint16_t color,
+                                uint16_t background) {
+  if (bitmap == nullptr || w == 0 || h == 0) return;
+
+  if (isRecording()) {
+    DisplayCommand cmd = makeCommand(DISPLAY_OP_BITMAP, x, y, w, h, color);
+    cmd.color2 = background;
+    cmd.data = bitmap;
+    cmd.opaque = true;
+    record(cmd);
+    return;
+  }
+
+  int16_t x0 = max(x, (int16_t)0);
+  int16_t y0 = max(y, (int16_t)0);
+  int16_t x1 = min((int16_t)(x + w), (int16_t)SCREEN_WIDTH);
+  int16_t y1 = min((int16_t)(y + h), (int16_t)frameBuffer->getHeight());
+  if (x0 >= x1 || y0 >= y1) return;
+
+  uint16_t stride = (w + 7) / 8;
+  uint16_t rowBuffer[w];
+  const uint16_t* visible = rowBuffer + (x0 - x);
+  int16_t visibleW = x1 - x0;
+
+  bool direct = frameBuffer->getMode() == BUFFER_MODE_DIRECT;
+  if (direct) {
+    // 整个位图一个地址窗口，先背景后前景的闪烁不会出现
+    tft->startWrite();
+    tft->setAddrWindow(x0, y0, visibleW, y1 - y0);
+  }
+
+  for (int16_t j = y0; j < y1; j++) {
+    const uint8_t* bits = bitmap + (j - y) * stride;
+    for (uint16_t i = 0; i < w; i++) {
+      rowBuffer[i] = (bits[i >> 3] & (0x80 >> (i & 7))) ? color : background;
+    }
+    if (direct) {
+      tft->writePixels((uint16_t*)visible, visibleW);
+    } else {
+      frameBuffer->writeRow(x0, j, visibleW, visible);
+    }
+  }
+
+  if (direct) {
+    tft->endWrite();
+    return;
+  }
+  frameBuffer->markDirty(x0, y0, visibleW, y1 - y0);
+  if (autoFlush) {
+    frameBuffer->flush(tft);
+  }
+}
+
 // ========== 动画控制 ==========
 
 void DisplayManager::playAnimation(Animation* anim) {
   if (anim == nullptr || anim->frameCount == 0) return;
 
+  decoder->end();
   currentAnimation = anim;
   currentFrame = 0;
   lastFrameTime = millis();
+  if (framePacing) framePacer->resetSchedule();
+  animationPlaying = true;
+}
+
+void DisplayManager::playAnimation(const CompressedAnimation* anim) {
+  if (anim == nullptr || anim->frameCount == 0) return;
+  if (frameBuffer->getMode() == BUFFER_MODE_STRIP) {
+    // 差分帧以上一帧为基础，需要保留整帧内容
+    Serial.println("Warning: compressed animation needs a full frame buffer");
+    return;
+  }
+
+  int16_t drawX = anim->x == -1 ? (SCREEN_WIDTH - anim->width) / 2 : anim->x;
+  int16_t drawY = anim->y == -1 ? (SCREEN_HEIGHT - anim->height) / 2 : anim->y;
+
+  currentAnimation = nullptr;
+  decoder->begin(anim, drawX, drawY);
+  if (!decoder->isActive()) return;
+
+  // 立即显示第 0 帧（关键帧），后续差分帧以它为基础
+  if (!decoder->decodeNext()) return;
+  if (frameBuffer->getMode() != BUFFER_MODE_DIRECT) presentFrame();
+
+  lastFrameTime = millis();
+  if (framePacing) framePacer->resetSchedule();
   animationPlaying = true;
 }
 
 void DisplayManager::stopAnimation() {
   animationPlaying = false;
   currentAnimation = nullptr;
+  decoder->end();
 }
 
 void DisplayManager::updateAnimation() {
-  if (!animationPlaying || currentAnimation == nullptr) return;
+  if (!animationPlaying) return;
+
+  if (decoder->isActive()) {
+    // 压缩动画：只写入并刷新变化的行段
+    if (!animationFrameDue(decoder->getFrameDuration())) return;
+
+    if (!decoder->decodeNext()) {
+      stopAnimation();
+      return;
+    }
+    if (frameBuffer->getMode() != BUFFER_MODE_DIRECT) presentFrame();
+    lastFrameTime = millis();
+    return;
+  }
+
+  if (currentAnimation == nullptr) return;
 
   unsigned long currentTime = millis();
   AnimationFrame& frame = currentAnimation->frames[currentFrame];
 
-  if (currentTime - lastFrameTime >= frame.duration) {
+  if (animationFrameDue(frame.duration)) {
     currentFrame++;
 
     if (currentFrame >= currentAnimation->frameCount) {
@@ -241,9 +533,29 @@ void DisplayManager::updateAnimation() {
     // 显示当前帧
     frame = currentAnimation->frames[currentFrame];
 
+    // 条带模式：背景与帧记录到显示列表，一次渲染
+    if (isRecording()) {
+      bool savedAutoFlush = autoFlush;
+      autoFlush = false;
+      if (currentAnimation->clearBackground) {
+        clear(ST77XX_BLACK);
+      }
+      ImageData image = {frame.data, frame.width, frame.height};
+      drawImage(image,
+                currentAnimation->x == -1 ? (SCREEN_WIDTH - frame.width) / 2
+                                          : currentAnimation->x,
+                currentAnimation->y == -1 ? (SCREEN_HEIGHT - frame.height) / 2
+                                          : currentAnimation->y);
+      autoFlush = savedAutoFlush;
+      renderStrips();
+      lastFrameTime = currentTime;
+      return;
+    }
+
     // 清除背景（如果需要）
     if (currentAnimation->clearBackground) {
       if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) {
+        syncToPanel(0, SCREEN_HEIGHT, (uint32_t)SCREEN_WIDTH * SCREEN_HEIGHT);
         tft->fillScreen(ST77XX_BLACK);
       } else {
         frameBuffer->clear(ST77XX_BLACK);
@@ -264,13 +576,17 @@ void DisplayManager::updateAnimation() {
     // 绘制当前帧
     if (frame.data != nullptr) {
       if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) {
+        if (!currentAnimation->clearBackground) {
+          syncToPanel(drawY, drawY + frame.height,
+                      (uint32_t)frame.width * frame.height);
+        }
         tft->startWrite();
         tft->setAddrWindow(drawX, drawY, frame.width, frame.height);
         tft->writePixels((uint16_t*)frame.data, frame.width * frame.height);
         tft->endWrite();
       } else {
         frameBuffer->drawRect(drawX, drawY, frame.width, frame.height, frame.data);
-        frameBuffer->flushImmediate(tft);  // 动画总是立即刷新
+        presentFrame();  // 动画总是立即刷新（只推送帧所在区域）
       }
     }
 
@@ -282,6 +598,53 @@ bool DisplayManager::isAnimationPlaying() {
   return animationPlaying;
 }
 
+// ========== 帧节奏 ==========
+
+void DisplayManager::setFramePacing(bool enabled, int8_t tePin) {
+  if (enabled && !framePacer->isReady()) {
+    if (!framePacer->begin(tft, tePin)) {
+      Serial.println("Warning: frame pacing unavailable");
+      return;
+    }
+  }
+  framePacing = enabled;
+  if (framePacing) framePacer->resetSchedule();
+}
+
+bool DisplayManager::animationFrameDue(uint16_t durationMs) {
+  if (framePacing) {
+    return framePacer->frameDue((uint32_t)durationMs * 1000);
+  }
+  return millis() - lastFrameTime >= durationMs;
+}
+
+bool DisplayManager::tearSyncActive() const {
+#if defined(ARDUINO_ARCH_ESP32)
+  // 没有 TE 时模拟时钟的相位与面板实际扫描无关，等待只增加延迟：只做固定步长调度
+  return framePacing && framePacer->hasTE();
+#else
+  return framePacing;  // 主机端面板按模拟刷新时钟扫描
+#endif
+}
+
+void DisplayManager::syncToPanel(int16_t top, int16_t bottom, uint32_t pixels) {
+  if (!tearSyncActive()) return;
+  // 推送时间按 SPI 时钟估算（每像素 16 位）
+  uint32_t pushMicros = (uint32_t)((uint64_t)pixels * 16 * 1000000 / spiFrequency);
+  framePacer->waitTearFree(top, bottom, pushMicros);
+}
+
+void DisplayManager::presentFrame() {
+  if (tearSyncActive() && frameBuffer->getMode() != BUFFER_MODE_STRIP) {
+    int16_t top, bottom;
+    uint32_t pixels;
+    if (frameBuffer->getDirtyBounds(top, bottom, pixels)) {
+      syncToPanel(top, bottom, pixels);
+    }
+  }
+  frameBuffer->flush(tft);
+}
+
 // ========== 特效 ==========
 
 void DisplayManager::fadeTransition(void (*drawFunc)(), uint16_t duration) {
@@ -310,22 +673,39 @@ void DisplayManager::scrollText(const char* text, int16_t y, int16_t speed,
   static unsigned long lastUpdate = 0;
 
   unsigned long currentTime = millis();
-  if (currentTime - lastUpdate >= 20) {
+  if (currentTime - lastUpdate >= 20 && isRecording()) {
+    // 条带模式：清除与文字都进入显示列表，清除会丢弃上一次的文字命令
+    bool savedAutoFlush = autoFlush;
+    autoFlush = false;
+    fillRect(0, y - size * 8, SCREEN_WIDTH, size * 8 + 8, ST77XX_BLACK);
+    drawText(text, scrollX, y, color, size);
+    autoFlush = savedAutoFlush;
+    if (autoFlush) renderStrips();
+
+    scrollX -= speed;
+    if (scrollX < -(int16_t)textRenderer->measure(text, size)) {
+      scrollX = SCREEN_WIDTH;
+    }
+    lastUpdate = currentTime;
+  } else if (currentTime - lastUpdate >= 20) {
+    Adafruit_GFX* gfx = beginDraw();
+
     // 清除之前的文字
-    tft->fillRect(0, y - size * 8, SCREEN_WIDTH, size * 8 + 8, ST77XX_BLACK);
+    gfx->fillRect(0, y - size * 8, SCREEN_WIDTH, size * 8 + 8, ST77XX_BLACK);
 
     // 绘制滚动文字
-    tft->setCursor(scrollX, y);
-    tft->setTextColor(color);
-    tft->setTextSize(size);
-    tft->print(text);
+    gfx->setCursor(scrollX, y);
+    gfx->setTextColor(color);
+    gfx->setTextSize(size);
+    gfx->print(text);
 
     scrollX -= speed;
 
     // 计算文字宽度
     int16_t x1, y1;
     uint16_t w, h;
-    tft->getTextBounds(text, 0, y, &x1, &y1, &w, &h);
+    gfx->getTextBounds(text, 0, y, &x1, &y1, &w, &h);
+    endDraw();
 
     if (scrollX < -w) {
       scrollX = SCREEN_WIDTH;
@@ -338,17 +718,67 @@ void DisplayManager::scrollText(const char* text, int16_t y, int16_t speed,
 // ========== 缓冲控制 ==========
 
 void DisplayManager::flush() {
-  if (frameBuffer->getMode() != BUFFER_MODE_DIRECT) {
+  if (frameBuffer->getMode() == BUFFER_MODE_STRIP) {
+    renderStrips();
+  } else if (frameBuffer->getMode() != BUFFER_MODE_DIRECT) {
     frameBuffer->flush(tft);
   }
 }
 
 void DisplayManager::flushImmediate() {
-  if (frameBuffer->getMode() != BUFFER_MODE_DIRECT) {
+  if (frameBuffer->getMode() == BUFFER_MODE_STRIP) {
+    displayList->markDirty(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    renderStrips();
+  } else if (frameBuffer->getMode() != BUFFER_MODE_DIRECT) {
     frameBuffer->flushImmediate(tft);
   }
 }
 
+void DisplayManager::setAsyncFlush(bool enabled) {
+  if (!enabled) {
+    waitFlush();
+  }
+  asyncFlush = enabled;
+}
+
+bool DisplayManager::flushAsync() {
+  if (frameBuffer->getMode() == BUFFER_MODE_DIRECT) return false;
+  if (frameBuffer->getMode() == BUFFER_MODE_STRIP) {
+    // 下一个条带要复用同一块缓冲，只能同步推送
+    renderStrips();
+    return false;
+  }
+  if (!asyncFlush) {
+    flush();
+    return false;
+  }
+
+  // 首次使用时记录 DMA 的总线配置（每次刷新时才从 SPIClass 接管总线）
+  if (!dma->isReady()) {
+    static bool dmaFailed = false;
+    if (!dmaFailed &&
+        !dma->begin(tft, spi, TFT_SCLK, TFT_MOSI, TFT_CS, TFT_DC, spiFrequency,
+                    SCREEN_WIDTH * FrameBuffer::ASYNC_LINES * sizeof(uint16_t))) {
+      Serial.println("Warning: DMA unavailable, using synchronous flush");
+      dmaFailed = true;
+    }
+  }
+
+  return frameBuffer->flushAsync(tft, dma);
+}
+
+void DisplayManager::pollFlush() {
+  frameBuffer->pollFlush();
+}
+
+void DisplayManager::waitFlush() {
+  frameBuffer->waitFlush();
+}
+
+bool DisplayManager::isFlushing() {
+  return frameBuffer->isFlushing();
+}
+
 void DisplayManager::setAutoFlush(bool enabled) {
   autoFlush = enabled;
 }
@@ -356,7 +786,35 @@ void DisplayManager::setAutoFlush(bool enabled) {
 void DisplayManager::printPerformanceInfo() {
   Serial.println("=== Display Performance Info ===");
   Serial.printf("Buffer mode: %d\n", frameBuffer->getMode());
-  Serial.printf("Memory usage: %d KB\n", frameBuffer->getMemoryUsage() / 1024);
+  Serial.printf("Memory usage: %u KB (internal SRAM: %u KB)\n",
+                (unsigned)(frameBuffer->getMemoryUsage() / 1024),
+                (unsigned)(frameBuffer->getInternalMemoryUsage() / 1024));
+  Serial.printf("Back buffer: %s, front buffer: %s, line cache: %s\n",
+                BufferAllocator::regionName(frameBuffer->getBackBufferRegion()),
+                BufferAllocator::regionName(frameBuffer->getFrontBufferRegion()),
+                BufferAllocator::regionName(frameBuffer->getLineCacheRegion()));
+  if (displayList->isReady()) {
+    Serial.printf("Display list: %u commands, %u B (dropped: %lu)\n",
+                  (unsigned)displayList->getCount(),
+                  (unsigned)displayList->getMemoryUsage(),
+                  (unsigned long)displayList->getDroppedCount());
+  }
+  if (framePacing) {
+    const FramePacingStats& pacing = framePacer->getStats();
+    Serial.printf("Frame pacing: %s, %lu frames, %lu missed, %lu torn, "
+                  "late avg %lu us, jitter avg/max %lu/%lu us\n",
+                  framePacer->hasTE() ? "TE"
+                      : tearSyncActive() ? "modelled" : "fixed-step only",
+                  (unsigned long)pacing.frames,
+                  (unsigned long)pacing.missedDeadlines,
+                  (unsigned long)pacing.tornFlushes,
+                  (unsigned long)pacing.averageLateMicros(),
+                  (unsigned long)pacing.averageJitterMicros(),
+                  (unsigned long)pacing.maxJitterMicros);
+  }
+  Serial.printf("Free internal: %u KB, free PSRAM: %u KB\n",
+                (unsigned)(BufferAllocator::getFreeBytes(MEMORY_INTERNAL) / 1024),
+                (unsigned)(BufferAllocator::getFreeBytes(MEMORY_PSRAM) / 1024));
   Serial.printf("Flush count: %d\n", frameBuffer->getFlushCount());
   Serial.printf("Last flush time: %lu ms\n", frameBuffer->getLastFlushTime());
   Serial.printf("SPI frequency: %d MHz\n", spiFrequency / 1000000);
@@ -364,5 +822,174 @@ void DisplayManager::printPerformanceInfo() {
 }
 
 size_t DisplayManager::getBufferMemoryUsage() {
-  return frameBuffer->getMemoryUsage();
+  return frameBuffer->getMemoryUsage() + displayList->getMemoryUsage();
+}
+
+// ========== 条带渲染 ==========
+
+bool DisplayManager::isRecording() const {
+  return !replaying && frameBuffer->getMode() == BUFFER_MODE_STRIP;
+}
+
+DisplayCommand DisplayManager::makeCommand(DisplayOp op, int16_t x, int16_t y,
+                                           int16_t w, int16_t h,
+                                           uint16_t color) {
+  DisplayCommand cmd;
+  memset(&cmd, 0, sizeof(cmd));
+  cmd.op = op;
+  cmd.x = x;
+  cmd.y = y;
+  cmd.w = w;
+  cmd.h = h;
+  cmd.color = color;
+  setRectBounds(cmd, x, y, w, h);
+  return cmd;
+}
+
+void DisplayManager::setRectBounds(DisplayCommand& cmd, int16_t x, int16_t y,
+                                   int16_t w, int16_t h) {
+  // 宽高不为正时帧缓冲不绘制，外接矩形为空
+  cmd.left = x;
+  cmd.top = y;
+  cmd.right = w > 0 ? x + w : x;
+  cmd.bottom = h > 0 ? y + h : y;
+}
+
+void DisplayManager::setTextBounds(DisplayCommand& cmd, const char* text) {
+  // 与 TextRenderer::drawString 相同的排版：\n 与自动换行回到第 0 列
+  int16_t advance = TextRenderer::GLYPH_WIDTH * cmd.param;
+  int16_t cursorX = cmd.x;
+  int16_t lines = 1;
+  cmd.left = cmd.x;
+  cmd.right = cmd.x;
+
+  for (const char* p = text; *p != '\0'; p++) {
+    if (*p == '\r') continue;
+    if (*p == '\n' || cursorX + advance > SCREEN_WIDTH) {
+      cursorX = 0;
+      cmd.left = 0;
+      lines++;
+      if (*p == '\n') continue;
+    }
+    cursorX += advance;
+    if (cursorX > cmd.right) cmd.right = cursorX;
+  }
+
+  cmd.top = cmd.y;
+  cmd.bottom = cmd.y + lines * TextRenderer::GLYPH_HEIGHT * cmd.param;
+}
+
+void DisplayManager::record(const DisplayCommand& cmd, const char* text) {
+  if (!displayList->begin()) return;
+
+  // 外接矩形裁到屏幕，完全在屏幕外的命令不记录
+  DisplayCommand clipped = cmd;
+  clipped.left = max(clipped.left, (int16_t)0);
+  clipped.top = max(clipped.top, (int16_t)0);
+  clipped.right = min(clipped.right, (int16_t)SCREEN_WIDTH);
+  clipped.bottom = min(clipped.bottom, (int16_t)SCREEN_HEIGHT);
+  if (clipped.left >= clipped.right || clipped.top >= clipped.bottom) return;
+
+  displayList->add(clipped, text);
+  if (autoFlush) {
+    renderStrips();
+  }
+}
+
+void DisplayManager::renderStrips() {
+  if (!displayList->isDirty()) return;
+
+  // 重放时绘制调用直接画进条带，不再记录也不自动刷新
+  bool savedAutoFlush = autoFlush;
+  autoFlush = false;
+  replaying = true;
+
+  int16_t lines = frameBuffer->getHeight();
+  for (int16_t stripTop = 0; stripTop < SCREEN_HEIGHT; stripTop += lines) {
+    int16_t stripBottom = min((int16_t)(stripTop + lines), (int16_t)SCREEN_HEIGHT);
+    int16_t left, top, right, bottom;
+    if (!displayList->takeDirty(stripTop, stripBottom, left, top, right, bottom)) {
+      continue;
+    }
+
+    frameBuffer->setStripOrigin(stripTop);
+    frameBuffer->fillRect(left, top - stripTop, right - left, bottom - top,
+                          ST77XX_BLACK);
+
+    // 只重放与变化范围相交的命令，范围外的像素不会被推送
+    for (uint8_t i = 0; i < displayList->getCount(); i++) {
+      const DisplayCommand& cmd = displayList->get(i);
+      if (cmd.bottom > top && cmd.top < bottom && cmd.right > left &&
+          cmd.left < right) {
+        replay(cmd, displayList->getText(cmd), stripTop);
+      }
+    }
+
+    frameBuffer->markClean();
+    frameBuffer->markDirty(left, top - stripTop, right - left, bottom - top);
+    frameBuffer->flush(tft);
+  }
+
+  replaying = false;
+  autoFlush = savedAutoFlush;
+}
+
+void DisplayManager::execute(const DisplayCommand& cmd, const char* text) {
+  if (cmd.op == DISPLAY_OP_CLEAR) {
+    clear(cmd.color);
+    return;
+  }
+  replay(cmd, text != nullptr ? text : "", 0);
+}
+
+void DisplayManager::replay(const DisplayCommand& cmd, const char* text,
+                            int16_t stripTop) {
+  int16_t y = cmd.y - stripTop;
+
+  switch (cmd.op) {
+    case DISPLAY_OP_CLEAR:
+      frameBuffer->fillRect(0, y, cmd.w, cmd.h, cmd.color);
+      break;
+    case DISPLAY_OP_TEXT:
+      drawText(text, cmd.x, y, cmd.color, cmd.param);
+      break;
+    case DISPLAY_OP_TEXT_BOX:
+      drawTextBox(cmd.x, y, cmd.w, cmd.h, text, cmd.color, cmd.color2);
+      break;
+    case DISPLAY_OP_RECT:
+      drawRect(cmd.x, y, cmd.w, cmd.h, cmd.color);
+      break;
+    case DISPLAY_OP_FILL_RECT:
+      fillRect(cmd.x, y, cmd.w, cmd.h, cmd.color);
+      break;
+    case DISPLAY_OP_CIRCLE:
+      drawCircle(cmd.x, y, cmd.w, cmd.color);
+      break;
+    case DISPLAY_OP_FILL_CIRCLE:
+      fillCircle(cmd.x, y, cmd.w, cmd.color);
+      break;
+    case DISPLAY_OP_LINE:
+      drawLine(cmd.x, y, cmd.w, cmd.h - stripTop, cmd.color);
+      break;
+    case DISPLAY_OP_IMAGE: {
+      ImageData img = {(const uint16_t*)cmd.data, cmd.srcWidth, cmd.srcHeight};
+      drawImage(img, cmd.x, y);
+      break;
+    }
+    case DISPLAY_OP_ENCODED_IMAGE: {
+      EncodedImage img = {(const uint8_t*)cmd.data, cmd.palette, cmd.srcWidth,
+                          cmd.srcHeight, (ImageEncoding)cmd.param};
+      drawImage(img, cmd.x, y);
+      break;
+    }
+    case DISPLAY_OP_IMAGE_SCALED: {
+      ImageData img = {(const uint16_t*)cmd.data, cmd.srcWidth, cmd.srcHeight};
+      drawImageScaled(img, cmd.x, y, cmd.w, cmd.h, (ScaleFilter)cmd.param);
+      break;
+    }
+    case DISPLAY_OP_BITMAP:
+      drawBitmap((const uint8_t*)cmd.data, cmd.x, y, cmd.w, cmd.h, cmd.color,
+                 cmd.color2);
+      break;
+  }
 }
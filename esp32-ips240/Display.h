@@ -5,6 +5,13 @@
 #include <Adafruit_ST7789.h>
 #include <SPI.h>
 #include "FrameBuffer.h"
+#include "FrameBufferCanvas.h"
+#include "TextRenderer.h"
+#include "AnimationDecoder.h"
+#include "ImageDecoder.h"
+#include "DisplayList.h"
+#include "DisplayDMA.h"
+#include "FramePacer.h"
 
 // 显示屏配置
 #define TFT_CS    5     // 片选
@@ -13,6 +20,7 @@
 #define TFT_MOSI  10    // SDA (数据)
 #define TFT_SCLK  11    // SCK (时钟)
 #define TFT_BL    16    // 背光
+#define TFT_TE    -1    // 撕裂效应信号（未连接时为 -1，按模拟刷新时钟排程）
 #define SCREEN_WIDTH  240
 #define SCREEN_HEIGHT 240
 
@@ -51,9 +59,17 @@ private:
   SPIClass* spi;
   Adafruit_ST7789* tft;
   FrameBuffer* frameBuffer;
+  FrameBufferCanvas* canvas;  // 缓冲模式下文字/图形的绘制目标
+  TextRenderer* textRenderer; // 缓冲模式下的文字引擎（字模表按行段写入）
+  DisplayDMA* dma;
+  DisplayList* displayList;   // 条带模式下记录的绘制命令
+  FramePacer* framePacer;     // 帧节奏：动画按固定步长调度，刷新避开扫描线
+  bool framePacing;
+  bool replaying;             // 正在重放显示列表（绘制调用直接画进条带）
 
   // 动画状态
   Animation* currentAnimation;
+  AnimationDecoder* decoder;  // 压缩动画（关键帧 + 差分帧）
   uint8_t currentFrame;
   unsigned long lastFrameTime;
   bool animationPlaying;
@@ -61,6 +77,26 @@ private:
   // 配置
   uint32_t spiFrequency;
   bool autoFlush;  // 自动刷新模式
+  bool asyncFlush; // 允许 DMA 异步刷新（默认关闭，见 setAsyncFlush）
+
+  // 图元绘制目标：直接模式为屏幕，缓冲模式为帧缓冲画布
+  Adafruit_GFX* beginDraw();
+  void endDraw();  // 缓冲模式下按 autoFlush 刷新
+
+  // 条带模式：绘制调用记录到显示列表，刷新时逐条带重放
+  bool isRecording() const;
+  void record(const DisplayCommand& cmd, const char* text = nullptr);
+  void renderStrips();
+  void replay(const DisplayCommand& cmd, const char* text, int16_t stripTop);
+  static void setRectBounds(DisplayCommand& cmd, int16_t x, int16_t y,
+                            int16_t w, int16_t h);
+  static void setTextBounds(DisplayCommand& cmd, const char* text);
+
+  // 帧节奏：开启时动画帧按 FramePacer 调度，刷新前等到不撕裂的时刻
+  bool animationFrameDue(uint16_t durationMs);
+  bool tearSyncActive() const;
+  void syncToPanel(int16_t top, int16_t bottom, uint32_t pixels);
+  void presentFrame();  // 同步后刷新帧缓冲的脏区域
 
 public:
   DisplayManager();
@@ -93,11 +129,17 @@ public:
 
   // 图片显示
   void drawImage(const ImageData& img, int16_t x, int16_t y);
+  void drawImage(const EncodedImage& img, int16_t x, int16_t y);
   void drawImageScaled(const ImageData& img, int16_t x, int16_t y,
-                       uint16_t newWidth, uint16_t newHeight);
+                       uint16_t newWidth, uint16_t newHeight,
+                       ScaleFilter filter = SCALE_NEAREST);
+  // 1 位位图（每行按字节对齐，高位在左）：置位像素为 color，其余为 background
+  void drawBitmap(const uint8_t* bitmap, int16_t x, int16_t y, uint16_t w,
+                  uint16_t h, uint16_t color, uint16_t background);
 
   // 动画控制
   void playAnimation(Animation* anim);
+  void playAnimation(const CompressedAnimation* anim);
   void stopAnimation();
   void updateAnimation();  // 在 loop 中调用
   bool isAnimationPlaying();
@@ -113,6 +155,27 @@ public:
   void setAutoFlush(bool enabled); // 设置自动刷新模式
   bool getAutoFlush() const { return autoFlush; }
 
+  // 异步刷新（DMA）：立即返回，传输与后续计算重叠。
+  // 默认关闭：DMA 会话要在 SPIClass 与 IDF 驱动之间交接 SPI2，尚未在硬件上验证；
+  // 关闭或 DMA 不可用时 flushAsync() 退回同步刷新并返回 false
+  void setAsyncFlush(bool enabled);
+  bool getAsyncFlush() const { return asyncFlush; }
+  bool flushAsync();
+  void pollFlush();                // 在 loop 中调用，继续发送剩余的行
+  void waitFlush();                // 等待异步刷新完成
+  bool isFlushing();
+
+  // 绘制命令：makeCommand 填写位置、尺寸、颜色与外接矩形，其余字段由调用者补充；
+  // execute 按命令调用对应的绘制方法（渲染流水线的消费端使用）
+  static DisplayCommand makeCommand(DisplayOp op, int16_t x, int16_t y,
+                                    int16_t w, int16_t h, uint16_t color);
+  void execute(const DisplayCommand& cmd, const char* text = nullptr);
+
+  // 帧节奏与防撕裂（条带模式逐条带推送，不做同步）。
+  // 设备上只有接了 TE 才在推送前避开扫描线，否则只做固定步长调度
+  void setFramePacing(bool enabled, int8_t tePin = TFT_TE);
+  bool getFramePacing() const { return framePacing; }
+
   // 性能信息
   void printPerformanceInfo();
   size_t getBufferMemoryUsage();
@@ -120,6 +183,9 @@ public:
   // 直接访问底层对象（高级功能）
   Adafruit_ST7789* getTFT() { return tft; }
   FrameBuffer* getFrameBuffer() { return frameBuffer; }
+  DisplayDMA* getDMA() { return dma; }
+  DisplayList* getDisplayList() { return displayList; }
+  FramePacer* getFramePacer() { return framePacer; }
 };
 
 #endif
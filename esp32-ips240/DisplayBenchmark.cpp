@@ -0,0 +1,409 @@
+#include "DisplayBenchmark.h"
+#include "SnakeGame.h"
+
+// 各负载的重复次数
+static const uint16_t kClearIterations = 20;
+static const uint16_t kFillSmallIterations = 2000;
+static const uint16_t kLineIterations = 20;
+static const uint16_t kFillLargeIterations = 50;
+static const uint16_t kBlitIterations = 500;
+static const uint16_t kScaleIterations = 200;
+static const uint16_t kFlushIterations = 10;
+static const uint16_t kSceneIterations = 3;
+static const uint16_t kSnakeSteps = 100;
+static const uint16_t kClockFrames = 10;
+static const uint16_t kAnimationFrames = 12;
+
+const DisplayBenchmark::Workload DisplayBenchmark::workloads[] = {
+  {"clear",            &DisplayBenchmark::benchClear,          true},
+  {"clear 2-byte",     &DisplayBenchmark::benchClearColor,     true},
+  {"lines h+v",        &DisplayBenchmark::benchFillLines,      true},
+  {"fillRect 8x8",     &DisplayBenchmark::benchFillSmall,      true},
+  {"fillRect 120x120", &DisplayBenchmark::benchFillLarge,      true},
+  {"drawRect 32x32",   &DisplayBenchmark::benchBlit,           true},
+  {"scaled 16->64",    &DisplayBenchmark::benchScale,          true},
+  {"bilinear 16->64",  &DisplayBenchmark::benchScaleBilinear,  true},
+  {"flush full",       &DisplayBenchmark::benchFlushFull,      true},
+  {"demo text",        &DisplayBenchmark::benchTextDemo,       false},
+  {"status screen",    &DisplayBenchmark::benchStatusScreen,   false},
+  {"clock screen",     &DisplayBenchmark::benchClockScreen,    false},
+  {"demo images",      &DisplayBenchmark::benchImageDemo,      false},
+  {"demo graphics",    &DisplayBenchmark::benchGraphicsDemo,   false},
+  {"snake",            &DisplayBenchmark::benchSnake,          false},
+  {"heart animation",  &DisplayBenchmark::benchHeartAnimation, false},
+};
+
+float BenchResult::nsPerPixel() const {
+  uint64_t pixels = pixelsDrawn > 0 ? pixelsDrawn : pixelsPushed;
+  if (pixels == 0) return 0.0f;
+  return (float)totalMicros() * 1000.0f / pixels;
+}
+
+float BenchResult::fps() const {
+  if (totalMicros() == 0) return 0.0f;
+  return frames * 1000000.0f / totalMicros();
+}
+
+DisplayBenchmark::DisplayBenchmark(DisplayManager* display) {
+  pDisplay = display;
+  smallIcon = nullptr;
+  largeIcon = nullptr;
+  animation = nullptr;
+  savedMode = BUFFER_MODE_DIRECT;
+  savedAutoFlush = true;
+  idleMicros = 0;
+}
+
+void DisplayBenchmark::setAssets(const ImageData* small, const ImageData* large,
+                                 Animation* anim) {
+  smallIcon = small;
+  largeIcon = large;
+  animation = anim;
+}
+
+uint8_t DisplayBenchmark::getWorkloadCount() const {
+  return sizeof(workloads) / sizeof(workloads[0]);
+}
+
+const char* DisplayBenchmark::getWorkloadName(uint8_t index) const {
+  if (index >= getWorkloadCount()) return "";
+  return workloads[index].name;
+}
+
+bool DisplayBenchmark::prepare(BufferMode mode) {
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  savedMode = fb->getMode();
+  savedAutoFlush = pDisplay->getAutoFlush();
+
+  if (!fb->setMode(mode)) {
+    Serial.printf("Benchmark: 无法切换到缓冲模式 %d\n", mode);
+    fb->setMode(savedMode);
+    return false;
+  }
+  pDisplay->setAutoFlush(true);
+  pDisplay->clear(ST77XX_BLACK);
+  return true;
+}
+
+void DisplayBenchmark::restore() {
+  pDisplay->stopAnimation();
+  pDisplay->getFrameBuffer()->setMode(savedMode);
+  pDisplay->setAutoFlush(savedAutoFlush);
+  pDisplay->clear(ST77XX_BLACK);
+}
+
+bool DisplayBenchmark::runWorkload(uint8_t index, BenchResult& result) {
+  memset(&result, 0, sizeof(result));
+  if (index >= getWorkloadCount()) return false;
+
+  const Workload& workload = workloads[index];
+  result.name = workload.name;
+
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  // 条带模式的缓冲只有一个条带，帧缓冲内核负载没有意义
+  if (workload.needsBuffer && (fb->getMode() == BUFFER_MODE_DIRECT ||
+                               fb->getMode() == BUFFER_MODE_STRIP)) {
+    return false;
+  }
+
+  FlushStats before = fb->getFlushStats();
+  idleMicros = 0;
+  unsigned long start = micros();
+
+  (this->*workload.func)(result);
+
+  uint32_t elapsed = micros() - start - idleMicros;
+  const FlushStats& after = fb->getFlushStats();
+
+  result.pixelsPushed = after.pixelsPushed - before.pixelsPushed;
+  result.pixelsMarked = after.pixelsMarked - before.pixelsMarked;
+  result.addrWindows = after.addrWindowCount - before.addrWindowCount;
+  result.flushMicros = after.totalFlushMicros - before.totalFlushMicros;
+  if (result.flushMicros > elapsed) result.flushMicros = elapsed;
+  result.drawMicros = elapsed - result.flushMicros;
+  return result.frames > 0;
+}
+
+bool DisplayBenchmark::runAll(BufferMode mode) {
+  if (!prepare(mode)) return false;
+
+  Serial.printf("=== Display Benchmark (buffer mode %d) ===\n", mode);
+  printHeader();
+
+  for (uint8_t i = 0; i < getWorkloadCount(); i++) {
+    BenchResult result;
+    if (runWorkload(i, result)) {
+      printResult(result);
+    } else {
+      Serial.printf("%-18s skipped\n", getWorkloadName(i));
+    }
+  }
+
+  restore();
+  return true;
+}
+
+void DisplayBenchmark::printHeader() {
+  Serial.printf("%-18s %6s %9s %9s %7s %9s %6s %9s %9s %8s\n", "workload",
+                "frames", "ns/px", "px/frame", "win/f", "bytes/f", "sent/m",
+                "draw_ms", "flush_ms", "fps");
+}
+
+void DisplayBenchmark::printResult(const BenchResult& r) {
+  uint32_t frames = r.frames > 0 ? r.frames : 1;
+  uint64_t bytes = r.pixelsPushed * 2 + (uint64_t)r.addrWindows * 11;
+  // 推送像素 / 标记像素：>1 表示合并带来的多余发送
+  float sentRatio = r.pixelsMarked > 0 ? (float)r.pixelsPushed / r.pixelsMarked : 0;
+  Serial.printf("%-18s %6lu %9.2f %9lu %7.1f %9lu %6.2f %9.2f %9.2f %8.1f\n",
+                r.name, (unsigned long)r.frames, r.nsPerPixel(),
+                (unsigned long)(r.pixelsPushed / frames),
+                (float)r.addrWindows / frames,
+                (unsigned long)(bytes / frames), sentRatio, r.drawMicros / 1000.0f,
+                r.flushMicros / 1000.0f, r.fps());
+}
+
+void DisplayBenchmark::idle(uint32_t ms) {
+  unsigned long start = micros();
+  delay(ms);
+  idleMicros += micros() - start;
+}
+
+// ========== 内核负载 ==========
+
+void DisplayBenchmark::benchClear(BenchResult& result) {
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kClearIterations; i++) {
+    fb->clear((i & 1) ? ST77XX_BLUE : ST77XX_BLACK);
+  }
+  fb->markClean();
+  result.frames = kClearIterations;
+  result.pixelsDrawn = (uint64_t)kClearIterations * SCREEN_WIDTH * SCREEN_HEIGHT;
+}
+
+// 高低字节不同的颜色，走 32 位写入而不是 memset
+void DisplayBenchmark::benchClearColor(BenchResult& result) {
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kClearIterations; i++) {
+    fb->clear((i & 1) ? ST77XX_RED : ST77XX_GREEN);
+  }
+  fb->markClean();
+  result.frames = kClearIterations;
+  result.pixelsDrawn = (uint64_t)kClearIterations * SCREEN_WIDTH * SCREEN_HEIGHT;
+}
+
+// 每行一条变长横线加一条竖线（文字、边框的典型形状）
+void DisplayBenchmark::benchFillLines(BenchResult& result) {
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  uint64_t pixels = 0;
+  for (uint16_t i = 0; i < kLineIterations; i++) {
+    uint16_t color = (i & 1) ? ST77XX_YELLOW : ST77XX_CYAN;
+    for (int16_t y = 0; y < SCREEN_HEIGHT; y++) {
+      int16_t w = 1 + (y * 7 + i) % SCREEN_WIDTH;
+      fb->fillRect(0, y, w, 1, color);
+      fb->fillRect(y, 0, 1, SCREEN_HEIGHT / 2, color);
+      pixels += w + SCREEN_HEIGHT / 2;
+    }
+  }
+  fb->markClean();
+  result.frames = kLineIterations;
+  result.pixelsDrawn = pixels;
+}
+
+void DisplayBenchmark::benchFillSmall(BenchResult& result) {
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kFillSmallIterations; i++) {
+    int16_t x = (i * 37) % (SCREEN_WIDTH / 8) * 8;
+    int16_t y = (i * 53) % (SCREEN_HEIGHT / 8) * 8;
+    fb->fillRect(x, y, 8, 8, (i & 1) ? ST77XX_RED : ST77XX_BLACK);
+  }
+  fb->markClean();
+  result.frames = kFillSmallIterations;
+  result.pixelsDrawn = (uint64_t)kFillSmallIterations * 8 * 8;
+}
+
+void DisplayBenchmark::benchFillLarge(BenchResult& result) {
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kFillLargeIterations; i++) {
+    fb->fillRect((i % 4) * 40, (i % 3) * 40, 120, 120,
+                 (i & 1) ? ST77XX_GREEN : ST77XX_BLACK);
+  }
+  fb->markClean();
+  result.frames = kFillLargeIterations;
+  result.pixelsDrawn = (uint64_t)kFillLargeIterations * 120 * 120;
+}
+
+void DisplayBenchmark::benchBlit(BenchResult& result) {
+  if (largeIcon == nullptr) return;
+
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kBlitIterations; i++) {
+    int16_t x = (i * 29) % (SCREEN_WIDTH - largeIcon->width);
+    int16_t y = (i * 41) % (SCREEN_HEIGHT - largeIcon->height);
+    fb->drawRect(x, y, largeIcon->width, largeIcon->height, largeIcon->data);
+  }
+  fb->markClean();
+  result.frames = kBlitIterations;
+  result.pixelsDrawn =
+      (uint64_t)kBlitIterations * largeIcon->width * largeIcon->height;
+}
+
+void DisplayBenchmark::benchScale(BenchResult& result) {
+  if (smallIcon == nullptr) return;
+
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kScaleIterations; i++) {
+    int16_t x = (i * 29) % (SCREEN_WIDTH - 64);
+    int16_t y = (i * 41) % (SCREEN_HEIGHT - 64);
+    fb->drawRectScaled(x, y, 64, 64, smallIcon->data, smallIcon->width,
+                       smallIcon->height);
+  }
+  fb->markClean();
+  result.frames = kScaleIterations;
+  result.pixelsDrawn = (uint64_t)kScaleIterations * 64 * 64;
+}
+
+void DisplayBenchmark::benchScaleBilinear(BenchResult& result) {
+  if (smallIcon == nullptr) return;
+
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kScaleIterations; i++) {
+    int16_t x = (i * 29) % (SCREEN_WIDTH - 64);
+    int16_t y = (i * 41) % (SCREEN_HEIGHT - 64);
+    fb->drawRectScaled(x, y, 64, 64, smallIcon->data, smallIcon->width,
+                       smallIcon->height, SCALE_BILINEAR);
+  }
+  fb->markClean();
+  result.frames = kScaleIterations;
+  result.pixelsDrawn = (uint64_t)kScaleIterations * 64 * 64;
+}
+
+void DisplayBenchmark::benchFlushFull(BenchResult& result) {
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  for (uint16_t i = 0; i < kFlushIterations; i++) {
+    fb->flushImmediate(pDisplay->getTFT());
+  }
+  result.frames = kFlushIterations;
+}
+
+// ========== 场景负载（与 esp32-ips240.ino 的演示界面一致） ==========
+
+void DisplayBenchmark::benchTextDemo(BenchResult& result) {
+  for (uint16_t i = 0; i < kSceneIterations; i++) {
+    pDisplay->clear(ST77XX_BLACK);
+    pDisplay->drawCenteredText("Text Demo", 20, ST77XX_YELLOW, 2);
+    pDisplay->drawText("Size 1 Text", 10, 50, ST77XX_WHITE, 1);
+    pDisplay->drawText("Size 2 Text", 10, 70, ST77XX_CYAN, 2);
+    pDisplay->drawText("Size 3", 10, 95, ST77XX_GREEN, 3);
+    pDisplay->drawTextBox(10, 140, 220, 50,
+                          "Text box with automatic wrapping!",
+                          ST77XX_WHITE, ST77XX_BLUE);
+    pDisplay->drawCenteredText("Mode: TEXT", 220, ST77XX_MAGENTA, 1);
+    pDisplay->flush();
+  }
+  result.frames = kSceneIterations;
+}
+
+// 与 showBLEStatus / showReadyScreen 一致的纯文字状态界面
+void DisplayBenchmark::benchStatusScreen(BenchResult& result) {
+  for (uint16_t i = 0; i < kSceneIterations; i++) {
+    pDisplay->clear(ST77XX_BLACK);
+    pDisplay->drawCenteredText("BLE Status", 30, ST77XX_YELLOW, 2);
+    pDisplay->drawCenteredText("Device: ESP32-LED", 80, ST77XX_WHITE, 1);
+    pDisplay->drawCenteredText("Status: Advertising", 110, ST77XX_GREEN, 1);
+    pDisplay->drawCenteredText("Ready to pair", 140, ST77XX_CYAN, 1);
+    pDisplay->flush();
+
+    pDisplay->clear(ST77XX_BLACK);
+    pDisplay->drawCenteredText("System Ready!", 70, ST77XX_GREEN, 2);
+    pDisplay->drawCenteredText("BLE: Waiting", 110, ST77XX_YELLOW, 1);
+    pDisplay->drawCenteredText("WiFi: Not connected", 130, ST77XX_ORANGE, 1);
+    pDisplay->drawCenteredText("Starting demo...", 170, ST77XX_WHITE, 1);
+    pDisplay->flush();
+  }
+  result.frames = kSceneIterations * 2;
+}
+
+// 与 ClockDisplay::displayClock 一致，每帧走一秒
+void DisplayBenchmark::benchClockScreen(BenchResult& result) {
+  char timeStr[16];
+  char uptime[32];
+  for (uint16_t i = 0; i < kClockFrames; i++) {
+    snprintf(timeStr, sizeof(timeStr), "12:%02u:%02u", (i / 60) % 60, i % 60);
+    snprintf(uptime, sizeof(uptime), "Uptime: %us", 3600 + i);
+
+    pDisplay->clear(ST77XX_BLACK);
+    pDisplay->drawCenteredText("2024-06-01", 30, ST77XX_CYAN, 1);
+    pDisplay->drawCenteredText(timeStr, 100, ST77XX_WHITE, 3);
+    pDisplay->drawCenteredText("Clock Mode", 160, ST77XX_GREEN, 1);
+    pDisplay->drawLine(40, 80, 200, 80, ST77XX_BLUE);
+    pDisplay->drawLine(40, 145, 200, 145, ST77XX_BLUE);
+    pDisplay->drawCenteredText(uptime, 200, ST77XX_MAGENTA, 1);
+    pDisplay->flush();
+  }
+  result.frames = kClockFrames;
+}
+
+void DisplayBenchmark::benchImageDemo(BenchResult& result) {
+  if (smallIcon == nullptr || largeIcon == nullptr) return;
+
+  for (uint16_t i = 0; i < kSceneIterations; i++) {
+    pDisplay->clear(ST77XX_BLACK);
+    pDisplay->drawCenteredText("Image Demo", 20, ST77XX_YELLOW, 2);
+    pDisplay->drawImage(*smallIcon, 50, 60);
+    pDisplay->drawText("Heart", 80, 65, ST77XX_WHITE, 1);
+    pDisplay->drawImage(*largeIcon, 50, 100);
+    pDisplay->drawText("Smile", 90, 115, ST77XX_WHITE, 1);
+    pDisplay->drawText("Scaled:", 10, 160, ST77XX_CYAN, 1);
+    pDisplay->drawImageScaled(*smallIcon, 80, 150, 32, 32);
+    pDisplay->drawCenteredText("Mode: IMAGES", 220, ST77XX_MAGENTA, 1);
+    pDisplay->flush();
+  }
+  result.frames = kSceneIterations;
+}
+
+void DisplayBenchmark::benchGraphicsDemo(BenchResult& result) {
+  for (uint16_t i = 0; i < kSceneIterations; i++) {
+    pDisplay->clear(ST77XX_BLACK);
+    pDisplay->drawCenteredText("Graphics Demo", 20, ST77XX_YELLOW, 2);
+    pDisplay->drawRect(10, 50, 60, 40, ST77XX_RED);
+    pDisplay->drawText("Rect", 15, 100, ST77XX_WHITE, 1);
+    pDisplay->fillRect(80, 50, 60, 40, ST77XX_GREEN);
+    pDisplay->drawText("Filled", 85, 100, ST77XX_BLACK, 1);
+    pDisplay->drawCircle(180, 70, 20, ST77XX_BLUE);
+    pDisplay->drawText("Circle", 160, 100, ST77XX_WHITE, 1);
+    pDisplay->fillCircle(35, 140, 15, ST77XX_MAGENTA);
+    pDisplay->fillCircle(100, 140, 15, ST77XX_CYAN);
+    pDisplay->fillCircle(165, 140, 15, ST77XX_YELLOW);
+    for (int j = 0; j < 5; j++) {
+      pDisplay->drawLine(10 + j * 45, 180, 40 + j * 45, 200, ST77XX_WHITE);
+    }
+    pDisplay->drawCenteredText("Mode: GRAPHICS", 220, ST77XX_MAGENTA, 1);
+    pDisplay->flush();
+  }
+  result.frames = kSceneIterations;
+}
+
+void DisplayBenchmark::benchSnake(BenchResult& result) {
+  SnakeGame snake(pDisplay);
+  snake.begin();
+  for (uint16_t i = 0; i < kSnakeSteps; i++) {
+    snake.step();
+  }
+  result.frames = kSnakeSteps;
+}
+
+void DisplayBenchmark::benchHeartAnimation(BenchResult& result) {
+  if (animation == nullptr) return;
+
+  pDisplay->clear(ST77XX_BLACK);
+  pDisplay->playAnimation(animation);
+  uint8_t frameIndex = 0;
+  for (uint16_t i = 0; i < kAnimationFrames; i++) {
+    // 等待当前帧的持续时间（不计入耗时），然后让动画切到下一帧
+    idle(animation->frames[frameIndex].duration);
+    pDisplay->updateAnimation();
+    frameIndex = (frameIndex + 1) % animation->frameCount;
+  }
+  pDisplay->stopAnimation();
+  result.frames = kAnimationFrames;
+}
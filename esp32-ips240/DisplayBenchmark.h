@@ -0,0 +1,93 @@
+#ifndef DISPLAY_BENCHMARK_H
+#define DISPLAY_BENCHMARK_H
+
+#include <Arduino.h>
+#include "Display.h"
+
+// 单个基准测试项的结果
+struct BenchResult {
+  const char* name;
+  uint32_t frames;           // 帧数（或内核调用次数）
+  uint64_t pixelsDrawn;      // 写入缓冲/屏幕的像素数
+  uint64_t pixelsPushed;     // flush 推送到屏幕的像素数
+  uint64_t pixelsMarked;     // 绘制标记为脏的像素数（合并前）
+  uint32_t addrWindows;      // flush 设置地址窗口的次数
+  uint32_t drawMicros;       // 绘制耗时（不含 flush）
+  uint32_t flushMicros;      // flush 耗时
+
+  uint32_t totalMicros() const { return drawMicros + flushMicros; }
+  float nsPerPixel() const;  // 总耗时 / 像素数（内核按绘制像素，场景按推送像素）
+  float fps() const;         // 帧数 / 总耗时
+};
+
+/**
+ * 显示管线基准测试
+ * 在主机和设备上运行同一组固定负载：填充/复制/缩放/清屏/刷新内核，
+ * 以及演示界面、贪吃蛇、心跳动画，输出每像素耗时、每帧推送像素、
+ * 地址窗口次数和帧率
+ */
+class DisplayBenchmark {
+public:
+  DisplayBenchmark(DisplayManager* display);
+
+  // 设置示例图片/动画（来自 ExampleImages.h，未设置的负载会被跳过）
+  void setAssets(const ImageData* smallIcon, const ImageData* largeIcon,
+                 Animation* animation);
+
+  // 运行全部负载并通过串口输出结果
+  bool runAll(BufferMode mode = BUFFER_MODE_SINGLE);
+
+  // 单项运行（主机端用于在每项前后读取 SPI 统计）
+  uint8_t getWorkloadCount() const;
+  const char* getWorkloadName(uint8_t index) const;
+  bool runWorkload(uint8_t index, BenchResult& result);
+
+  // 切换/恢复缓冲模式
+  bool prepare(BufferMode mode);
+  void restore();
+
+  static void printHeader();
+  static void printResult(const BenchResult& result);
+
+private:
+  DisplayManager* pDisplay;
+  const ImageData* smallIcon;
+  const ImageData* largeIcon;
+  Animation* animation;
+  BufferMode savedMode;
+  bool savedAutoFlush;
+
+  typedef void (DisplayBenchmark::*WorkloadFunc)(BenchResult& result);
+  struct Workload {
+    const char* name;
+    WorkloadFunc func;
+    bool needsBuffer;  // 仅在缓冲模式下有意义
+  };
+  static const Workload workloads[];
+
+  // 等待时间（动画帧间隔等）不计入耗时
+  uint32_t idleMicros;
+  void idle(uint32_t ms);
+
+  // 内核负载
+  void benchClear(BenchResult& result);
+  void benchClearColor(BenchResult& result);
+  void benchFillLines(BenchResult& result);
+  void benchFillSmall(BenchResult& result);
+  void benchFillLarge(BenchResult& result);
+  void benchBlit(BenchResult& result);
+  void benchScale(BenchResult& result);
+  void benchScaleBilinear(BenchResult& result);
+  void benchFlushFull(BenchResult& result);
+
+  // 场景负载
+  void benchTextDemo(BenchResult& result);
+  void benchStatusScreen(BenchResult& result);
+  void benchClockScreen(BenchResult& result);
+  void benchImageDemo(BenchResult& result);
+  void benchGraphicsDemo(BenchResult& result);
+  void benchSnake(BenchResult& result);
+  void benchHeartAnimation(BenchResult& result);
+};
+
+#endif // DISPLAY_BENCHMARK_H
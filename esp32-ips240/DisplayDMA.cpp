@@ -0,0 +1,211 @@
+#include "DisplayDMA.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <esp_heap_caps.h>
+#include <driver/gpio.h>
+
+// Adafruit 库的 SPIClass(FSPI) 使用的同一个外设；会话期间由 IDF 驱动独占
+#define DISPLAY_DMA_HOST SPI2_HOST
+
+#define ST7789_CASET  0x2A
+#define ST7789_RASET  0x2B
+#define ST7789_RAMWR  0x2C
+
+// 传输前设置 DC：transaction.user 为 0 是命令，1 是数据
+static int8_t dmaPinDC = -1;
+
+static void IRAM_ATTR dmaPreTransfer(spi_transaction_t* t) {
+  gpio_set_level((gpio_num_t)dmaPinDC, (int)(intptr_t)t->user);
+}
+
+DisplayDMA::DisplayDMA() {
+  ready = false;
+  busAcquired = false;
+  inFlight = 0;
+  completedCount = 0;
+  pTFT = nullptr;
+  pSPI = nullptr;
+  pinSCLK = pinMOSI = pinCS = pinDC = -1;
+  frequency = 0;
+  maxTransfer = 0;
+  device = nullptr;
+  nextTransaction = 0;
+  memset(transactions, 0, sizeof(transactions));
+}
+
+DisplayDMA::~DisplayDMA() {
+  end();
+}
+
+bool DisplayDMA::begin(Adafruit_ST7789* tft, SPIClass* spi, int8_t sclk,
+                       int8_t mosi, int8_t cs, int8_t dc,
+                       uint32_t spiFrequency, uint32_t maxTransferBytes) {
+  if (ready) return true;
+  if (tft == nullptr || spi == nullptr || dc < 0) return false;
+  pTFT = tft;
+  pSPI = spi;
+  pinSCLK = sclk;
+  pinMOSI = mosi;
+  pinCS = cs;
+  pinDC = dc;
+  frequency = spiFrequency;
+  maxTransfer = maxTransferBytes;
+  ready = true;
+  return true;
+}
+
+void DisplayDMA::end() {
+  if (!ready) return;
+  releaseBus();
+  ready = false;
+}
+
+bool DisplayDMA::acquireBus() {
+  if (!ready) return false;
+  if (busAcquired) return true;
+
+  // 先让 Arduino HAL 放开 SPI2 和引脚，IDF 驱动随后完整地重新配置外设
+  pSPI->end();
+
+  spi_bus_config_t busConfig = {};
+  busConfig.mosi_io_num = pinMOSI;
+  busConfig.miso_io_num = -1;
+  busConfig.sclk_io_num = pinSCLK;
+  busConfig.quadwp_io_num = -1;
+  busConfig.quadhd_io_num = -1;
+  busConfig.max_transfer_sz = maxTransfer;
+
+  esp_err_t err = spi_bus_initialize(DISPLAY_DMA_HOST, &busConfig,
+                                     SPI_DMA_CH_AUTO);
+  if (err != ESP_OK) {
+    Serial.printf("DMA: spi_bus_initialize failed (%d)\n", err);
+    restoreArduinoBus();
+    return false;
+  }
+
+  spi_device_interface_config_t devConfig = {};
+  devConfig.mode = 3;                  // 与 tft->init(..., SPI_MODE3) 一致
+  devConfig.clock_speed_hz = frequency;
+  devConfig.spics_io_num = pinCS;      // 会话期间 CS 由 IDF 设备控制
+  devConfig.queue_size = MAX_IN_FLIGHT;
+  devConfig.flags = SPI_DEVICE_NO_DUMMY;
+  devConfig.pre_cb = dmaPreTransfer;
+
+  dmaPinDC = pinDC;
+  err = spi_bus_add_device(DISPLAY_DMA_HOST, &devConfig, &device);
+  if (err != ESP_OK) {
+    Serial.printf("DMA: spi_bus_add_device failed (%d)\n", err);
+    spi_bus_free(DISPLAY_DMA_HOST);
+    restoreArduinoBus();
+    return false;
+  }
+
+  busAcquired = true;
+  return true;
+}
+
+void DisplayDMA::releaseBus() {
+  if (!busAcquired) return;
+  wait();
+  spi_bus_remove_device(device);
+  device = nullptr;
+  spi_bus_free(DISPLAY_DMA_HOST);
+  busAcquired = false;
+  restoreArduinoBus();
+}
+
+// 与 DisplayManager::begin 相同的 SPIClass 配置；CS 交还给 Adafruit 的 GPIO 控制
+void DisplayDMA::restoreArduinoBus() {
+  pSPI->begin(pinSCLK, -1, pinMOSI, pinCS);
+  pSPI->setFrequency(frequency);
+  if (pinCS >= 0) {
+    pinMode(pinCS, OUTPUT);
+    digitalWrite(pinCS, HIGH);
+  }
+  pinMode(pinDC, OUTPUT);
+}
+
+// 命令字节（DC 低）+ 参数（DC 高），阻塞发送
+void DisplayDMA::sendCommand(uint8_t command, const uint8_t* data,
+                             uint8_t length) {
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.flags = SPI_TRANS_USE_TXDATA;
+  t.length = 8;
+  t.tx_data[0] = command;
+  t.user = (void*)0;
+  spi_device_polling_transmit(device, &t);
+
+  if (length == 0) return;
+  memset(&t, 0, sizeof(t));
+  t.flags = SPI_TRANS_USE_TXDATA;
+  t.length = length * 8;
+  memcpy(t.tx_data, data, length);
+  t.user = (void*)1;
+  spi_device_polling_transmit(device, &t);
+}
+
+void DisplayDMA::setWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  if (!busAcquired) return;
+  // 轮询传输不能与排队的传输交错
+  wait();
+
+  uint16_t x1 = x + w - 1;
+  uint16_t y1 = y + h - 1;
+  const uint8_t columns[4] = {
+    (uint8_t)(x >> 8), (uint8_t)x, (uint8_t)(x1 >> 8), (uint8_t)x1
+  };
+  const uint8_t rows[4] = {
+    (uint8_t)(y >> 8), (uint8_t)y, (uint8_t)(y1 >> 8), (uint8_t)y1
+  };
+  sendCommand(ST7789_CASET, columns, sizeof(columns));
+  sendCommand(ST7789_RASET, rows, sizeof(rows));
+  sendCommand(ST7789_RAMWR, nullptr, 0);
+}
+
+uint16_t* DisplayDMA::allocBuffer(size_t bytes) {
+  return (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_DMA);
+}
+
+void DisplayDMA::freeBuffer(uint16_t* buffer) {
+  heap_caps_free(buffer);
+}
+
+bool DisplayDMA::queue(const uint16_t* data, uint32_t pixelCount) {
+  if (!busAcquired || inFlight >= MAX_IN_FLIGHT) return false;
+
+  spi_transaction_t& t = transactions[nextTransaction];
+  memset(&t, 0, sizeof(t));
+  t.length = pixelCount * 16;  // 位数
+  t.tx_buffer = data;
+  t.user = (void*)1;           // 像素数据
+
+  if (spi_device_queue_trans(device, &t, portMAX_DELAY) != ESP_OK) {
+    return false;
+  }
+
+  nextTransaction = (nextTransaction + 1) % MAX_IN_FLIGHT;
+  inFlight++;
+  return true;
+}
+
+void DisplayDMA::poll() {
+  spi_transaction_t* result;
+  while (inFlight > 0 &&
+         spi_device_get_trans_result(device, &result, 0) == ESP_OK) {
+    inFlight--;
+    completedCount++;
+  }
+}
+
+void DisplayDMA::wait() {
+  spi_transaction_t* result;
+  while (inFlight > 0 &&
+         spi_device_get_trans_result(device, &result, portMAX_DELAY) == ESP_OK) {
+    inFlight--;
+    completedCount++;
+  }
+}
+
+#endif // ARDUINO_ARCH_ESP32
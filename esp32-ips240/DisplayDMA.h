@@ -0,0 +1,98 @@
+#ifndef DISPLAY_DMA_H
+#define DISPLAY_DMA_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Adafruit_ST7789.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <driver/spi_master.h>
+#endif
+
+/**
+ * 屏幕像素 DMA 传输
+ *
+ * Adafruit 库通过 Arduino SPIClass 驱动 FSPI（SPI2），而 Arduino 的 SPI HAL
+ * 不向 IDF 的 spi_master 驱动登记，两者不能同时操作同一组寄存器和引脚。
+ * 因此 DMA 以"会话"独占总线：acquireBus() 先结束 SPIClass，再在 SPI2 上初始化
+ * IDF 总线并挂载设备；会话中的地址窗口命令和像素都经 IDF 设备发送（CS 由设备
+ * 控制，DC 在传输前按命令 / 数据设置）；releaseBus() 释放 IDF 总线并恢复
+ * SPIClass，之后 Adafruit 的阻塞写入重新使用自己的时钟和模式。
+ *
+ * - 数据必须是大端 RGB565，且位于 DMA 可访问的内存（使用 allocBuffer 分配）
+ * - 同时最多 MAX_IN_FLIGHT 个传输在途，完成的传输由 poll()/wait() 回收
+ * - 窗口坐标不加面板偏移：240x240 面板在旋转 0 时 Adafruit 的偏移为 0
+ * - 主机端由 host/mock/DisplayDMA.cpp 按 SPI 时钟模拟完成时间
+ */
+class DisplayDMA {
+public:
+  static const uint8_t MAX_IN_FLIGHT = 2;
+
+  DisplayDMA();
+  ~DisplayDMA();
+
+  // 记录总线配置（不占用总线）
+  bool begin(Adafruit_ST7789* tft, SPIClass* spi, int8_t sclk, int8_t mosi,
+             int8_t cs, int8_t dc, uint32_t spiFrequency,
+             uint32_t maxTransferBytes);
+  void end();
+  bool isReady() const { return ready; }
+
+  // DMA 会话：独占 SPI2（失败时 SPIClass 保持可用并返回 false）
+  bool acquireBus();
+  // 等待传输完成，释放 SPI2 并恢复 SPIClass
+  void releaseBus();
+  bool hasBus() const { return busAcquired; }
+
+  // 设置地址窗口并开始写显存（等待在途传输完成后阻塞发送）
+  void setWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+  // DMA 可访问的缓冲区
+  uint16_t* allocBuffer(size_t bytes);
+  void freeBuffer(uint16_t* buffer);
+
+  // 排队一次传输（队列满时返回 false）
+  bool queue(const uint16_t* data, uint32_t pixelCount);
+  // 回收已完成的传输（非阻塞）
+  void poll();
+  // 阻塞直到所有传输完成
+  void wait();
+
+  uint8_t getInFlight() const { return inFlight; }
+  uint32_t getCompletedCount() const { return completedCount; }
+
+private:
+  bool ready;
+  bool busAcquired;
+  uint8_t inFlight;
+  uint32_t completedCount;
+  Adafruit_ST7789* pTFT;
+  SPIClass* pSPI;
+  int8_t pinSCLK;
+  int8_t pinMOSI;
+  int8_t pinCS;
+  int8_t pinDC;
+  uint32_t frequency;
+  uint32_t maxTransfer;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  spi_device_handle_t device;
+  spi_transaction_t transactions[MAX_IN_FLIGHT];
+  uint8_t nextTransaction;
+
+  void restoreArduinoBus();
+  void sendCommand(uint8_t command, const uint8_t* data, uint8_t length);
+#else
+  // 主机模拟：按模拟的 SPI 时钟计算每个传输的完成时刻
+  struct PendingTransfer {
+    const uint16_t* data;
+    uint32_t pixelCount;
+    uint64_t doneAt;
+  };
+  PendingTransfer pending[MAX_IN_FLIGHT];
+  uint8_t pendingHead;
+  uint64_t busyUntil;
+#endif
+};
+
+#endif // DISPLAY_DMA_H
@@ -0,0 +1,154 @@
+#include "DisplayList.h"
+#include "BufferAllocator.h"
+
+DisplayList::DisplayList()
+  : commands(nullptr), textPool(nullptr), count(0), textUsed(0), dropped(0),
+    dirtyGroups(0) {
+}
+
+DisplayList::~DisplayList() {
+  end();
+}
+
+bool DisplayList::begin() {
+  if (isReady()) return true;
+
+  // 列表每个条带都要遍历，放在内部 SRAM
+  MemoryRegion region;
+  commands = (DisplayCommand*)BufferAllocator::allocate(
+      MAX_COMMANDS * sizeof(DisplayCommand), BUFFER_PLACE_INTERNAL, &region);
+  textPool = (char*)BufferAllocator::allocate(TEXT_POOL_SIZE,
+                                              BUFFER_PLACE_INTERNAL, &region);
+  if (commands == nullptr || textPool == nullptr) {
+    Serial.println("Failed to allocate display list");
+    end();
+    return false;
+  }
+  clear();
+  return true;
+}
+
+void DisplayList::end() {
+  BufferAllocator::release(commands);
+  BufferAllocator::release(textPool);
+  commands = nullptr;
+  textPool = nullptr;
+  count = 0;
+  textUsed = 0;
+}
+
+bool DisplayList::add(const DisplayCommand& cmd, const char* text) {
+  if (!isReady()) return false;
+
+  if (cmd.opaque) {
+    removeCovered(cmd);
+  }
+
+  size_t length = text != nullptr ? strlen(text) : 0;
+  if (count >= MAX_COMMANDS ||
+      (text != nullptr && textUsed + length + 1 > TEXT_POOL_SIZE)) {
+    if (dropped++ == 0) {
+      Serial.println("Warning: display list full, command dropped");
+    }
+    return false;
+  }
+
+  DisplayCommand& added = commands[count++];
+  added = cmd;
+  added.textOffset = NO_TEXT;
+  added.textLength = length;
+  if (text != nullptr) {
+    memcpy(textPool + textUsed, text, length + 1);
+    added.textOffset = textUsed;
+    textUsed += length + 1;
+  }
+
+  markDirty(cmd.left, cmd.top, cmd.right, cmd.bottom);
+  return true;
+}
+
+void DisplayList::clear() {
+  count = 0;
+  textUsed = 0;
+}
+
+const char* DisplayList::getText(const DisplayCommand& cmd) const {
+  return cmd.textOffset != NO_TEXT ? textPool + cmd.textOffset : "";
+}
+
+void DisplayList::removeCovered(const DisplayCommand& cover) {
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    const DisplayCommand& cmd = commands[i];
+    bool covered = cmd.left >= cover.left && cmd.right <= cover.right &&
+                   cmd.top >= cover.top && cmd.bottom <= cover.bottom;
+    if (!covered) {
+      commands[kept++] = cmd;
+    }
+  }
+
+  if (kept != count) {
+    count = kept;
+    compactText();
+  }
+}
+
+void DisplayList::compactText() {
+  // 文字按记录顺序存放，向前移动不会覆盖尚未移动的内容
+  uint16_t used = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    DisplayCommand& cmd = commands[i];
+    if (cmd.textOffset == NO_TEXT) continue;
+    memmove(textPool + used, textPool + cmd.textOffset, cmd.textLength + 1);
+    cmd.textOffset = used;
+    used += cmd.textLength + 1;
+  }
+  textUsed = used;
+}
+
+void DisplayList::markDirty(int16_t left, int16_t top, int16_t right,
+                            int16_t bottom) {
+  if (left >= right || top >= bottom || bottom <= 0) return;
+
+  int16_t first = max(top, (int16_t)0) / DIRTY_LINES;
+  int16_t last = min((bottom - 1) / DIRTY_LINES, MAX_DIRTY_GROUPS - 1);
+  for (int16_t g = first; g <= last; g++) {
+    uint32_t bit = 1UL << g;
+    if (dirtyGroups & bit) {
+      dirtyLeft[g] = min(dirtyLeft[g], left);
+      dirtyRight[g] = max(dirtyRight[g], right);
+    } else {
+      dirtyLeft[g] = left;
+      dirtyRight[g] = right;
+      dirtyGroups |= bit;
+    }
+  }
+}
+
+bool DisplayList::takeDirty(int16_t rowTop, int16_t rowBottom, int16_t& left,
+                            int16_t& top, int16_t& right, int16_t& bottom) {
+  bool found = false;
+  int16_t last = min((rowBottom - 1) / DIRTY_LINES, MAX_DIRTY_GROUPS - 1);
+  for (int16_t g = rowTop / DIRTY_LINES; g <= last; g++) {
+    uint32_t bit = 1UL << g;
+    if (!(dirtyGroups & bit)) continue;
+    dirtyGroups &= ~bit;
+
+    if (!found) {
+      left = dirtyLeft[g];
+      right = dirtyRight[g];
+      top = g * DIRTY_LINES;
+      found = true;
+    } else {
+      left = min(left, dirtyLeft[g]);
+      right = max(right, dirtyRight[g]);
+    }
+    bottom = min((int16_t)((g + 1) * DIRTY_LINES), rowBottom);
+  }
+  return found;
+}
+
+size_t DisplayList::getMemoryUsage() const {
+  if (!isReady()) return 0;
+  return MAX_COMMANDS * sizeof(DisplayCommand) + TEXT_POOL_SIZE;
+}
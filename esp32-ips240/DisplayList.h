@@ -0,0 +1,99 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <Arduino.h>
+
+// 显示列表中的绘制命令
+enum DisplayOp : uint8_t {
+  DISPLAY_OP_CLEAR,          // 整屏填充
+  DISPLAY_OP_TEXT,           // 文字（居中文字记录为算好 x 的普通文字）
+  DISPLAY_OP_TEXT_BOX,       // 文字框
+  DISPLAY_OP_RECT,
+  DISPLAY_OP_FILL_RECT,
+  DISPLAY_OP_CIRCLE,
+  DISPLAY_OP_FILL_CIRCLE,
+  DISPLAY_OP_LINE,
+  DISPLAY_OP_IMAGE,          // RGB565 图片
+  DISPLAY_OP_ENCODED_IMAGE,  // 编码图片（调色板 / RLE）
+  DISPLAY_OP_IMAGE_SCALED,
+  DISPLAY_OP_BITMAP          // 1 位位图（前景色 + 背景色）
+};
+
+struct DisplayCommand {
+  const void* data;        // 图片像素 / 编码数据 / 位图
+  const uint16_t* palette; // 编码图片的调色板
+  int16_t x, y;            // 位置（线段为起点，圆为圆心）
+  int16_t w, h;            // 尺寸（线段为终点，圆的半径在 w）
+  uint16_t color;          // 颜色（文字框为文字颜色，位图为前景色）
+  uint16_t color2;         // 文字框边框颜色 / 位图背景色
+  uint16_t srcWidth;       // 图片源尺寸
+  uint16_t srcHeight;
+  uint16_t textOffset;     // 文字在字符池中的位置
+  uint16_t textLength;
+  int16_t left, top, right, bottom;  // 屏幕上的外接矩形（right / bottom 不含）
+  DisplayOp op;
+  uint8_t param;           // 字号；缩放图片为 ScaleFilter；编码图片为 ImageEncoding
+  bool opaque;             // 外接矩形内的像素全部被覆盖
+};
+
+/**
+ * 绘制命令列表（条带渲染）
+ *
+ * BUFFER_MODE_STRIP 只有几十行高的条带缓冲，绘制调用先记录在这里，
+ * 刷新时对每个条带重放与它相交的命令。文字复制到字符池，图片只记录数据指针
+ * （数据须保持有效）。新的不透明命令完全盖住的旧命令被丢弃，所以反复重绘
+ * 同一区域（动画帧、时钟数字）不会让列表增长；列表满时新命令被丢弃并给出警告
+ */
+class DisplayList {
+public:
+  static const uint8_t MAX_COMMANDS = 48;
+  static const uint16_t TEXT_POOL_SIZE = 768;
+  static const uint16_t NO_TEXT = 0xFFFF;  // 命令没有文字时的 textOffset
+
+  // 变化范围按 8 行一组记录每组的左右边界（最多 256 行）
+  static const uint8_t DIRTY_LINES = 8;
+  static const uint8_t MAX_DIRTY_GROUPS = 32;
+
+  DisplayList();
+  ~DisplayList();
+
+  // 分配命令与字符池（首次记录时由 DisplayManager 调用）
+  bool begin();
+  void end();
+  bool isReady() const { return commands != nullptr; }
+
+  // 记录一条命令；外接矩形与 opaque 由调用者填写
+  bool add(const DisplayCommand& cmd, const char* text = nullptr);
+  void clear();
+
+  uint8_t getCount() const { return count; }
+  const DisplayCommand& get(uint8_t index) const { return commands[index]; }
+  // 命令的文字（以 '\0' 结尾）
+  const char* getText(const DisplayCommand& cmd) const;
+
+  // 自上次渲染以来变化的屏幕范围
+  void markDirty(int16_t left, int16_t top, int16_t right, int16_t bottom);
+  bool isDirty() const { return dirtyGroups != 0; }
+  // 取出 [rowTop, rowBottom) 内的变化范围并清除（行边界须为 DIRTY_LINES 的倍数）
+  bool takeDirty(int16_t rowTop, int16_t rowBottom, int16_t& left,
+                 int16_t& top, int16_t& right, int16_t& bottom);
+
+  size_t getMemoryUsage() const;
+  uint32_t getDroppedCount() const { return dropped; }
+
+private:
+  DisplayCommand* commands;
+  char* textPool;
+  uint8_t count;
+  uint16_t textUsed;
+  uint32_t dropped;
+
+  uint32_t dirtyGroups;  // 每组一位
+  int16_t dirtyLeft[MAX_DIRTY_GROUPS];
+  int16_t dirtyRight[MAX_DIRTY_GROUPS];
+
+  void removeCovered(const DisplayCommand& cover);
+  void compactText();
+};
+
+#endif // DISPLAY_LIST_H
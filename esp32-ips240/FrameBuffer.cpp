@@ -1,14 +1,93 @@
 #include "FrameBuffer.h"
+#include "DisplayDMA.h"
+
+// 按 32 位一次读写两个像素（允许与 uint16_t 别名）
+typedef uint32_t __attribute__((__may_alias__)) PixelPair;
+
+// 填充连续的 count 个像素
+static inline void fillSpan(uint16_t* dst, uint16_t color, uint32_t count) {
+  // 高低字节相同的颜色（黑、白等）直接 memset
+  if ((color >> 8) == (color & 0xFF)) {
+    memset(dst, color & 0xFF, count * sizeof(uint16_t));
+    return;
+  }
+  if (count == 0) return;
+
+  // 对齐到 4 字节后每次写两个像素，循环展开为 8 像素
+  if ((uintptr_t)dst & 3) {
+    *dst++ = color;
+    count--;
+  }
+  uint32_t pair = ((uint32_t)color << 16) | color;
+  PixelPair* p = (PixelPair*)dst;
+  uint32_t pairs = count >> 1;
+  uint32_t i = 0;
+  for (; i + 4 <= pairs; i += 4) {
+    p[i] = pair;
+    p[i + 1] = pair;
+    p[i + 2] = pair;
+    p[i + 3] = pair;
+  }
+  for (; i < pairs; i++) {
+    p[i] = pair;
+  }
+  if (count & 1) {
+    dst[count - 1] = color;
+  }
+}
+
+// 读写调色板索引（4 位时高半字节为偶数列）
+static inline uint8_t readIndex(const uint8_t* row, int16_t x, uint8_t bits) {
+  if (bits == 8) return row[x];
+  return (x & 1) ? (row[x >> 1] & 0x0F) : (row[x >> 1] >> 4);
+}
+
+static inline void writeIndex(uint8_t* row, int16_t x, uint8_t bits,
+                              uint8_t index) {
+  if (bits == 8) {
+    row[x] = index;
+  } else if (x & 1) {
+    row[x >> 1] = (row[x >> 1] & 0xF0) | index;
+  } else {
+    row[x >> 1] = (row[x >> 1] & 0x0F) | (index << 4);
+  }
+}
+
+// 4 位默认调色板：ST77XX 常用色 + 灰阶与暗色
+static const uint16_t DEFAULT_PALETTE16[16] = {
+  0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x07FF, 0xF81F, 0xFFE0,
+  0xFC00, 0x7BEF, 0xC618, 0x000F, 0x03E0, 0x7800, 0x780F, 0x7BE0
+};
 
 FrameBuffer::FrameBuffer(uint16_t w, uint16_t h)
-  : width(w), height(h), mode(BUFFER_MODE_DIRECT),
+  : width(w), height(h), panelHeight(h), originY(0), mode(BUFFER_MODE_DIRECT),
     frontBuffer(nullptr), backBuffer(nullptr),
-    dirtyCount(0), fullScreenDirty(false),
-    lastFlushTime(0), flushCount(0) {
+    indexBack(nullptr), indexFront(nullptr), lineCache(nullptr),
+    indexBits(0), indexStride(0), paletteSize(0), paletteRGB332(false),
+    paletteCustom(false), placement(BUFFER_PLACE_AUTO), backRegion(MEMORY_NONE),
+    frontRegion(MEMORY_NONE), cacheRegion(MEMORY_NONE),
+    dirtyCount(0), regionBudget(DEFAULT_REGION_BUDGET),
+    pendingMarkedPixels(0), batchDepth(0), batchX1(0), batchY1(0),
+    batchX2(0), batchY2(0), dirtyTracking(DIRTY_TRACK_REGIONS),
+    tilesX((w + TILE_SIZE - 1) / TILE_SIZE),
+    tilesY((h + TILE_SIZE - 1) / TILE_SIZE), tilesDirty(false),
+    fullScreenDirty(false), diffFlush(true), frontValid(false),
+    lastFlushTime(0), flushCount(0),
+    asyncDMA(nullptr), nextLineBuffer(0),
+    asyncRegionCount(0), asyncRegionIndex(0), asyncHasTiles(false), asyncRow(0),
+    asyncNeedWindow(false), asyncActive(false),
+    asyncStartMicros(0) {
+  lineBuffers[0] = nullptr;
+  lineBuffers[1] = nullptr;
+  memset(dirtyTiles, 0, sizeof(dirtyTiles));
+  memset(staleTiles, 0, sizeof(staleTiles));
+  memset(colorCache, 0, sizeof(colorCache));
+  resetFlushStats();
 }
 
 FrameBuffer::~FrameBuffer() {
   freeBuffers();
+  freeLineBuffers();
 }
 
 bool FrameBuffer::begin(BufferMode bufferMode) {
@@ -28,38 +107,93 @@ void FrameBuffer::end() {
 bool FrameBuffer::allocateBuffers() {
   freeBuffers();
 
+  bool indexed = mode == BUFFER_MODE_INDEXED8 || mode == BUFFER_MODE_INDEXED4;
+  BufferPlacement backPlacement = placement;
+  if (mode == BUFFER_MODE_STRIP) {
+    // 条带很小，默认放内部 SRAM，直接被 SPI / DMA 读取
+    height = min((uint16_t)STRIP_LINES, panelHeight);
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    if (backPlacement == BUFFER_PLACE_AUTO) backPlacement = BUFFER_PLACE_INTERNAL;
+  }
+
   size_t bufferSize = width * height * sizeof(uint16_t);
+  if (indexed) {
+    indexBits = mode == BUFFER_MODE_INDEXED8 ? 8 : 4;
+    indexStride = ((uint32_t)width * indexBits + 7) / 8;
+    bufferSize = (size_t)indexStride * height;
+  }
 
   // 分配后台缓冲（必需）
-  backBuffer = (uint16_t*)malloc(bufferSize);
-  if (backBuffer == nullptr) {
+  void* back = BufferAllocator::allocate(bufferSize, backPlacement, &backRegion);
+  if (back == nullptr) {
     Serial.println("Failed to allocate back buffer");
+    indexBits = 0;
     return false;
   }
 
-  // 双缓冲模式需要前台缓冲
-  if (mode == BUFFER_MODE_DOUBLE) {
-    frontBuffer = (uint16_t*)malloc(bufferSize);
-    if (frontBuffer == nullptr) {
+  // 双缓冲需要前台缓冲（索引模式用于差分刷新，失败时每次发送全部脏区域）
+  void* front = nullptr;
+  if (indexed || mode == BUFFER_MODE_DOUBLE) {
+    front = BufferAllocator::allocate(bufferSize, placement, &frontRegion);
+    if (front == nullptr && indexed) {
+      Serial.println("Failed to allocate front index buffer, diff flush disabled");
+    } else if (front == nullptr) {
       Serial.println("Failed to allocate front buffer, fallback to single");
       mode = BUFFER_MODE_SINGLE;
     }
   }
 
+  if (indexed) {
+    indexBack = (uint8_t*)back;
+    indexFront = (uint8_t*)front;
+  } else {
+    backBuffer = (uint16_t*)back;
+    frontBuffer = (uint16_t*)front;
+  }
+
+  // 行缓存：索引模式用于展开调色板，后台缓冲在 PSRAM 时用于中转
+  if (indexed || backRegion == MEMORY_PSRAM) {
+    lineCache = (uint16_t*)BufferAllocator::allocateLineCache(
+        width * ASYNC_LINES * sizeof(uint16_t), &cacheRegion);
+    if (lineCache == nullptr && indexed) {
+      Serial.println("Failed to allocate line cache");
+      freeBuffers();
+      return false;
+    }
+  }
+
+  if (indexed && (!paletteCustom || paletteSize > (1u << indexBits))) {
+    setDefaultPalette();
+  }
+
+  frontValid = false;
+  memset(staleTiles, 0, sizeof(staleTiles));
   clear(0x0000);
-  Serial.printf("FrameBuffer allocated: %d KB\n", getMemoryUsage() / 1024);
+  Serial.printf("FrameBuffer allocated: %d KB (back: %s, front: %s, line cache: %s)\n",
+                getMemoryUsage() / 1024, BufferAllocator::regionName(backRegion),
+                BufferAllocator::regionName(frontRegion),
+                BufferAllocator::regionName(cacheRegion));
   return true;
 }
 
 void FrameBuffer::freeBuffers() {
-  if (backBuffer) {
-    free(backBuffer);
-    backBuffer = nullptr;
-  }
-  if (frontBuffer) {
-    free(frontBuffer);
-    frontBuffer = nullptr;
-  }
+  waitFlush();  // DMA 可能仍在读取后台缓冲
+
+  BufferAllocator::release(backBuffer);
+  BufferAllocator::release(frontBuffer);
+  BufferAllocator::release(indexBack);
+  BufferAllocator::release(indexFront);
+  BufferAllocator::release(lineCache);
+  backBuffer = nullptr;
+  frontBuffer = nullptr;
+  indexBack = nullptr;
+  indexFront = nullptr;
+  lineCache = nullptr;
+  backRegion = frontRegion = cacheRegion = MEMORY_NONE;
+  indexBits = 0;
+  height = panelHeight;
+  tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+  originY = 0;
 }
 
 bool FrameBuffer::setMode(BufferMode newMode) {
@@ -79,6 +213,12 @@ bool FrameBuffer::setMode(BufferMode newMode) {
 void FrameBuffer::setPixel(int16_t x, int16_t y, uint16_t color) {
   if (!isValidCoord(x, y)) return;
 
+  if (indexBack != nullptr) {
+    writeIndex(&indexBack[y * indexStride], x, indexBits, colorToIndex(color));
+    markDirty(x, y, 1, 1);
+    return;
+  }
+
   if (mode == BUFFER_MODE_DIRECT || backBuffer == nullptr) {
     return;  // 直接模式在flush时由调用者处理
   }
@@ -88,7 +228,12 @@ void FrameBuffer::setPixel(int16_t x, int16_t y, uint16_t color) {
 }
 
 uint16_t FrameBuffer::getPixel(int16_t x, int16_t y) const {
-  if (!isValidCoord(x, y) || backBuffer == nullptr) {
+  if (!isValidCoord(x, y)) return 0x0000;
+
+  if (indexBack != nullptr) {
+    return palette[readIndex(&indexBack[y * indexStride], x, indexBits)];
+  }
+  if (backBuffer == nullptr) {
     return 0x0000;
   }
 
@@ -97,20 +242,36 @@ uint16_t FrameBuffer::getPixel(int16_t x, int16_t y) const {
 
 void FrameBuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
                             uint16_t color) {
-  if (backBuffer == nullptr) return;
+  if (!hasPixels()) return;
 
-  // 边界裁剪
+  // 边界裁剪（与 Adafruit_GFX 一致，允许负的宽高）
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
   if (x < 0) { w += x; x = 0; }
   if (y < 0) { h += y; y = 0; }
   if (x + w > width) w = width - x;
   if (y + h > height) h = height - y;
   if (w <= 0 || h <= 0) return;
 
-  // 批量填充
-  for (int16_t j = 0; j < h; j++) {
-    uint16_t* row = &backBuffer[(y + j) * width + x];
-    for (int16_t i = 0; i < w; i++) {
-      row[i] = color;
+  if (indexBack != nullptr) {
+    uint8_t index = colorToIndex(color);
+    for (int16_t j = 0; j < h; j++) {
+      fillIndexRow(x, y + j, w, index);
+    }
+  } else if (w == width) {
+    // 整行宽度的区域在内存中连续，一次填充
+    fillSpan(&backBuffer[y * width], color, (uint32_t)w * h);
+  } else if (w < 8) {
+    // 窄区域（竖线、字体像素）逐像素写比调用内核更快
+    uint16_t* row = &backBuffer[y * width + x];
+    for (int16_t j = 0; j < h; j++, row += width) {
+      for (int16_t i = 0; i < w; i++) {
+        row[i] = color;
+      }
+    }
+  } else {
+    for (int16_t j = 0; j < h; j++) {
+      fillSpan(&backBuffer[(y + j) * width + x], color, w);
     }
   }
 
@@ -119,18 +280,23 @@ void FrameBuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
 
 void FrameBuffer::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
                             const uint16_t* data) {
-  if (backBuffer == nullptr || data == nullptr) return;
+  if (!hasPixels() || data == nullptr) return;
 
-  // 边界裁剪
+  // 边界裁剪（源数据行距保持原始宽度）
+  int16_t stride = w;
   if (x < 0) { data += -x; w += x; x = 0; }
-  if (y < 0) { data += (-y * w); h += y; y = 0; }
+  if (y < 0) { data += (-y * stride); h += y; y = 0; }
   if (x + w > width) w = width - x;
   if (y + h > height) h = height - y;
   if (w <= 0 || h <= 0) return;
 
   // 批量复制（优化版）
   for (int16_t j = 0; j < h; j++) {
-    memcpy(&backBuffer[(y + j) * width + x], &data[j * w], w * sizeof(uint16_t));
+    if (indexBack != nullptr) {
+      writeIndexRow(x, y + j, w, &data[j * stride]);
+    } else {
+      memcpy(&backBuffer[(y + j) * width + x], &data[j * stride], w * sizeof(uint16_t));
+    }
   }
 
   markDirty(x, y, w, h);
@@ -138,55 +304,67 @@ void FrameBuffer::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
 
 void FrameBuffer::drawRectScaled(int16_t x, int16_t y, int16_t w, int16_t h,
                                   const uint16_t* srcData, uint16_t srcW,
-                                  uint16_t srcH) {
-  if (backBuffer == nullptr || srcData == nullptr) return;
+                                  uint16_t srcH, ScaleFilter filter) {
+  if (!hasPixels() || srcData == nullptr || w <= 0 || h <= 0) return;
 
-  // 最近邻插值缩放（批量版本）
-  float xRatio = (float)srcW / w;
-  float yRatio = (float)srcH / h;
+  // 缩放器先裁剪到缓冲区，逐行写入可见部分
+  ImageScaler scaler;
+  if (!scaler.begin(srcData, srcW, srcH, x, y, w, h, width, height, filter)) {
+    return;
+  }
 
-  for (int16_t j = 0; j < h; j++) {
-    if (y + j < 0 || y + j >= height) continue;
+  int16_t visibleW = scaler.getWidth();
+  int16_t visibleH = scaler.getHeight();
 
-    uint16_t srcY = (uint16_t)(j * yRatio);
-    uint16_t* destRow = &backBuffer[(y + j) * width + x];
-    const uint16_t* srcRow = &srcData[srcY * srcW];
+  if (indexBack != nullptr) {
+    // 先缩放到 RGB565 行缓冲再转换为索引；同一源行时缓冲内容不变
+    uint16_t rowBuffer[ImageScaler::MAX_WIDTH];
+    for (int16_t j = 0; j < visibleH; j++) {
+      scaler.scaleRow(j, rowBuffer);
+      writeIndexRow(scaler.getX(), scaler.getY() + j, visibleW, rowBuffer);
+    }
+    markDirty(scaler.getX(), scaler.getY(), visibleW, visibleH);
+    return;
+  }
 
-    for (int16_t i = 0; i < w; i++) {
-      if (x + i < 0 || x + i >= width) continue;
-      uint16_t srcX = (uint16_t)(i * xRatio);
-      destRow[i] = srcRow[srcX];
+  uint16_t* destRow = &backBuffer[scaler.getY() * width + scaler.getX()];
+  for (int16_t j = 0; j < visibleH; j++, destRow += width) {
+    // 与上一行取自同一源行时直接复制
+    if (!scaler.scaleRow(j, destRow)) {
+      memcpy(destRow, destRow - width, visibleW * sizeof(uint16_t));
     }
   }
 
-  markDirty(x, y, w, h);
+  markDirty(scaler.getX(), scaler.getY(), visibleW, visibleH);
 }
 
 void FrameBuffer::clear(uint16_t color) {
-  if (backBuffer) {
-    uint32_t pixelCount = width * height;
-    for (uint32_t i = 0; i < pixelCount; i++) {
-      backBuffer[i] = color;
-    }
-  }
-
-  if (frontBuffer) {
-    uint32_t pixelCount = width * height;
-    for (uint32_t i = 0; i < pixelCount; i++) {
-      frontBuffer[i] = color;
-    }
+  if (indexBack) {
+    uint8_t index = colorToIndex(color);
+    memset(indexBack, indexBits == 8 ? index : index * 0x11,
+           (size_t)indexStride * height);
+  } else if (backBuffer) {
+    fillSpan(backBuffer, color, (uint32_t)width * height);
   }
 
   fullScreenDirty = true;
   dirtyCount = 0;
+  pendingMarkedPixels += (uint32_t)width * height;
 }
 
 void FrameBuffer::drawFullScreen(const uint16_t* data) {
-  if (backBuffer == nullptr || data == nullptr) return;
+  if (!hasPixels() || data == nullptr) return;
 
-  memcpy(backBuffer, data, width * height * sizeof(uint16_t));
+  if (indexBack != nullptr) {
+    for (int16_t j = 0; j < height; j++) {
+      writeIndexRow(0, j, width, &data[j * width]);
+    }
+  } else {
+    memcpy(backBuffer, data, width * height * sizeof(uint16_t));
+  }
   fullScreenDirty = true;
   dirtyCount = 0;
+  pendingMarkedPixels += (uint32_t)width * height;
 }
 
 // ========== 刷新控制 ==========
@@ -195,34 +373,41 @@ void FrameBuffer::flush(Adafruit_ST7789* tft) {
   if (tft == nullptr) return;
 
   unsigned long startTime = millis();
+  unsigned long startMicros = micros();
 
   if (mode == BUFFER_MODE_DIRECT) {
     // 直接模式不处理，由调用者直接操作tft
     return;
   }
 
-  if (backBuffer == nullptr) return;
+  if (!hasPixels()) return;
+
+  waitFlush();
+
+  beginFlushStats();
+  if (isDiffActive()) {
+    diffDirtyRegions();
+  }
 
   tft->startWrite();
 
   if (fullScreenDirty) {
     // 全屏刷新
-    tft->setAddrWindow(0, 0, width, height);
-    tft->writePixels(backBuffer, width * height);
+    pushRegion(tft, 0, 0, width, height);
     fullScreenDirty = false;
   } else {
+    // 按脏图块的行程发送（DIRTY_TRACK_TILES）
+    DirtyRegion run;
+    while (takeTileRun(dirtyTiles, run)) {
+      pushRegion(tft, run.x, run.y, run.width, run.height);
+    }
+
     // 仅刷新脏区域
     for (uint8_t i = 0; i < dirtyCount; i++) {
       DirtyRegion& region = dirtyRegions[i];
       if (!region.isDirty) continue;
 
-      tft->setAddrWindow(region.x, region.y, region.width, region.height);
-
-      // 逐行传输脏区域
-      for (int16_t y = 0; y < region.height; y++) {
-        uint16_t* row = &backBuffer[(region.y + y) * width + region.x];
-        tft->writePixels(row, region.width);
-      }
+      pushRegion(tft, region.x, region.y, region.width, region.height);
     }
   }
 
@@ -232,21 +417,70 @@ void FrameBuffer::flush(Adafruit_ST7789* tft) {
 
   lastFlushTime = millis() - startTime;
   flushCount++;
+  endFlushStats(startMicros);
 }
 
 void FrameBuffer::flushRegion(Adafruit_ST7789* tft, int16_t x, int16_t y,
                                int16_t w, int16_t h) {
-  if (tft == nullptr || backBuffer == nullptr) return;
+  if (tft == nullptr || !hasPixels()) return;
+
+  waitFlush();
+
+  unsigned long startMicros = micros();
+  beginFlushStats();
 
   tft->startWrite();
-  tft->setAddrWindow(x, y, w, h);
+  pushRegion(tft, x, y, w, h);
+  tft->endWrite();
 
-  for (int16_t j = 0; j < h; j++) {
-    uint16_t* row = &backBuffer[(y + j) * width + x];
-    tft->writePixels(row, w);
+  endFlushStats(startMicros);
+}
+
+void FrameBuffer::pushRegion(Adafruit_ST7789* tft, int16_t x, int16_t y,
+                              int16_t w, int16_t h) {
+  tft->setAddrWindow(x, y + originY, w, h);
+
+  if (indexBack != nullptr) {
+    // 索引经调色板展开到行缓冲，每次发送多行
+    for (int16_t j = 0; j < h; j += ASYNC_LINES) {
+      int16_t rows = min((int16_t)ASYNC_LINES, (int16_t)(h - j));
+      expandRows(x, y + j, w, rows, lineCache, false);
+      tft->writePixels(lineCache, (uint32_t)w * rows);
+    }
+  } else if (lineCache != nullptr) {
+    // 后台缓冲在 PSRAM：先复制到内部 SRAM 的行缓存再发送
+    for (int16_t j = 0; j < h; j += ASYNC_LINES) {
+      int16_t rows = min((int16_t)ASYNC_LINES, (int16_t)(h - j));
+      uint16_t* dst = lineCache;
+      for (int16_t r = 0; r < rows; r++, dst += w) {
+        memcpy(dst, &backBuffer[(y + j + r) * width + x], w * sizeof(uint16_t));
+      }
+      tft->writePixels(lineCache, (uint32_t)w * rows);
+    }
+  } else if (x == 0 && w == width) {
+    // 整行宽度的区域在内存中连续，一次传输
+    tft->writePixels(&backBuffer[y * width], (uint32_t)w * h);
+  } else {
+    // 逐行传输
+    for (int16_t j = 0; j < h; j++) {
+      uint16_t* row = &backBuffer[(y + j) * width + x];
+      tft->writePixels(row, w);
+    }
   }
 
-  tft->endWrite();
+  // 差分刷新：前台缓冲记录面板上的内容
+  if (isDiffActive()) {
+    copyToFront(x, y, w, h);
+  }
+
+  countRegion(w, h);
+}
+
+void FrameBuffer::countRegion(int16_t w, int16_t h) {
+  stats.addrWindowCount++;
+  stats.lastAddrWindows++;
+  stats.pixelsPushed += (uint32_t)w * h;
+  stats.lastPixelsPushed += (uint32_t)w * h;
 }
 
 void FrameBuffer::flushImmediate(Adafruit_ST7789* tft) {
@@ -255,7 +489,184 @@ void FrameBuffer::flushImmediate(Adafruit_ST7789* tft) {
   flush(tft);
 }
 
+// ========== 异步刷新 ==========
+
+bool FrameBuffer::allocateLineBuffers(DisplayDMA* dma) {
+  if (lineBuffers[0] != nullptr && asyncDMA == dma) return true;
+
+  freeLineBuffers();
+
+  size_t bytes = (size_t)width * ASYNC_LINES * sizeof(uint16_t);
+  lineBuffers[0] = dma->allocBuffer(bytes);
+  lineBuffers[1] = dma->allocBuffer(bytes);
+  if (lineBuffers[0] == nullptr || lineBuffers[1] == nullptr) {
+    Serial.println("Failed to allocate DMA line buffers");
+    if (lineBuffers[0]) dma->freeBuffer(lineBuffers[0]);
+    if (lineBuffers[1]) dma->freeBuffer(lineBuffers[1]);
+    lineBuffers[0] = lineBuffers[1] = nullptr;
+    return false;
+  }
+
+  asyncDMA = dma;
+  return true;
+}
+
+void FrameBuffer::freeLineBuffers() {
+  waitFlush();
+
+  if (asyncDMA != nullptr) {
+    if (lineBuffers[0]) asyncDMA->freeBuffer(lineBuffers[0]);
+    if (lineBuffers[1]) asyncDMA->freeBuffer(lineBuffers[1]);
+  }
+  lineBuffers[0] = lineBuffers[1] = nullptr;
+  asyncDMA = nullptr;
+}
+
+bool FrameBuffer::flushAsync(Adafruit_ST7789* tft, DisplayDMA* dma) {
+  if (tft == nullptr) return false;
+  if (mode == BUFFER_MODE_DIRECT || !hasPixels()) return false;
+
+  // 上一次异步刷新尚未完成
+  waitFlush();
+
+  if (dma == nullptr || !dma->isReady() || !allocateLineBuffers(dma)) {
+    flush(tft);  // DMA 不可用时退回同步刷新
+    return false;
+  }
+
+  if (!isDirty()) return true;
+
+  // 本次刷新期间由 DMA 独占 SPI 总线（窗口命令也经 DMA 设备发送）
+  if (!dma->acquireBus()) {
+    flush(tft);
+    return false;
+  }
+
+  asyncStartMicros = micros();
+  beginFlushStats();
+  if (isDiffActive()) {
+    diffDirtyRegions();
+  }
+
+  // 记录本次要发送的区域，之后的绘制会重新标脏
+  asyncHasTiles = false;
+  asyncRegionCount = 0;
+  if (fullScreenDirty) {
+    asyncRegions[0].x = 0;
+    asyncRegions[0].y = 0;
+    asyncRegions[0].width = width;
+    asyncRegions[0].height = height;
+    asyncRegions[0].isDirty = true;
+    asyncRegionCount = 1;
+  } else {
+    memcpy(asyncTiles, dirtyTiles, sizeof(asyncTiles));
+    asyncHasTiles = tilesDirty;
+    for (uint8_t i = 0; i < dirtyCount; i++) {
+      if (dirtyRegions[i].isDirty) {
+        asyncRegions[asyncRegionCount++] = dirtyRegions[i];
+      }
+    }
+  }
+  markClean();
+
+  asyncRegionIndex = 0;
+  asyncRow = 0;
+  asyncNeedWindow = true;
+  asyncActive = true;
+
+  pollFlush();  // 先填满两个行缓冲
+  return true;
+}
+
+void FrameBuffer::pollFlush() {
+  if (!asyncActive) return;
+
+  asyncDMA->poll();
+
+  while (asyncDMA->getInFlight() < DisplayDMA::MAX_IN_FLIGHT) {
+    DirtyRegion& region = asyncCurrent;
+
+    if (asyncNeedWindow) {
+      // 地址窗口命令是阻塞传输，必须等上一区域的 DMA 全部完成
+      if (asyncDMA->getInFlight() > 0) return;
+
+      if (!nextAsyncRegion()) {
+        finishAsyncFlush();
+        return;
+      }
+
+      asyncDMA->setWindow(region.x, region.y + originY, region.width,
+                          region.height);
+      asyncNeedWindow = false;
+      asyncRow = 0;
+      countRegion(region.width, region.height);
+    }
+
+    // 复制若干行到空闲的行缓冲，转换为面板需要的大端字节序
+    int16_t rows = min((int16_t)ASYNC_LINES, (int16_t)(region.height - asyncRow));
+    uint16_t* dst = lineBuffers[nextLineBuffer];
+    if (indexBack != nullptr) {
+      expandRows(region.x, region.y + asyncRow, region.width, rows, dst, true);
+    } else {
+      for (int16_t j = 0; j < rows; j++) {
+        const uint16_t* src = &backBuffer[(region.y + asyncRow + j) * width + region.x];
+        for (int16_t i = 0; i < region.width; i++) {
+          uint16_t c = src[i];
+          *dst++ = (uint16_t)((c << 8) | (c >> 8));
+        }
+      }
+    }
+    if (isDiffActive()) {
+      copyToFront(region.x, region.y + asyncRow, region.width, rows);
+    }
+
+    asyncDMA->queue(lineBuffers[nextLineBuffer], (uint32_t)region.width * rows);
+    nextLineBuffer ^= 1;
+
+    asyncRow += rows;
+    if (asyncRow >= region.height) {
+      asyncNeedWindow = true;
+    }
+  }
+}
+
+bool FrameBuffer::nextAsyncRegion() {
+  if (asyncRegionIndex < asyncRegionCount) {
+    asyncCurrent = asyncRegions[asyncRegionIndex++];
+    return true;
+  }
+  return asyncHasTiles && takeTileRun(asyncTiles, asyncCurrent);
+}
+
+void FrameBuffer::waitFlush() {
+  while (asyncActive) {
+    asyncDMA->wait();
+    pollFlush();
+  }
+}
+
+void FrameBuffer::finishAsyncFlush() {
+  // 交还总线，之后的 Adafruit 阻塞写入重新使用 SPIClass
+  asyncDMA->releaseBus();
+  asyncActive = false;
+
+  lastFlushTime = (micros() - asyncStartMicros) / 1000;
+  flushCount++;
+  endFlushStats(asyncStartMicros);
+}
+
 void FrameBuffer::swapBuffers() {
+  waitFlush();
+
+  if (diffFlush) return;
+
+  if (indexFront != nullptr) {
+    uint8_t* temp = indexFront;
+    indexFront = indexBack;
+    indexBack = temp;
+    return;
+  }
+
   if (mode != BUFFER_MODE_DOUBLE || frontBuffer == nullptr) {
     return;
   }
@@ -265,77 +676,723 @@ void FrameBuffer::swapBuffers() {
   backBuffer = temp;
 }
 
+// ========== 差分刷新 ==========
+
+bool FrameBuffer::isDiffActive() const {
+  return diffFlush && ((mode == BUFFER_MODE_DOUBLE && frontBuffer != nullptr) ||
+                       indexFront != nullptr);
+}
+
+void FrameBuffer::setDiffFlush(bool enabled) {
+  waitFlush();
+  if (enabled && !diffFlush) {
+    frontValid = false;  // 关闭期间前台缓冲没有跟随面板
+  }
+  diffFlush = enabled;
+}
+
+void FrameBuffer::diffDirtyRegions() {
+  if (!frontValid) {
+    // 前台缓冲还不是面板内容的镜像：整屏发送一次后开始差分
+    frontValid = true;
+    memset(staleTiles, 0, sizeof(staleTiles));
+    fullScreenDirty = true;
+    dirtyCount = 0;
+    memset(dirtyTiles, 0, sizeof(dirtyTiles));
+    tilesDirty = false;
+    return;
+  }
+
+  // 取出待比较的区域，清空后用比较结果重新标脏
+  DirtyRegion sources[MAX_DIRTY_REGIONS + 1];
+  uint8_t sourceCount = 0;
+  uint32_t tiles[MAX_TILE_ROWS];
+  bool hasTiles = false;
+
+  if (fullScreenDirty) {
+    sources[0].x = 0;
+    sources[0].y = 0;
+    sources[0].width = width;
+    sources[0].height = height;
+    sources[0].isDirty = true;
+    sourceCount = 1;
+  } else {
+    sourceCount = dirtyCount;
+    memcpy(sources, dirtyRegions, sizeof(DirtyRegion) * dirtyCount);
+    memcpy(tiles, dirtyTiles, sizeof(tiles));
+    hasTiles = tilesDirty;
+  }
+
+  fullScreenDirty = false;
+  dirtyCount = 0;
+  memset(dirtyTiles, 0, sizeof(dirtyTiles));
+  tilesDirty = false;
+
+  for (uint8_t i = 0; i < sourceCount; i++) {
+    diffRegion(sources[i]);
+  }
+  DirtyRegion run;
+  while (hasTiles && takeTileRun(tiles, run)) {
+    diffRegion(run);
+  }
+}
+
+void FrameBuffer::diffRegion(const DirtyRegion& region) {
+  // 连续有差异的行合并成矩形；合并某一行多发送的像素
+  // 超过一个地址窗口的开销时另起一个矩形
+  bool open = false;
+  int16_t rx0 = 0, rx1 = 0, ry0 = 0;
+  int16_t yEnd = region.y + region.height;
+
+  uint32_t regionMask = tileSpanMask(region.x, region.width);
+
+  for (int16_t y = region.y; y < yEnd; y++) {
+    int16_t first, last;
+    bool changed = diffRowSpan(y, region.x, region.x + region.width, first, last);
+
+    // 面板内容未知的图块按有差异处理
+    uint32_t stale = staleTiles[y / TILE_SIZE] & regionMask;
+    if (stale) {
+      int16_t sx0 = max((int)region.x, __builtin_ctz(stale) * TILE_SIZE);
+      int16_t sx1 = min(region.x + region.width, (32 - __builtin_clz(stale)) * TILE_SIZE) - 1;
+      first = changed ? min(first, sx0) : sx0;
+      last = changed ? max(last, sx1) : sx1;
+      changed = true;
+    }
+
+    if (!changed) {
+      if (open) {
+        addDirtyRect(rx0, ry0, rx1 - rx0, y - ry0);
+        open = false;
+      }
+      continue;
+    }
+    last++;  // 转为半开区间
+
+    if (open) {
+      int16_t nx0 = min(rx0, first);
+      int16_t nx1 = max(rx1, last);
+      uint32_t rows = y - ry0;
+      uint32_t merged = (uint32_t)(nx1 - nx0) * (rows + 1);
+      uint32_t separate = (uint32_t)(rx1 - rx0) * rows + (last - first);
+      if (merged - separate <= WINDOW_COST_PIXELS) {
+        rx0 = nx0;
+        rx1 = nx1;
+        continue;
+      }
+      addDirtyRect(rx0, ry0, rx1 - rx0, y - ry0);
+    }
+
+    rx0 = first;
+    rx1 = last;
+    ry0 = y;
+    open = true;
+  }
+
+  if (open) {
+    addDirtyRect(rx0, ry0, rx1 - rx0, yEnd - ry0);
+  }
+}
+
+bool FrameBuffer::diffRowSpan(int16_t y, int16_t x0, int16_t x1,
+                              int16_t& first, int16_t& last) const {
+  if (indexBack != nullptr) {
+    // 索引缓冲：4 位时一次比较两个像素所在的字节
+    const uint8_t* back = &indexBack[y * indexStride];
+    const uint8_t* front = &indexFront[y * indexStride];
+    int16_t x = x0;
+    while (x < x1) {
+      if (indexBits == 4 && !(x & 1) && x + 2 <= x1 && back[x >> 1] == front[x >> 1]) {
+        x += 2;
+      } else if (readIndex(back, x, indexBits) == readIndex(front, x, indexBits)) {
+        x++;
+      } else {
+        break;
+      }
+    }
+    if (x >= x1) return false;
+    first = x;
+
+    int16_t e = x1 - 1;
+    while (e > first && readIndex(back, e, indexBits) == readIndex(front, e, indexBits)) {
+      e--;
+    }
+    last = e;
+    return true;
+  }
+
+  const uint16_t* back = &backBuffer[y * width];
+  const uint16_t* front = &frontBuffer[y * width];
+
+  // 从左向右：逐像素走到 4 字节对齐处，再每次比较两个像素
+  int16_t x = x0;
+  while (x < x1 && ((uintptr_t)(back + x) & 3) != 0 && back[x] == front[x]) x++;
+  while (x + 2 <= x1 && ((uintptr_t)(back + x) & 3) == 0 &&
+         *(const PixelPair*)(back + x) == *(const PixelPair*)(front + x)) {
+    x += 2;
+  }
+  while (x < x1 && back[x] == front[x]) x++;
+  if (x >= x1) return false;
+  first = x;
+
+  // 从右向左找到最后一个不同的像素
+  int16_t e = x1;
+  while (e > first && ((uintptr_t)(back + e) & 3) != 0 && back[e - 1] == front[e - 1]) e--;
+  while (e - 2 >= first && ((uintptr_t)(back + e) & 3) == 0 &&
+         *(const PixelPair*)(back + e - 2) == *(const PixelPair*)(front + e - 2)) {
+    e -= 2;
+  }
+  while (e > first && back[e - 1] == front[e - 1]) e--;
+  last = e - 1;
+  return true;
+}
+
+void FrameBuffer::copyToFront(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width) w = width - x;
+  if (y + h > height) h = height - y;
+  if (w <= 0 || h <= 0) return;
+
+  for (int16_t j = y; j < y + h; j++) {
+    if (indexBack == nullptr) {
+      memcpy(&frontBuffer[j * width + x], &backBuffer[j * width + x],
+             w * sizeof(uint16_t));
+    } else if (indexBits == 8) {
+      memcpy(&indexFront[j * indexStride + x], &indexBack[j * indexStride + x], w);
+    } else {
+      // 4 位：首尾不满一个字节的像素单独复制
+      const uint8_t* src = &indexBack[j * indexStride];
+      uint8_t* dst = &indexFront[j * indexStride];
+      int16_t i = x;
+      int16_t end = x + w;
+      if ((i & 1) && i < end) {
+        writeIndex(dst, i, 4, readIndex(src, i, 4));
+        i++;
+      }
+      int16_t pairs = (end - i) / 2;
+      memcpy(&dst[i >> 1], &src[i >> 1], pairs);
+      i += pairs * 2;
+      if (i < end) writeIndex(dst, i, 4, readIndex(src, i, 4));
+    }
+  }
+
+  // 完整覆盖的图块重新与面板一致
+  int16_t tx0 = (x + TILE_SIZE - 1) / TILE_SIZE;
+  int16_t tx1 = (x + w == width) ? tilesX : (x + w) / TILE_SIZE;
+  int16_t ty0 = (y + TILE_SIZE - 1) / TILE_SIZE;
+  int16_t ty1 = (y + h == height) ? tilesY : (y + h) / TILE_SIZE;
+  if (tx1 <= tx0 || ty1 <= ty0) return;
+
+  uint32_t mask = tileSpanMask(tx0 * TILE_SIZE, (tx1 - tx0) * TILE_SIZE);
+  for (int16_t ty = ty0; ty < ty1; ty++) {
+    staleTiles[ty] &= ~mask;
+  }
+}
+
+void FrameBuffer::invalidateFront(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width) w = width - x;
+  if (y + h > height) h = height - y;
+  if (w <= 0 || h <= 0) return;
+
+  uint32_t mask = tileSpanMask(x, w);
+  for (int16_t ty = y / TILE_SIZE; ty <= (y + h - 1) / TILE_SIZE; ty++) {
+    staleTiles[ty] |= mask;
+  }
+}
+
 // ========== 脏区域管理 ==========
 
 void FrameBuffer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  // 裁剪到屏幕范围
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > width) w = width - x;
+  if (y + h > height) h = height - y;
+  if (w <= 0 || h <= 0) return;
+
+  pendingMarkedPixels += (uint32_t)w * h;
+
+  if (batchDepth > 0) {
+    // 批量中只扩展外接矩形，endBatch 时统一标记
+    if (batchX2 <= batchX1) {
+      batchX1 = x;
+      batchY1 = y;
+      batchX2 = x + w;
+      batchY2 = y + h;
+    } else {
+      batchX1 = min(batchX1, x);
+      batchY1 = min(batchY1, y);
+      batchX2 = max(batchX2, (int16_t)(x + w));
+      batchY2 = max(batchY2, (int16_t)(y + h));
+    }
+    return;
+  }
+
+  markDirtyClipped(x, y, w, h);
+}
+
+void FrameBuffer::markDirtyClipped(int16_t x, int16_t y, int16_t w, int16_t h) {
   if (fullScreenDirty) return;
 
-  // 如果区域过大，标记全屏脏
-  if (w * h > (width * height) / 4) {
-    fullScreenDirty = true;
-    dirtyCount = 0;
+  if (dirtyTracking == DIRTY_TRACK_TILES) {
+    // 只置位覆盖到的图块，开销与图块行数成正比
+    uint32_t mask = tileSpanMask(x, w);
+    for (uint8_t ty = y / TILE_SIZE; ty <= (y + h - 1) / TILE_SIZE; ty++) {
+      dirtyTiles[ty] |= mask;
+    }
+    tilesDirty = true;
     return;
   }
 
-  expandDirtyRegion(x, y, w, h);
+  addDirtyRect(x, y, w, h);
+}
+
+void FrameBuffer::addDirtyRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (fullScreenDirty) return;
 
-  // 如果脏区域过多，合并或标记全屏
-  if (dirtyCount >= MAX_DIRTY_REGIONS) {
+  // 与现有区域合并：外接矩形的发送代价不高于分开发送时合并，
+  // 合并后的区域可能又能与其它区域合并，因此重复直到没有收益
+  int16_t x2 = x + w;
+  int16_t y2 = y + h;
+  uint8_t i = 0;
+  while (i < dirtyCount) {
+    const DirtyRegion& region = dirtyRegions[i];
+    int16_t mx1 = min(region.x, x);
+    int16_t my1 = min(region.y, y);
+    int16_t mx2 = max((int16_t)(region.x + region.width), x2);
+    int16_t my2 = max((int16_t)(region.y + region.height), y2);
+
+    if (regionCost(mx2 - mx1, my2 - my1) <=
+        regionCost(region.width, region.height) + regionCost(x2 - x, y2 - y)) {
+      x = mx1;
+      y = my1;
+      x2 = mx2;
+      y2 = my2;
+      removeDirtyRegion(i);
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+
+  DirtyRegion& added = dirtyRegions[dirtyCount++];
+  added.x = x;
+  added.y = y;
+  added.width = x2 - x;
+  added.height = y2 - y;
+  added.isDirty = true;
+
+  // 超出区域预算时合并代价增加最少的区域
+  if (dirtyCount > regionBudget) {
     mergeDirtyRegions();
   }
+
+  // 分区域发送不比全屏便宜时直接全屏
+  uint32_t totalCost = 0;
+  for (i = 0; i < dirtyCount; i++) {
+    totalCost += regionCost(dirtyRegions[i].width, dirtyRegions[i].height);
+  }
+  if (totalCost >= regionCost(width, height)) {
+    fullScreenDirty = true;
+    dirtyCount = 0;
+  }
 }
 
-void FrameBuffer::expandDirtyRegion(int16_t x, int16_t y, int16_t w, int16_t h) {
-  // 尝试扩展现有脏区域
-  for (uint8_t i = 0; i < dirtyCount; i++) {
-    DirtyRegion& region = dirtyRegions[i];
-    if (!region.isDirty) continue;
+void FrameBuffer::mergeDirtyRegions() {
+  while (dirtyCount > regionBudget) {
+    uint8_t bestA = 0;
+    uint8_t bestB = 1;
+    int32_t bestDelta = INT32_MAX;
+
+    for (uint8_t a = 0; a < dirtyCount; a++) {
+      const DirtyRegion& ra = dirtyRegions[a];
+      int32_t costA = regionCost(ra.width, ra.height);
+      for (uint8_t b = a + 1; b < dirtyCount; b++) {
+        const DirtyRegion& rb = dirtyRegions[b];
+        int16_t mx1 = min(ra.x, rb.x);
+        int16_t my1 = min(ra.y, rb.y);
+        int16_t mx2 = max(ra.x + ra.width, rb.x + rb.width);
+        int16_t my2 = max(ra.y + ra.height, rb.y + rb.height);
+        int32_t delta = (int32_t)regionCost(mx2 - mx1, my2 - my1) - costA -
+                        (int32_t)regionCost(rb.width, rb.height);
+        if (delta < bestDelta) {
+          bestDelta = delta;
+          bestA = a;
+          bestB = b;
+        }
+      }
+    }
+
+    DirtyRegion& ra = dirtyRegions[bestA];
+    const DirtyRegion& rb = dirtyRegions[bestB];
+    int16_t mx1 = min(ra.x, rb.x);
+    int16_t my1 = min(ra.y, rb.y);
+    int16_t mx2 = max(ra.x + ra.width, rb.x + rb.width);
+    int16_t my2 = max(ra.y + ra.height, rb.y + rb.height);
+    ra.x = mx1;
+    ra.y = my1;
+    ra.width = mx2 - mx1;
+    ra.height = my2 - my1;
+    removeDirtyRegion(bestB);
+  }
+}
+
+void FrameBuffer::removeDirtyRegion(uint8_t index) {
+  dirtyRegions[index] = dirtyRegions[dirtyCount - 1];
+  dirtyRegions[dirtyCount - 1].isDirty = false;
+  dirtyCount--;
+}
 
-    // 检查是否相邻或重叠
-    int16_t x1 = min(region.x, x);
-    int16_t y1 = min(region.y, y);
-    int16_t x2 = max(region.x + region.width, x + w);
-    int16_t y2 = max(region.y + region.height, y + h);
+uint32_t FrameBuffer::regionCost(int16_t w, int16_t h) const {
+  uint32_t cost = (uint32_t)w * h + WINDOW_COST_PIXELS;
+  if (w < width) {
+    cost += (uint32_t)h * ROW_COST_PIXELS;  // 非整行区域逐行发送
+  }
+  return cost;
+}
 
-    if (x2 - x1 <= region.width + w && y2 - y1 <= region.height + h) {
-      // 可以合并
-      region.x = x1;
-      region.y = y1;
-      region.width = x2 - x1;
-      region.height = y2 - y1;
-      return;
+bool FrameBuffer::takeTileRun(uint32_t* rows, DirtyRegion& out) const {
+  for (uint8_t ty = 0; ty < tilesY; ty++) {
+    uint32_t bits = rows[ty];
+    if (bits == 0) continue;
+
+    // 本行第一段连续的脏图块
+    uint8_t tx0 = 0;
+    while (!(bits & (1u << tx0))) tx0++;
+    uint8_t tx1 = tx0;
+    while (tx1 + 1 < tilesX && (bits & (1u << (tx1 + 1)))) tx1++;
+    uint32_t mask = tileSpanMask(tx0 * TILE_SIZE, (tx1 - tx0 + 1) * TILE_SIZE);
+
+    // 向下延伸：下一行同样覆盖这一段时并入同一个矩形
+    uint8_t ty1 = ty;
+    rows[ty] &= ~mask;
+    while (ty1 + 1 < tilesY && (rows[ty1 + 1] & mask) == mask) {
+      ty1++;
+      rows[ty1] &= ~mask;
     }
+
+    out.x = tx0 * TILE_SIZE;
+    out.y = ty * TILE_SIZE;
+    out.width = min((int)(tx1 + 1) * TILE_SIZE, (int)width) - out.x;
+    out.height = min((int)(ty1 + 1) * TILE_SIZE, (int)height) - out.y;
+    out.isDirty = true;
+    return true;
   }
+  return false;
+}
 
-  // 添加新脏区域
-  if (dirtyCount < MAX_DIRTY_REGIONS) {
-    dirtyRegions[dirtyCount].x = x;
-    dirtyRegions[dirtyCount].y = y;
-    dirtyRegions[dirtyCount].width = w;
-    dirtyRegions[dirtyCount].height = h;
-    dirtyRegions[dirtyCount].isDirty = true;
-    dirtyCount++;
+uint32_t FrameBuffer::tileSpanMask(int16_t x, int16_t w) const {
+  uint8_t tx0 = x / TILE_SIZE;
+  uint8_t tx1 = (x + w - 1) / TILE_SIZE;
+  if (tx1 - tx0 == 31) return 0xFFFFFFFFu;
+  return ((1u << (tx1 - tx0 + 1)) - 1) << tx0;
+}
+
+void FrameBuffer::setDirtyTracking(DirtyTracking tracking) {
+  if (tracking == dirtyTracking) return;
+
+  waitFlush();
+
+  // 把尚未刷新的脏区域转换到新的跟踪方式（不重复计入标记像素）
+  uint32_t marked = pendingMarkedPixels;
+  if (tracking == DIRTY_TRACK_TILES) {
+    DirtyRegion regions[MAX_DIRTY_REGIONS + 1];
+    uint8_t count = dirtyCount;
+    memcpy(regions, dirtyRegions, sizeof(DirtyRegion) * count);
+    dirtyCount = 0;
+    dirtyTracking = tracking;
+    for (uint8_t i = 0; i < count; i++) {
+      markDirty(regions[i].x, regions[i].y, regions[i].width, regions[i].height);
+    }
+  } else {
+    uint32_t rows[MAX_TILE_ROWS];
+    memcpy(rows, dirtyTiles, sizeof(rows));
+    memset(dirtyTiles, 0, sizeof(dirtyTiles));
+    tilesDirty = false;
+    dirtyTracking = tracking;
+    DirtyRegion run;
+    while (takeTileRun(rows, run)) {
+      markDirty(run.x, run.y, run.width, run.height);
+    }
   }
+  pendingMarkedPixels = marked;
 }
 
-void FrameBuffer::mergeDirtyRegions() {
-  // 简化合并：标记全屏脏
-  fullScreenDirty = true;
-  dirtyCount = 0;
+uint16_t FrameBuffer::getDirtyTileCount() const {
+  uint16_t count = 0;
+  for (uint8_t ty = 0; ty < tilesY; ty++) {
+    for (uint32_t bits = dirtyTiles[ty]; bits; bits &= bits - 1) count++;
+  }
+  return count;
+}
+
+bool FrameBuffer::getDirtyBounds(int16_t& top, int16_t& bottom,
+                                 uint32_t& pixels) const {
+  if (fullScreenDirty) {
+    top = 0;
+    bottom = height;
+    pixels = (uint32_t)width * height;
+    return true;
+  }
+
+  top = height;
+  bottom = 0;
+  pixels = 0;
+  for (uint8_t ty = 0; ty < tilesY; ty++) {
+    if (dirtyTiles[ty] == 0) continue;
+    uint8_t tiles = 0;
+    for (uint32_t bits = dirtyTiles[ty]; bits; bits &= bits - 1) tiles++;
+    top = min(top, (int16_t)(ty * TILE_SIZE));
+    bottom = max(bottom, (int16_t)min((ty + 1) * TILE_SIZE, (int)height));
+    pixels += (uint32_t)tiles * TILE_SIZE * TILE_SIZE;
+  }
+  for (uint8_t i = 0; i < dirtyCount; i++) {
+    const DirtyRegion& region = dirtyRegions[i];
+    if (!region.isDirty) continue;
+    top = min(top, region.y);
+    bottom = max(bottom, (int16_t)(region.y + region.height));
+    pixels += (uint32_t)region.width * region.height;
+  }
+  return top < bottom;
+}
+
+void FrameBuffer::setDirtyRegionBudget(uint8_t maxRegions) {
+  if (maxRegions < 1) maxRegions = 1;
+  if (maxRegions > MAX_DIRTY_REGIONS) maxRegions = MAX_DIRTY_REGIONS;
+  regionBudget = maxRegions;
+  if (dirtyCount > regionBudget) {
+    mergeDirtyRegions();
+  }
+}
+
+void FrameBuffer::beginBatch() {
+  if (batchDepth++ == 0) {
+    batchX1 = batchY1 = batchX2 = batchY2 = 0;
+  }
+}
+
+void FrameBuffer::endBatch() {
+  if (batchDepth == 0 || --batchDepth > 0) return;
+
+  if (batchX2 > batchX1) {
+    markDirtyClipped(batchX1, batchY1, batchX2 - batchX1, batchY2 - batchY1);
+  }
 }
 
 void FrameBuffer::markClean() {
   fullScreenDirty = false;
   dirtyCount = 0;
 
-  for (uint8_t i = 0; i < MAX_DIRTY_REGIONS; i++) {
+  memset(dirtyTiles, 0, sizeof(dirtyTiles));
+  tilesDirty = false;
+
+  stats.lastPixelsMarked = pendingMarkedPixels;
+  stats.pixelsMarked += pendingMarkedPixels;
+  pendingMarkedPixels = 0;
+
+  for (uint8_t i = 0; i <= MAX_DIRTY_REGIONS; i++) {
     dirtyRegions[i].isDirty = false;
   }
 }
 
+// ========== 性能统计 ==========
+
+void FrameBuffer::beginFlushStats() {
+  stats.lastPixelsPushed = 0;
+  stats.lastAddrWindows = 0;
+}
+
+void FrameBuffer::endFlushStats(unsigned long startMicros) {
+  stats.lastFlushMicros = micros() - startMicros;
+  stats.totalFlushMicros += stats.lastFlushMicros;
+  stats.flushCount++;
+}
+
+void FrameBuffer::resetFlushStats() {
+  memset(&stats, 0, sizeof(stats));
+}
+
 size_t FrameBuffer::getMemoryUsage() const {
   size_t usage = 0;
   if (backBuffer) usage += width * height * sizeof(uint16_t);
   if (frontBuffer) usage += width * height * sizeof(uint16_t);
+  if (indexBack) usage += (size_t)indexStride * height;
+  if (indexFront) usage += (size_t)indexStride * height;
+  if (lineCache) usage += width * ASYNC_LINES * sizeof(uint16_t);
+  return usage;
+}
+
+size_t FrameBuffer::getInternalMemoryUsage() const {
+  size_t bufferSize = indexBits ? (size_t)indexStride * height
+                                : (size_t)width * height * sizeof(uint16_t);
+  size_t usage = 0;
+  if (backRegion == MEMORY_INTERNAL) usage += bufferSize;
+  if (frontRegion == MEMORY_INTERNAL) usage += bufferSize;
+  if (cacheRegion == MEMORY_INTERNAL) usage += width * ASYNC_LINES * sizeof(uint16_t);
   return usage;
 }
+
+// ========== 调色板索引 ==========
+
+void FrameBuffer::setDefaultPalette() {
+  paletteCustom = false;
+  memset(colorCache, 0, sizeof(colorCache));
+
+  if (indexBits == 4) {
+    memcpy(palette, DEFAULT_PALETTE16, sizeof(DEFAULT_PALETTE16));
+    paletteSize = 16;
+    paletteRGB332 = false;
+    return;
+  }
+
+  // RGB332：每个分量取高位，展开时低位重复高位，白色仍为 0xFFFF
+  for (uint16_t i = 0; i < 256; i++) {
+    uint16_t r = i >> 5;
+    uint16_t g = (i >> 2) & 0x07;
+    uint16_t b = i & 0x03;
+    palette[i] = (((r << 2) | (r >> 1)) << 11) | (((g << 3) | g) << 5) |
+                 ((b << 3) | (b << 1) | (b >> 1));
+  }
+  paletteSize = 256;
+  paletteRGB332 = true;
+}
+
+void FrameBuffer::setPalette(const uint16_t* colors, uint16_t count) {
+  if (colors == nullptr || count == 0) {
+    setDefaultPalette();
+  } else {
+    uint16_t limit = indexBits == 4 ? 16 : MAX_PALETTE_SIZE;
+    if (count > limit) {
+      Serial.printf("Palette truncated to %d colors\n", limit);
+      count = limit;
+    }
+    waitFlush();
+    memcpy(palette, colors, count * sizeof(uint16_t));
+    paletteSize = count;
+    paletteRGB332 = false;
+    paletteCustom = true;
+    memset(colorCache, 0, sizeof(colorCache));
+  }
+
+  // 已有索引对应的颜色变了，整屏重发
+  if (isIndexed()) {
+    frontValid = false;
+    fullScreenDirty = true;
+    dirtyCount = 0;
+  }
+}
+
+uint8_t FrameBuffer::colorToIndex(uint16_t color) {
+  if (paletteRGB332) {
+    return ((color >> 13) << 5) | (((color >> 8) & 0x07) << 2) | ((color >> 3) & 0x03);
+  }
+
+  uint8_t slot = (color ^ (color >> 6) ^ (color >> 11)) & (COLOR_CACHE_SIZE - 1);
+  uint32_t entry = colorCache[slot];
+  if ((entry >> 24) != 0 && (uint16_t)entry == color) {
+    return (entry >> 16) & 0xFF;
+  }
+
+  uint8_t index = nearestIndex(color);
+  colorCache[slot] = (1u << 24) | ((uint32_t)index << 16) | color;
+  return index;
+}
+
+uint8_t FrameBuffer::nearestIndex(uint16_t color) const {
+  // 按 6 位精度比较各分量的平方距离
+  int16_t r = (color >> 11) << 1;
+  int16_t g = (color >> 5) & 0x3F;
+  int16_t b = (color & 0x1F) << 1;
+
+  uint8_t best = 0;
+  uint32_t bestDistance = UINT32_MAX;
+  for (uint16_t i = 0; i < paletteSize; i++) {
+    uint16_t c = palette[i];
+    if (c == color) return i;
+    int16_t dr = r - ((c >> 11) << 1);
+    int16_t dg = g - ((c >> 5) & 0x3F);
+    int16_t db = b - ((c & 0x1F) << 1);
+    uint32_t distance = dr * dr + dg * dg + db * db;
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      best = i;
+    }
+  }
+  return best;
+}
+
+void FrameBuffer::fillIndexRow(int16_t x, int16_t y, int16_t w, uint8_t index) {
+  uint8_t* row = &indexBack[y * indexStride];
+  if (indexBits == 8) {
+    memset(&row[x], index, w);
+    return;
+  }
+
+  if ((x & 1) && w > 0) {
+    writeIndex(row, x, 4, index);
+    x++;
+    w--;
+  }
+  memset(&row[x >> 1], index * 0x11, w >> 1);
+  if (w & 1) {
+    writeIndex(row, x + w - 1, 4, index);
+  }
+}
+
+void FrameBuffer::writeIndexRow(int16_t x, int16_t y, int16_t w,
+                                const uint16_t* colors) {
+  uint8_t* row = &indexBack[y * indexStride];
+  // 图片中相邻像素常为同色，记住上一次的转换结果
+  uint16_t lastColor = colors[0];
+  uint8_t lastIndex = colorToIndex(lastColor);
+  for (int16_t i = 0; i < w; i++) {
+    if (colors[i] != lastColor) {
+      lastColor = colors[i];
+      lastIndex = colorToIndex(lastColor);
+    }
+    writeIndex(row, x + i, indexBits, lastIndex);
+  }
+}
+
+void FrameBuffer::expandRows(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t* dst, bool swapBytes) const {
+  for (int16_t j = 0; j < h; j++) {
+    const uint8_t* row = &indexBack[(y + j) * indexStride];
+    for (int16_t i = 0; i < w; i++) {
+      uint16_t c = palette[readIndex(row, x + i, indexBits)];
+      *dst++ = swapBytes ? (uint16_t)((c << 8) | (c >> 8)) : c;
+    }
+  }
+}
+
+// ========== 单行写入 ==========
+
+void FrameBuffer::fillRow(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  if (y < 0 || y >= height) return;
+  if (x < 0) { w += x; x = 0; }
+  if (x + w > width) w = width - x;
+  if (w <= 0) return;
+
+  if (indexBack != nullptr) {
+    fillIndexRow(x, y, w, colorToIndex(color));
+  } else if (backBuffer != nullptr) {
+    fillSpan(&backBuffer[y * width + x], color, w);
+  }
+}
+
+void FrameBuffer::writeRow(int16_t x, int16_t y, int16_t w,
+                           const uint16_t* colors) {
+  if (y < 0 || y >= height || colors == nullptr) return;
+  if (x < 0) { colors -= x; w += x; x = 0; }
+  if (x + w > width) w = width - x;
+  if (w <= 0) return;
+
+  if (indexBack != nullptr) {
+    writeIndexRow(x, y, w, colors);
+  } else if (backBuffer != nullptr) {
+    memcpy(&backBuffer[y * width + x], colors, w * sizeof(uint16_t));
+  }
+}
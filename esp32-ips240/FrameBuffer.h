@@ -3,6 +3,10 @@
 
 #include <Arduino.h>
 #include <Adafruit_ST7789.h>
+#include "ImageScaler.h"
+#include "BufferAllocator.h"
+
+class DisplayDMA;
 
 // 脏区域结构
 struct DirtyRegion {
@@ -13,11 +17,36 @@ struct DirtyRegion {
   bool isDirty;
 };
 
+// 刷新统计（每次 flush 累计，用于基准测试）
+struct FlushStats {
+  uint32_t flushCount;         // 刷新次数
+  uint32_t addrWindowCount;    // 地址窗口设置次数（每次约 11 字节命令开销）
+  uint64_t pixelsPushed;       // 推送到屏幕的像素总数
+  uint64_t totalFlushMicros;   // 刷新总耗时
+  uint32_t lastPixelsPushed;   // 最近一次刷新的像素数
+  uint32_t lastAddrWindows;    // 最近一次刷新的地址窗口数
+  uint32_t lastFlushMicros;    // 最近一次刷新耗时
+  uint64_t pixelsMarked;       // 绘制操作标记为脏的像素总数（合并前）
+  uint32_t lastPixelsMarked;   // 最近一次刷新前标记的像素数
+
+  // 线上字节数估算（像素数据 + 地址窗口命令）
+  uint64_t bytesOnWire() const { return pixelsPushed * 2 + addrWindowCount * 11; }
+};
+
+// 脏区域跟踪方式
+enum DirtyTracking {
+  DIRTY_TRACK_REGIONS,     // 矩形列表 + 代价合并（少量大块更新）
+  DIRTY_TRACK_TILES        // 16x16 图块位图（大量分散的小块更新）
+};
+
 // 缓冲模式
 enum BufferMode {
   BUFFER_MODE_DIRECT,      // 直接写入（无缓冲，低内存占用）
   BUFFER_MODE_SINGLE,      // 单缓冲+脏区域（中等内存占用）
-  BUFFER_MODE_DOUBLE       // 双缓冲（高内存占用，最佳性能）
+  BUFFER_MODE_DOUBLE,      // 双缓冲（高内存占用，最佳性能）
+  BUFFER_MODE_INDEXED8,    // 8 位调色板索引双缓冲（内存为 DOUBLE 的一半）
+  BUFFER_MODE_INDEXED4,    // 4 位调色板索引双缓冲（内存为 DOUBLE 的 1/4）
+  BUFFER_MODE_STRIP        // 条带缓冲：按显示列表逐条带重绘（内存约为 SINGLE 的 1/10）
 };
 
 /**
@@ -26,32 +55,132 @@ enum BufferMode {
  * 解决动画花屏问题
  */
 class FrameBuffer {
+public:
+  static const uint8_t ASYNC_LINES = 8;  // 每个 DMA 行缓冲容纳的行数
+
+  // 脏区域合并代价模型（单位：像素，1 像素 = 2 字节线上数据）
+  static const uint8_t MAX_DIRTY_REGIONS = 16;
+  static const uint8_t DEFAULT_REGION_BUDGET = 8;
+  static const uint16_t WINDOW_COST_PIXELS = 32;  // 地址窗口 11 字节命令 + 事务开销
+  static const uint16_t ROW_COST_PIXELS = 4;      // 非整行区域每行一次写入调用
+
+  // 图块位图：每个图块行一个 uint32_t，最多 32x32 个图块
+  static const uint8_t TILE_SIZE = 16;
+  static const uint8_t MAX_TILE_ROWS = 32;
+
+  // 调色板索引模式：颜色 -> 索引的直接映射缓存
+  static const uint16_t MAX_PALETTE_SIZE = 256;
+  static const uint8_t COLOR_CACHE_SIZE = 64;
+
+  // 条带模式：缓冲只有这么多行（DisplayList::DIRTY_LINES 的倍数），推送时加上条带顶部的偏移
+  static const uint8_t STRIP_LINES = 24;
+
 private:
   uint16_t width;
-  uint16_t height;
+  uint16_t height;         // 缓冲行数（条带模式为 STRIP_LINES）
+  uint16_t panelHeight;    // 屏幕行数
+  int16_t originY;         // 条带模式：缓冲第 0 行在屏幕上的位置
   BufferMode mode;
 
   // 缓冲区指针
-  uint16_t* frontBuffer;   // 前台缓冲（显示中）
+  uint16_t* frontBuffer;   // 前台缓冲（差分刷新时为面板内容的镜像）
   uint16_t* backBuffer;    // 后台缓冲（绘制中）
 
-  // 脏区域管理
-  static const uint8_t MAX_DIRTY_REGIONS = 8;
-  DirtyRegion dirtyRegions[MAX_DIRTY_REGIONS];
+  // 调色板索引模式：缓冲中存索引，刷新时经行缓冲展开为 RGB565
+  uint8_t* indexBack;      // 后台索引缓冲
+  uint8_t* indexFront;     // 前台索引缓冲（差分刷新的面板镜像）
+  uint16_t* lineCache;     // 行缓存（ASYNC_LINES 行 RGB565，内部 SRAM）
+  uint8_t indexBits;       // 每像素位数（8 / 4），非索引模式为 0
+  uint16_t indexStride;    // 每行字节数
+  uint16_t palette[MAX_PALETTE_SIZE];
+  uint16_t paletteSize;
+  bool paletteRGB332;      // 默认 8 位调色板：按位截取，不需要查找
+  bool paletteCustom;      // 由 setPalette 设置（切换模式时保留）
+  uint32_t colorCache[COLOR_CACHE_SIZE];  // 有效位 | 索引 << 16 | 颜色
+
+  // 缓冲放置：帧缓冲按策略放在 PSRAM / 内部 SRAM，行缓存总在内部 SRAM
+  BufferPlacement placement;
+  MemoryRegion backRegion;
+  MemoryRegion frontRegion;
+  MemoryRegion cacheRegion;
+
+  // 脏区域管理（多一个位置暂存新区域，超出预算时再合并）
+  DirtyRegion dirtyRegions[MAX_DIRTY_REGIONS + 1];
   uint8_t dirtyCount;
+  uint8_t regionBudget;
+  uint32_t pendingMarkedPixels;
+
+  // 批量标记：beginBatch/endBatch 之间只累计外接矩形
+  uint8_t batchDepth;
+  int16_t batchX1, batchY1, batchX2, batchY2;
+
+  // 图块脏位图（DIRTY_TRACK_TILES）
+  DirtyTracking dirtyTracking;
+  uint8_t tilesX;
+  uint8_t tilesY;
+  uint32_t dirtyTiles[MAX_TILE_ROWS];
+  bool tilesDirty;
 
   // 全屏脏标记
   bool fullScreenDirty;
 
+  // 差分刷新（双缓冲）：只发送与前台缓冲不同的像素
+  bool diffFlush;
+  bool frontValid;  // 前台缓冲是否与面板内容一致
+  uint32_t staleTiles[MAX_TILE_ROWS];  // 面板被直接改写、前台内容未知的图块
+
   // 性能统计
   unsigned long lastFlushTime;
   uint32_t flushCount;
+  FlushStats stats;
+
+  // 异步刷新状态（DMA + 乒乓行缓冲）
+  DisplayDMA* asyncDMA;
+  uint16_t* lineBuffers[2];
+  uint8_t nextLineBuffer;
+  DirtyRegion asyncRegions[MAX_DIRTY_REGIONS];
+  uint8_t asyncRegionCount;
+  uint8_t asyncRegionIndex;
+  uint32_t asyncTiles[MAX_TILE_ROWS];
+  bool asyncHasTiles;
+  DirtyRegion asyncCurrent;
+  int16_t asyncRow;
+  bool asyncNeedWindow;
+  bool asyncActive;
+  unsigned long asyncStartMicros;
 
   // 私有方法
   void mergeDirtyRegions();
-  void expandDirtyRegion(int16_t x, int16_t y, int16_t w, int16_t h);
+  void removeDirtyRegion(uint8_t index);
+  void markDirtyClipped(int16_t x, int16_t y, int16_t w, int16_t h);
+  void addDirtyRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  uint32_t regionCost(int16_t w, int16_t h) const;
+  bool isDiffActive() const;
+  void diffDirtyRegions();
+  void diffRegion(const DirtyRegion& region);
+  bool diffRowSpan(int16_t y, int16_t x0, int16_t x1,
+                   int16_t& first, int16_t& last) const;
+  void copyToFront(int16_t x, int16_t y, int16_t w, int16_t h);
+  bool takeTileRun(uint32_t* rows, DirtyRegion& out) const;
+  uint32_t tileSpanMask(int16_t x, int16_t w) const;
+  bool nextAsyncRegion();
   bool allocateBuffers();
   void freeBuffers();
+  void beginFlushStats();
+  void endFlushStats(unsigned long startMicros);
+  void pushRegion(Adafruit_ST7789* tft, int16_t x, int16_t y, int16_t w, int16_t h);
+  void countRegion(int16_t w, int16_t h);
+  bool allocateLineBuffers(DisplayDMA* dma);
+  void freeLineBuffers();
+  void finishAsyncFlush();
+  bool hasPixels() const { return backBuffer != nullptr || indexBack != nullptr; }
+  void setDefaultPalette();
+  uint8_t colorToIndex(uint16_t color);
+  uint8_t nearestIndex(uint16_t color) const;
+  void fillIndexRow(int16_t x, int16_t y, int16_t w, uint8_t index);
+  void writeIndexRow(int16_t x, int16_t y, int16_t w, const uint16_t* colors);
+  void expandRows(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* dst,
+                  bool swapBytes) const;
 
 public:
   FrameBuffer(uint16_t w, uint16_t h);
@@ -64,6 +193,25 @@ public:
   // 缓冲模式控制
   BufferMode getMode() const { return mode; }
   bool setMode(BufferMode newMode);
+  bool isIndexed() const { return indexBits != 0; }
+
+  // 尺寸与后台缓冲（文字引擎按行直接写入，写后自行 markDirty）
+  // 调色板索引模式下没有 RGB565 后台缓冲，返回 nullptr，改用 fillRow / writeRow
+  // 条带模式下 getHeight 为条带行数，坐标相对条带顶部
+  uint16_t getWidth() const { return width; }
+  uint16_t getHeight() const { return height; }
+  uint16_t getPanelHeight() const { return panelHeight; }
+  uint16_t* getBackBuffer() { return backBuffer; }
+
+  // 单行写入（自动裁剪，不标记脏区域，写后自行 markDirty），所有缓冲模式可用
+  void fillRow(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void writeRow(int16_t x, int16_t y, int16_t w, const uint16_t* colors);
+
+  // 调色板（索引模式）：默认 8 位为 RGB332，4 位为 16 种常用色；
+  // 不在调色板中的颜色映射到最接近的一项。更换调色板后整屏重发
+  void setPalette(const uint16_t* colors, uint16_t count);
+  const uint16_t* getPalette() const { return palette; }
+  uint16_t getPaletteSize() const { return paletteSize; }
 
   // 像素操作
   void setPixel(int16_t x, int16_t y, uint16_t color);
@@ -74,7 +222,8 @@ public:
   void drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
                 const uint16_t* data);
   void drawRectScaled(int16_t x, int16_t y, int16_t w, int16_t h,
-                      const uint16_t* srcData, uint16_t srcW, uint16_t srcH);
+                      const uint16_t* srcData, uint16_t srcW, uint16_t srcH,
+                      ScaleFilter filter = SCALE_NEAREST);
 
   // 全屏操作
   void clear(uint16_t color = 0x0000);
@@ -86,19 +235,56 @@ public:
                    int16_t x, int16_t y, int16_t w, int16_t h);
   void flushImmediate(Adafruit_ST7789* tft);  // 强制立即刷新全屏
 
-  // 双缓冲交换
+  // 异步刷新：脏区域经两个行缓冲交替送入 DMA，立即返回
+  bool flushAsync(Adafruit_ST7789* tft, DisplayDMA* dma);
+  void pollFlush();   // 回收完成的行缓冲并继续排队（在 loop 中调用）
+  void waitFlush();   // 阻塞直到异步刷新完成
+  bool isFlushing() const { return asyncActive; }
+
+  // 条带模式：设置缓冲对应的屏幕行（之后的刷新推送到 y 开始的条带）
+  void setStripOrigin(int16_t y) { originY = y; }
+  int16_t getStripOrigin() const { return originY; }
+
+  // 双缓冲交换（差分刷新时前台缓冲是面板镜像，不做交换）
   void swapBuffers();
 
+  // 差分刷新：双缓冲模式下默认开启
+  void setDiffFlush(bool enabled);
+  bool getDiffFlush() const { return diffFlush; }
+  // 绕过帧缓冲写屏时调用：整屏，或只标记被改写的范围
+  void invalidateFront() { frontValid = false; }
+  void invalidateFront(int16_t x, int16_t y, int16_t w, int16_t h);
+
   // 脏区域管理
   void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
   void markClean();
-  bool isDirty() const { return fullScreenDirty || dirtyCount > 0; }
+  void beginBatch();  // 一个图元的多次写入合并为一次标记
+  void endBatch();
+  bool isDirty() const { return fullScreenDirty || dirtyCount > 0 || tilesDirty; }
   uint8_t getDirtyRegionCount() const { return dirtyCount; }
+  const DirtyRegion& getDirtyRegion(uint8_t index) const { return dirtyRegions[index]; }
+  void setDirtyRegionBudget(uint8_t maxRegions);  // 1 ~ MAX_DIRTY_REGIONS
+  uint8_t getDirtyRegionBudget() const { return regionBudget; }
+  void setDirtyTracking(DirtyTracking tracking);
+  DirtyTracking getDirtyTracking() const { return dirtyTracking; }
+  uint16_t getDirtyTileCount() const;
+  // 待刷新内容的行范围 [top, bottom) 与像素数上限（合并与差分之前），没有时返回 false
+  bool getDirtyBounds(int16_t& top, int16_t& bottom, uint32_t& pixels) const;
 
   // 性能信息
   uint32_t getFlushCount() const { return flushCount; }
   unsigned long getLastFlushTime() const { return lastFlushTime; }
+  const FlushStats& getFlushStats() const { return stats; }
+  void resetFlushStats();
   size_t getMemoryUsage() const;
+  size_t getInternalMemoryUsage() const;  // 其中位于内部 SRAM 的部分
+
+  // 缓冲放置策略（下一次 begin / setMode 分配时生效）与实际所在的内存
+  void setPlacement(BufferPlacement policy) { placement = policy; }
+  BufferPlacement getPlacement() const { return placement; }
+  MemoryRegion getBackBufferRegion() const { return backRegion; }
+  MemoryRegion getFrontBufferRegion() const { return frontRegion; }
+  MemoryRegion getLineCacheRegion() const { return cacheRegion; }
 
   // 辅助方法
   bool isValidCoord(int16_t x, int16_t y) const {
@@ -0,0 +1,59 @@
+#include "FrameBufferCanvas.h"
+
+FrameBufferCanvas::FrameBufferCanvas(FrameBuffer* fb, int16_t w, int16_t h)
+  : Adafruit_GFX(w, h), pFrameBuffer(fb) {
+}
+
+void FrameBufferCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  pFrameBuffer->setPixel(x, y, color);
+}
+
+// ========== 批量写入 ==========
+
+void FrameBufferCanvas::startWrite() {
+  pFrameBuffer->beginBatch();
+}
+
+void FrameBufferCanvas::writePixel(int16_t x, int16_t y, uint16_t color) {
+  pFrameBuffer->setPixel(x, y, color);
+}
+
+void FrameBufferCanvas::writeFillRect(int16_t x, int16_t y, int16_t w,
+                                      int16_t h, uint16_t color) {
+  pFrameBuffer->fillRect(x, y, w, h, color);
+}
+
+void FrameBufferCanvas::writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                       uint16_t color) {
+  pFrameBuffer->fillRect(x, y, 1, h, color);
+}
+
+void FrameBufferCanvas::writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                       uint16_t color) {
+  pFrameBuffer->fillRect(x, y, w, 1, color);
+}
+
+void FrameBufferCanvas::endWrite() {
+  pFrameBuffer->endBatch();
+}
+
+// ========== 直线与矩形 ==========
+
+void FrameBufferCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                      uint16_t color) {
+  pFrameBuffer->fillRect(x, y, 1, h, color);
+}
+
+void FrameBufferCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                      uint16_t color) {
+  pFrameBuffer->fillRect(x, y, w, 1, color);
+}
+
+void FrameBufferCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 uint16_t color) {
+  pFrameBuffer->fillRect(x, y, w, h, color);
+}
+
+void FrameBufferCanvas::fillScreen(uint16_t color) {
+  pFrameBuffer->clear(color);
+}
@@ -0,0 +1,36 @@
+#ifndef FRAMEBUFFER_CANVAS_H
+#define FRAMEBUFFER_CANVAS_H
+
+#include <Adafruit_GFX.h>
+#include "FrameBuffer.h"
+
+/**
+ * 绘制到帧缓冲的 GFX 画布
+ * 文字、线条、圆等 Adafruit_GFX 图元经此写入后台缓冲并标记脏区域，
+ * 由 flush 一次性发送；每个图元（startWrite/endWrite 之间）只标记一次外接矩形
+ */
+class FrameBufferCanvas : public Adafruit_GFX {
+public:
+  FrameBufferCanvas(FrameBuffer* fb, int16_t w, int16_t h);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+
+  // 批量写入（Adafruit_GFX 在绘制字符、圆等图元时使用）
+  void startWrite();
+  void writePixel(int16_t x, int16_t y, uint16_t color);
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void endWrite();
+
+  // 直线与矩形走帧缓冲的批量填充
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillScreen(uint16_t color);
+
+private:
+  FrameBuffer* pFrameBuffer;
+};
+
+#endif // FRAMEBUFFER_CANVAS_H
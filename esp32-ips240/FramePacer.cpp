@@ -0,0 +1,212 @@
+#include "FramePacer.h"
+
+// ST7789 命令：打开 TE 输出（参数 0 = 只在垂直消隐期间输出高电平）
+static const uint8_t ST7789_TEON = 0x35;
+
+// TE 中断记录的最近一次上升沿与实测周期（只有一块屏，用文件内静态变量）
+static volatile uint32_t teLastMicros = 0;
+static volatile uint32_t tePeriodMicros = 0;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void IRAM_ATTR onTearingEffect() {
+  uint32_t now = micros();
+  uint32_t period = now - teLastMicros;
+  // 忽略毛刺：正常周期在 25 ~ 120 Hz 之间
+  if (period > 8000 && period < 40000) {
+    tePeriodMicros = period;
+  }
+  teLastMicros = now;
+}
+#endif
+
+FramePacer::FramePacer() {
+  ready = false;
+  tePin = -1;
+  refreshMicros = DEFAULT_REFRESH_MICROS;
+  epochMicros = 0;
+  frameInterval = DEFAULT_REFRESH_MICROS;
+  lastDeadline = 0;
+  lastFrameStart = 0;
+  firstFrame = true;
+  resetStats();
+}
+
+FramePacer::~FramePacer() {
+  end();
+}
+
+bool FramePacer::begin(Adafruit_ST7789* tft, int8_t pin, uint32_t refresh) {
+  if (refresh == 0) return false;
+  end();
+
+  refreshMicros = refresh;
+  epochMicros = micros();
+  tePin = -1;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  if (pin >= 0 && tft != nullptr) {
+    uint8_t mode = 0;
+    tft->sendCommand(ST7789_TEON, &mode, 1);
+    teLastMicros = micros();
+    tePeriodMicros = 0;
+    pinMode(pin, INPUT);
+    attachInterrupt(digitalPinToInterrupt(pin), onTearingEffect, RISING);
+    tePin = pin;
+  }
+#else
+  (void)tft;
+  (void)pin;
+  (void)ST7789_TEON;
+#endif
+
+  ready = true;
+  Serial.printf("帧节奏: %s，刷新周期 %lu us\n",
+                hasTE() ? "TE 信号" : "模拟刷新时钟",
+                (unsigned long)refreshMicros);
+  return true;
+}
+
+void FramePacer::end() {
+  if (!ready) return;
+#if defined(ARDUINO_ARCH_ESP32)
+  if (tePin >= 0) {
+    detachInterrupt(digitalPinToInterrupt(tePin));
+  }
+#endif
+  tePin = -1;
+  ready = false;
+}
+
+// ========== 面板扫描 ==========
+
+uint32_t FramePacer::getRefreshMicros() const {
+  if (hasTE() && tePeriodMicros != 0) return tePeriodMicros;
+  return refreshMicros;
+}
+
+uint32_t FramePacer::lastVSyncMicros() const {
+  if (hasTE()) return teLastMicros;
+  return epochMicros;
+}
+
+// 当前时刻在刷新周期内的位置（距最近一次消隐开始，纳秒）
+uint32_t FramePacer::phaseNanos(uint32_t now, uint32_t periodMicros) const {
+  uint32_t sinceVSync = (now - lastVSyncMicros()) % periodMicros;
+  return sinceVSync * 1000;
+}
+
+int16_t FramePacer::getScanLine() const {
+  uint32_t period = getRefreshMicros();
+  uint32_t phase = phaseNanos(micros(), period);
+  uint32_t lineNs = period * 1000 / TOTAL_LINES;
+  return (int16_t)(phase / lineNs) - PORCH_LINES;
+}
+
+void FramePacer::waitForVSync() {
+  uint32_t period = getRefreshMicros();
+  uint32_t phase = phaseNanos(micros(), period) / 1000;
+  delayMicroseconds(period - phase);
+}
+
+// 写入从 startNs（距消隐开始）起，按 rowNs 一行的速度写 rows 行；
+// 每一次经过区域的扫描只能全部看到旧内容或全部看到新内容
+bool FramePacer::isTearFree(int64_t startNs, int16_t top, int16_t rows,
+                            int64_t rowNs, int64_t lineNs, int64_t periodNs) {
+  int64_t writeNs = rows * rowNs;
+  int64_t slope = lineNs - rowNs;  // 扫描线相对写入位置的速度差
+  for (int64_t pass = (PORCH_LINES + top) * lineNs - startNs; pass < writeNs;
+       pass += periodNs) {
+    // 第 k 行：扫描在写入之前为 pass + k*L < k*W，在写入完成之后为 pass + k*L >= (k+1)*W
+    int64_t firstOld = pass;
+    int64_t lastOld = pass + (rows - 1) * slope;
+    if (firstOld < 0 && lastOld < 0) continue;
+    int64_t firstNew = pass - rowNs;
+    int64_t lastNew = pass - rowNs + (rows - 1) * slope;
+    if (firstNew >= 0 && lastNew >= 0) continue;
+    return false;
+  }
+  return true;
+}
+
+uint32_t FramePacer::waitTearFree(int16_t top, int16_t bottom,
+                                  uint32_t pushMicros) {
+  if (!ready) return 0;
+  top = max(top, (int16_t)0);
+  bottom = min(bottom, (int16_t)PANEL_ROWS);
+  if (top >= bottom) return 0;
+
+  int16_t rows = bottom - top;
+  uint32_t period = getRefreshMicros();
+  int64_t periodNs = (int64_t)period * 1000;
+  int64_t lineNs = periodNs / TOTAL_LINES;
+  int64_t rowNs = (int64_t)pushMicros * 1000 / rows;
+  int64_t phase = phaseNanos(micros(), period);
+
+  // 以扫描行为步长找最早的起始时刻，最多一个刷新周期
+  int64_t delayNs = -1;
+  for (uint16_t step = 0; step < TOTAL_LINES; step++) {
+    if (isTearFree(phase + step * lineNs, top, rows, rowNs, lineNs, periodNs)) {
+      delayNs = step * lineNs;
+      break;
+    }
+  }
+
+  if (delayNs < 0) {
+    // 无法避免：扫描线刚经过区域顶部时开始，撕裂线尽量靠下
+    stats.tornFlushes++;
+    int64_t topNs = (PORCH_LINES + top + 1) * lineNs;
+    delayNs = (topNs - phase) % periodNs;
+    if (delayNs < 0) delayNs += periodNs;
+  }
+
+  uint32_t waitMicros = (uint32_t)(delayNs / 1000);
+  if (waitMicros > 0) {
+    delayMicroseconds(waitMicros);
+  }
+  stats.syncedFlushes++;
+  stats.syncWaitMicros += waitMicros;
+  return waitMicros;
+}
+
+// ========== 帧调度 ==========
+
+void FramePacer::resetSchedule() {
+  lastDeadline = micros();
+  lastFrameStart = lastDeadline;
+  firstFrame = false;
+}
+
+bool FramePacer::frameDue(uint32_t intervalMicros) {
+  uint32_t now = micros();
+  if (firstFrame) {
+    resetSchedule();
+    stats.frames++;
+    return true;
+  }
+
+  uint32_t deadline = lastDeadline + intervalMicros;
+  if ((int32_t)(now - deadline) < 0) return false;
+
+  // 固定步长：截止时刻按间隔累加；迟到超过一个间隔时跳过错过的时刻
+  uint32_t late = now - deadline;
+  uint32_t skipped = intervalMicros > 0 ? late / intervalMicros : 0;
+  stats.missedDeadlines += skipped;
+  lastDeadline = deadline + skipped * intervalMicros;
+  late -= skipped * intervalMicros;
+
+  uint32_t actual = now - lastFrameStart;
+  uint32_t target = intervalMicros * (skipped + 1);
+  uint32_t jitter = actual > target ? actual - target : target - actual;
+  lastFrameStart = now;
+
+  stats.frames++;
+  stats.totalLateMicros += late;
+  stats.maxLateMicros = max(stats.maxLateMicros, late);
+  stats.totalJitterMicros += jitter;
+  stats.maxJitterMicros = max(stats.maxJitterMicros, jitter);
+  return true;
+}
+
+void FramePacer::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+}
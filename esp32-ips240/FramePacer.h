@@ -0,0 +1,99 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <Arduino.h>
+#include <Adafruit_ST7789.h>
+
+// 帧节奏统计
+struct FramePacingStats {
+  uint32_t frames;            // frameDue() 返回 true 的次数
+  uint32_t missedDeadlines;   // 被跳过的帧时刻（一帧迟到超过一个间隔）
+  uint32_t syncedFlushes;     // 经 waitTearFree() 排程的刷新
+  uint32_t tornFlushes;       // 其中找不到不撕裂起始时刻的刷新（区域太大或 SPI 太慢）
+  uint64_t syncWaitMicros;    // 为避开扫描线等待的总时间
+  uint32_t maxLateMicros;     // 帧开始时刻相对截止时刻的最大延迟
+  uint64_t totalLateMicros;
+  uint32_t maxJitterMicros;   // 相邻两帧的实际间隔与目标间隔之差的最大值
+  uint64_t totalJitterMicros;
+
+  uint32_t averageLateMicros() const {
+    return frames > 0 ? totalLateMicros / frames : 0;
+  }
+  uint32_t averageJitterMicros() const {
+    return frames > 0 ? totalJitterMicros / frames : 0;
+  }
+};
+
+/**
+ * 帧节奏与防撕裂
+ *
+ * 面板按自己的刷新周期从上到下扫描显存，写入区域时若扫描线从写入位置旁经过，
+ * 同一次扫描会显示一半旧帧、一半新帧（撕裂）。waitTearFree() 根据扫描位置与
+ * 预计的推送时间，等到写入全程都在扫描线之前（或之后）的最早时刻再返回。
+ *
+ * 扫描位置来自 ST7789 的 TE 信号（每次垂直消隐开始的上升沿）；没有接 TE 时
+ * 按 begin() 时刻起算的模拟刷新时钟推算（主机端总是如此）。模拟时钟与真实面板
+ * 的扫描不同步，设备上 DisplayManager 只在接了 TE 时调用 waitTearFree()。
+ * frameDue() 是固定步长的帧调度：截止时刻按目标间隔累加，不随处理延迟漂移，
+ * 迟到超过一个间隔的帧被跳过并计入 missedDeadlines
+ */
+class FramePacer {
+public:
+  static const uint32_t DEFAULT_REFRESH_MICROS = 16667;  // ST7789 默认 60 Hz（FRCTRL2 = 0x0F）
+
+  // ST7789 扫描时序：320 条门线 + 前后肩各 12 行（PORCTRL 默认 0x0C），
+  // TE 上升沿在消隐开始处，消隐结束后从第 0 行开始扫描
+  static const uint16_t GATE_LINES = 320;
+  static const uint16_t PORCH_LINES = 24;
+  static const uint16_t TOTAL_LINES = GATE_LINES + PORCH_LINES;
+  static const uint16_t PANEL_ROWS = 240;
+
+  FramePacer();
+  ~FramePacer();
+
+  // tePin < 0 时不使用 TE 信号，按 refreshMicros 模拟刷新时钟
+  bool begin(Adafruit_ST7789* tft, int8_t tePin = -1,
+             uint32_t refreshMicros = DEFAULT_REFRESH_MICROS);
+  void end();
+  bool isReady() const { return ready; }
+  bool hasTE() const { return tePin >= 0; }
+
+  // 面板扫描
+  uint32_t getRefreshMicros() const;  // 有 TE 时为实测周期
+  int16_t getScanLine() const;        // 正在扫描的行，消隐期间为负
+  void waitForVSync();                // 等到下一次消隐开始
+
+  // 推送 [top, bottom) 行、预计耗时 pushMicros 之前调用：
+  // 等到不会与扫描线交叉的时刻，返回等待的微秒数
+  uint32_t waitTearFree(int16_t top, int16_t bottom, uint32_t pushMicros);
+
+  // 固定步长帧调度
+  void setFrameInterval(uint32_t intervalMicros) { frameInterval = intervalMicros; }
+  uint32_t getFrameInterval() const { return frameInterval; }
+  bool frameDue() { return frameDue(frameInterval); }
+  bool frameDue(uint32_t intervalMicros);  // 本帧使用指定间隔（逐帧时长的动画）
+  void resetSchedule();                    // 以当前时刻为新时间线的起点
+
+  const FramePacingStats& getStats() const { return stats; }
+  void resetStats();
+
+private:
+  bool ready;
+  int8_t tePin;
+  uint32_t refreshMicros;
+  uint32_t epochMicros;  // 模拟刷新时钟：一次消隐开始的时刻
+
+  uint32_t frameInterval;
+  uint32_t lastDeadline;
+  uint32_t lastFrameStart;
+  bool firstFrame;
+
+  FramePacingStats stats;
+
+  uint32_t lastVSyncMicros() const;
+  uint32_t phaseNanos(uint32_t now, uint32_t periodMicros) const;
+  static bool isTearFree(int64_t startNs, int16_t top, int16_t rows,
+                         int64_t rowNs, int64_t lineNs, int64_t periodNs);
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,109 @@
+#include "ImageDecoder.h"
+
+ImageDecoder::ImageDecoder() {
+  image = nullptr;
+  cursor = nullptr;
+  packetLeft = 0;
+  packetRepeat = false;
+  packetColor = 0;
+}
+
+bool ImageDecoder::begin(const EncodedImage& img) {
+  image = nullptr;
+  if (img.data == nullptr || img.width == 0 || img.height == 0) return false;
+  if (img.encoding >= IMAGE_INDEXED1 && img.encoding <= IMAGE_INDEXED8 &&
+      img.palette == nullptr) {
+    return false;
+  }
+
+  image = &img;
+  cursor = img.data;
+  packetLeft = 0;
+  packetRepeat = false;
+  packetColor = 0;
+  return true;
+}
+
+uint8_t ImageDecoder::bitsPerPixel() const {
+  switch (image->encoding) {
+    case IMAGE_INDEXED1: return 1;
+    case IMAGE_INDEXED2: return 2;
+    case IMAGE_INDEXED4: return 4;
+    case IMAGE_INDEXED8: return 8;
+    default: return 16;
+  }
+}
+
+void ImageDecoder::nextRow(uint16_t* out) {
+  if (image == nullptr) return;
+  uint16_t width = image->width;
+
+  if (image->encoding == IMAGE_RGB565) {
+    for (uint16_t i = 0; i < width; i++, cursor += 2) {
+      out[i] = cursor[0] | (cursor[1] << 8);
+    }
+    return;
+  }
+
+  if (image->encoding == IMAGE_RLE) {
+    uint16_t i = 0;
+    while (i < width) {
+      if (packetLeft == 0) {
+        uint8_t header = *cursor++;
+        packetRepeat = (header & 0x80) != 0;
+        packetLeft = (header & 0x7F) + 1;
+        if (packetRepeat) {
+          packetColor = cursor[0] | (cursor[1] << 8);
+          cursor += 2;
+        }
+      }
+      uint16_t n = min((uint16_t)packetLeft, (uint16_t)(width - i));
+      if (packetRepeat) {
+        for (uint16_t k = 0; k < n; k++) out[i + k] = packetColor;
+      } else {
+        for (uint16_t k = 0; k < n; k++, cursor += 2) {
+          out[i + k] = cursor[0] | (cursor[1] << 8);
+        }
+      }
+      packetLeft -= n;
+      i += n;
+    }
+    return;
+  }
+
+  // 调色板索引
+  const uint16_t* palette = image->palette;
+  uint8_t bpp = bitsPerPixel();
+  if (bpp == 8) {
+    for (uint16_t i = 0; i < width; i++) out[i] = palette[cursor[i]];
+  } else {
+    uint8_t mask = (1 << bpp) - 1;
+    uint8_t perByte = 8 / bpp;
+    for (uint16_t i = 0; i < width; i++) {
+      uint8_t shift = 8 - bpp * (i % perByte + 1);
+      out[i] = palette[(cursor[i / perByte] >> shift) & mask];
+    }
+  }
+  cursor += ((uint32_t)width * bpp + 7) / 8;
+}
+
+uint32_t ImageDecoder::dataSize(const EncodedImage& img) {
+  if (img.data == nullptr) return 0;
+
+  if (img.encoding == IMAGE_RLE) {
+    // 需要扫描包头
+    uint32_t pixels = (uint32_t)img.width * img.height;
+    const uint8_t* p = img.data;
+    while (pixels > 0) {
+      uint8_t header = *p++;
+      uint8_t n = (header & 0x7F) + 1;
+      p += (header & 0x80) ? 2 : n * 2;
+      pixels -= min((uint32_t)n, pixels);
+    }
+    return p - img.data;
+  }
+
+  ImageDecoder decoder;
+  decoder.image = &img;
+  return (((uint32_t)img.width * decoder.bitsPerPixel() + 7) / 8) * img.height;
+}
@@ -0,0 +1,59 @@
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include <Arduino.h>
+
+// 编码图片的存储格式
+enum ImageEncoding {
+  IMAGE_RGB565,    // 原始 RGB565（小端字节）
+  IMAGE_INDEXED1,  // 1/2/4/8 位调色板索引，每行按字节对齐，高位在左
+  IMAGE_INDEXED2,
+  IMAGE_INDEXED4,
+  IMAGE_INDEXED8,
+  IMAGE_RLE        // RGB565 行程编码，见 ImageDecoder
+};
+
+/**
+ * 编码图片（ImageData 的压缩版本）
+ * 由主机端工具 host/asset_compiler 生成，用 DisplayManager::drawImage 绘制
+ */
+struct EncodedImage {
+  const uint8_t* data;      // 编码数据
+  const uint16_t* palette;  // 调色板（仅索引格式）
+  uint16_t width;
+  uint16_t height;
+  ImageEncoding encoding;
+};
+
+/**
+ * 编码图片逐行解码器
+ *
+ * RLE 数据为连续的包，包头字节 h：
+ *   h & 0x80：重复包，(h & 0x7F) + 1 个像素，后跟 1 个颜色（2 字节，小端）
+ *   否则：   原样包，h + 1 个像素，后跟 (h + 1) * 2 字节
+ * 包可以跨行
+ */
+class ImageDecoder {
+public:
+  ImageDecoder();
+
+  bool begin(const EncodedImage& img);
+  // 解码下一行（width 个像素）
+  void nextRow(uint16_t* out);
+
+  // 编码数据字节数（不含调色板）
+  static uint32_t dataSize(const EncodedImage& img);
+
+private:
+  const EncodedImage* image;
+  const uint8_t* cursor;
+
+  // RLE 包状态
+  uint8_t packetLeft;
+  bool packetRepeat;
+  uint16_t packetColor;
+
+  uint8_t bitsPerPixel() const;
+};
+
+#endif // IMAGE_DECODER_H
@@ -0,0 +1,256 @@
+#include "ImageReceiver.h"
+
+static uint16_t readLE16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+ImageReceiver::ImageReceiver(DisplayManager* display)
+  : pDisplay(display), state(STATE_IDLE), originX(0), originY(0), width(0),
+    height(0), encoding(IMAGE_RGB565), nextSeq(0), sinceAck(0),
+    gapReported(false), row(0), column(0), spanStart(0), colorLow(0),
+    haveLow(false), packetLeft(0), packetRepeat(false), startMicros(0),
+    uploadBytes(0) {
+  setMTU(DEFAULT_MTU);
+  resetStats();
+}
+
+void ImageReceiver::setMTU(uint16_t mtu) {
+  // 一次无响应写入最多 MTU - 3 字节，其中帧头、CRC 和序号占 8 字节
+  int chunk = (int)mtu - ATT_OVERHEAD - FrameParser::HEADER_SIZE -
+              FrameParser::CRC_SIZE - SEQUENCE_SIZE;
+  if (chunk < 2) chunk = 2;
+  if (chunk > FrameParser::MAX_PAYLOAD - SEQUENCE_SIZE) {
+    chunk = FrameParser::MAX_PAYLOAD - SEQUENCE_SIZE;
+  }
+  maxChunk = chunk;
+}
+
+void ImageReceiver::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+}
+
+uint8_t ImageReceiver::begin(const uint8_t* payload, uint16_t length,
+                             uint8_t* reply, uint16_t* replyLength) {
+  *replyLength = 0;
+  // 分发表已限定长度，直接调用时同样不能读越界
+  if (length < BEGIN_SIZE) {
+    return FRAME_STATUS_BAD_LENGTH;
+  }
+  if (pDisplay == nullptr ||
+      pDisplay->getFrameBuffer()->getMode() == BUFFER_MODE_STRIP) {
+    // 条带模式没有整屏缓冲，按显示列表重放，无法接收任意像素
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+
+  int16_t x = (int16_t)readLE16(payload);
+  int16_t y = (int16_t)readLE16(payload + 2);
+  uint16_t w = readLE16(payload + 4);
+  uint16_t h = readLE16(payload + 6);
+  uint8_t format = payload[8];
+  if (w == 0 || h == 0 || x < 0 || y < 0 || x + w > SCREEN_WIDTH ||
+      y + h > SCREEN_HEIGHT ||
+      (format != IMAGE_RGB565 && format != IMAGE_RLE)) {
+    return FRAME_STATUS_BAD_VALUE;
+  }
+
+  if (state == STATE_RECEIVING) {
+    Serial.println("图片上传被新的上传替换");
+    stats.aborted++;
+  }
+
+  originX = x;
+  originY = y;
+  width = w;
+  height = h;
+  encoding = (ImageEncoding)format;
+  nextSeq = 0;
+  sinceAck = 0;
+  gapReported = false;
+  row = 0;
+  column = 0;
+  spanStart = 0;
+  haveLow = false;
+  packetLeft = 0;
+  packetRepeat = false;
+  uploadBytes = 0;
+  startMicros = micros();
+  state = STATE_RECEIVING;
+  stats.uploads++;
+
+  Serial.printf("开始接收图片 %ux%u @(%d,%d) %s，每帧 %u 字节\n", w, h, x, y,
+                format == IMAGE_RLE ? "RLE" : "RGB565", maxChunk);
+
+  reply[0] = WINDOW;
+  reply[1] = maxChunk & 0xFF;
+  reply[2] = maxChunk >> 8;
+  *replyLength = 3;
+  return FRAME_STATUS_OK;
+}
+
+uint8_t ImageReceiver::receive(const uint8_t* payload, uint16_t length,
+                               uint8_t* reply, uint16_t* replyLength) {
+  *replyLength = 0;
+  if (state == STATE_IDLE) {
+    return FRAME_STATUS_UNAVAILABLE;
+  }
+
+  uint16_t seq = readLE16(payload);
+  uint16_t ahead = seq - nextSeq;
+  if (state == STATE_COMPLETE || (ahead != 0 && ahead >= 0x8000)) {
+    // 已收到的数据帧：发送端没收到确认而重发，再确认一次
+    stats.duplicateChunks++;
+    return ack(FRAME_STATUS_OK, reply, replyLength);
+  }
+  if (ahead != 0) {
+    // 前面的数据帧丢失：丢弃，同一个缺口只请求一次重传
+    stats.outOfOrderChunks++;
+    if (gapReported) {
+      return FRAME_STATUS_DEFERRED;
+    }
+    gapReported = true;
+    return ack(FRAME_STATUS_OUT_OF_ORDER, reply, replyLength);
+  }
+
+  nextSeq++;
+  gapReported = false;
+  stats.chunks++;
+  uint16_t dataLength = length - SEQUENCE_SIZE;
+  stats.bytes += dataLength;
+  uploadBytes += dataLength;
+
+  // 解码本帧数据，按行标记写入的区域
+  uint16_t firstRow = row;
+  decode(payload + SEQUENCE_SIZE, dataLength);
+  writeSpan();
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  if (fb->getMode() != BUFFER_MODE_DIRECT) {
+    uint16_t endRow = column > 0 ? row + 1 : row;
+    if (endRow > firstRow) {
+      fb->markDirty(originX, originY + firstRow, width, endRow - firstRow);
+    }
+  }
+
+  if (row >= height) {
+    finish();
+    return ack(FRAME_STATUS_OK, reply, replyLength);
+  }
+  if (++sinceAck >= ACK_INTERVAL) {
+    return ack(FRAME_STATUS_OK, reply, replyLength);
+  }
+  return FRAME_STATUS_DEFERRED;
+}
+
+uint8_t ImageReceiver::end(const uint8_t* payload, uint16_t length,
+                           uint8_t* reply, uint16_t* replyLength) {
+  // IMAGE_END 没有载荷，也不回复数据
+  (void)payload;
+  (void)length;
+  (void)reply;
+  *replyLength = 0;
+  abort();
+  return FRAME_STATUS_OK;
+}
+
+void ImageReceiver::abort() {
+  if (state == STATE_RECEIVING) {
+    // 已收到的行保留在屏幕上
+    Serial.printf("图片上传中止，已收 %u 行\n", row);
+    stats.aborted++;
+    pDisplay->flush();
+  }
+  state = STATE_IDLE;
+}
+
+// 确认：下一个期望的序号、本次上传已收字节数、是否完成
+uint8_t ImageReceiver::ack(uint8_t status, uint8_t* reply,
+                           uint16_t* replyLength) {
+  reply[0] = nextSeq & 0xFF;
+  reply[1] = nextSeq >> 8;
+  memcpy(reply + 2, &uploadBytes, sizeof(uploadBytes));
+  reply[6] = state == STATE_COMPLETE ? 1 : 0;
+  *replyLength = 7;
+  sinceAck = 0;
+  stats.acks++;
+  return status;
+}
+
+void ImageReceiver::finish() {
+  // 缓冲模式：一次推送所有标记的行
+  pDisplay->flush();
+  state = STATE_COMPLETE;
+  stats.completed++;
+  stats.lastBytes = uploadBytes;
+  stats.lastMicros = max(micros() - startMicros, 1UL);
+  Serial.printf("图片接收完成：%u 字节，%u ms，%.1f KB/s\n",
+                (unsigned)uploadBytes, (unsigned)(stats.lastMicros / 1000),
+                stats.lastKBps());
+}
+
+// ========== 流式解码 ==========
+
+void ImageReceiver::decode(const uint8_t* data, uint16_t length) {
+  for (uint16_t i = 0; i < length && row < height; i++) {
+    uint8_t b = data[i];
+    if (encoding == IMAGE_RLE && packetLeft == 0) {
+      // 包头：重复包后跟一个颜色，原样包后跟 n 个颜色
+      packetRepeat = (b & 0x80) != 0;
+      packetLeft = (b & 0x7F) + 1;
+      continue;
+    }
+    if (!haveLow) {
+      colorLow = b;
+      haveLow = true;
+      continue;
+    }
+    haveLow = false;
+    uint16_t color = colorLow | (b << 8);
+
+    if (encoding == IMAGE_RGB565) {
+      putPixels(color, 1);
+    } else if (packetRepeat) {
+      putPixels(color, packetLeft);
+      packetLeft = 0;
+    } else {
+      putPixels(color, 1);
+      packetLeft--;
+    }
+  }
+}
+
+// 写入 count 个同色像素（可跨行），超出图片的部分丢弃
+void ImageReceiver::putPixels(uint16_t color, uint16_t count) {
+  while (count > 0 && row < height) {
+    uint16_t n = min((uint16_t)(width - column), count);
+    for (uint16_t i = 0; i < n; i++) {
+      rowPixels[column + i] = color;
+    }
+    column += n;
+    count -= n;
+    if (column == width) {
+      writeSpan();
+      row++;
+      column = 0;
+      spanStart = 0;
+    }
+  }
+}
+
+// 写出当前行中尚未写出的像素
+void ImageReceiver::writeSpan() {
+  if (column <= spanStart) return;
+
+  int16_t x = originX + spanStart;
+  int16_t y = originY + row;
+  uint16_t count = column - spanStart;
+  FrameBuffer* fb = pDisplay->getFrameBuffer();
+  if (fb->getMode() == BUFFER_MODE_DIRECT) {
+    Adafruit_ST7789* tft = pDisplay->getTFT();
+    tft->startWrite();
+    tft->setAddrWindow(x, y, count, 1);
+    tft->writePixels(rowPixels + spanStart, count);
+    tft->endWrite();
+  } else {
+    fb->writeRow(x, y, count, rowPixels + spanStart);
+  }
+  spanStart = column;
+}
@@ -0,0 +1,118 @@
+#ifndef IMAGE_RECEIVER_H
+#define IMAGE_RECEIVER_H
+
+#include <Arduino.h>
+#include "Display.h"
+#include "BinaryProtocol.h"
+
+// 图片上传统计
+struct ImageUploadStats {
+  uint32_t uploads;           // IMAGE_BEGIN 次数
+  uint32_t completed;
+  uint32_t aborted;           // IMAGE_END 中止、BLE 断开，或被新的 IMAGE_BEGIN 替换
+  uint32_t chunks;            // 按序收到的数据帧
+  uint32_t duplicateChunks;   // 重传中已经收到过的数据帧（丢弃）
+  uint32_t outOfOrderChunks;  // 序号跳跃（前面的数据帧丢失，丢弃）
+  uint32_t acks;              // 发出的确认（含重传请求）
+  uint64_t bytes;             // 收到的图片数据字节（RLE 为压缩后的字节）
+  uint32_t lastBytes;         // 最近一次完成的上传
+  uint32_t lastMicros;        // 最近一次完成的上传：IMAGE_BEGIN 到刷新完成
+
+  // 最近一次上传的速率（KB/s）
+  float lastKBps() const {
+    return lastMicros > 0 ? lastBytes * 1000000.0f / 1024.0f / lastMicros : 0;
+  }
+};
+
+/**
+ * BLE 图片上传
+ *
+ * 手机用 IMAGE_BEGIN 声明区域和格式（IMAGE_RGB565 或 IMAGE_RLE），随后把图片数据
+ * 按行优先顺序切成带序号的 IMAGE_DATA 帧，用无响应写入连续发送。数据帧边界可以在
+ * 像素、行和 RLE 包的任意位置，收到后立即解码：缓冲模式写入帧缓冲并按行标记脏区域，
+ * 完成时刷新；直接模式逐段写入屏幕。
+ *
+ * 流控为滑动窗口：发送端最多有 WINDOW 个未确认的数据帧；每按序收到 ACK_INTERVAL 个
+ * 回复一次累计确认（下一个期望的序号）。序号跳跃时回复一次 OUT_OF_ORDER 和期望的
+ * 序号，发送端从该序号重发（回退 N 帧）。其余数据帧不回复（FRAME_STATUS_DEFERRED）
+ */
+class ImageReceiver {
+public:
+  static const uint8_t WINDOW = 16;
+  static const uint8_t ACK_INTERVAL = 4;
+  static const uint8_t SEQUENCE_SIZE = 2;  // 数据帧载荷开头的序号（小端）
+  static const uint8_t BEGIN_SIZE = 9;     // IMAGE_BEGIN 载荷：区域 8 字节 + 格式
+  static const uint8_t ATT_OVERHEAD = 3;   // 每次写入中 ATT 操作码与句柄
+  static const uint16_t DEFAULT_MTU = 23;
+
+  ImageReceiver(DisplayManager* display);
+
+  // 按协商的 ATT MTU 计算每个数据帧可携带的图片字节数（在 IMAGE_BEGIN 的回复中告知）
+  void setMTU(uint16_t mtu);
+  uint16_t getMaxChunk() const { return maxChunk; }
+
+  // 二进制指令处理，参数与 FrameHandler 相同（不含 context）
+  // IMAGE_BEGIN：x、y、宽、高（各 2 字节小端）、格式；回复窗口大小、每帧最大字节数
+  uint8_t begin(const uint8_t* payload, uint16_t length, uint8_t* reply,
+                uint16_t* replyLength);
+  // IMAGE_DATA：序号 + 图片数据；确认回复下一个期望的序号、已收字节数、是否完成
+  uint8_t receive(const uint8_t* payload, uint16_t length, uint8_t* reply,
+                  uint16_t* replyLength);
+  // IMAGE_END：中止未完成的上传
+  uint8_t end(const uint8_t* payload, uint16_t length, uint8_t* reply,
+              uint16_t* replyLength);
+
+  // 中止未完成的上传（BLE 断开时调用，已收到的行保留在屏幕上）
+  void abort();
+
+  bool isActive() const { return state == STATE_RECEIVING; }
+  const ImageUploadStats& getStats() const { return stats; }
+  void resetStats();
+
+private:
+  enum State {
+    STATE_IDLE,
+    STATE_RECEIVING,
+    STATE_COMPLETE   // 完成后对重发的数据帧重复完成确认（最后的确认可能丢失）
+  };
+
+  DisplayManager* pDisplay;
+  State state;
+  uint16_t maxChunk;
+
+  // 目标区域与格式
+  int16_t originX;
+  int16_t originY;
+  uint16_t width;
+  uint16_t height;
+  ImageEncoding encoding;
+
+  // 滑动窗口
+  uint16_t nextSeq;
+  uint8_t sinceAck;
+  bool gapReported;   // 当前缺口已回复过重传请求
+
+  // 写入位置：下一个像素在 (column, row)，本行从 spanStart 起尚未写出
+  uint16_t row;
+  uint16_t column;
+  uint16_t spanStart;
+  uint16_t rowPixels[SCREEN_WIDTH];
+
+  // 流式解码状态（数据帧可在颜色的两个字节之间切开）
+  uint8_t colorLow;
+  bool haveLow;
+  uint8_t packetLeft;   // RLE 包剩余像素，0 表示下一个字节是包头
+  bool packetRepeat;
+
+  unsigned long startMicros;
+  uint32_t uploadBytes;
+  ImageUploadStats stats;
+
+  void decode(const uint8_t* data, uint16_t length);
+  void putPixels(uint16_t color, uint16_t count);
+  void writeSpan();
+  void finish();
+  uint8_t ack(uint8_t status, uint8_t* reply, uint16_t* replyLength);
+};
+
+#endif // IMAGE_RECEIVER_H
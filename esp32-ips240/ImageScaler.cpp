@@ -0,0 +1,137 @@
+#include "ImageScaler.h"
+
+// ========== RGB565 插值 ==========
+
+// 把 RGB565 展开为 0x07E0F81F 布局（G 移到高半字），各通道之间留出空位，
+// 乘以不超过 32 的权重后相加不会进位到相邻通道
+static inline uint32_t expand565(uint16_t c) {
+  return ((uint32_t)c | ((uint32_t)c << 16)) & 0x07E0F81F;
+}
+
+static inline uint16_t compress565(uint32_t e) {
+  return (uint16_t)((e & 0xF81F) | (e >> 16));
+}
+
+// 按权重 w（0-32）在 a 和 b 之间插值（展开格式）
+static inline uint32_t lerp565(uint32_t a, uint32_t b, uint32_t w) {
+  return ((a * (32 - w) + b * w) >> 5) & 0x07E0F81F;
+}
+
+// ========== 缩放器 ==========
+
+ImageScaler::ImageScaler() {
+  srcData = nullptr;
+  srcWidth = 0;
+  srcHeight = 0;
+  scaleFilter = SCALE_NEAREST;
+  visibleX = visibleY = visibleW = visibleH = 0;
+  rowStart = 0;
+  rowStep = 0;
+  lastRowKey = 0xFFFFFFFF;
+  colNext = 0;
+}
+
+bool ImageScaler::begin(const uint16_t* src, uint16_t srcW, uint16_t srcH,
+                        int16_t x, int16_t y, uint16_t dstW, uint16_t dstH,
+                        int16_t clipW, int16_t clipH, ScaleFilter filter) {
+  if (src == nullptr || srcW == 0 || srcH == 0 || dstW == 0 || dstH == 0) {
+    return false;
+  }
+
+  // 裁剪到 [0, clipW) x [0, clipH)
+  int32_t x0 = x < 0 ? 0 : x;
+  int32_t y0 = y < 0 ? 0 : y;
+  int32_t x1 = (int32_t)x + dstW;
+  int32_t y1 = (int32_t)y + dstH;
+  if (x1 > clipW) x1 = clipW;
+  if (y1 > clipH) y1 = clipH;
+  if (x0 >= x1 || y0 >= y1) return false;
+
+  if (x1 - x0 > MAX_WIDTH) {
+    Serial.printf("ImageScaler: 可见宽度 %d 超过 %d\n", (int)(x1 - x0),
+                  MAX_WIDTH);
+    return false;
+  }
+
+  srcData = src;
+  srcWidth = srcW;
+  srcHeight = srcH;
+  scaleFilter = filter;
+  visibleX = x0;
+  visibleY = y0;
+  visibleW = x1 - x0;
+  visibleH = y1 - y0;
+
+  // 16.16 定点步长（向上取整，使整数比例的采样与精确除法一致）；
+  // 双线性按像素中心对齐（偏移半个源像素）
+  int32_t colStep = (((uint32_t)srcW << 16) + dstW - 1) / dstW;
+  rowStep = (((uint32_t)srcH << 16) + dstH - 1) / dstH;
+  int32_t colOffset = 0;
+  int32_t rowOffset = 0;
+  if (filter == SCALE_BILINEAR) {
+    colOffset = colStep / 2 - 0x8000;
+    rowOffset = rowStep / 2 - 0x8000;
+  }
+
+  int32_t pos = (int32_t)((int64_t)(x0 - x) * colStep) + colOffset;
+  for (int16_t k = 0; k < visibleW; k++, pos += colStep) {
+    sourcePosition(pos, srcW, colIndex[k], colWeight[k]);
+  }
+  colNext = srcW > 1 ? 1 : 0;
+
+  rowStart = (int32_t)((int64_t)(y0 - y) * rowStep) + rowOffset;
+  lastRowKey = 0xFFFFFFFF;
+  return true;
+}
+
+void ImageScaler::sourcePosition(int32_t pos, uint16_t size, uint16_t& index,
+                                 uint8_t& weight) const {
+  if (scaleFilter == SCALE_NEAREST) {
+    index = (uint16_t)(pos >> 16);
+    if (index >= size) index = size - 1;
+    weight = 0;
+    return;
+  }
+
+  if (pos < 0) pos = 0;
+  index = (uint16_t)(pos >> 16);
+  weight = (uint8_t)((pos >> 11) & 0x1F);
+  if (size == 1) {
+    index = 0;
+    weight = 0;
+  } else if (index >= size - 1) {
+    // 最后一个源像素：改为前一个像素加满权重，保证 index + 1 不越界
+    index = size - 2;
+    weight = 32;
+  }
+}
+
+bool ImageScaler::scaleRow(int16_t row, uint16_t* out) {
+  uint16_t srcY;
+  uint8_t rowWeight;
+  sourcePosition(rowStart + (int32_t)row * rowStep, srcHeight, srcY, rowWeight);
+
+  uint32_t key = ((uint32_t)srcY << 8) | rowWeight;
+  if (key == lastRowKey) return false;
+  lastRowKey = key;
+
+  const uint16_t* row0 = &srcData[(uint32_t)srcY * srcWidth];
+
+  if (scaleFilter == SCALE_NEAREST) {
+    for (int16_t k = 0; k < visibleW; k++) {
+      out[k] = row0[colIndex[k]];
+    }
+    return true;
+  }
+
+  const uint16_t* row1 = srcHeight > 1 ? row0 + srcWidth : row0;
+  uint8_t next = colNext;
+  for (int16_t k = 0; k < visibleW; k++) {
+    uint16_t i = colIndex[k];
+    uint32_t w = colWeight[k];
+    uint32_t top = lerp565(expand565(row0[i]), expand565(row0[i + next]), w);
+    uint32_t bottom = lerp565(expand565(row1[i]), expand565(row1[i + next]), w);
+    out[k] = compress565(lerp565(top, bottom, rowWeight));
+  }
+  return true;
+}
@@ -0,0 +1,63 @@
+#ifndef IMAGE_SCALER_H
+#define IMAGE_SCALER_H
+
+#include <Arduino.h>
+
+// 缩放滤波方式
+enum ScaleFilter {
+  SCALE_NEAREST,   // 最近邻（像素风格图标）
+  SCALE_BILINEAR   // 双线性（RGB565 分通道插值）
+};
+
+/**
+ * RGB565 图片缩放器
+ *
+ * begin() 先把目标矩形裁剪到可见区域，再按 16.16 定点步长为每个可见列
+ * 预先计算源列号（双线性时还有 5 位权重），之后 scaleRow() 逐行生成像素，
+ * 内循环只做查表，不含浮点与边界判断。
+ * 相邻目标行对应同一源行时 scaleRow() 返回 false，调用方直接复用上一行。
+ */
+class ImageScaler {
+public:
+  static const uint16_t MAX_WIDTH = 320;  // 可见区域最大宽度（查找表大小）
+
+  ImageScaler();
+
+  // 计算裁剪区域与列查找表；完全不可见或参数无效时返回 false
+  bool begin(const uint16_t* src, uint16_t srcW, uint16_t srcH,
+             int16_t x, int16_t y, uint16_t dstW, uint16_t dstH,
+             int16_t clipW, int16_t clipH, ScaleFilter filter = SCALE_NEAREST);
+
+  // 裁剪后的可见区域（屏幕坐标）
+  int16_t getX() const { return visibleX; }
+  int16_t getY() const { return visibleY; }
+  int16_t getWidth() const { return visibleW; }
+  int16_t getHeight() const { return visibleH; }
+
+  // 生成可见区域第 row 行（getWidth() 个像素）
+  // 与上一次生成的行相同时不写 out，返回 false
+  bool scaleRow(int16_t row, uint16_t* out);
+
+private:
+  const uint16_t* srcData;
+  uint16_t srcWidth;
+  uint16_t srcHeight;
+  ScaleFilter scaleFilter;
+
+  int16_t visibleX, visibleY, visibleW, visibleH;
+
+  // 行方向：可见第一行的定点源坐标与步长
+  int32_t rowStart;
+  int32_t rowStep;
+  uint32_t lastRowKey;
+
+  // 列方向查找表
+  uint16_t colIndex[MAX_WIDTH];
+  uint8_t colWeight[MAX_WIDTH];  // 双线性：右侧像素权重（0-32）
+  uint8_t colNext;               // 双线性：右侧像素偏移（源宽为 1 时为 0）
+
+  void sourcePosition(int32_t pos, uint16_t size, uint16_t& index,
+                      uint8_t& weight) const;
+};
+
+#endif // IMAGE_SCALER_H
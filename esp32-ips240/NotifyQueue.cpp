@@ -0,0 +1,201 @@
+#include "NotifyQueue.h"
+#include "BinaryProtocol.h"
+
+NotifyQueue::NotifyQueue()
+  : readPos(0), used(0), fragmentOffset(0), fragmentIndex(0), messageSeq(0),
+    pushedCount(0), retiredCount(0),
+    intervalMicros(DEFAULT_INTERVAL_MICROS),
+    packetsPerInterval(DEFAULT_PACKETS_PER_INTERVAL), windowStart(0),
+    sentInWindow(0), windowFull(false) {
+#if defined(ARDUINO_ARCH_ESP32)
+  portMUX_INITIALIZE(&mux);
+#endif
+  resetStats();
+}
+
+void NotifyQueue::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+  stats.queuedBytes = used;
+  stats.peakQueuedBytes = used;
+}
+
+void NotifyQueue::setPacing(uint32_t intervalMicros, uint8_t packetsPerInterval) {
+  lock();
+  this->intervalMicros = intervalMicros;
+  this->packetsPerInterval = max(packetsPerInterval, (uint8_t)1);
+  unlock();
+}
+
+void NotifyQueue::clear() {
+  lock();
+  readPos = 0;
+  used = 0;
+  fragmentOffset = 0;
+  fragmentIndex = 0;
+  retiredCount = pushedCount;
+  stats.queuedBytes = 0;
+  unlock();
+}
+
+bool NotifyQueue::push(const uint8_t* data, size_t length) {
+  if (length == 0) return false;
+
+  lock();
+  if (length + 2 > (size_t)(CAPACITY - used)) {
+    stats.droppedMessages++;
+    stats.droppedBytes += length;
+    unlock();
+    return false;
+  }
+
+  // 2 字节长度（小端）+ 数据，写到环尾（可能绕回开头）
+  uint16_t pos = (readPos + used) % CAPACITY;
+  buffer[pos] = length & 0xFF;
+  buffer[(pos + 1) % CAPACITY] = length >> 8;
+  pos = (pos + 2) % CAPACITY;
+  uint16_t first = min((size_t)(CAPACITY - pos), length);
+  memcpy(buffer + pos, data, first);
+  memcpy(buffer, data + first, length - first);
+
+  used += length + 2;
+  pushedCount++;
+  stats.messages++;
+  stats.queuedBytes = used;
+  stats.peakQueuedBytes = max(stats.peakQueuedBytes, used);
+  unlock();
+  return true;
+}
+
+size_t NotifyQueue::take(unsigned long now, uint8_t* out, size_t maxLength) {
+  if (maxLength <= FRAGMENT_HEADER) return 0;
+
+  lock();
+  if (used == 0) {
+    unlock();
+    return 0;
+  }
+
+  // 每个连接间隔最多 packetsPerInterval 个通知
+  if (now - windowStart >= intervalMicros) {
+    windowStart = now;
+    sentInWindow = 0;
+    windowFull = false;
+  }
+  if (sentInWindow >= packetsPerInterval) {
+    if (!windowFull) {
+      windowFull = true;
+      stats.pacedWaits++;
+    }
+    unlock();
+    return 0;
+  }
+
+  uint16_t length = peekLength(0);
+  size_t n;
+  if (fragmentOffset > 0 || length > maxLength) {
+    n = takeFragment(length, out, maxLength);
+  } else {
+    n = takeCoalesced(out, maxLength);
+  }
+
+  sentInWindow++;
+  stats.notifications++;
+  stats.sentBytes += n;
+  stats.queuedBytes = used;
+  unlock();
+  return n;
+}
+
+// 队首消息的下一个分片
+size_t NotifyQueue::takeFragment(uint16_t length, uint8_t* out,
+                                 size_t maxLength) {
+  uint16_t chunk = min((size_t)(length - fragmentOffset),
+                       maxLength - FRAGMENT_HEADER);
+  bool last = fragmentOffset + chunk == length;
+  out[0] = NOTIFY_FRAGMENT_MARKER;
+  out[1] = messageSeq;
+  out[2] = fragmentIndex | (last ? NOTIFY_FRAGMENT_LAST : 0);
+  copyOut(2 + fragmentOffset, out + FRAGMENT_HEADER, chunk);
+  stats.fragments++;
+
+  if (last) {
+    pop(length);
+    fragmentOffset = 0;
+    fragmentIndex = 0;
+    messageSeq++;
+  } else {
+    fragmentOffset += chunk;
+    fragmentIndex++;
+  }
+  return FRAGMENT_HEADER + chunk;
+}
+
+// 队首消息，加上其后能放进同一个通知的同类消息
+size_t NotifyQueue::takeCoalesced(uint8_t* out, size_t maxLength) {
+  uint16_t length = peekLength(0);
+  bool frames = peekByte(2) == FRAME_MAGIC;
+  copyOut(2, out, length);
+  pop(length);
+  size_t n = length;
+
+  while (used > 0) {
+    length = peekLength(0);
+    if ((peekByte(2) == FRAME_MAGIC) != frames) break;
+    // 文本之间加换行分隔；二进制帧自带长度，直接拼接
+    size_t separator = frames ? 0 : 1;
+    if (n + separator + length > maxLength) break;
+    if (!frames) out[n] = '\n';
+    copyOut(2, out + n + separator, length);
+    pop(length);
+    n += separator + length;
+    stats.coalescedMessages++;
+  }
+  return n;
+}
+
+// ========== 字节环 ==========
+
+uint16_t NotifyQueue::peekLength(uint16_t offset) const {
+  return peekByte(offset) | (peekByte(offset + 1) << 8);
+}
+
+uint8_t NotifyQueue::peekByte(uint16_t offset) const {
+  return buffer[(readPos + offset) % CAPACITY];
+}
+
+void NotifyQueue::copyOut(uint16_t offset, uint8_t* out, uint16_t length) const {
+  uint16_t pos = (readPos + offset) % CAPACITY;
+  uint16_t first = min((uint16_t)(CAPACITY - pos), length);
+  memcpy(out, buffer + pos, first);
+  memcpy(out + first, buffer, length - first);
+}
+
+// 移除队首消息（长度字段 + 数据）
+void NotifyQueue::pop(uint16_t length) {
+  readPos = (readPos + 2 + length) % CAPACITY;
+  used -= 2 + length;
+  retiredCount++;
+  if (used == 0) readPos = 0;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+void NotifyQueue::lock() {
+  portENTER_CRITICAL(&mux);
+}
+
+void NotifyQueue::unlock() {
+  portEXIT_CRITICAL(&mux);
+}
+
+#else
+
+void NotifyQueue::lock() {
+  mutex.lock();
+}
+
+void NotifyQueue::unlock() {
+  mutex.unlock();
+}
+
+#endif
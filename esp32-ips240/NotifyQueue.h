@@ -0,0 +1,107 @@
+#ifndef NOTIFY_QUEUE_H
+#define NOTIFY_QUEUE_H
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#else
+#include <mutex>
+#endif
+
+// 分片通知：标记 | 消息序号 | 分片序号（最后一片置 FRAGMENT_LAST）| 数据
+// 0xFE 不会出现在 UTF-8 文本开头，也不是二进制帧头 0xA5
+#define NOTIFY_FRAGMENT_MARKER  0xFE
+#define NOTIFY_FRAGMENT_LAST    0x80
+
+struct NotifyQueueStats {
+  uint32_t messages;           // 入队的消息
+  uint32_t notifications;      // 发出的通知
+  uint32_t coalescedMessages;  // 与前一条消息合并进同一个通知的消息
+  uint32_t fragments;          // 分片通知
+  uint32_t droppedMessages;    // 队列满被丢弃的消息
+  uint32_t droppedBytes;
+  uint32_t pacedWaits;         // 本连接间隔的通知配额用完、留到下个间隔
+  uint64_t sentBytes;          // 通知字节（含分隔符与分片头）
+  uint16_t queuedBytes;        // 当前排队字节
+  uint16_t peakQueuedBytes;
+};
+
+/**
+ * BLE 通知发送队列
+ *
+ * sendData 只把消息复制进固定大小的字节环，由主循环按连接间隔取出发送：
+ * - 合并：连续的短文本消息以 '\n' 分隔合并进一个通知，连续的二进制帧直接拼接
+ *   （帧自带长度）；文本与帧不混合
+ * - 分片：超过一个通知容量（MTU - 3）的消息加 3 字节分片头逐片发送，手机按消息序号
+ *   和分片序号拼回
+ * - 节奏：每个连接间隔最多发 packetsPerInterval 个通知，多出的留在队列里，
+ *   不在协议栈中堆积
+ * 队列满时丢弃整条新消息并计数。入队与取出可在不同任务中进行
+ */
+class NotifyQueue {
+public:
+  static const uint16_t CAPACITY = 2048;  // 排队字节（每条消息另占 2 字节长度）
+  static const uint8_t FRAGMENT_HEADER = 3;
+  static const uint32_t DEFAULT_INTERVAL_MICROS = 15000;
+  static const uint8_t DEFAULT_PACKETS_PER_INTERVAL = 4;
+
+  NotifyQueue();
+
+  // 复制一条消息入队；放不下时丢弃整条并返回 false
+  bool push(const uint8_t* data, size_t length);
+  // 取出下一个通知（不超过 maxLength 字节）写入 out，返回长度；
+  // 队列为空或本连接间隔的配额已用完时返回 0
+  size_t take(unsigned long now, uint8_t* out, size_t maxLength);
+  void clear();
+
+  void setPacing(uint32_t intervalMicros, uint8_t packetsPerInterval);
+  uint32_t getIntervalMicros() const { return intervalMicros; }
+  bool isEmpty() const { return used == 0; }
+
+  const NotifyQueueStats& getStats() const { return stats; }
+  void resetStats();
+
+  // 累计入队 / 已离开队列（发出或被清除）的消息数，不随 resetStats 清零；
+  // 入队时记下 getPushedCount()，getRetiredCount() 追上它即该消息已发出
+  uint32_t getPushedCount() const { return pushedCount; }
+  uint32_t getRetiredCount() const { return retiredCount; }
+
+private:
+  uint8_t buffer[CAPACITY];
+  uint16_t readPos;
+  uint16_t used;
+
+  // 队首消息的分片进度
+  uint16_t fragmentOffset;
+  uint8_t fragmentIndex;
+  uint8_t messageSeq;
+  uint32_t pushedCount;
+  uint32_t retiredCount;
+
+  // 节奏控制
+  uint32_t intervalMicros;
+  uint8_t packetsPerInterval;
+  unsigned long windowStart;
+  uint8_t sentInWindow;
+  bool windowFull;   // 本间隔已计入 pacedWaits
+
+  NotifyQueueStats stats;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portMUX_TYPE mux;
+#else
+  std::mutex mutex;
+#endif
+
+  void lock();
+  void unlock();
+  uint16_t peekLength(uint16_t offset) const;
+  uint8_t peekByte(uint16_t offset) const;
+  void copyOut(uint16_t offset, uint8_t* out, uint16_t length) const;
+  void pop(uint16_t length);
+  size_t takeFragment(uint16_t length, uint8_t* out, size_t maxLength);
+  size_t takeCoalesced(uint8_t* out, size_t maxLength);
+};
+
+#endif // NOTIFY_QUEUE_H
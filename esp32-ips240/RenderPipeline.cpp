@@ -0,0 +1,298 @@
+#include "RenderPipeline.h"
+#include "BufferAllocator.h"
+
+#if !defined(ARDUINO_ARCH_ESP32)
+#include <chrono>
+#endif
+
+RenderPipeline::RenderPipeline(DisplayManager* display)
+  : pDisplay(display), ring(nullptr), head(0), tail(0), renderedFrames(0),
+    renderedStamp(0), running(false), stopping(false), savedAutoFlush(true) {
+#if defined(ARDUINO_ARCH_ESP32)
+  task = nullptr;
+  taskExited = false;
+#endif
+  resetStats();
+}
+
+RenderPipeline::~RenderPipeline() {
+  end();
+}
+
+bool RenderPipeline::begin() {
+  if (running.load()) return true;
+  if (pDisplay == nullptr) return false;
+
+  // 两个核都频繁访问命令环，放在内部 SRAM
+  if (ring == nullptr) {
+    MemoryRegion region;
+    ring = (Slot*)BufferAllocator::allocate(RING_SIZE * sizeof(Slot),
+                                            BUFFER_PLACE_INTERNAL, &region);
+    if (ring == nullptr) {
+      Serial.println("Failed to allocate render command ring");
+      return false;
+    }
+  }
+
+  head.store(0);
+  tail.store(0);
+  renderedFrames.store(0);
+  renderedStamp.store(micros());
+  stopping.store(false);
+  resetStats();
+
+  // 渲染任务按帧结束标记刷新
+  savedAutoFlush = pDisplay->getAutoFlush();
+  pDisplay->setAutoFlush(false);
+  running.store(true);
+
+#if defined(ARDUINO_ARCH_ESP32)
+  // Arduino 的 loop 任务在核 1，渲染任务放到另一个核
+  BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+  taskExited.store(false);
+  if (xTaskCreatePinnedToCore(taskEntry, "render", TASK_STACK_SIZE, this,
+                              TASK_PRIORITY, &task, core) != pdPASS) {
+    Serial.println("Failed to start render task");
+    running.store(false);
+    pDisplay->setAutoFlush(savedAutoFlush);
+    return false;
+  }
+  Serial.printf("渲染流水线已启动（渲染任务在核 %d）\n", (int)core);
+#else
+  worker = std::thread(&RenderPipeline::renderLoop, this);
+#endif
+  return true;
+}
+
+void RenderPipeline::end() {
+  if (!running.load()) {
+    BufferAllocator::release(ring);
+    ring = nullptr;
+    return;
+  }
+
+  // 渲染任务处理完剩余命令后退出
+  stopping.store(true);
+  wakeRenderer();
+#if defined(ARDUINO_ARCH_ESP32)
+  while (!taskExited.load()) {
+    delay(1);
+  }
+  task = nullptr;
+#else
+  worker.join();
+  hostWaitUntilMicros(renderedStamp.load());
+#endif
+  running.store(false);
+  pDisplay->setAutoFlush(savedAutoFlush);
+  BufferAllocator::release(ring);
+  ring = nullptr;
+}
+
+void RenderPipeline::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+}
+
+// ========== 生产端（应用代码） ==========
+
+void RenderPipeline::push(const DisplayCommand& cmd, const char* text,
+                          bool frameEnd) {
+  if (!running.load()) return;
+
+  uint32_t slotIndex = head.load(std::memory_order_relaxed);
+  if (slotIndex - tail.load(std::memory_order_acquire) >= RING_SIZE) {
+    // 命令环满：等渲染任务释放命令槽
+    stats.producerStalls++;
+    unsigned long start = micros();
+    wakeRenderer();
+    while (slotIndex - tail.load(std::memory_order_acquire) >= RING_SIZE) {
+      waitForRenderer();
+    }
+#if !defined(ARDUINO_ARCH_ESP32)
+    hostWaitUntilMicros(renderedStamp.load(std::memory_order_acquire));
+#endif
+    stats.stallMicros += micros() - start;
+  }
+
+  Slot& slot = ring[slotIndex % RING_SIZE];
+  slot.cmd = cmd;
+  slot.frameEnd = frameEnd;
+  slot.stamp = micros();
+  slot.text[0] = '\0';
+  if (text != nullptr) {
+    strncpy(slot.text, text, MAX_TEXT_LENGTH);
+    slot.text[MAX_TEXT_LENGTH] = '\0';
+  }
+  head.store(slotIndex + 1, std::memory_order_release);
+
+  if (!frameEnd) stats.commands++;
+}
+
+void RenderPipeline::clear(uint16_t color) {
+  push(DisplayManager::makeCommand(DISPLAY_OP_CLEAR, 0, 0, SCREEN_WIDTH,
+                                   SCREEN_HEIGHT, color),
+       nullptr, false);
+}
+
+void RenderPipeline::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                              uint16_t color) {
+  push(DisplayManager::makeCommand(DISPLAY_OP_FILL_RECT, x, y, w, h, color),
+       nullptr, false);
+}
+
+void RenderPipeline::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                              uint16_t color) {
+  push(DisplayManager::makeCommand(DISPLAY_OP_RECT, x, y, w, h, color),
+       nullptr, false);
+}
+
+void RenderPipeline::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                              uint16_t color) {
+  push(DisplayManager::makeCommand(DISPLAY_OP_LINE, x0, y0, x1, y1, color),
+       nullptr, false);
+}
+
+void RenderPipeline::drawCircle(int16_t x, int16_t y, int16_t r,
+                                uint16_t color) {
+  push(DisplayManager::makeCommand(DISPLAY_OP_CIRCLE, x, y, r, 0, color),
+       nullptr, false);
+}
+
+void RenderPipeline::fillCircle(int16_t x, int16_t y, int16_t r,
+                                uint16_t color) {
+  push(DisplayManager::makeCommand(DISPLAY_OP_FILL_CIRCLE, x, y, r, 0, color),
+       nullptr, false);
+}
+
+void RenderPipeline::drawText(const char* text, int16_t x, int16_t y,
+                              uint16_t color, uint8_t size) {
+  if (text == nullptr) return;
+  DisplayCommand cmd =
+      DisplayManager::makeCommand(DISPLAY_OP_TEXT, x, y, 0, 0, color);
+  cmd.param = size;
+  push(cmd, text, false);
+}
+
+void RenderPipeline::drawImage(const ImageData& img, int16_t x, int16_t y) {
+  if (img.data == nullptr) return;
+  DisplayCommand cmd = DisplayManager::makeCommand(
+      DISPLAY_OP_IMAGE, x, y, img.width, img.height, 0);
+  cmd.data = img.data;
+  cmd.srcWidth = img.width;
+  cmd.srcHeight = img.height;
+  push(cmd, nullptr, false);
+}
+
+void RenderPipeline::drawBitmap(const uint8_t* bitmap, int16_t x, int16_t y,
+                                uint16_t w, uint16_t h, uint16_t color,
+                                uint16_t background) {
+  if (bitmap == nullptr) return;
+  DisplayCommand cmd =
+      DisplayManager::makeCommand(DISPLAY_OP_BITMAP, x, y, w, h, color);
+  cmd.color2 = background;
+  cmd.data = bitmap;
+  push(cmd, nullptr, false);
+}
+
+void RenderPipeline::submitFrame() {
+  DisplayCommand marker;
+  memset(&marker, 0, sizeof(marker));
+  push(marker, nullptr, true);
+  stats.framesSubmitted++;
+  wakeRenderer();
+}
+
+void RenderPipeline::waitIdle() {
+  if (!running.load()) return;
+  wakeRenderer();
+  while (renderedFrames.load(std::memory_order_acquire) < stats.framesSubmitted) {
+    waitForRenderer();
+  }
+#if !defined(ARDUINO_ARCH_ESP32)
+  hostWaitUntilMicros(renderedStamp.load(std::memory_order_acquire));
+#endif
+}
+
+// ========== 消费端（渲染任务） ==========
+
+// 取出并执行一条命令；命令环为空时返回 false
+bool RenderPipeline::renderNext() {
+  uint32_t slotIndex = tail.load(std::memory_order_relaxed);
+  if (slotIndex == head.load(std::memory_order_acquire)) return false;
+
+  const Slot& slot = ring[slotIndex % RING_SIZE];
+#if !defined(ARDUINO_ARCH_ESP32)
+  // 主机：命令不能在写入时刻之前执行（两个线程的模拟时间各自独立）
+  hostWaitUntilMicros(slot.stamp);
+#endif
+
+  unsigned long start = micros();
+  bool frameEnd = slot.frameEnd;
+  unsigned long submitted = slot.stamp;
+  if (frameEnd) {
+    pDisplay->flush();
+  } else {
+    pDisplay->execute(slot.cmd, slot.text);
+  }
+  unsigned long done = micros();
+  stats.renderMicros += done - start;
+
+  renderedStamp.store(done, std::memory_order_release);
+  tail.store(slotIndex + 1, std::memory_order_release);
+
+  if (frameEnd) {
+    uint32_t latency = done - submitted;
+    stats.totalLatencyMicros += latency;
+    stats.maxLatencyMicros = max(stats.maxLatencyMicros, latency);
+    stats.framesRendered++;
+    renderedFrames.store(stats.framesRendered, std::memory_order_release);
+  }
+  return true;
+}
+
+void RenderPipeline::renderLoop() {
+  for (;;) {
+    if (renderNext()) continue;
+    if (stopping.load()) break;
+    waitForWork();
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  taskExited.store(true);
+  vTaskDelete(nullptr);
+#endif
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+void RenderPipeline::taskEntry(void* arg) {
+  ((RenderPipeline*)arg)->renderLoop();
+}
+
+void RenderPipeline::wakeRenderer() {
+  if (task != nullptr) xTaskNotifyGive(task);
+}
+
+void RenderPipeline::waitForWork() {
+  // 由 submitFrame / 命令环满时的通知唤醒；超时后也检查一次，不会错过命令
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5));
+}
+
+void RenderPipeline::waitForRenderer() {
+  vTaskDelay(1);
+}
+
+#else
+
+void RenderPipeline::wakeRenderer() {
+}
+
+void RenderPipeline::waitForWork() {
+  std::this_thread::sleep_for(std::chrono::microseconds(20));
+}
+
+void RenderPipeline::waitForRenderer() {
+  std::this_thread::yield();
+}
+
+#endif
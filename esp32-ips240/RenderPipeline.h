@@ -0,0 +1,112 @@
+#ifndef RENDER_PIPELINE_H
+#define RENDER_PIPELINE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Display.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+// 流水线统计（渲染端的字段在 waitIdle() / end() 之后读取）
+struct RenderPipelineStats {
+  uint32_t framesSubmitted;
+  uint32_t framesRendered;
+  uint32_t commands;
+  uint32_t producerStalls;      // 命令环满、应用代码等待渲染任务的次数
+  uint64_t stallMicros;
+  uint64_t renderMicros;        // 渲染任务执行命令与刷新的总时间
+  uint64_t totalLatencyMicros;  // 提交帧到刷新完成
+  uint32_t maxLatencyMicros;
+
+  uint32_t averageLatencyMicros() const {
+    return framesRendered > 0 ? totalLatencyMicros / framesRendered : 0;
+  }
+};
+
+/**
+ * 双核渲染流水线
+ *
+ * 应用代码把绘制调用记录为 DisplayCommand，写入单生产者 / 单消费者的无锁命令环；
+ * 固定在另一个核上的渲染任务取出命令，经 DisplayManager::execute 光栅化到帧缓冲，
+ * 在 submitFrame() 写入的帧结束标记处刷新。流水线运行期间 DisplayManager 只由
+ * 渲染任务使用，应用代码不能再直接调用它。文字复制进命令槽，图片与位图只传指针
+ * （数据须保持有效到该帧渲染完成）。主机端渲染任务为 std::thread
+ */
+class RenderPipeline {
+public:
+  static const uint16_t RING_SIZE = 64;  // 2 的幂
+  static const uint8_t MAX_TEXT_LENGTH = 47;
+  static const uint32_t TASK_STACK_SIZE = 4096;
+  static const uint8_t TASK_PRIORITY = 2;
+
+  RenderPipeline(DisplayManager* display);
+  ~RenderPipeline();
+
+  // 启动渲染任务（固定在调用者以外的核上）
+  bool begin();
+  // 渲染完已提交的命令后停止
+  void end();
+  bool isRunning() const { return running.load(); }
+
+  // 记录绘制命令（命令环满时等待渲染任务）
+  void clear(uint16_t color = ST77XX_BLACK);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+  void fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+  void drawText(const char* text, int16_t x, int16_t y,
+                uint16_t color = ST77XX_WHITE, uint8_t size = 1);
+  void drawImage(const ImageData& img, int16_t x, int16_t y);
+  void drawBitmap(const uint8_t* bitmap, int16_t x, int16_t y, uint16_t w,
+                  uint16_t h, uint16_t color, uint16_t background);
+
+  // 帧结束：渲染任务执行到这里时刷新
+  void submitFrame();
+  // 等待已提交的帧全部渲染完成
+  void waitIdle();
+
+  const RenderPipelineStats& getStats() const { return stats; }
+  void resetStats();
+
+private:
+  struct Slot {
+    DisplayCommand cmd;
+    unsigned long stamp;  // 写入时刻（帧结束标记为提交时刻）
+    bool frameEnd;
+    char text[MAX_TEXT_LENGTH + 1];
+  };
+
+  DisplayManager* pDisplay;
+  Slot* ring;
+  std::atomic<uint32_t> head;            // 生产者下一个写入位置
+  std::atomic<uint32_t> tail;            // 消费者下一个读取位置
+  std::atomic<uint32_t> renderedFrames;  // waitIdle 据此判断完成
+  std::atomic<unsigned long> renderedStamp;  // 最近一次释放命令槽 / 完成帧的时刻
+  std::atomic<bool> running;
+  std::atomic<bool> stopping;
+  bool savedAutoFlush;
+  RenderPipelineStats stats;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  TaskHandle_t task;
+  std::atomic<bool> taskExited;
+  static void taskEntry(void* arg);
+#else
+  std::thread worker;
+#endif
+
+  void push(const DisplayCommand& cmd, const char* text, bool frameEnd);
+  void renderLoop();
+  bool renderNext();
+  void wakeRenderer();
+  void waitForWork();
+  void waitForRenderer();
+};
+
+#endif // RENDER_PIPELINE_H
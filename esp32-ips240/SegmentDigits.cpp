@@ -0,0 +1,166 @@
+#include "SegmentDigits.h"
+
+// 七段编码：bit0~6 依次为 a b c d e f g
+static const uint8_t SEG_A = 0x01;
+static const uint8_t SEG_B = 0x02;
+static const uint8_t SEG_C = 0x04;
+static const uint8_t SEG_D = 0x08;
+static const uint8_t SEG_E = 0x10;
+static const uint8_t SEG_F = 0x20;
+static const uint8_t SEG_G = 0x40;
+
+static const uint8_t DIGIT_SEGMENTS[10] = {
+  0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F
+};
+
+// 笔画半宽；笔画两端收成尖角（六边形）
+static const int8_t HALF_THICKNESS = 2;
+
+static const uint8_t GLYPH_COLON = 10;
+static const uint8_t GLYPH_BLANK = 11;
+
+// 横笔画：中心行 cy，从 x0 到 x1
+static bool inHorizontal(int16_t px, int16_t py, int16_t cy, int16_t x0,
+                         int16_t x1) {
+  int16_t dy = abs(py - cy);
+  if (dy > HALF_THICKNESS) return false;
+  int16_t taper = HALF_THICKNESS - dy;
+  return px >= x0 - taper && px <= x1 + taper;
+}
+
+// 竖笔画：中心列 cx，从 y0 到 y1
+static bool inVertical(int16_t px, int16_t py, int16_t cx, int16_t y0,
+                       int16_t y1) {
+  int16_t dx = abs(px - cx);
+  if (dx > HALF_THICKNESS) return false;
+  int16_t taper = HALF_THICKNESS - dx;
+  return py >= y0 - taper && py <= y1 + taper;
+}
+
+SegmentDigits::SegmentDigits(DisplayManager* display) {
+  pDisplay = display;
+  glyphsReady = false;
+  originY = 0;
+  foreground = ST77XX_WHITE;
+  background = ST77XX_BLACK;
+  shownCount = 0;
+}
+
+void SegmentDigits::begin() {
+  if (glyphsReady) return;
+
+  memset(glyphs, 0, sizeof(glyphs));
+  for (uint8_t d = 0; d < 10; d++) {
+    rasterise(d, DIGIT_SEGMENTS[d]);
+  }
+
+  // 冒号：两个 4x4 圆点，行跨度 1 字节
+  uint8_t* colon = glyphs[GLYPH_COLON];
+  for (uint8_t row = 0; row < 4; row++) {
+    colon[12 + row] = 0x3C;
+    colon[24 + row] = 0x3C;
+  }
+
+  glyphsReady = true;
+}
+
+void SegmentDigits::rasterise(uint8_t index, uint8_t segments) {
+  const int16_t left = HALF_THICKNESS;
+  const int16_t right = DIGIT_WIDTH - 1 - HALF_THICKNESS;
+  const int16_t top = HALF_THICKNESS;
+  const int16_t middle = DIGIT_HEIGHT / 2;
+  const int16_t bottom = DIGIT_HEIGHT - 1 - HALF_THICKNESS - 1;
+  const int16_t gap = HALF_THICKNESS + 1;  // 笔画之间留出的空隙
+
+  uint8_t* glyph = glyphs[index];
+  for (int16_t py = 0; py < DIGIT_HEIGHT; py++) {
+    for (int16_t px = 0; px < DIGIT_WIDTH; px++) {
+      bool lit =
+          ((segments & SEG_A) && inHorizontal(px, py, top, left + gap, right - gap)) ||
+          ((segments & SEG_G) && inHorizontal(px, py, middle, left + gap, right - gap)) ||
+          ((segments & SEG_D) && inHorizontal(px, py, bottom, left + gap, right - gap)) ||
+          ((segments & SEG_F) && inVertical(px, py, left, top + gap, middle - gap)) ||
+          ((segments & SEG_B) && inVertical(px, py, right, top + gap, middle - gap)) ||
+          ((segments & SEG_E) && inVertical(px, py, left, middle + gap, bottom - gap)) ||
+          ((segments & SEG_C) && inVertical(px, py, right, middle + gap, bottom - gap));
+      if (lit) {
+        glyph[py * GLYPH_STRIDE + (px >> 3)] |= 0x80 >> (px & 7);
+      }
+    }
+  }
+}
+
+void SegmentDigits::setStyle(int16_t y, uint16_t color, uint16_t bg) {
+  originY = y;
+  foreground = color;
+  background = bg;
+  invalidate();
+}
+
+void SegmentDigits::invalidate() {
+  shownCount = 0;
+}
+
+uint8_t SegmentDigits::glyphIndex(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c == ':') return GLYPH_COLON;
+  return GLYPH_BLANK;
+}
+
+uint8_t SegmentDigits::glyphWidth(char c) {
+  return c == ':' ? COLON_WIDTH : DIGIT_WIDTH;
+}
+
+uint16_t SegmentDigits::measure(const char* text) {
+  uint16_t width = 0;
+  uint8_t n = 0;
+  for (; text[n] != '\0' && n < MAX_CHARS; n++) {
+    width += glyphWidth(text[n]);
+  }
+  return n > 0 ? width + (n - 1) * SPACING : 0;
+}
+
+// ========== 绘制 ==========
+
+uint8_t SegmentDigits::draw(const char* text) {
+  begin();
+
+  uint8_t count = strnlen(text, MAX_CHARS);
+  int16_t x = (SCREEN_WIDTH - measure(text)) / 2;
+
+  // 布局（字符数或冒号位置）变化时擦掉旧的整段并全部重绘
+  bool relayout = shownCount != count;
+  for (uint8_t i = 0; i < count && !relayout; i++) {
+    relayout = glyphWidth(shown[i]) != glyphWidth(text[i]);
+  }
+
+  bool savedAutoFlush = pDisplay->getAutoFlush();
+  pDisplay->setAutoFlush(false);
+
+  if (relayout && shownCount > 0) {
+    int16_t left = shownX[0];
+    int16_t right = shownX[shownCount - 1] + glyphWidth(shown[shownCount - 1]);
+    pDisplay->fillRect(left, originY, right - left, DIGIT_HEIGHT, background);
+  }
+
+  uint8_t repainted = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    char c = text[i];
+    uint8_t w = glyphWidth(c);
+    if (relayout || shown[i] != c) {
+      pDisplay->drawBitmap(glyphs[glyphIndex(c)], x, originY, w, DIGIT_HEIGHT,
+                           foreground, background);
+      shown[i] = c;
+      repainted++;
+    }
+    shownX[i] = x;
+    x += w + SPACING;
+  }
+  shownCount = count;
+
+  pDisplay->setAutoFlush(savedAutoFlush);
+  if (repainted > 0) {
+    pDisplay->flush();
+  }
+  return repainted;
+}
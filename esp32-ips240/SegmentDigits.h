@@ -0,0 +1,59 @@
+#ifndef SEGMENT_DIGITS_H
+#define SEGMENT_DIGITS_H
+
+#include <Arduino.h>
+#include "Display.h"
+
+/**
+ * 大号七段数字（时钟）
+ *
+ * begin() 把 0~9 与冒号栅格化成 1 位字模表；每个字符位置记住上一次显示的字符，
+ * draw() 只重绘变化的位置（每秒通常只有最后一位），每个位置用一次 drawBitmap
+ * 连同背景整格写入，不需要先清除。字模表在对象生存期内有效，条带模式可以引用
+ */
+class SegmentDigits {
+public:
+  static const uint8_t DIGIT_WIDTH = 24;
+  static const uint8_t DIGIT_HEIGHT = 40;
+  static const uint8_t COLON_WIDTH = 8;
+  static const uint8_t SPACING = 4;      // 字符间距
+  static const uint8_t MAX_CHARS = 8;    // "HH:MM:SS"
+
+  SegmentDigits(DisplayManager* display);
+
+  // 生成字模表（只需一次）
+  void begin();
+
+  // 设置位置与颜色，并让下一次 draw() 重绘所有位置
+  void setStyle(int16_t y, uint16_t color, uint16_t background);
+  void invalidate();
+
+  // 绘制数字与冒号（其他字符为空格），水平居中；返回重绘的位置数
+  uint8_t draw(const char* text);
+
+  // 字符串宽度（像素）
+  static uint16_t measure(const char* text);
+
+private:
+  static const uint8_t GLYPH_STRIDE = (DIGIT_WIDTH + 7) / 8;
+  static const uint8_t GLYPH_COUNT = 12;  // 0~9、冒号、空白
+
+  DisplayManager* pDisplay;
+  bool glyphsReady;
+  uint8_t glyphs[GLYPH_COUNT][DIGIT_HEIGHT * GLYPH_STRIDE];
+
+  int16_t originY;
+  uint16_t foreground;
+  uint16_t background;
+
+  // 每个位置上一次绘制的字符与横坐标
+  char shown[MAX_CHARS];
+  int16_t shownX[MAX_CHARS];
+  uint8_t shownCount;
+
+  static uint8_t glyphIndex(char c);
+  static uint8_t glyphWidth(char c);
+  void rasterise(uint8_t index, uint8_t segments);
+};
+
+#endif // SEGMENT_DIGITS_H
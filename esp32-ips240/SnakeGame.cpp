@@ -56,6 +56,14 @@ void SnakeGame::update() {
   advanceSnake();
 }
 
+void SnakeGame::tick() {
+  if (gameOver) {
+    return;
+  }
+
+  step();
+}
+
 bool SnakeGame::isGameOver() {
   return gameOver;
 }
@@ -208,6 +216,12 @@ void SnakeGame::advanceSnake() {
     return;
   }
 
+  step();
+}
+
+void SnakeGame::step() {
+  if (gameOver) return;
+
   if (!chooseDirection()) {
     gameOver = true;
     pDisplay->drawCenteredText("GAME OVER!", 100, ST77XX_RED, 2);
@@ -262,5 +276,5 @@ void SnakeGame::advanceSnake() {
   pDisplay->flush();
   pDisplay->setAutoFlush(true);
 
-  lastStepTime = now;
+  lastStepTime = millis();
 }
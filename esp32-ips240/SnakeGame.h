@@ -18,6 +18,9 @@ public:
   void begin();
   void reset();
   void update();  // 在loop中调用
+  void tick();    // 由调度器按 getStepInterval() 周期调用，每次走一步
+  unsigned long getStepInterval() const { return stepIntervalMs; }
+  void step();    // 立即推进一步（忽略步进间隔，供基准测试使用）
 
   // 状态查询
   bool isGameOver();
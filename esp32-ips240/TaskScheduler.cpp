@@ -0,0 +1,182 @@
+#include "TaskScheduler.h"
+
+// 释放时刻早于等于 now（按 32 位回绕比较）
+static bool isDue(uint32_t release, uint32_t now) {
+  return (int32_t)(now - release) >= 0;
+}
+
+TaskScheduler::TaskScheduler() {
+  taskCount = 0;
+  idleHook = defaultIdle;
+  idleMicros = 0;
+  statsStart = 0;
+  memset(tasks, 0, sizeof(tasks));
+}
+
+uint8_t TaskScheduler::addTask(const char* name, TaskFunction function,
+                               void* context, uint32_t periodMicros,
+                               uint8_t priority, uint32_t deadlineMicros) {
+  if (taskCount >= MAX_TASKS || function == nullptr || periodMicros == 0) {
+    Serial.printf("Warning: cannot add task %s\n", name ? name : "?");
+    return NO_TASK;
+  }
+  if (taskCount == 0) statsStart = micros();
+
+  Task& task = tasks[taskCount];
+  task.name = name;
+  task.function = function;
+  task.context = context;
+  task.period = periodMicros;
+  task.deadline = deadlineMicros > 0 ? deadlineMicros : periodMicros;
+  task.nextRelease = micros();
+  task.priority = priority;
+  task.enabled = true;
+  memset(&task.stats, 0, sizeof(task.stats));
+  return taskCount++;
+}
+
+void TaskScheduler::setEnabled(uint8_t id, bool enabled) {
+  if (id >= taskCount) return;
+  Task& task = tasks[id];
+  if (enabled && !task.enabled) {
+    task.nextRelease = micros();
+  }
+  task.enabled = enabled;
+}
+
+bool TaskScheduler::isEnabled(uint8_t id) const {
+  return id < taskCount && tasks[id].enabled;
+}
+
+void TaskScheduler::setPeriod(uint8_t id, uint32_t periodMicros) {
+  if (id >= taskCount || periodMicros == 0) return;
+  Task& task = tasks[id];
+  if (task.deadline == task.period) task.deadline = periodMicros;
+  task.period = periodMicros;
+}
+
+void TaskScheduler::trigger(uint8_t id) {
+  if (id >= taskCount) return;
+  tasks[id].nextRelease = micros();
+}
+
+const char* TaskScheduler::getTaskName(uint8_t id) const {
+  return id < taskCount ? tasks[id].name : "";
+}
+
+// ========== 调度 ==========
+
+uint8_t TaskScheduler::pickReady(uint32_t now) const {
+  uint8_t best = NO_TASK;
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const Task& task = tasks[i];
+    if (!task.enabled || !isDue(task.nextRelease, now)) continue;
+    if (best == NO_TASK) {
+      best = i;
+      continue;
+    }
+    const Task& current = tasks[best];
+    if (task.priority != current.priority) {
+      if (task.priority > current.priority) best = i;
+    } else if ((int32_t)((task.nextRelease + task.deadline) -
+                         (current.nextRelease + current.deadline)) < 0) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+void TaskScheduler::runTask(Task& task, uint32_t now) {
+  uint32_t release = task.nextRelease;
+  uint32_t late = now - release;
+
+  task.function(task.context);
+
+  uint32_t end = micros();
+  uint32_t runMicros = end - now;
+  TaskStats& stats = task.stats;
+  stats.runs++;
+  stats.totalRunMicros += runMicros;
+  stats.maxRunMicros = max(stats.maxRunMicros, runMicros);
+  stats.maxLateMicros = max(stats.maxLateMicros, late);
+  if ((int32_t)(end - (release + task.deadline)) > 0) {
+    stats.overruns++;
+  }
+
+  // 固定速率：下一次释放按周期累加，错过的释放直接跳过
+  uint32_t missed = late / task.period;
+  stats.skipped += missed;
+  task.nextRelease = release + (missed + 1) * task.period;
+}
+
+uint32_t TaskScheduler::untilNextRelease(uint32_t now) const {
+  uint32_t sleep = UINT32_MAX;
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const Task& task = tasks[i];
+    if (!task.enabled) continue;
+    if (isDue(task.nextRelease, now)) return 0;
+    sleep = min(sleep, task.nextRelease - now);
+  }
+  return sleep;
+}
+
+void TaskScheduler::run() {
+  // 每次挑一个任务运行后重新选择，让运行期间新释放的高优先级任务先执行；
+  // 运行次数有上限，任务持续超时时也会回到 loop()
+  for (uint8_t picks = 0; picks < 2 * MAX_TASKS; picks++) {
+    uint32_t now = micros();
+    uint8_t id = pickReady(now);
+    if (id == NO_TASK) break;
+    runTask(tasks[id], now);
+  }
+
+  uint32_t sleep = untilNextRelease(micros());
+  if (sleep == 0) return;
+  if (sleep == UINT32_MAX) sleep = 1000;  // 没有启用的任务
+
+  uint32_t start = micros();
+  if (idleHook != nullptr) idleHook(sleep);
+  idleMicros += micros() - start;
+}
+
+void TaskScheduler::defaultIdle(uint32_t sleepMicros) {
+  // ESP32 上 delay() 让出 CPU（空闲任务可进入省电状态），不足 1 ms 的部分忙等
+  if (sleepMicros >= 1000) {
+    delay(sleepMicros / 1000);
+    sleepMicros %= 1000;
+  }
+  if (sleepMicros > 0) {
+    delayMicroseconds(sleepMicros);
+  }
+}
+
+// ========== 统计 ==========
+
+void TaskScheduler::resetStats() {
+  for (uint8_t i = 0; i < taskCount; i++) {
+    memset(&tasks[i].stats, 0, sizeof(TaskStats));
+  }
+  idleMicros = 0;
+  statsStart = micros();
+}
+
+void TaskScheduler::printStats() {
+  uint32_t elapsed = micros() - statsStart;
+  Serial.println("=== Task Scheduler ===");
+  Serial.println("task          period   runs  avg/max us  late max  overrun  skipped");
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const Task& task = tasks[i];
+    const TaskStats& stats = task.stats;
+    Serial.printf("%-12s %7lu %6lu %5lu/%-6lu %8lu %8lu %8lu%s\n", task.name,
+                  (unsigned long)task.period, (unsigned long)stats.runs,
+                  (unsigned long)stats.averageRunMicros(),
+                  (unsigned long)stats.maxRunMicros,
+                  (unsigned long)stats.maxLateMicros,
+                  (unsigned long)stats.overruns, (unsigned long)stats.skipped,
+                  task.enabled ? "" : " (off)");
+  }
+  if (elapsed > 0) {
+    Serial.printf("Idle: %lu%%\n",
+                  (unsigned long)(idleMicros * 100 / elapsed));
+  }
+}
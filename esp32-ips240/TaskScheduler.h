@@ -0,0 +1,85 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+typedef void (*TaskFunction)(void* context);
+typedef void (*IdleHook)(uint32_t sleepMicros);
+
+// 任务运行统计
+struct TaskStats {
+  uint32_t runs;
+  uint32_t overruns;        // 完成时刻晚于截止时刻的次数
+  uint32_t skipped;         // 因迟到超过一个周期而跳过的释放
+  uint64_t totalRunMicros;
+  uint32_t maxRunMicros;
+  uint32_t maxLateMicros;   // 开始时刻相对释放时刻的最大延迟
+
+  uint32_t averageRunMicros() const {
+    return runs > 0 ? totalRunMicros / runs : 0;
+  }
+};
+
+/**
+ * 协作式任务调度器
+ *
+ * 每个任务有周期、优先级和相对截止时间（默认等于周期）。run() 反复挑出已释放的
+ * 任务中优先级最高的一个运行（同优先级先运行截止时刻早的），直到没有到期任务，
+ * 再调用空闲钩子睡到最早的下一次释放。释放时刻按周期累加（固定速率），
+ * 迟到超过一个周期时跳过错过的释放。任务不可抢占，运行时间须短于其他任务的周期
+ */
+class TaskScheduler {
+public:
+  static const uint8_t MAX_TASKS = 12;
+  static const uint8_t NO_TASK = 0xFF;
+
+  TaskScheduler();
+
+  // 添加任务，返回任务编号（已满时返回 NO_TASK）；优先级数值越大越先运行
+  uint8_t addTask(const char* name, TaskFunction function, void* context,
+                  uint32_t periodMicros, uint8_t priority = 0,
+                  uint32_t deadlineMicros = 0);
+
+  void setEnabled(uint8_t id, bool enabled);  // 启用时从当前时刻重新释放
+  bool isEnabled(uint8_t id) const;
+  void setPeriod(uint8_t id, uint32_t periodMicros);
+  void trigger(uint8_t id);                   // 立即释放一次（下一次 run() 运行）
+
+  // 在 loop() 中调用：运行所有到期任务，然后空闲到下一次释放
+  void run();
+  // 空闲钩子（默认 delay / delayMicroseconds，让出 CPU 给系统任务）
+  void setIdleHook(IdleHook hook) { idleHook = hook; }
+
+  uint8_t getTaskCount() const { return taskCount; }
+  const char* getTaskName(uint8_t id) const;
+  const TaskStats& getStats(uint8_t id) const { return tasks[id].stats; }
+  uint64_t getIdleMicros() const { return idleMicros; }
+  void resetStats();
+  void printStats();
+
+private:
+  struct Task {
+    const char* name;
+    TaskFunction function;
+    void* context;
+    uint32_t period;
+    uint32_t deadline;      // 相对截止时间
+    uint32_t nextRelease;
+    uint8_t priority;
+    bool enabled;
+    TaskStats stats;
+  };
+
+  Task tasks[MAX_TASKS];
+  uint8_t taskCount;
+  IdleHook idleHook;
+  uint64_t idleMicros;
+  uint32_t statsStart;
+
+  uint8_t pickReady(uint32_t now) const;
+  void runTask(Task& task, uint32_t now);
+  uint32_t untilNextRelease(uint32_t now) const;
+  static void defaultIdle(uint32_t sleepMicros);
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,178 @@
+#include "TextCommandParser.h"
+
+#define PATTERN(keyword, match, type, implied) \
+  {keyword, sizeof(keyword) - 1, match, type, implied}
+
+// 指令表：按顺序匹配，第一个匹配的表项生效（"T " 在 "T" 之前）
+static constexpr CommandPattern commandPatterns[] = {
+  // 完整格式和简化格式指令
+  PATTERN("TEXT:",       MATCH_PREFIX, CMD_SET_TEXT,       nullptr),
+  PATTERN("T ",          MATCH_PREFIX, CMD_SET_TEXT,       nullptr),
+  PATTERN("T:",          MATCH_PREFIX, CMD_SET_TEXT,       nullptr),
+  PATTERN("BRIGHTNESS:", MATCH_PREFIX, CMD_SET_BRIGHTNESS, nullptr),
+  PATTERN("B ",          MATCH_PREFIX, CMD_SET_BRIGHTNESS, nullptr),
+  PATTERN("B:",          MATCH_PREFIX, CMD_SET_BRIGHTNESS, nullptr),
+  PATTERN("CLEAR",       MATCH_EXACT,  CMD_CLEAR_SCREEN,   nullptr),
+  PATTERN("C",           MATCH_EXACT,  CMD_CLEAR_SCREEN,   nullptr),
+  PATTERN("MODE:",       MATCH_PREFIX, CMD_SET_MODE,       nullptr),
+  PATTERN("M ",          MATCH_PREFIX, CMD_SET_MODE,       nullptr),
+  PATTERN("M:",          MATCH_PREFIX, CMD_SET_MODE,       nullptr),
+  PATTERN("STATUS",      MATCH_EXACT,  CMD_GET_STATUS,     nullptr),
+  PATTERN("GET_STATUS",  MATCH_EXACT,  CMD_GET_STATUS,     nullptr),
+  PATTERN("S",           MATCH_EXACT,  CMD_GET_STATUS,     nullptr),
+  PATTERN("SLEEP",       MATCH_EXACT,  CMD_SLEEP,          nullptr),
+  PATTERN("WAKEUP",      MATCH_EXACT,  CMD_WAKEUP,         nullptr),
+  PATTERN("WAKE",        MATCH_EXACT,  CMD_WAKEUP,         nullptr),
+  PATTERN("W",           MATCH_EXACT,  CMD_WAKEUP,         nullptr),
+  PATTERN("RESTART",     MATCH_EXACT,  CMD_RESTART,        nullptr),
+  PATTERN("REBOOT",      MATCH_EXACT,  CMD_RESTART,        nullptr),
+  PATTERN("R",           MATCH_EXACT,  CMD_RESTART,        nullptr),
+  PATTERN("SETTIME:",    MATCH_PREFIX, CMD_SET_TIME,       nullptr),
+  PATTERN("ST ",         MATCH_PREFIX, CMD_SET_TIME,       nullptr),
+  PATTERN("ST:",         MATCH_PREFIX, CMD_SET_TIME,       nullptr),
+  PATTERN("SETDATE:",    MATCH_PREFIX, CMD_SET_DATE,       nullptr),
+  PATTERN("SD ",         MATCH_PREFIX, CMD_SET_DATE,       nullptr),
+  PATTERN("SD:",         MATCH_PREFIX, CMD_SET_DATE,       nullptr),
+  PATTERN("OTA:",        MATCH_PREFIX, CMD_OTA_UPDATE,     nullptr),
+  PATTERN("OTA ",        MATCH_PREFIX, CMD_OTA_UPDATE,     nullptr),
+  PATTERN("BENCH",       MATCH_EXACT,  CMD_BENCHMARK,      nullptr),
+  PATTERN("BENCHMARK",   MATCH_EXACT,  CMD_BENCHMARK,      nullptr),
+  PATTERN("BENCH:",      MATCH_PREFIX, CMD_BENCHMARK,      nullptr),
+  PATTERN("TASKS",       MATCH_EXACT,  CMD_TASKS,          nullptr),
+  // 模式切换别名
+  PATTERN("DEMO",        MATCH_EXACT,  CMD_SET_MODE,       "DEMO"),
+  PATTERN("D",           MATCH_EXACT,  CMD_SET_MODE,       "DEMO"),
+  PATTERN("DEMO2",       MATCH_EXACT,  CMD_SET_MODE,       "DEMO2"),
+  PATTERN("D2",          MATCH_EXACT,  CMD_SET_MODE,       "DEMO2"),
+  PATTERN("CLOCK",       MATCH_EXACT,  CMD_SET_MODE,       "CLOCK"),
+  PATTERN("CL",          MATCH_EXACT,  CMD_SET_MODE,       "CLOCK")
+};
+
+static const size_t PATTERN_COUNT =
+    sizeof(commandPatterns) / sizeof(commandPatterns[0]);
+
+static bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static char upper(char c) {
+  return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+// text 的前 length 个字符与关键字相同（关键字为大写）
+static bool matchesKeyword(const char* text, const char* keyword,
+                           size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    if (upper(text[i]) != keyword[i]) return false;
+  }
+  return true;
+}
+
+ParsedCommand TextCommandParser::parse(char* line, size_t length) {
+  // 就地去掉首尾空白
+  while (length > 0 && isSpace(line[length - 1])) length--;
+  line[length] = '\0';
+  while (length > 0 && isSpace(*line)) {
+    line++;
+    length--;
+  }
+
+  ParsedCommand result = {CMD_UNKNOWN, line, line + length, 0};
+  if (length == 0) return result;
+
+  for (size_t i = 0; i < PATTERN_COUNT; i++) {
+    const CommandPattern& pattern = commandPatterns[i];
+    size_t keywordLength = pattern.keywordLength;
+    if (pattern.match == MATCH_EXACT ? length != keywordLength
+                                     : length < keywordLength) {
+      continue;
+    }
+    if (!matchesKeyword(line, pattern.keyword, keywordLength)) continue;
+
+    result.type = pattern.type;
+    if (pattern.impliedParam != nullptr) {
+      result.param = pattern.impliedParam;
+      result.paramLength = strlen(pattern.impliedParam);
+    } else {
+      const char* param = line + keywordLength;
+      while (isSpace(*param)) param++;
+      result.param = param;
+      result.paramLength = line + length - param;
+    }
+    break;
+  }
+  return result;
+}
+
+bool TextCommandParser::equalsIgnoreCase(const char* text, const char* keyword) {
+  while (*text != '\0' && upper(*text) == upper(*keyword)) {
+    text++;
+    keyword++;
+  }
+  return *text == '\0' && *keyword == '\0';
+}
+
+long TextCommandParser::toNumber(const char* text, size_t length) {
+  size_t i = 0;
+  while (i < length && isSpace(text[i])) i++;
+  bool negative = false;
+  if (i < length && (text[i] == '-' || text[i] == '+')) {
+    negative = text[i] == '-';
+    i++;
+  }
+  long value = 0;
+  for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+    value = value * 10 + (text[i] - '0');
+  }
+  return negative ? -value : value;
+}
+
+// ========== 回复缓冲 ==========
+
+void ReplyBuffer::clear() {
+  text[0] = '\0';
+  used = 0;
+  truncated = false;
+}
+
+ReplyBuffer& ReplyBuffer::append(const char* str) {
+  size_t length = strlen(str);
+  size_t room = CAPACITY - 1 - used;
+  if (length > room) {
+    length = room;
+    truncated = true;
+  }
+  memcpy(text + used, str, length);
+  used += length;
+  text[used] = '\0';
+  return *this;
+}
+
+void ReplyBuffer::appendv(const char* format, va_list args) {
+  size_t room = CAPACITY - used;
+  int written = vsnprintf(text + used, room, format, args);
+  if (written < 0) return;
+  if ((size_t)written >= room) {
+    used = CAPACITY - 1;
+    truncated = true;
+  } else {
+    used += written;
+  }
+}
+
+ReplyBuffer& ReplyBuffer::appendf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  appendv(format, args);
+  va_end(args);
+  return *this;
+}
+
+const char* ReplyBuffer::format(const char* format, ...) {
+  clear();
+  va_list args;
+  va_start(args, format);
+  appendv(format, args);
+  va_end(args);
+  return text;
+}
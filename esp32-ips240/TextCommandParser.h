@@ -0,0 +1,99 @@
+#ifndef TEXT_COMMAND_PARSER_H
+#define TEXT_COMMAND_PARSER_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// 支持的指令枚举
+enum CommandType {
+  CMD_UNKNOWN,
+  CMD_SET_TEXT,         // 设置文本显示
+  CMD_SET_BRIGHTNESS,   // 设置亮度
+  CMD_CLEAR_SCREEN,     // 清屏
+  CMD_SET_MODE,         // 设置显示模式
+  CMD_GET_STATUS,       // 获取状态
+  CMD_SLEEP,            // 进入睡眠
+  CMD_WAKEUP,           // 唤醒
+  CMD_RESTART,          // 重启
+  CMD_SET_TIME,         // 设置时间
+  CMD_SET_DATE,         // 设置日期
+  CMD_OTA_UPDATE,       // OTA更新
+  CMD_BENCHMARK,        // 显示性能基准测试
+  CMD_TASKS             // 任务调度统计
+};
+
+// 关键字匹配方式
+enum CommandMatch {
+  MATCH_EXACT,   // 整条指令等于关键字
+  MATCH_PREFIX   // 以关键字开头，其后为参数
+};
+
+// 指令表项（关键字不区分大小写）
+struct CommandPattern {
+  const char* keyword;
+  uint8_t keywordLength;
+  CommandMatch match;
+  CommandType type;
+  const char* impliedParam;  // 别名隐含的参数（D = MODE:DEMO），没有时为 nullptr
+};
+
+// 解析结果：command / param 指向输入缓冲内部，都以 '\0' 结尾
+struct ParsedCommand {
+  CommandType type;
+  const char* command;   // 去掉首尾空白后的整条指令
+  const char* param;     // 去掉前导空白的参数（没有参数时为空串）
+  uint16_t paramLength;
+};
+
+/**
+ * 表驱动的文本指令解析
+ *
+ * 在收到的字节上就地去掉首尾空白，按顺序与静态指令表比较（不区分大小写，
+ * 不复制、不转换大小写），第一个匹配的表项决定指令类型和参数位置。
+ * 整个过程不分配内存
+ */
+class TextCommandParser {
+public:
+  static const uint16_t MAX_COMMAND_LENGTH = 255;
+
+  // line 至少有 length + 1 字节（末尾写入 '\0'）
+  static ParsedCommand parse(char* line, size_t length);
+
+  static bool equalsIgnoreCase(const char* text, const char* keyword);
+  // 与 String::toInt 相同：可选符号加前导数字，遇到其他字符停止
+  static long toNumber(const char* text, size_t length);
+};
+
+/**
+ * 回复缓冲
+ *
+ * 固定大小的字符缓冲，回复文字格式化到这里后直接发送，
+ * 代替 "OK:..." + String(x) 的拼接；超出容量时截断并记录
+ */
+class ReplyBuffer {
+public:
+  static const uint16_t CAPACITY = 192;
+
+  ReplyBuffer() { clear(); }
+
+  void clear();
+  ReplyBuffer& append(const char* text);
+  ReplyBuffer& appendf(const char* format, ...)
+      __attribute__((format(printf, 2, 3)));
+  // 清空后格式化，返回文字
+  const char* format(const char* format, ...)
+      __attribute__((format(printf, 2, 3)));
+
+  const char* c_str() const { return text; }
+  size_t length() const { return used; }
+  bool isTruncated() const { return truncated; }
+
+private:
+  char text[CAPACITY];
+  size_t used;
+  bool truncated;
+
+  void appendv(const char* format, va_list args);
+};
+
+#endif // TEXT_COMMAND_PARSER_H
@@ -0,0 +1,181 @@
+#include "TextRenderer.h"
+#include <Adafruit_GFX.h>
+
+TextRenderer::TextRenderer() {
+  pFrameBuffer = nullptr;
+  atlasReady = false;
+  memset(glyphRows, 0, sizeof(glyphRows));
+  memset(runCount, 0, sizeof(runCount));
+  memset(runs, 0, sizeof(runs));
+}
+
+// ========== 字模表 ==========
+
+void TextRenderer::begin() {
+  if (!atlasReady) buildAtlas();
+}
+
+void TextRenderer::buildAtlas() {
+  // 用 Adafruit_GFX 自己的 drawChar 栅格化，保证与直接模式的字形完全一致
+  GFXcanvas1 cell(GLYPH_WIDTH, GLYPH_HEIGHT);
+  for (uint16_t c = 0; c < 256; c++) {
+    cell.fillScreen(0);
+    cell.drawChar(0, 0, (unsigned char)c, 1, 0, 1);
+    for (uint8_t r = 0; r < GLYPH_HEIGHT; r++) {
+      uint8_t bits = 0;
+      for (uint8_t i = 0; i < 5; i++) {
+        if (cell.getPixel(i, r)) bits |= 1 << i;
+      }
+      glyphRows[c][r] = bits;
+    }
+  }
+
+  // 行图案 -> 连续像素段
+  for (uint8_t pattern = 0; pattern < 32; pattern++) {
+    uint8_t count = 0;
+    uint8_t i = 0;
+    while (i < 5) {
+      if (!(pattern & (1 << i))) {
+        i++;
+        continue;
+      }
+      uint8_t start = i;
+      while (i < 5 && (pattern & (1 << i))) i++;
+      runs[pattern][count++] = (start << 3) | (i - start);
+    }
+    runCount[pattern] = count;
+  }
+
+  atlasReady = true;
+}
+
+// ========== 绘制 ==========
+
+void TextRenderer::blitGlyph(int16_t x, int16_t y, unsigned char c,
+                             uint16_t color, uint8_t size, Bounds& bounds) {
+  uint16_t* buffer = pFrameBuffer->getBackBuffer();
+  int16_t width = pFrameBuffer->getWidth();
+  int16_t height = pFrameBuffer->getHeight();
+
+  // 整个字符在屏幕外
+  if (x >= width || y >= height || x + GLYPH_WIDTH * size <= 0 ||
+      y + GLYPH_HEIGHT * size <= 0) {
+    return;
+  }
+
+  const uint8_t* rows = glyphRows[c];
+  for (uint8_t r = 0; r < GLYPH_HEIGHT; r++) {
+    uint8_t pattern = rows[r];
+    if (pattern == 0) continue;
+
+    for (uint8_t sy = 0; sy < size; sy++) {
+      int16_t py = y + r * size + sy;
+      if (py < 0 || py >= height) continue;
+      uint16_t* row = buffer != nullptr ? &buffer[py * width] : nullptr;
+
+      for (uint8_t k = 0; k < runCount[pattern]; k++) {
+        uint8_t run = runs[pattern][k];
+        int16_t x0 = x + (run >> 3) * size;
+        int16_t x1 = x0 + (run & 0x07) * size;
+        if (x0 < 0) x0 = 0;
+        if (x1 > width) x1 = width;
+        if (x0 >= x1) continue;
+
+        if (row != nullptr) {
+          for (int16_t px = x0; px < x1; px++) {
+            row[px] = color;
+          }
+        } else {
+          // 调色板索引模式没有 RGB565 后台缓冲
+          pFrameBuffer->fillRow(x0, py, x1 - x0, color);
+        }
+        if (x0 < bounds.minX) bounds.minX = x0;
+        if (x1 - 1 > bounds.maxX) bounds.maxX = x1 - 1;
+        if (py < bounds.minY) bounds.minY = py;
+        if (py > bounds.maxY) bounds.maxY = py;
+      }
+    }
+  }
+}
+
+bool TextRenderer::canDraw() const {
+  return pFrameBuffer != nullptr &&
+         (pFrameBuffer->getBackBuffer() != nullptr || pFrameBuffer->isIndexed());
+}
+
+void TextRenderer::markBounds(const Bounds& bounds) {
+  if (bounds.maxX < bounds.minX) return;
+  pFrameBuffer->markDirty(bounds.minX, bounds.minY,
+                          bounds.maxX - bounds.minX + 1,
+                          bounds.maxY - bounds.minY + 1);
+}
+
+void TextRenderer::drawString(const char* text, int16_t x, int16_t y,
+                              uint16_t color, uint8_t size, bool wrap) {
+  if (text == nullptr || !canDraw()) return;
+  if (!atlasReady) buildAtlas();
+  if (size == 0) size = 1;
+
+  int16_t width = pFrameBuffer->getWidth();
+  int16_t advance = GLYPH_WIDTH * size;
+  int16_t lineHeight = GLYPH_HEIGHT * size;
+  int16_t cursorX = x;
+  int16_t cursorY = y;
+  Bounds bounds;
+  bounds.reset();
+
+  for (const char* p = text; *p != '\0'; p++) {
+    unsigned char c = (unsigned char)*p;
+    if (c == '\r') continue;
+
+    // 换行与 Adafruit_GFX::write 相同：回到第 0 列
+    if (c == '\n' || (wrap && cursorX + advance > width)) {
+      markBounds(bounds);
+      bounds.reset();
+      cursorX = 0;
+      cursorY += lineHeight;
+      if (c == '\n') continue;
+    }
+
+    blitGlyph(cursorX, cursorY, c, color, size, bounds);
+    cursorX += advance;
+  }
+  markBounds(bounds);
+}
+
+void TextRenderer::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint8_t size) {
+  if (!canDraw()) return;
+  if (!atlasReady) buildAtlas();
+  if (size == 0) size = 1;
+
+  Bounds bounds;
+  bounds.reset();
+  blitGlyph(x, y, c, color, size, bounds);
+  markBounds(bounds);
+}
+
+uint16_t TextRenderer::measure(const char* text, uint8_t size,
+                               bool wrap) const {
+  if (text == nullptr) return 0;
+  if (size == 0) size = 1;
+
+  // 与 getTextBounds(text, 0, y, ...) 的宽度相同
+  int16_t width = pFrameBuffer ? pFrameBuffer->getWidth() : 0;
+  int16_t advance = GLYPH_WIDTH * size;
+  int16_t cursorX = 0;
+  int16_t minX = 0x7FFF;
+  int16_t maxX = -1;
+
+  for (const char* p = text; *p != '\0'; p++) {
+    if (*p == '\n') {
+      cursorX = 0;
+    } else if (*p != '\r') {
+      if (wrap && cursorX + advance > width) cursorX = 0;
+      if (cursorX < minX) minX = cursorX;
+      if (cursorX + advance - 1 > maxX) maxX = cursorX + advance - 1;
+      cursorX += advance;
+    }
+  }
+  return maxX >= minX ? maxX - minX + 1 : 0;
+}
@@ -0,0 +1,60 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <Arduino.h>
+#include "FrameBuffer.h"
+
+/**
+ * 帧缓冲文字引擎（经典 5x7 字体）
+ *
+ * 首次使用时用 Adafruit_GFX 把 256 个字符栅格化成 1 位字模表（每字符 8 行，
+ * 每行 5 位），并为 32 种行图案预先算好横向行段。绘制时按行段直接填充后台缓冲，
+ * 每行文字只标记一次脏区域；排版（\n 回到第 0 列、超出屏宽自动换行）与
+ * Adafruit_GFX::print 一致，缓冲模式与直接模式的输出逐像素相同。
+ */
+class TextRenderer {
+public:
+  static const uint8_t GLYPH_WIDTH = 6;   // 含 1 列字间距
+  static const uint8_t GLYPH_HEIGHT = 8;
+
+  TextRenderer();
+
+  void setFrameBuffer(FrameBuffer* fb) { pFrameBuffer = fb; }
+  // 生成字模表（未调用时在第一次绘制时生成）
+  void begin();
+
+  // 按 Adafruit_GFX::print 的排版绘制字符串（透明背景）
+  void drawString(const char* text, int16_t x, int16_t y, uint16_t color,
+                  uint8_t size, bool wrap = true);
+  // 在指定位置绘制单个字符
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint8_t size);
+
+  // 字符串宽度，与 getTextBounds 相同（等宽字体，直接由字符数算出）
+  uint16_t measure(const char* text, uint8_t size, bool wrap = true) const;
+
+private:
+  FrameBuffer* pFrameBuffer;
+
+  bool atlasReady;
+  uint8_t glyphRows[256][GLYPH_HEIGHT];  // 每行 5 位，bit i 为第 i 列
+
+  // 5 位行图案 -> 行段（起始列 << 3 | 长度），最多 3 段
+  uint8_t runCount[32];
+  uint8_t runs[32][3];
+
+  void buildAtlas();
+  // 实际写入像素的外接矩形（闭区间）
+  struct Bounds {
+    int16_t minX, minY, maxX, maxY;
+    void reset() { minX = minY = 0x7FFF; maxX = maxY = -1; }
+  };
+
+  // 绘制一个字符，并把实际写入的范围并入 bounds
+  void blitGlyph(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                 uint8_t size, Bounds& bounds);
+  void markBounds(const Bounds& bounds);
+  bool canDraw() const;
+};
+
+#endif // TEXT_RENDERER_H
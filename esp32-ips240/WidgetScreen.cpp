@@ -0,0 +1,369 @@
+#include "WidgetScreen.h"
+
+static bool intersects(int16_t l1, int16_t t1, int16_t r1, int16_t b1,
+                       int16_t l2, int16_t t2, int16_t r2, int16_t b2) {
+  return l1 < r2 && l2 < r1 && t1 < b2 && t2 < b1;
+}
+
+WidgetScreen::WidgetScreen(DisplayManager* display) {
+  pDisplay = display;
+  background = ST77XX_BLACK;
+  widgetCount = 0;
+  damageCount = 0;
+}
+
+void WidgetScreen::begin(uint16_t backgroundColor) {
+  background = backgroundColor;
+  widgetCount = 0;
+  invalidate();
+}
+
+void WidgetScreen::invalidate() {
+  damage[0].left = 0;
+  damage[0].top = 0;
+  damage[0].right = SCREEN_WIDTH;
+  damage[0].bottom = SCREEN_HEIGHT;
+  damageCount = 1;
+}
+
+// ========== 添加控件 ==========
+
+WidgetScreen::Widget* WidgetScreen::addWidget(WidgetType type) {
+  if (widgetCount >= MAX_WIDGETS) {
+    Serial.println("Warning: widget screen full");
+    return nullptr;
+  }
+
+  Widget& widget = widgets[widgetCount++];
+  memset(&widget, 0, sizeof(widget));
+  widget.type = type;
+  widget.visible = true;
+  return &widget;
+}
+
+uint8_t WidgetScreen::addLabel(const char* text, int16_t x, int16_t y,
+                               uint16_t color, uint8_t size) {
+  Widget* widget = addWidget(WIDGET_LABEL);
+  if (widget == nullptr) return NO_WIDGET;
+
+  widget->x = x;
+  widget->y = y;
+  widget->color = color;
+  widget->size = size > 0 ? size : 1;
+  strncpy(widget->text, text != nullptr ? text : "", MAX_TEXT_LENGTH);
+  layoutLabel(*widget);
+  damageWidget(*widget);
+  return widgetCount - 1;
+}
+
+uint8_t WidgetScreen::addCenteredLabel(const char* text, int16_t y,
+                                       uint16_t color, uint8_t size) {
+  uint8_t id = addLabel(text, 0, y, color, size);
+  if (id == NO_WIDGET) return id;
+
+  widgets[id].centered = true;
+  layoutLabel(widgets[id]);
+  damageWidget(widgets[id]);
+  return id;
+}
+
+uint8_t WidgetScreen::addRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                              uint16_t color, bool filled) {
+  Widget* widget = addWidget(filled ? WIDGET_FILL_RECT : WIDGET_RECT);
+  if (widget == nullptr) return NO_WIDGET;
+
+  widget->x = x;
+  widget->y = y;
+  widget->w = w;
+  widget->h = h;
+  widget->color = color;
+  damageWidget(*widget);
+  return widgetCount - 1;
+}
+
+uint8_t WidgetScreen::addLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                              uint16_t color) {
+  Widget* widget = addWidget(WIDGET_LINE);
+  if (widget == nullptr) return NO_WIDGET;
+
+  widget->x = x0;
+  widget->y = y0;
+  widget->w = x1;
+  widget->h = y1;
+  widget->color = color;
+  damageWidget(*widget);
+  return widgetCount - 1;
+}
+
+uint8_t WidgetScreen::addImage(const ImageData* image, int16_t x, int16_t y) {
+  Widget* widget = addWidget(WIDGET_IMAGE);
+  if (widget == nullptr) return NO_WIDGET;
+
+  widget->image = image;
+  widget->x = x;
+  widget->y = y;
+  damageWidget(*widget);
+  return widgetCount - 1;
+}
+
+uint8_t WidgetScreen::addProgressBar(int16_t x, int16_t y, int16_t w, int16_t h,
+                                     uint16_t barColor, uint16_t frameColor) {
+  Widget* widget = addWidget(WIDGET_PROGRESS);
+  if (widget == nullptr) return NO_WIDGET;
+
+  widget->x = x;
+  widget->y = y;
+  widget->w = w;
+  widget->h = h;
+  widget->color = barColor;
+  widget->color2 = frameColor;
+  damageWidget(*widget);
+  return widgetCount - 1;
+}
+
+// ========== 修改属性 ==========
+
+WidgetScreen::Widget* WidgetScreen::getWidget(uint8_t id) {
+  return id < widgetCount ? &widgets[id] : nullptr;
+}
+
+void WidgetScreen::setText(uint8_t id, const char* text) {
+  Widget* widget = getWidget(id);
+  if (widget == nullptr || widget->type != WIDGET_LABEL) return;
+  if (text == nullptr) text = "";
+  if (strncmp(widget->text, text, MAX_TEXT_LENGTH) == 0) return;
+
+  damageWidget(*widget);
+  strncpy(widget->text, text, MAX_TEXT_LENGTH);
+  layoutLabel(*widget);
+  damageWidget(*widget);
+}
+
+void WidgetScreen::setColor(uint8_t id, uint16_t color) {
+  Widget* widget = getWidget(id);
+  if (widget == nullptr || widget->color == color) return;
+
+  widget->color = color;
+  damageWidget(*widget);
+}
+
+void WidgetScreen::setPosition(uint8_t id, int16_t x, int16_t y) {
+  Widget* widget = getWidget(id);
+  if (widget == nullptr || (widget->x == x && widget->y == y)) return;
+
+  damageWidget(*widget);
+  if (widget->type == WIDGET_LINE) {
+    // 线段整体平移
+    widget->w += x - widget->x;
+    widget->h += y - widget->y;
+  }
+  widget->x = x;
+  widget->y = y;
+  layoutLabel(*widget);
+  damageWidget(*widget);
+}
+
+void WidgetScreen::setVisible(uint8_t id, bool visible) {
+  Widget* widget = getWidget(id);
+  if (widget == nullptr || widget->visible == visible) return;
+
+  // 先标记再隐藏，隐藏的控件也要擦除原来的位置
+  widget->visible = true;
+  damageWidget(*widget);
+  widget->visible = visible;
+}
+
+void WidgetScreen::setValue(uint8_t id, uint8_t percent) {
+  Widget* widget = getWidget(id);
+  if (percent > 100) percent = 100;
+  if (widget == nullptr || widget->type != WIDGET_PROGRESS ||
+      widget->value == percent) {
+    return;
+  }
+
+  widget->value = percent;
+  damageWidget(*widget);
+}
+
+void WidgetScreen::setImage(uint8_t id, const ImageData* image) {
+  Widget* widget = getWidget(id);
+  if (widget == nullptr || widget->type != WIDGET_IMAGE ||
+      widget->image == image) {
+    return;
+  }
+
+  damageWidget(*widget);
+  widget->image = image;
+  damageWidget(*widget);
+}
+
+// ========== 损坏区域 ==========
+
+void WidgetScreen::layoutLabel(Widget& widget) {
+  if (widget.type != WIDGET_LABEL) return;
+
+  // 等宽字体：与 drawCenteredText 的居中计算相同
+  widget.w = strlen(widget.text) * TextRenderer::GLYPH_WIDTH * widget.size;
+  widget.h = TextRenderer::GLYPH_HEIGHT * widget.size;
+  if (widget.centered) {
+    widget.x = (SCREEN_WIDTH - widget.w) / 2;
+  }
+}
+
+void WidgetScreen::getBounds(const Widget& widget, DamageRect& out) const {
+  switch (widget.type) {
+    case WIDGET_LINE:
+      out.left = min(widget.x, widget.w);
+      out.top = min(widget.y, widget.h);
+      out.right = max(widget.x, widget.w) + 1;
+      out.bottom = max(widget.y, widget.h) + 1;
+      return;
+    case WIDGET_IMAGE:
+      out.left = widget.x;
+      out.top = widget.y;
+      out.right = widget.x + (widget.image ? widget.image->width : 0);
+      out.bottom = widget.y + (widget.image ? widget.image->height : 0);
+      return;
+    default:
+      out.left = widget.x;
+      out.top = widget.y;
+      out.right = widget.x + widget.w;
+      out.bottom = widget.y + widget.h;
+      return;
+  }
+}
+
+void WidgetScreen::damageWidget(const Widget& widget) {
+  if (!widget.visible) return;
+
+  DamageRect rect;
+  getBounds(widget, rect);
+  addDamage(rect);
+}
+
+void WidgetScreen::addDamage(DamageRect rect) {
+  rect.left = max(rect.left, (int16_t)0);
+  rect.top = max(rect.top, (int16_t)0);
+  rect.right = min(rect.right, (int16_t)SCREEN_WIDTH);
+  rect.bottom = min(rect.bottom, (int16_t)SCREEN_HEIGHT);
+  if (rect.left >= rect.right || rect.top >= rect.bottom) return;
+
+  // 与已有区域相交则合并；区域已满时并入面积增长最小的一个
+  int8_t target = -1;
+  int32_t bestGrowth = 0x7FFFFFFF;
+  for (uint8_t i = 0; i < damageCount; i++) {
+    DamageRect& d = damage[i];
+    int32_t merged = (int32_t)(max(d.right, rect.right) - min(d.left, rect.left)) *
+                     (max(d.bottom, rect.bottom) - min(d.top, rect.top));
+    int32_t growth = merged - (int32_t)(d.right - d.left) * (d.bottom - d.top);
+    if (intersects(d.left, d.top, d.right, d.bottom, rect.left, rect.top,
+                   rect.right, rect.bottom)) {
+      growth = -1;
+    }
+    if (growth < bestGrowth) {
+      bestGrowth = growth;
+      target = i;
+    }
+  }
+
+  if (target < 0 || (bestGrowth >= 0 && damageCount < MAX_DAMAGE_RECTS)) {
+    damage[damageCount++] = rect;
+    return;
+  }
+
+  DamageRect& d = damage[target];
+  d.left = min(d.left, rect.left);
+  d.top = min(d.top, rect.top);
+  d.right = max(d.right, rect.right);
+  d.bottom = max(d.bottom, rect.bottom);
+}
+
+void WidgetScreen::expandDamage(DamageRect& rect) const {
+  // 部分相交的控件会整体重绘，区域扩大到它的外接矩形，直到不再变化
+  bool grown = true;
+  while (grown) {
+    grown = false;
+    for (uint8_t i = 0; i < widgetCount; i++) {
+      if (!widgets[i].visible) continue;
+      DamageRect b;
+      getBounds(widgets[i], b);
+      if (!intersects(rect.left, rect.top, rect.right, rect.bottom, b.left,
+                      b.top, b.right, b.bottom)) {
+        continue;
+      }
+      if (b.left < rect.left || b.top < rect.top || b.right > rect.right ||
+          b.bottom > rect.bottom) {
+        rect.left = min(rect.left, b.left);
+        rect.top = min(rect.top, b.top);
+        rect.right = max(rect.right, b.right);
+        rect.bottom = max(rect.bottom, b.bottom);
+        grown = true;
+      }
+    }
+  }
+}
+
+// ========== 渲染 ==========
+
+bool WidgetScreen::render() {
+  if (damageCount == 0) return false;
+
+  bool savedAutoFlush = pDisplay->getAutoFlush();
+  pDisplay->setAutoFlush(false);
+
+  for (uint8_t d = 0; d < damageCount; d++) {
+    DamageRect rect = damage[d];
+    expandDamage(rect);
+
+    pDisplay->fillRect(rect.left, rect.top, rect.right - rect.left,
+                       rect.bottom - rect.top, background);
+    for (uint8_t i = 0; i < widgetCount; i++) {
+      const Widget& widget = widgets[i];
+      if (!widget.visible) continue;
+      DamageRect b;
+      getBounds(widget, b);
+      if (intersects(rect.left, rect.top, rect.right, rect.bottom, b.left,
+                     b.top, b.right, b.bottom)) {
+        drawWidget(widget);
+      }
+    }
+  }
+  damageCount = 0;
+
+  pDisplay->setAutoFlush(savedAutoFlush);
+  pDisplay->flush();
+  return true;
+}
+
+void WidgetScreen::drawWidget(const Widget& widget) {
+  switch (widget.type) {
+    case WIDGET_LABEL:
+      pDisplay->drawText(widget.text, widget.x, widget.y, widget.color,
+                         widget.size);
+      break;
+    case WIDGET_RECT:
+      pDisplay->drawRect(widget.x, widget.y, widget.w, widget.h, widget.color);
+      break;
+    case WIDGET_FILL_RECT:
+      pDisplay->fillRect(widget.x, widget.y, widget.w, widget.h, widget.color);
+      break;
+    case WIDGET_LINE:
+      pDisplay->drawLine(widget.x, widget.y, widget.w, widget.h, widget.color);
+      break;
+    case WIDGET_IMAGE:
+      if (widget.image != nullptr) {
+        pDisplay->drawImage(*widget.image, widget.x, widget.y);
+      }
+      break;
+    case WIDGET_PROGRESS: {
+      // 与 OTA 进度界面相同：边框内留 2 像素，按百分比填充
+      pDisplay->drawRect(widget.x, widget.y, widget.w, widget.h, widget.color2);
+      int16_t fillWidth = (widget.w - 4) * widget.value / 100;
+      if (fillWidth > 0) {
+        pDisplay->fillRect(widget.x + 2, widget.y + 2, fillWidth, widget.h - 4,
+                           widget.color);
+      }
+      break;
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#ifndef WIDGET_SCREEN_H
+#define WIDGET_SCREEN_H
+
+#include <Arduino.h>
+#include "Display.h"
+
+// 控件类型
+enum WidgetType : uint8_t {
+  WIDGET_LABEL,      // 单行文字（可水平居中）
+  WIDGET_RECT,       // 矩形边框
+  WIDGET_FILL_RECT,  // 实心矩形
+  WIDGET_LINE,       // 线段
+  WIDGET_IMAGE,      // RGB565 图片
+  WIDGET_PROGRESS    // 进度条（边框 + 按百分比填充）
+};
+
+/**
+ * 保留模式界面
+ *
+ * 界面由一组控件组成，控件属性改变时只记录它新旧位置的损坏区域；
+ * render() 用背景色填充损坏区域，再按添加顺序重绘与之相交的控件，
+ * 一次 flush 推送。与损坏区域部分重叠的控件会把区域扩大到整个控件，
+ * 所以不需要裁剪。界面被其他代码覆盖后调用 begin() 重新建立
+ */
+class WidgetScreen {
+public:
+  static const uint8_t MAX_WIDGETS = 16;
+  static const uint8_t MAX_TEXT_LENGTH = 31;
+  static const uint8_t MAX_DAMAGE_RECTS = 4;
+  static const uint8_t NO_WIDGET = 0xFF;
+
+  WidgetScreen(DisplayManager* display);
+
+  // 移除所有控件，下一次 render() 重绘整屏
+  void begin(uint16_t background = ST77XX_BLACK);
+
+  // 添加控件，返回控件编号（已满时返回 NO_WIDGET）
+  uint8_t addLabel(const char* text, int16_t x, int16_t y, uint16_t color,
+                   uint8_t size = 1);
+  uint8_t addCenteredLabel(const char* text, int16_t y, uint16_t color,
+                           uint8_t size = 1);
+  uint8_t addRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color,
+                  bool filled = false);
+  uint8_t addLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                  uint16_t color);
+  uint8_t addImage(const ImageData* image, int16_t x, int16_t y);
+  uint8_t addProgressBar(int16_t x, int16_t y, int16_t w, int16_t h,
+                         uint16_t barColor, uint16_t frameColor = ST77XX_WHITE);
+
+  // 修改属性（值不变时不产生损坏区域）
+  void setText(uint8_t id, const char* text);
+  void setColor(uint8_t id, uint16_t color);
+  void setPosition(uint8_t id, int16_t x, int16_t y);
+  void setVisible(uint8_t id, bool visible);
+  void setValue(uint8_t id, uint8_t percent);  // 进度条 0~100
+  void setImage(uint8_t id, const ImageData* image);
+
+  // 重绘损坏区域，没有损坏时返回 false
+  bool render();
+  void invalidate();  // 整屏标记为损坏
+  bool isDirty() const { return damageCount > 0; }
+  uint8_t getWidgetCount() const { return widgetCount; }
+
+private:
+  struct Widget {
+    const ImageData* image;
+    int16_t x, y;      // 线段为起点
+    int16_t w, h;      // 线段为终点；文字为算出的尺寸
+    uint16_t color;    // 进度条为填充色
+    uint16_t color2;   // 进度条边框色
+    uint8_t size;      // 字号
+    uint8_t value;     // 进度百分比
+    WidgetType type;
+    bool centered;
+    bool visible;
+    char text[MAX_TEXT_LENGTH + 1];
+  };
+
+  struct DamageRect {
+    int16_t left, top, right, bottom;  // right / bottom 不含
+  };
+
+  DisplayManager* pDisplay;
+  uint16_t background;
+  Widget widgets[MAX_WIDGETS];
+  uint8_t widgetCount;
+  DamageRect damage[MAX_DAMAGE_RECTS];
+  uint8_t damageCount;
+
+  Widget* addWidget(WidgetType type);
+  Widget* getWidget(uint8_t id);
+  void layoutLabel(Widget& widget);
+  void getBounds(const Widget& widget, DamageRect& out) const;
+  void damageWidget(const Widget& widget);
+  void addDamage(DamageRect rect);
+  void expandDamage(DamageRect& rect) const;
+  void drawWidget(const Widget& widget);
+};
+
+#endif // WIDGET_SCREEN_H
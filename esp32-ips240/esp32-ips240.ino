@@ -14,6 +14,7 @@
  * TFT_MOSI -> GPIO 10
  * TFT_SCLK -> GPIO 11
  * TFT_BL   -> GPIO 16
+ * TFT_TE   -> 可选，接上后在 Display.h 中设置 TFT_TE
  */
 
 #include "Display.h"
@@ -25,6 +26,10 @@
 #include "SnakeGame.h"
 #include "ClockDisplay.h"
 #include "OTAManager.h"
+#include "DisplayBenchmark.h"
+#include "WidgetScreen.h"
+#include "TaskScheduler.h"
+#include "ImageReceiver.h"
 
 // 创建模块实例
 DisplayManager display;
@@ -35,6 +40,10 @@ CommandHandler* commandHandler;  // 使用指针，在setup中初始化
 SnakeGame* snakeGame;             // 贪吃蛇游戏实例
 ClockDisplay* clockDisplay;       // 时钟显示实例
 OTAManager* otaManager;           // OTA更新管理器
+DisplayBenchmark* benchmark;      // 显示性能基准测试
+ImageReceiver* imageReceiver;     // BLE 图片上传
+WidgetScreen statusScreen(&display);  // 状态界面（WiFi / 就绪 / OTA 进度），只重绘变化的控件
+TaskScheduler scheduler;              // 主循环任务调度（空闲时睡到下一次释放）
 
 // 演示模式
 enum DemoMode {
@@ -54,9 +63,16 @@ bool isManualMode = false;  // 手动控制模式
 bool isClockMode = false;   // 时钟模式标志
 bool wifiConnected = false;
 
+// 按当前模式启用的任务
+uint8_t animationTask = TaskScheduler::NO_TASK;
+uint8_t snakeTask = TaskScheduler::NO_TASK;
+uint8_t clockRefreshTask = TaskScheduler::NO_TASK;
+
 // 前向声明回调函数
-void onBLECommandReceived(String command);
+void onBLECommandReceived(char* command, size_t length);
+void onBLEFrameReceived(uint8_t opcode, const uint8_t* payload, uint16_t length);
 void onWiFiCredentialsReceived(String ssid, String password);
+void onBLEConnectionChanged(bool connected);
 void onOTAProgress(unsigned int progress, unsigned int total);
 
 // OTA进度显示回调
@@ -72,33 +88,27 @@ void onOTAProgress(unsigned int progress, unsigned int total) {
 
   int percent = (progress * 100) / total;
 
-  display.clear(ST77XX_BLACK);
-
-  // 标题
-  display.drawCenteredText("OTA Updating", 40, ST77XX_YELLOW, 2);
-
-  // 进度百分比
-  String percentText = String(percent) + "%";
-  display.drawCenteredText(percentText.c_str(), 80, ST77XX_WHITE, 3);
-
-  // 进度条外框
-  int barX = 20;
-  int barY = 120;
-  int barWidth = 200;
-  int barHeight = 20;
-  display.drawRect(barX, barY, barWidth, barHeight, ST77XX_WHITE);
-
-  // 进度条填充
-  int fillWidth = (barWidth - 4) * percent / 100;
-  if (fillWidth > 0) {
-    display.fillRect(barX + 2, barY + 2, fillWidth, barHeight - 4, ST77XX_GREEN);
+  // 第一次回调时建立界面，之后只重绘百分比和进度条
+  static uint8_t percentLabel = WidgetScreen::NO_WIDGET;
+  static uint8_t progressBar = WidgetScreen::NO_WIDGET;
+  if (progressBar == WidgetScreen::NO_WIDGET || progress == 0) {
+    statusScreen.begin(ST77XX_BLACK);
+    // 标题
+    statusScreen.addCenteredLabel("OTA Updating", 40, ST77XX_YELLOW, 2);
+    // 进度百分比
+    percentLabel = statusScreen.addCenteredLabel("", 80, ST77XX_WHITE, 3);
+    // 进度条
+    progressBar = statusScreen.addProgressBar(20, 120, 200, 20, ST77XX_GREEN,
+                                              ST77XX_WHITE);
+    // 底部提示
+    statusScreen.addCenteredLabel("Please wait...", 160, ST77XX_CYAN, 1);
+    statusScreen.addCenteredLabel("Do not power off!", 180, ST77XX_RED, 1);
   }
 
-  // 底部提示
-  display.drawCenteredText("Please wait...", 160, ST77XX_CYAN, 1);
-  display.drawCenteredText("Do not power off!", 180, ST77XX_RED, 1);
-
-  display.flush();
+  String percentText = String(percent) + "%";
+  statusScreen.setText(percentLabel, percentText.c_str());
+  statusScreen.setValue(progressBar, percent);
+  statusScreen.render();
 
   Serial.printf("OTA进度: %d%%\n", percent);
 }
@@ -110,7 +120,11 @@ void setup() {
   Serial.println("========================================");
 
   // 1. 初始化显示屏
-  display.begin(BUFFER_MODE_DIRECT, SPI_FREQUENCY_FAST);  // 使用直接模式
+  // 全彩单缓冲（RGB565，有 PSRAM 时放 PSRAM），分配失败时退回直接模式。
+  // 内部 SRAM 紧张时可改用 BUFFER_MODE_INDEXED8（RGB332，所有颜色会被量化）
+  display.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  // 动画按固定步长调度；接了 TE（Display.h 中的 TFT_TE）时推送前还会避开扫描线
+  display.setFramePacing(true);
   display.printPerformanceInfo();
   Serial.println("开始显示启动界面...");
   showStartupScreen();
@@ -131,7 +145,9 @@ void setup() {
   // 5. 初始化BLE
   bleManager.begin("ESP32-LED");
   bleManager.setCommandCallback(onBLECommandReceived);
+  bleManager.setFrameCallback(onBLEFrameReceived);
   bleManager.setWiFiCredentialsCallback(onWiFiCredentialsReceived);
+  bleManager.setConnectionCallback(onBLEConnectionChanged);
   showBLEStatus();
   delay(1500);
 
@@ -184,6 +200,30 @@ void setup() {
   }
   commandHandler->setOTAManager(otaManager);  // 设置OTA管理器到指令处理器
 
+  // 基准测试（BLE 指令 BENCH / BENCH:0-5 触发，结果输出到串口）
+  benchmark = new DisplayBenchmark(&display);
+  benchmark->setAssets(&heartImage, &smileImage, &heartBeatAnimation);
+  commandHandler->setBenchmark(benchmark);
+
+  // 图片上传（IMAGE_BEGIN / IMAGE_DATA 帧，直接写入帧缓冲）
+  imageReceiver = new ImageReceiver(&display);
+  commandHandler->setImageReceiver(imageReceiver);
+
+  // 主循环任务（周期 us，优先级数值越大越先运行）
+  scheduler.addTask("flush", taskPollFlush, nullptr, 2000, 3);
+  scheduler.addTask("bleCommands", taskBLECommands, nullptr, 2000, 3);
+  scheduler.addTask("bleNotify", taskBLENotify, nullptr, 2000, 2);
+  animationTask = scheduler.addTask("animation", taskAnimation, nullptr, 4000, 2);
+  snakeTask = scheduler.addTask("snake", taskSnake, nullptr,
+                                snakeGame->getStepInterval() * 1000, 2);
+  scheduler.addTask("clock", taskClock, nullptr, 50000, 1);
+  clockRefreshTask = scheduler.addTask("clockRefresh", taskClockRefresh, nullptr,
+                                       1000000, 1);
+  scheduler.addTask("ota", taskOTA, nullptr, 20000, 1);
+  scheduler.addTask("demo", taskDemo, nullptr, 100000, 0);
+  scheduler.addTask("wifi", taskWiFi, nullptr, 100000, 0);
+  commandHandler->setScheduler(&scheduler);
+
   // 9. 显示就绪界面
   showReadyScreen();
   delay(1500);
@@ -199,75 +239,102 @@ void setup() {
 }
 
 void loop() {
-  unsigned long currentTime = millis();
+  updateTaskStates();
+  scheduler.run();
+}
 
-  // 更新WiFi状态
-  wifiManager.update();
+// 按模式启用任务（BLE 指令会切换模式，每次调度前同步）
+void updateTaskStates() {
+  bool demoRunning = !isManualMode;
+  scheduler.setEnabled(animationTask, demoRunning && currentMode == MODE_ANIMATION);
+  scheduler.setEnabled(snakeTask, demoRunning && currentMode == MODE_SNAKE);
+  scheduler.setEnabled(clockRefreshTask, isClockMode);
+}
+
+// ========== 调度任务 ==========
+
+// 推进异步刷新（DMA）
+void taskPollFlush(void* context) {
+  display.pollFlush();
+}
+
+// 执行 BLE 回调入队的指令（绘图、配网、OTA 都在主循环中进行）
+void taskBLECommands(void* context) {
+  bleManager.processCommands();
+}
+
+// 发送排队的 BLE 通知（队列按连接间隔控制节奏）
+void taskBLENotify(void* context) {
+  bleManager.poll();
+}
+
+// 动画帧按 FramePacer 的固定步长推进，任务周期只决定检查的粒度
+void taskAnimation(void* context) {
+  display.updateAnimation();
+}
+
+// 贪吃蛇：任务周期即步进间隔（DEMO2专属，不自动切换）
+void taskSnake(void* context) {
+  snakeGame->tick();
+}
+
+// 时钟一直在后台计时（如果时间已设置）
+void taskClock(void* context) {
+  clockDisplay->update();
+}
+
+// 在时钟模式下，每秒刷新显示
+void taskClockRefresh(void* context) {
+  clockDisplay->refresh();
+}
 
-  // 处理OTA请求（Arduino OTA）
+// 处理OTA请求（Arduino OTA）
+void taskOTA(void* context) {
   if (otaManager) {
     otaManager->handle();
   }
+}
 
-  // 只在非手动模式下运行演示
-  if (!isManualMode) {
-    // 贪吃蛇模式特殊处理：持续运行，不自动切换（DEMO2专属）
-    if (currentMode == MODE_SNAKE) {
-      snakeGame->update();
-    } else {
-      // 其他模式每5秒切换一次（DEMO循环：文本→图片→动画→图形）
-      if (currentTime - lastModeChange >= MODE_DURATION) {
-        lastModeChange = currentTime;
-
-        // 停止当前模式的后台活动
-        stopCurrentMode();
-
-        // 切换到下一个模式（循环前4个模式，跳过贪吃蛇）
-        currentMode = (DemoMode)((currentMode + 1) % 4);
-        display.clear();
-
-        switch (currentMode) {
-          case MODE_TEXT:
-            showTextDemo();
-            break;
-
-          case MODE_IMAGES:
-            showImageDemo();
-            break;
-
-          case MODE_ANIMATION:
-            showAnimationDemo();
-            break;
-
-          case MODE_GRAPHICS:
-            showGraphicsDemo();
-            break;
-
-          default:
-            break;
-        }
-      }
+// 更新WiFi状态
+void taskWiFi(void* context) {
+  wifiManager.update();
+}
 
-      // 在动画模式下更新动画
-      if (currentMode == MODE_ANIMATION) {
-        display.updateAnimation();
-      }
-    }
-  }
+// 演示模式每5秒切换一次（DEMO循环：文本→图片→动画→图形）
+void taskDemo(void* context) {
+  if (isManualMode || currentMode == MODE_SNAKE) return;
 
-  // 时钟一直在后台计时（如果时间已设置）
-  clockDisplay->update();
+  unsigned long currentTime = millis();
+  if (currentTime - lastModeChange < MODE_DURATION) return;
+  lastModeChange = currentTime;
 
-  // 在时钟模式下，每秒刷新显示
-  if (isClockMode) {
-    static unsigned long lastClockRefresh = 0;
-    if (currentTime - lastClockRefresh >= 1000) {
-      clockDisplay->show();
-      lastClockRefresh = currentTime;
-    }
-  }
+  // 停止当前模式的后台活动
+  stopCurrentMode();
+
+  // 切换到下一个模式（循环前4个模式，跳过贪吃蛇）
+  currentMode = (DemoMode)((currentMode + 1) % 4);
+  display.clear();
+
+  switch (currentMode) {
+    case MODE_TEXT:
+      showTextDemo();
+      break;
+
+    case MODE_IMAGES:
+      showImageDemo();
+      break;
+
+    case MODE_ANIMATION:
+      showAnimationDemo();
+      break;
 
-  delay(10);
+    case MODE_GRAPHICS:
+      showGraphicsDemo();
+      break;
+
+    default:
+      break;
+  }
 }
 
 // 停止当前模式的后台活动
@@ -288,68 +355,109 @@ void stopCurrentMode() {
 
 // ========== BLE回调函数 ==========
 
-void onBLECommandReceived(String command) {
-  Serial.println("BLE指令: " + command);
+// 切换回自动演示模式（循环演示）
+void enterDemoMode() {
+  isManualMode = false;
+  isClockMode = false;  // 退出时钟模式
+  lastModeChange = millis();  // 重置计时器
+  currentMode = MODE_TEXT;     // 从文本模式开始
+  display.stopAnimation();
+  display.clear();
+  showTextDemo();
+  Serial.println("切换到自动演示模式");
+}
+
+// 切换到贪吃蛇演示模式
+void enterSnakeMode() {
+  isManualMode = false;
+  isClockMode = false;  // 退出时钟模式
+  currentMode = MODE_SNAKE;
+  display.stopAnimation();
+  display.clear();
+  showSnakeDemo();
+  Serial.println("切换到贪吃蛇演示模式");
+}
+
+// 切换到时钟模式
+void enterClockMode() {
+  isManualMode = true;  // 时钟模式不自动切换
+  isClockMode = true;   // 进入时钟模式
+  display.stopAnimation();
+  display.clear();
+  clockDisplay->show();
+  Serial.println("切换到时钟模式");
+}
 
-  // 检查是否是切换模式指令
-  String cmd = command;
-  cmd.toUpperCase();
+// 显式切换到手动模式
+void enterManualMode() {
+  isManualMode = true;
+  isClockMode = false;  // 退出时钟模式
+  display.stopAnimation();  // 停止可能正在播放的动画
+  Serial.println("切换到手动模式");
+}
 
-  if (cmd == "MODE:DEMO" || cmd == "DEMO" || cmd == "M:DEMO" || cmd == "D") {
-    // 切换回自动演示模式（循环演示）
-    isManualMode = false;
-    isClockMode = false;  // 退出时钟模式
-    lastModeChange = millis();  // 重置计时器
-    currentMode = MODE_TEXT;     // 从文本模式开始
+// 收到控制指令（TEXT, BRIGHTNESS, CLEAR等）
+void takeManualControl() {
+  if (!isManualMode) {
+    // 从自动演示模式切换到手动模式
+    isManualMode = true;
     display.stopAnimation();
-    display.clear();
-    showTextDemo();
+    Serial.println("收到控制指令，自动切换到手动模式");
+  }
+
+  // 退出时钟模式（如果正在时钟模式）
+  if (isClockMode) {
+    isClockMode = false;
+    Serial.println("退出时钟显示模式");
+  }
+}
+
+void onBLECommandReceived(char* command, size_t length) {
+  // 就地解析一次，模式切换与 CommandHandler 使用同一个结果
+  ParsedCommand cmd = TextCommandParser::parse(command, length);
+  Serial.printf("BLE指令: %s\n", cmd.command);
+
+  const char* mode = cmd.type == CMD_SET_MODE ? cmd.param : "";
+  if (TextCommandParser::equalsIgnoreCase(mode, "DEMO")) {
+    enterDemoMode();
     bleManager.sendData("OK:Auto demo mode");
-    Serial.println("切换到自动演示模式");
-  } else if (cmd == "MODE:DEMO2" || cmd == "DEMO2" || cmd == "M:DEMO2" || cmd == "D2") {
-    // 切换到贪吃蛇演示模式
-    isManualMode = false;
-    isClockMode = false;  // 退出时钟模式
-    currentMode = MODE_SNAKE;
-    display.stopAnimation();
-    display.clear();
-    showSnakeDemo();
+  } else if (TextCommandParser::equalsIgnoreCase(mode, "DEMO2")) {
+    enterSnakeMode();
     bleManager.sendData("OK:Snake game mode");
-    Serial.println("切换到贪吃蛇演示模式");
-  } else if (cmd == "MODE:CLOCK" || cmd == "CLOCK" || cmd == "M:CLOCK" || cmd == "CL") {
-    // 切换到时钟模式
-    isManualMode = true;  // 时钟模式不自动切换
-    isClockMode = true;   // 进入时钟模式
-    display.stopAnimation();
-    display.clear();
-    clockDisplay->show();
+  } else if (TextCommandParser::equalsIgnoreCase(mode, "CLOCK")) {
+    enterClockMode();
     bleManager.sendData("OK:Clock mode");
-    Serial.println("切换到时钟模式");
-  } else if (cmd == "MODE:MANUAL" || cmd == "M:MANUAL") {
-    // 显式切换到手动模式
-    isManualMode = true;
-    isClockMode = false;  // 退出时钟模式
-    display.stopAnimation();  // 停止可能正在播放的动画
+  } else if (TextCommandParser::equalsIgnoreCase(mode, "MANUAL")) {
+    enterManualMode();
     bleManager.sendData("OK:Manual mode");
-    Serial.println("切换到手动模式");
   } else {
-    // 收到控制指令（TEXT, BRIGHTNESS, CLEAR等）
-    if (!isManualMode) {
-      // 从自动演示模式切换到手动模式
-      isManualMode = true;
-      display.stopAnimation();
-      Serial.println("收到控制指令，自动切换到手动模式");
-    }
-
-    // 退出时钟模式（如果正在时钟模式）
-    if (isClockMode) {
-      isClockMode = false;
-      Serial.println("退出时钟显示模式");
-    }
+    takeManualControl();
   }
 
   // 处理指令
-  commandHandler->handleCommand(command);
+  commandHandler->execute(cmd);
+}
+
+// 二进制帧：不做字符串处理，模式切换与文本指令一致，回复由 CommandHandler 发出
+void onBLEFrameReceived(uint8_t opcode, const uint8_t* payload, uint16_t length) {
+  // 与文本指令相同：除了切换到演示 / 贪吃蛇 / 时钟 / 手动模式，其他指令都接管为手动控制
+  uint8_t mode = opcode == FRAME_OP_MODE && length == 1 ? payload[0] : 0xFF;
+  switch (mode) {
+    case MODE_DEMO:       enterDemoMode(); break;
+    case MODE_SNAKE_DEMO: enterSnakeMode(); break;
+    case MODE_CLOCK:      enterClockMode(); break;
+    case MODE_MANUAL:     enterManualMode(); break;
+    default:              takeManualControl(); break;
+  }
+
+  commandHandler->handleFrame(opcode, payload, length);
+}
+
+// 连接建立或断开：上一个连接未完成的图片上传不会再有数据帧
+void onBLEConnectionChanged(bool connected) {
+  if (imageReceiver != nullptr) {
+    imageReceiver->abort();
+  }
 }
 
 void onWiFiCredentialsReceived(String ssid, String password) {
@@ -427,16 +535,16 @@ void showWiFiConnecting(String ssid) {
 }
 
 void showWiFiConnected() {
-  display.clear(ST77XX_BLACK);
-  display.drawCenteredText("WiFi Connected!", 50, ST77XX_GREEN, 2);
-  display.drawCenteredText("SSID:", 90, ST77XX_WHITE, 1);
-  display.drawCenteredText(wifiManager.getSSID().c_str(), 110, ST77XX_CYAN, 1);
-  display.drawCenteredText("IP:", 140, ST77XX_WHITE, 1);
-  display.drawCenteredText(wifiManager.getLocalIP().c_str(), 160, ST77XX_YELLOW, 1);
+  statusScreen.begin(ST77XX_BLACK);
+  statusScreen.addCenteredLabel("WiFi Connected!", 50, ST77XX_GREEN, 2);
+  statusScreen.addCenteredLabel("SSID:", 90, ST77XX_WHITE, 1);
+  statusScreen.addCenteredLabel(wifiManager.getSSID().c_str(), 110, ST77XX_CYAN, 1);
+  statusScreen.addCenteredLabel("IP:", 140, ST77XX_WHITE, 1);
+  statusScreen.addCenteredLabel(wifiManager.getLocalIP().c_str(), 160, ST77XX_YELLOW, 1);
 
   String rssiText = String(wifiManager.getRSSI()) + " dBm";
-  display.drawCenteredText(rssiText.c_str(), 190, ST77XX_WHITE, 1);
-  display.flush();
+  statusScreen.addCenteredLabel(rssiText.c_str(), 190, ST77XX_WHITE, 1);
+  statusScreen.render();
 }
 
 void showWiFiFailed() {
@@ -448,25 +556,25 @@ void showWiFiFailed() {
 }
 
 void showReadyScreen() {
-  display.clear(ST77XX_BLACK);
-  display.drawCenteredText("System Ready!", 70, ST77XX_GREEN, 2);
+  statusScreen.begin(ST77XX_BLACK);
+  statusScreen.addCenteredLabel("System Ready!", 70, ST77XX_GREEN, 2);
 
   // BLE状态
   if (bleManager.isConnected()) {
-    display.drawCenteredText("BLE: Connected", 110, ST77XX_CYAN, 1);
+    statusScreen.addCenteredLabel("BLE: Connected", 110, ST77XX_CYAN, 1);
   } else {
-    display.drawCenteredText("BLE: Waiting", 110, ST77XX_YELLOW, 1);
+    statusScreen.addCenteredLabel("BLE: Waiting", 110, ST77XX_YELLOW, 1);
   }
 
   // WiFi状态
   if (wifiConnected) {
-    display.drawCenteredText("WiFi: Connected", 130, ST77XX_CYAN, 1);
+    statusScreen.addCenteredLabel("WiFi: Connected", 130, ST77XX_CYAN, 1);
   } else {
-    display.drawCenteredText("WiFi: Not connected", 130, ST77XX_ORANGE, 1);
+    statusScreen.addCenteredLabel("WiFi: Not connected", 130, ST77XX_ORANGE, 1);
   }
 
-  display.drawCenteredText("Starting demo...", 170, ST77XX_WHITE, 1);
-  display.flush();
+  statusScreen.addCenteredLabel("Starting demo...", 170, ST77XX_WHITE, 1);
+  statusScreen.render();
 }
 
 void showTextDemo() {
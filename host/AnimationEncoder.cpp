@@ -0,0 +1,131 @@
+#include "AnimationEncoder.h"
+#include "AnimationDecoder.h"
+#include <ctype.h>
+#include <stdio.h>
+
+// ========== 编码 ==========
+
+static void emitOp(std::vector<uint16_t>& out, uint16_t type, uint32_t count,
+                   const uint16_t* pixels) {
+  while (count > 0) {
+    uint32_t n = count > AnimationDecoder::COUNT_MASK
+                     ? AnimationDecoder::COUNT_MASK
+                     : count;
+    out.push_back(type | (uint16_t)n);
+    if (type == AnimationDecoder::OP_LITERAL) {
+      out.insert(out.end(), pixels, pixels + n);
+      pixels += n;
+    } else if (type == AnimationDecoder::OP_FILL) {
+      out.push_back(pixels[0]);
+    }
+    count -= n;
+  }
+}
+
+// [begin, end) 内的像素编码为同色段与原样段
+static void encodePixels(std::vector<uint16_t>& out, const uint16_t* pixels,
+                         uint32_t begin, uint32_t end) {
+  uint32_t literalStart = begin;
+  uint32_t i = begin;
+  while (i < end) {
+    uint32_t run = 1;
+    while (i + run < end && pixels[i + run] == pixels[i]) run++;
+
+    if (run >= 3) {
+      emitOp(out, AnimationDecoder::OP_LITERAL, i - literalStart,
+             &pixels[literalStart]);
+      emitOp(out, AnimationDecoder::OP_FILL, run, &pixels[i]);
+      literalStart = i + run;
+    }
+    i += run;
+  }
+  emitOp(out, AnimationDecoder::OP_LITERAL, end - literalStart,
+         &pixels[literalStart]);
+}
+
+std::vector<uint16_t> encodeAnimation(uint16_t width, uint16_t height,
+                                      const std::vector<RGB565Frame>& frames,
+                                      const std::vector<uint16_t>& durations,
+                                      uint16_t keyInterval) {
+  std::vector<uint16_t> out;
+  uint32_t count = (uint32_t)width * height;
+
+  for (size_t f = 0; f < frames.size(); f++) {
+    const uint16_t* cur = frames[f].data();
+    bool key = f == 0 || (keyInterval > 0 && f % keyInterval == 0);
+
+    out.push_back(key ? AnimationDecoder::FRAME_KEY : 0);
+    out.push_back(f < durations.size() ? durations[f] : 100);
+
+    if (key) {
+      encodePixels(out, cur, 0, count);
+    } else {
+      const uint16_t* prev = frames[f - 1].data();
+      std::vector<bool> changed(count);
+      for (uint32_t i = 0; i < count; i++) changed[i] = cur[i] != prev[i];
+
+      // 合并 1~2 像素的未变化间隙：少一次 SKIP 和一个行段
+      for (uint32_t i = 1; i + 1 < count; i++) {
+        if (changed[i] || !changed[i - 1]) continue;
+        uint32_t gap = 1;
+        while (i + gap < count && !changed[i + gap] && gap <= 2) gap++;
+        if (gap <= 2 && i + gap < count) {
+          for (uint32_t k = 0; k < gap; k++) changed[i + k] = true;
+        }
+      }
+
+      uint32_t i = 0;
+      while (i < count) {
+        uint32_t j = i;
+        while (j < count && changed[j] == changed[i]) j++;
+        if (!changed[i]) {
+          // 帧尾未变化的像素不需要编码
+          if (j < count) emitOp(out, AnimationDecoder::OP_SKIP, j - i, nullptr);
+        } else {
+          encodePixels(out, cur, i, j);
+        }
+        i = j;
+      }
+    }
+    out.push_back(AnimationDecoder::OP_END);
+  }
+  return out;
+}
+
+// ========== 文件 ==========
+
+void writeAnimationData(FILE* f, const std::string& name,
+                        const std::vector<uint16_t>& stream, uint16_t width,
+                        uint16_t height, uint16_t frameCount) {
+  fprintf(f, "// %s：%u 帧 %ux%u，编码 %u 字节（原始 %u 字节）\n", name.c_str(),
+          frameCount, width, height, (unsigned)(stream.size() * 2),
+          (unsigned)((uint32_t)width * height * frameCount * 2));
+  fprintf(f, "const uint16_t %sStream[] PROGMEM = {", name.c_str());
+  for (size_t i = 0; i < stream.size(); i++) {
+    fprintf(f, "%s0x%04X,", i % 12 == 0 ? "\n  " : " ", stream[i]);
+  }
+  fprintf(f, "\n};\n\n");
+  fprintf(f, "CompressedAnimation %s = {\n", name.c_str());
+  fprintf(f, "  %sStream,\n  %u,    // 宽\n  %u,    // 高\n  %u,    // 帧数\n",
+          name.c_str(), width, height, frameCount);
+  fprintf(f, "  -1,   // x: 居中\n  -1,   // y: 居中\n  true  // 循环播放\n};\n\n");
+}
+
+bool writeAnimationHeader(const char* path, const std::string& name,
+                          const std::vector<uint16_t>& stream, uint16_t width,
+                          uint16_t height, uint16_t frameCount) {
+  FILE* f = fopen(path, "w");
+  if (f == nullptr) return false;
+
+  std::string guard = name;
+  for (size_t i = 0; i < guard.size(); i++) guard[i] = toupper(guard[i]);
+
+  fprintf(f, "#ifndef %s_ANIMATION_H\n#define %s_ANIMATION_H\n\n",
+          guard.c_str(), guard.c_str());
+  fprintf(f, "// 由 host/anim_encode 生成\n");
+  fprintf(f, "#include \"AnimationDecoder.h\"\n\n");
+  writeAnimationData(f, name, stream, width, height, frameCount);
+  fprintf(f, "#endif\n");
+  fclose(f);
+  return true;
+}
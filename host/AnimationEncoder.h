@@ -0,0 +1,32 @@
+#ifndef HOST_ANIMATION_ENCODER_H
+#define HOST_ANIMATION_ENCODER_H
+
+/**
+ * 主机端工具：压缩动画编码（格式见 esp32-ips240/AnimationDecoder.h）
+ *
+ * - 关键帧：整帧编码为 OP_FILL（连续 3 个以上同色）/ OP_LITERAL
+ * - 差分帧：与上一帧相同的像素编码为 OP_SKIP，1~2 个像素的小间隙并入变化段，
+ *   避免行段过碎（每段在刷新时对应一次地址窗口）
+ */
+
+#include "ImageLoader.h"
+#include <stdio.h>
+#include <string>
+
+// 编码整段动画；keyInterval 为关键帧间隔（0 表示只有第 0 帧是关键帧）
+std::vector<uint16_t> encodeAnimation(uint16_t width, uint16_t height,
+                                      const std::vector<RGB565Frame>& frames,
+                                      const std::vector<uint16_t>& durations,
+                                      uint16_t keyInterval);
+
+// 写出编码流数组和 CompressedAnimation 定义（不含头文件保护）
+void writeAnimationData(FILE* f, const std::string& name,
+                        const std::vector<uint16_t>& stream, uint16_t width,
+                        uint16_t height, uint16_t frameCount);
+
+// 把编码流写成可直接 #include 到草图中的头文件
+bool writeAnimationHeader(const char* path, const std::string& name,
+                          const std::vector<uint16_t>& stream, uint16_t width,
+                          uint16_t height, uint16_t frameCount);
+
+#endif // HOST_ANIMATION_ENCODER_H
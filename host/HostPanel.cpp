@@ -0,0 +1,68 @@
+#include "HostPanel.h"
+
+void printSpiStats(const char* label, const SpiStats& stats) {
+  printf("%-28s win=%-6u px=%-8llu calls=%-6u dma=%-4u bytes=%-8llu "
+         "@40MHz=%8.1fus @80MHz=%8.1fus\n",
+         label, stats.addrWindowCount, (unsigned long long)stats.pixels,
+         stats.writePixelsCalls + stats.writeColorCalls, stats.dmaTransfers,
+         (unsigned long long)stats.totalBytes(),
+         stats.modelledMicros(SPI_FREQUENCY_DEFAULT),
+         stats.modelledMicros(SPI_FREQUENCY_FAST));
+}
+
+uint32_t compareWithFrameBuffer(const Adafruit_ST7789* tft,
+                                const FrameBuffer* fb) {
+  uint32_t mismatches = 0;
+  for (int16_t y = 0; y < tft->height(); y++) {
+    for (int16_t x = 0; x < tft->width(); x++) {
+      if (tft->getGRAMPixel(x, y) != fb->getPixel(x, y)) {
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+
+uint32_t comparePanels(const Adafruit_ST7789* a, const Adafruit_ST7789* b) {
+  uint32_t mismatches = 0;
+  for (int16_t y = 0; y < a->height(); y++) {
+    for (int16_t x = 0; x < a->width(); x++) {
+      if (a->getGRAMPixel(x, y) != b->getGRAMPixel(x, y)) {
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+
+uint32_t panelChecksum(const Adafruit_ST7789* tft) {
+  uint32_t hash = 2166136261u;
+  for (int16_t y = 0; y < tft->height(); y++) {
+    for (int16_t x = 0; x < tft->width(); x++) {
+      uint16_t c = tft->getGRAMPixel(x, y);
+      hash = (hash ^ (c & 0xFF)) * 16777619u;
+      hash = (hash ^ (c >> 8)) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+bool writePanelPPM(const Adafruit_ST7789* tft, const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (f == nullptr) return false;
+
+  fprintf(f, "P6\n%d %d\n255\n", tft->width(), tft->height());
+  for (int16_t y = 0; y < tft->height(); y++) {
+    for (int16_t x = 0; x < tft->width(); x++) {
+      uint16_t c = tft->getGRAMPixel(x, y);
+      uint8_t rgb[3] = {
+        (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+        (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+        (uint8_t)((c & 0x1F) * 255 / 31)
+      };
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  fclose(f);
+  return true;
+}
@@ -0,0 +1,26 @@
+#ifndef HOST_PANEL_H
+#define HOST_PANEL_H
+
+/**
+ * 主机端工具：SPI 统计输出、面板显存校验、PPM 导出
+ */
+
+#include "Display.h"
+
+// 打印一段 SPI 统计（含 40/80 MHz 下的模拟线上时间）
+void printSpiStats(const char* label, const SpiStats& stats);
+
+// 比较面板显存与帧缓冲（后台缓冲）内容，返回不一致的像素数
+uint32_t compareWithFrameBuffer(const Adafruit_ST7789* tft,
+                                const FrameBuffer* fb);
+
+// 比较两块面板显存，返回不一致的像素数
+uint32_t comparePanels(const Adafruit_ST7789* a, const Adafruit_ST7789* b);
+
+// 计算面板显存的校验和（FNV-1a），用于像素输出回归
+uint32_t panelChecksum(const Adafruit_ST7789* tft);
+
+// 导出面板显存为 PPM 图片
+bool writePanelPPM(const Adafruit_ST7789* tft, const char* path);
+
+#endif // HOST_PANEL_H
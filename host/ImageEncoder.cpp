@@ -0,0 +1,164 @@
+#include "ImageEncoder.h"
+#include <map>
+
+EncodedImage EncodedAsset::view() const {
+  EncodedImage img = {data.data(), palette.empty() ? nullptr : palette.data(),
+                      width, height, encoding};
+  return img;
+}
+
+uint32_t EncodedAsset::totalBytes() const {
+  return data.size() + palette.size() * 2;
+}
+
+// ========== 编码 ==========
+
+static void pushColor(std::vector<uint8_t>& out, uint16_t color) {
+  out.push_back(color & 0xFF);
+  out.push_back(color >> 8);
+}
+
+static void encodeRLE(const RGB565Frame& pixels, std::vector<uint8_t>& out) {
+  size_t count = pixels.size();
+  size_t literalStart = 0;
+  size_t i = 0;
+
+  // [literalStart, end) 写成原样包
+  auto flushLiteral = [&](size_t end) {
+    while (literalStart < end) {
+      size_t n = end - literalStart > 128 ? 128 : end - literalStart;
+      out.push_back((uint8_t)(n - 1));
+      for (size_t k = 0; k < n; k++) pushColor(out, pixels[literalStart + k]);
+      literalStart += n;
+    }
+  };
+
+  while (i < count) {
+    size_t run = 1;
+    while (i + run < count && pixels[i + run] == pixels[i]) run++;
+
+    if (run >= 3) {
+      flushLiteral(i);
+      for (size_t left = run; left > 0;) {
+        size_t n = left > 128 ? 128 : left;
+        out.push_back(0x80 | (uint8_t)(n - 1));
+        pushColor(out, pixels[i]);
+        left -= n;
+      }
+      literalStart = i + run;
+    }
+    i += run;
+  }
+  flushLiteral(count);
+}
+
+static uint8_t indexedBits(ImageEncoding encoding) {
+  switch (encoding) {
+    case IMAGE_INDEXED1: return 1;
+    case IMAGE_INDEXED2: return 2;
+    case IMAGE_INDEXED4: return 4;
+    case IMAGE_INDEXED8: return 8;
+    default: return 0;
+  }
+}
+
+bool encodeImage(const RGB565Frame& pixels, uint16_t width, uint16_t height,
+                 ImageEncoding encoding, EncodedAsset& out) {
+  if (pixels.size() != (size_t)width * height) return false;
+
+  out.encoding = encoding;
+  out.width = width;
+  out.height = height;
+  out.palette.clear();
+  out.data.clear();
+
+  if (encoding == IMAGE_RGB565) {
+    for (size_t i = 0; i < pixels.size(); i++) pushColor(out.data, pixels[i]);
+    return true;
+  }
+  if (encoding == IMAGE_RLE) {
+    encodeRLE(pixels, out.data);
+    return true;
+  }
+
+  uint8_t bpp = indexedBits(encoding);
+  std::map<uint16_t, uint8_t> index;
+  for (size_t i = 0; i < pixels.size(); i++) {
+    if (index.count(pixels[i])) continue;
+    if (out.palette.size() >= (1u << bpp)) return false;
+    index[pixels[i]] = (uint8_t)out.palette.size();
+    out.palette.push_back(pixels[i]);
+  }
+
+  // 每行按字节对齐，高位在左
+  uint8_t perByte = 8 / bpp;
+  size_t stride = ((size_t)width * bpp + 7) / 8;
+  out.data.assign(stride * height, 0);
+  for (uint16_t y = 0; y < height; y++) {
+    uint8_t* row = &out.data[y * stride];
+    for (uint16_t x = 0; x < width; x++) {
+      uint8_t shift = 8 - bpp * (x % perByte + 1);
+      row[x / perByte] |= index[pixels[y * width + x]] << shift;
+    }
+  }
+  return true;
+}
+
+EncodedAsset encodeImageAuto(const RGB565Frame& pixels, uint16_t width,
+                             uint16_t height) {
+  static const ImageEncoding candidates[] = {
+      IMAGE_INDEXED1, IMAGE_INDEXED2, IMAGE_INDEXED4, IMAGE_INDEXED8, IMAGE_RLE};
+
+  EncodedAsset best;
+  encodeImage(pixels, width, height, IMAGE_RGB565, best);
+  for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+    EncodedAsset asset;
+    if (encodeImage(pixels, width, height, candidates[i], asset) &&
+        asset.totalBytes() < best.totalBytes()) {
+      best = asset;
+    }
+  }
+  return best;
+}
+
+const char* encodingName(ImageEncoding encoding) {
+  switch (encoding) {
+    case IMAGE_RGB565: return "IMAGE_RGB565";
+    case IMAGE_INDEXED1: return "IMAGE_INDEXED1";
+    case IMAGE_INDEXED2: return "IMAGE_INDEXED2";
+    case IMAGE_INDEXED4: return "IMAGE_INDEXED4";
+    case IMAGE_INDEXED8: return "IMAGE_INDEXED8";
+    case IMAGE_RLE: return "IMAGE_RLE";
+  }
+  return "?";
+}
+
+// ========== 文件 ==========
+
+void writeImageData(FILE* f, const std::string& name, const EncodedAsset& asset) {
+  fprintf(f, "// %s：%ux%u %s，%u 字节（原始 %u 字节）\n", name.c_str(),
+          asset.width, asset.height, encodingName(asset.encoding),
+          asset.totalBytes(), (unsigned)((uint32_t)asset.width * asset.height * 2));
+
+  if (!asset.palette.empty()) {
+    fprintf(f, "const uint16_t %sPalette[] PROGMEM = {", name.c_str());
+    for (size_t i = 0; i < asset.palette.size(); i++) {
+      fprintf(f, "%s0x%04X,", i % 12 == 0 ? "\n  " : " ", asset.palette[i]);
+    }
+    fprintf(f, "\n};\n");
+  }
+  fprintf(f, "const uint8_t %sData[] PROGMEM = {", name.c_str());
+  for (size_t i = 0; i < asset.data.size(); i++) {
+    fprintf(f, "%s0x%02X,", i % 16 == 0 ? "\n  " : " ", asset.data[i]);
+  }
+  fprintf(f, "\n};\n");
+
+  fprintf(f, "const EncodedImage %s = {\n  %sData,\n", name.c_str(), name.c_str());
+  if (asset.palette.empty()) {
+    fprintf(f, "  nullptr,\n");
+  } else {
+    fprintf(f, "  %sPalette,\n", name.c_str());
+  }
+  fprintf(f, "  %u,    // 宽\n  %u,    // 高\n  %s\n};\n\n", asset.width,
+          asset.height, encodingName(asset.encoding));
+}
@@ -0,0 +1,42 @@
+#ifndef HOST_IMAGE_ENCODER_H
+#define HOST_IMAGE_ENCODER_H
+
+/**
+ * 主机端工具：静态图片编码（格式见 esp32-ips240/ImageDecoder.h）
+ *
+ * - 索引格式：按首次出现顺序提取调色板，颜色数超过 2^位数 时失败
+ * - RLE：连续 3 个以上同色编码为重复包，其余为原样包，每包最多 128 像素
+ * - 自动选择：在可用格式中取数据 + 调色板总字节数最小的一种
+ */
+
+#include "ImageDecoder.h"
+#include "ImageLoader.h"
+#include <stdio.h>
+#include <string>
+
+struct EncodedAsset {
+  ImageEncoding encoding;
+  uint16_t width;
+  uint16_t height;
+  std::vector<uint16_t> palette;
+  std::vector<uint8_t> data;
+
+  // 指向本对象数据的 EncodedImage（对象销毁或修改后失效）
+  EncodedImage view() const;
+  uint32_t totalBytes() const;
+};
+
+// 按指定格式编码；索引格式颜色过多时返回 false
+bool encodeImage(const RGB565Frame& pixels, uint16_t width, uint16_t height,
+                 ImageEncoding encoding, EncodedAsset& out);
+
+// 自动选择最小的格式
+EncodedAsset encodeImageAuto(const RGB565Frame& pixels, uint16_t width,
+                             uint16_t height);
+
+const char* encodingName(ImageEncoding encoding);
+
+// 写出数据 / 调色板数组和 EncodedImage 定义（不含头文件保护）
+void writeImageData(FILE* f, const std::string& name, const EncodedAsset& asset);
+
+#endif // HOST_IMAGE_ENCODER_H
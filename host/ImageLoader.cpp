@@ -0,0 +1,96 @@
+#include "ImageLoader.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#ifdef HOST_HAVE_PNG
+#include <png.h>
+#endif
+
+static uint16_t toRGB565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static bool hasExtension(const char* path, const char* ext) {
+  size_t n = strlen(path);
+  size_t m = strlen(ext);
+  return n > m && strcasecmp(path + n - m, ext) == 0;
+}
+
+bool readPPM(const char* path, uint16_t& width, uint16_t& height,
+             RGB565Frame& pixels) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) return false;
+
+  int w = 0, h = 0, maxval = 0;
+  if (fscanf(f, "P6 %d %d %d", &w, &h, &maxval) != 3 || maxval != 255 ||
+      w <= 0 || h <= 0 || w > 0xFFFF || h > 0xFFFF) {
+    fclose(f);
+    return false;
+  }
+  fgetc(f);  // 头部之后的单个空白
+
+  width = w;
+  height = h;
+  pixels.resize((size_t)w * h);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    uint8_t rgb[3];
+    if (fread(rgb, 1, 3, f) != 3) {
+      fclose(f);
+      return false;
+    }
+    pixels[i] = toRGB565(rgb[0], rgb[1], rgb[2]);
+  }
+  fclose(f);
+  return true;
+}
+
+#ifdef HOST_HAVE_PNG
+bool readPNG(const char* path, uint16_t& width, uint16_t& height,
+             RGB565Frame& pixels) {
+  png_image image;
+  memset(&image, 0, sizeof(image));
+  image.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(&image, path)) return false;
+  if (image.width == 0 || image.height == 0 || image.width > 0xFFFF ||
+      image.height > 0xFFFF) {
+    png_image_free(&image);
+    return false;
+  }
+
+  // 透明像素与黑色（屏幕背景）混合
+  image.format = PNG_FORMAT_RGB;
+  png_color background = {0, 0, 0};
+  std::vector<uint8_t> rgb(PNG_IMAGE_SIZE(image));
+  if (!png_image_finish_read(&image, &background, rgb.data(), 0, nullptr)) {
+    png_image_free(&image);
+    return false;
+  }
+
+  width = image.width;
+  height = image.height;
+  pixels.resize((size_t)width * height);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = toRGB565(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+  }
+  return true;
+}
+#else
+bool readPNG(const char* path, uint16_t& width, uint16_t& height,
+             RGB565Frame& pixels) {
+  (void)width;
+  (void)height;
+  (void)pixels;
+  fprintf(stderr, "%s: 构建时未找到 libpng，请先转换为 PPM\n", path);
+  return false;
+}
+#endif
+
+bool readImage(const char* path, uint16_t& width, uint16_t& height,
+               RGB565Frame& pixels) {
+  if (hasExtension(path, ".png")) return readPNG(path, width, height, pixels);
+  return readPPM(path, width, height, pixels);
+}
+
+bool isImageFile(const char* path) {
+  return hasExtension(path, ".ppm") || hasExtension(path, ".png");
+}
@@ -0,0 +1,31 @@
+#ifndef HOST_IMAGE_LOADER_H
+#define HOST_IMAGE_LOADER_H
+
+/**
+ * 主机端工具：读取源图片并转换为 RGB565
+ *
+ * - PPM（P6，maxval 255）始终可用
+ * - PNG 需要构建时找到 libpng（定义 HOST_HAVE_PNG），带透明通道时与黑色混合
+ */
+
+#include <stdint.h>
+#include <vector>
+
+typedef std::vector<uint16_t> RGB565Frame;
+
+// 读取二进制 PPM（P6，maxval 255）并转换为 RGB565
+bool readPPM(const char* path, uint16_t& width, uint16_t& height,
+             RGB565Frame& pixels);
+
+// 读取 PNG（任意位深 / 颜色类型）；没有 libpng 时返回 false
+bool readPNG(const char* path, uint16_t& width, uint16_t& height,
+             RGB565Frame& pixels);
+
+// 按扩展名选择 readPPM / readPNG
+bool readImage(const char* path, uint16_t& width, uint16_t& height,
+               RGB565Frame& pixels);
+
+// 是否为 readImage 支持的扩展名
+bool isImageFile(const char* path);
+
+#endif // HOST_IMAGE_LOADER_H
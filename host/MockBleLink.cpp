@@ -0,0 +1,199 @@
+#include "MockBleLink.h"
+
+// ========== 设备端 ==========
+
+// 解析器回调没有上下文参数，经文件内的变量找到接收器和待发通知
+static ImageReceiver* linkReceiver = nullptr;
+static std::vector<std::vector<uint8_t> > deviceNotifications;
+
+static uint8_t linkImageBegin(void* context, const uint8_t* payload,
+                              uint16_t length, uint8_t* reply,
+                              uint16_t* replyLength) {
+  return ((ImageReceiver*)context)->begin(payload, length, reply, replyLength);
+}
+
+static uint8_t linkImageData(void* context, const uint8_t* payload,
+                             uint16_t length, uint8_t* reply,
+                             uint16_t* replyLength) {
+  return ((ImageReceiver*)context)->receive(payload, length, reply, replyLength);
+}
+
+static uint8_t linkImageEnd(void* context, const uint8_t* payload,
+                            uint16_t length, uint8_t* reply,
+                            uint16_t* replyLength) {
+  return ((ImageReceiver*)context)->end(payload, length, reply, replyLength);
+}
+
+// 与 CommandHandler 分发表中的图片表项相同
+static const FrameCommand linkCommands[] = {
+  {FRAME_OP_IMAGE_BEGIN, 9, 9, linkImageBegin},
+  {FRAME_OP_IMAGE_DATA, ImageReceiver::SEQUENCE_SIZE + 1,
+   FrameParser::MAX_PAYLOAD, linkImageData},
+  {FRAME_OP_IMAGE_END, 0, 0, linkImageEnd}
+};
+
+// 与 CommandHandler::handleFrame 相同：DEFERRED 不回复，其余回复 状态 + 数据
+static void deviceFrame(uint8_t opcode, const uint8_t* payload,
+                        uint16_t length) {
+  uint8_t response[32];
+  uint16_t responseLength = sizeof(response) - 1;
+  response[0] = FrameParser::dispatch(
+      linkCommands, sizeof(linkCommands) / sizeof(linkCommands[0]),
+      linkReceiver, opcode, payload, length, response + 1, &responseLength);
+  if (response[0] == FRAME_STATUS_DEFERRED) return;
+
+  uint8_t frame[64];
+  size_t frameLength = FrameParser::encode(opcode | FRAME_REPLY_FLAG, response,
+                                           responseLength + 1, frame,
+                                           sizeof(frame));
+  deviceNotifications.push_back(
+      std::vector<uint8_t>(frame, frame + frameLength));
+}
+
+// ========== 手机端 ==========
+
+struct PhoneState {
+  bool beginReplied;
+  uint8_t beginStatus;
+  uint8_t window;
+  uint16_t maxChunk;
+  uint32_t base;       // 最早未确认的数据帧
+  uint32_t next;       // 下一个要发送的数据帧
+  bool acked;          // 本事件收到推进窗口的确认
+  bool completed;
+};
+
+static PhoneState phone;
+
+static void phoneFrame(uint8_t opcode, const uint8_t* payload,
+                       uint16_t length) {
+  if (opcode == (FRAME_OP_IMAGE_BEGIN | FRAME_REPLY_FLAG)) {
+    phone.beginReplied = true;
+    phone.beginStatus = payload[0];
+    if (payload[0] == FRAME_STATUS_OK && length >= 4) {
+      phone.window = payload[1];
+      phone.maxChunk = payload[2] | (payload[3] << 8);
+    }
+    return;
+  }
+  if (opcode != (FRAME_OP_IMAGE_DATA | FRAME_REPLY_FLAG) || length < 8) return;
+
+  // 16 位序号按与窗口起点的距离还原
+  uint16_t expected = payload[1] | (payload[2] << 8);
+  uint32_t acked = phone.base + (uint16_t)(expected - (uint16_t)phone.base);
+  if (acked > phone.base && acked <= phone.next) {
+    phone.base = acked;
+    phone.acked = true;
+  }
+  if (payload[0] == FRAME_STATUS_OUT_OF_ORDER) {
+    // 回退 N 帧：从期望的序号重发
+    phone.next = phone.base;
+  }
+  if (payload[7] != 0) {
+    phone.completed = true;
+  }
+}
+
+static void writeFrame(FrameParser& device, uint8_t opcode,
+                       const uint8_t* payload, uint16_t length) {
+  uint8_t frame[FrameParser::MAX_FRAME];
+  size_t frameLength = FrameParser::encode(opcode, payload, length, frame,
+                                           sizeof(frame));
+  device.feed(frame, frameLength);
+}
+
+bool simulateImageUpload(ImageReceiver& receiver, const BleLinkConfig& config,
+                         int16_t x, int16_t y, uint16_t w, uint16_t h,
+                         ImageEncoding encoding, const std::vector<uint8_t>& data,
+                         BleLinkResult& result) {
+  memset(&result, 0, sizeof(result));
+  memset(&phone, 0, sizeof(phone));
+  linkReceiver = &receiver;
+  deviceNotifications.clear();
+
+  FrameParser device;
+  device.setCallback(deviceFrame);
+  FrameParser phoneParser;
+  phoneParser.setCallback(phoneFrame);
+
+  // 设备端在 IMAGE_BEGIN 时按协商的 MTU 计算数据帧大小（同 CommandHandler）
+  receiver.setMTU(config.mtu);
+
+  unsigned long start = micros();
+  unsigned long eventTime = start;
+  const uint8_t begin[9] = {
+    (uint8_t)(x & 0xFF), (uint8_t)(x >> 8), (uint8_t)(y & 0xFF), (uint8_t)(y >> 8),
+    (uint8_t)(w & 0xFF), (uint8_t)(w >> 8), (uint8_t)(h & 0xFF), (uint8_t)(h >> 8),
+    (uint8_t)encoding
+  };
+  writeFrame(device, FRAME_OP_IMAGE_BEGIN, begin, sizeof(begin));
+
+  uint32_t chunkSize = 0;
+  uint32_t totalChunks = 0;
+  uint32_t highestSent = 0;
+  uint32_t idleEvents = 0;
+  uint8_t payload[FrameParser::MAX_PAYLOAD];
+  const uint32_t MAX_EVENTS = 100000;
+
+  while (!phone.completed && result.events < MAX_EVENTS) {
+    eventTime += config.intervalMicros;
+    hostWaitUntilMicros(eventTime);
+    result.events++;
+
+    // 上一个事件中设备发出的通知
+    for (size_t i = 0; i < deviceNotifications.size(); i++) {
+      phoneParser.feed(&deviceNotifications[i][0], deviceNotifications[i].size());
+    }
+    result.notifications += deviceNotifications.size();
+    deviceNotifications.clear();
+
+    if (!phone.beginReplied) continue;
+    if (phone.beginStatus != FRAME_STATUS_OK) break;
+    if (totalChunks == 0) {
+      chunkSize = phone.maxChunk;
+      totalChunks = (data.size() + chunkSize - 1) / chunkSize;
+    }
+    if (phone.completed) break;
+
+    // 超时：窗口中的数据帧一直没有确认（最后几个数据帧或确认丢失）
+    if (phone.acked) {
+      idleEvents = 0;
+    } else if (phone.base < phone.next && ++idleEvents >= config.timeoutEvents) {
+      phone.next = phone.base;
+      idleEvents = 0;
+    }
+    phone.acked = false;
+
+    for (uint8_t p = 0; p < config.packetsPerEvent &&
+                        phone.next < phone.base + phone.window &&
+                        phone.next < totalChunks; p++) {
+      uint32_t offset = phone.next * chunkSize;
+      uint16_t length = min((uint32_t)data.size() - offset, chunkSize);
+      payload[0] = phone.next & 0xFF;
+      payload[1] = (phone.next >> 8) & 0xFF;
+      memcpy(payload + ImageReceiver::SEQUENCE_SIZE, &data[offset], length);
+
+      result.writes++;
+      if (phone.next < highestSent) {
+        result.retransmits++;
+      } else {
+        highestSent = phone.next + 1;
+      }
+      if (config.dropEvery > 0 && result.writes % config.dropEvery == 0) {
+        result.dropped++;
+      } else {
+        writeFrame(device, FRAME_OP_IMAGE_DATA, payload,
+                   ImageReceiver::SEQUENCE_SIZE + length);
+      }
+      phone.next++;
+    }
+  }
+
+  result.completed = phone.completed;
+  result.beginStatus = phone.beginStatus;
+  result.imageBytes = data.size();
+  result.chunks = totalChunks;
+  result.elapsedMicros = micros() - start;
+  linkReceiver = nullptr;
+  return result.completed;
+}
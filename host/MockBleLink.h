@@ -0,0 +1,50 @@
+#ifndef HOST_MOCK_BLE_LINK_H
+#define HOST_MOCK_BLE_LINK_H
+
+/**
+ * 主机端工具：模拟手机经 BLE 向 ImageReceiver 上传图片
+ *
+ * 链路模型（时间为模拟时间）：
+ * - 每个连接间隔一个连接事件，手机在一个事件中最多发出 packetsPerEvent 个无响应写入，
+ *   每个写入是一个完整的帧（不超过 MTU - 3 字节）
+ * - 设备收到写入立即经 FrameParser 和分发表处理；回复以通知发出，手机在下一个事件收到
+ * - 手机按 IMAGE_BEGIN 回复的窗口发送，收到累计确认后滑动窗口，收到 OUT_OF_ORDER
+ *   或超时未确认时从期望的序号重发
+ * - dropEvery > 0 时每 dropEvery 个数据写入丢弃一个
+ */
+
+#include "ImageReceiver.h"
+#include <vector>
+
+struct BleLinkConfig {
+  uint16_t mtu;
+  uint32_t intervalMicros;   // 连接间隔
+  uint8_t packetsPerEvent;
+  uint32_t dropEvery;
+  uint8_t timeoutEvents;     // 窗口中有未确认数据帧、连续这么多个事件没有确认时重发
+};
+
+struct BleLinkResult {
+  bool completed;
+  uint8_t beginStatus;
+  uint32_t imageBytes;       // 图片数据字节（不含帧开销）
+  uint32_t chunks;
+  uint32_t writes;           // 手机发出的数据写入（含重发和丢失的）
+  uint32_t dropped;
+  uint32_t retransmits;
+  uint32_t notifications;    // 设备发出的回复
+  uint32_t events;
+  uint32_t elapsedMicros;    // 发出 IMAGE_BEGIN 到收到完成确认
+
+  float kbps() const {
+    return elapsedMicros > 0 ? imageBytes * 1000000.0f / 1024.0f / elapsedMicros : 0;
+  }
+};
+
+// 上传 data（格式为 encoding 的图片数据）到 (x, y, w, h)，返回是否完成
+bool simulateImageUpload(ImageReceiver& receiver, const BleLinkConfig& config,
+                         int16_t x, int16_t y, uint16_t w, uint16_t h,
+                         ImageEncoding encoding, const std::vector<uint8_t>& data,
+                         BleLinkResult& result);
+
+#endif // HOST_MOCK_BLE_LINK_H
@@ -0,0 +1,100 @@
+/*
+ * 压缩动画编码工具
+ *
+ * 把目录中按文件名排序的 PPM / PNG 图片（尺寸相同）编码为关键帧 + 差分帧，
+ * 输出可直接放进草图目录的头文件，用 display.playAnimation(&名称) 播放
+ *
+ * 用法：anim_encode 图片目录 输出.h [--name 名称] [--duration 毫秒] [--key 间隔]
+ */
+
+#include "AnimationEncoder.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+static void usage() {
+  fprintf(stderr,
+          "用法：anim_encode 图片目录 输出.h [--name 名称] [--duration 毫秒] "
+          "[--key 间隔]\n");
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  const char* dirPath = argv[1];
+  const char* outPath = argv[2];
+  std::string name = "encodedAnimation";
+  uint16_t duration = 100;
+  uint16_t keyInterval = 0;
+  for (int i = 3; i < argc; i++) {
+    if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+      name = argv[++i];
+    } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+      duration = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--key") == 0 && i + 1 < argc) {
+      keyInterval = (uint16_t)atoi(argv[++i]);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  DIR* dir = opendir(dirPath);
+  if (dir == nullptr) {
+    fprintf(stderr, "无法打开目录 %s\n", dirPath);
+    return 1;
+  }
+  std::vector<std::string> files;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string file = entry->d_name;
+    if (isImageFile(file.c_str())) {
+      files.push_back(std::string(dirPath) + "/" + file);
+    }
+  }
+  closedir(dir);
+  std::sort(files.begin(), files.end());
+
+  if (files.empty() || files.size() > 0xFFFF) {
+    fprintf(stderr, "%s 中没有 PPM / PNG 图片\n", dirPath);
+    return 1;
+  }
+
+  uint16_t width = 0, height = 0;
+  std::vector<RGB565Frame> frames(files.size());
+  for (size_t i = 0; i < files.size(); i++) {
+    uint16_t w, h;
+    if (!readImage(files[i].c_str(), w, h, frames[i])) {
+      fprintf(stderr, "无法读取 %s\n", files[i].c_str());
+      return 1;
+    }
+    if (i == 0) {
+      width = w;
+      height = h;
+    } else if (w != width || h != height) {
+      fprintf(stderr, "%s 尺寸 %ux%u 与第一帧 %ux%u 不同\n", files[i].c_str(),
+              w, h, width, height);
+      return 1;
+    }
+  }
+
+  std::vector<uint16_t> durations(frames.size(), duration);
+  std::vector<uint16_t> stream =
+      encodeAnimation(width, height, frames, durations, keyInterval);
+
+  if (!writeAnimationHeader(outPath, name, stream, width, height,
+                            (uint16_t)frames.size())) {
+    fprintf(stderr, "无法写入 %s\n", outPath);
+    return 1;
+  }
+
+  uint32_t raw = (uint32_t)width * height * frames.size() * 2;
+  printf("%s: %u 帧 %ux%u，编码 %u 字节 / 原始 %u 字节 (%.1f%%)\n", outPath,
+         (unsigned)frames.size(), width, height, (unsigned)(stream.size() * 2),
+         raw, stream.size() * 200.0 / raw);
+  return 0;
+}
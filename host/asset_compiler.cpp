@@ -0,0 +1,183 @@
+/*
+ * 资源编译工具
+ *
+ * 把 PPM / PNG 图片和动画帧目录编译为一个可直接放进草图目录的头文件：
+ * - 图片编码为 EncodedImage（RGB565 / 1~8 位调色板 / RLE），用 display.drawImage 绘制
+ * - 动画编码为 CompressedAnimation（见 anim_encode），用 display.playAnimation 播放
+ *
+ * 用法：asset_compiler 输出.h [--format auto|rgb565|idx1|idx2|idx4|idx8|rle]
+ *                      名称=图片 ... [--anim 名称=目录] [--duration 毫秒] [--key 间隔]
+ * --format / --duration / --key 作用于其后的资源
+ */
+
+#include "AnimationEncoder.h"
+#include "ImageEncoder.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+static void usage() {
+  fprintf(stderr,
+          "用法：asset_compiler 输出.h [--format auto|rgb565|idx1|idx2|idx4|idx8|rle]\n"
+          "                     名称=图片 ... [--anim 名称=目录] [--duration 毫秒] "
+          "[--key 间隔]\n");
+}
+
+static bool parseFormat(const char* s, bool& autoFormat, ImageEncoding& encoding) {
+  static const struct {
+    const char* name;
+    ImageEncoding encoding;
+  } formats[] = {{"rgb565", IMAGE_RGB565}, {"idx1", IMAGE_INDEXED1},
+                 {"idx2", IMAGE_INDEXED2}, {"idx4", IMAGE_INDEXED4},
+                 {"idx8", IMAGE_INDEXED8}, {"rle", IMAGE_RLE}};
+
+  autoFormat = strcmp(s, "auto") == 0;
+  if (autoFormat) return true;
+  for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+    if (strcmp(s, formats[i].name) == 0) {
+      encoding = formats[i].encoding;
+      return true;
+    }
+  }
+  return false;
+}
+
+// 名称=路径
+static bool splitAsset(const char* arg, std::string& name, std::string& path) {
+  const char* eq = strchr(arg, '=');
+  if (eq == nullptr || eq == arg || eq[1] == '\0') return false;
+  name.assign(arg, eq - arg);
+  path = eq + 1;
+  return true;
+}
+
+static bool compileAnimation(FILE* out, const std::string& name,
+                             const std::string& dirPath, uint16_t duration,
+                             uint16_t keyInterval) {
+  DIR* dir = opendir(dirPath.c_str());
+  if (dir == nullptr) {
+    fprintf(stderr, "无法打开目录 %s\n", dirPath.c_str());
+    return false;
+  }
+  std::vector<std::string> files;
+  while (struct dirent* entry = readdir(dir)) {
+    if (isImageFile(entry->d_name)) files.push_back(dirPath + "/" + entry->d_name);
+  }
+  closedir(dir);
+  std::sort(files.begin(), files.end());
+  if (files.empty() || files.size() > 0xFFFF) {
+    fprintf(stderr, "%s 中没有 PPM / PNG 图片\n", dirPath.c_str());
+    return false;
+  }
+
+  uint16_t width = 0, height = 0;
+  std::vector<RGB565Frame> frames(files.size());
+  for (size_t i = 0; i < files.size(); i++) {
+    uint16_t w, h;
+    if (!readImage(files[i].c_str(), w, h, frames[i])) {
+      fprintf(stderr, "无法读取 %s\n", files[i].c_str());
+      return false;
+    }
+    if (i == 0) {
+      width = w;
+      height = h;
+    } else if (w != width || h != height) {
+      fprintf(stderr, "%s 尺寸 %ux%u 与第一帧 %ux%u 不同\n", files[i].c_str(),
+              w, h, width, height);
+      return false;
+    }
+  }
+
+  std::vector<uint16_t> durations(frames.size(), duration);
+  std::vector<uint16_t> stream =
+      encodeAnimation(width, height, frames, durations, keyInterval);
+  writeAnimationData(out, name, stream, width, height, (uint16_t)frames.size());
+  printf("  %-16s 动画 %u 帧 %ux%u，%u 字节\n", name.c_str(),
+         (unsigned)frames.size(), width, height, (unsigned)(stream.size() * 2));
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+
+  const char* outPath = argv[1];
+  FILE* out = fopen(outPath, "w");
+  if (out == nullptr) {
+    fprintf(stderr, "无法写入 %s\n", outPath);
+    return 1;
+  }
+
+  std::string guard = outPath;
+  size_t slash = guard.find_last_of('/');
+  if (slash != std::string::npos) guard = guard.substr(slash + 1);
+  for (size_t i = 0; i < guard.size(); i++) {
+    guard[i] = isalnum((unsigned char)guard[i]) ? toupper(guard[i]) : '_';
+  }
+  fprintf(out, "#ifndef %s\n#define %s\n\n", guard.c_str(), guard.c_str());
+  fprintf(out, "// 由 host/asset_compiler 生成，请勿手工修改\n");
+  fprintf(out, "#include \"ImageDecoder.h\"\n#include \"AnimationDecoder.h\"\n\n");
+
+  bool autoFormat = true;
+  ImageEncoding encoding = IMAGE_RGB565;
+  uint16_t duration = 100;
+  uint16_t keyInterval = 0;
+  uint32_t totalBytes = 0, rawBytes = 0;
+  bool ok = true;
+
+  for (int i = 2; i < argc && ok; i++) {
+    std::string name, path;
+    if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+      ok = parseFormat(argv[++i], autoFormat, encoding);
+      if (!ok) usage();
+    } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+      duration = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--key") == 0 && i + 1 < argc) {
+      keyInterval = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--anim") == 0 && i + 1 < argc) {
+      ok = splitAsset(argv[++i], name, path) &&
+           compileAnimation(out, name, path, duration, keyInterval);
+    } else if (splitAsset(argv[i], name, path)) {
+      uint16_t w, h;
+      RGB565Frame pixels;
+      if (!readImage(path.c_str(), w, h, pixels)) {
+        fprintf(stderr, "无法读取 %s\n", path.c_str());
+        ok = false;
+        break;
+      }
+      EncodedAsset asset;
+      if (autoFormat) {
+        asset = encodeImageAuto(pixels, w, h);
+      } else if (!encodeImage(pixels, w, h, encoding, asset)) {
+        fprintf(stderr, "%s 颜色数超过 %s 的调色板容量\n", path.c_str(),
+                encodingName(encoding));
+        ok = false;
+        break;
+      }
+      writeImageData(out, name, asset);
+      totalBytes += asset.totalBytes();
+      rawBytes += (uint32_t)w * h * 2;
+      printf("  %-16s %ux%u %-15s %u 字节 / 原始 %u 字节\n", name.c_str(), w, h,
+             encodingName(asset.encoding), asset.totalBytes(), w * h * 2);
+    } else {
+      usage();
+      ok = false;
+    }
+  }
+
+  fprintf(out, "#endif\n");
+  fclose(out);
+  if (!ok) {
+    remove(outPath);
+    return 1;
+  }
+  if (rawBytes > 0) {
+    printf("%s: 图片共 %u 字节 / 原始 %u 字节 (%.1f%%)\n", outPath, totalBytes,
+           rawBytes, totalBytes * 100.0 / rawBytes);
+  }
+  return 0;
+}
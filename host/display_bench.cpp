@@ -0,0 +1,78 @@
+/*
+ * 主机端显示基准测试
+ *
+ * 运行与设备相同的 DisplayBenchmark 负载，并额外输出记录型 ST7789
+ * 统计到的真实线上数据（含绕过帧缓冲直接写屏的调用）
+ *
+ * 用法：display_bench [0|1|2 ...]   缓冲模式，默认依次运行 0 1 2
+ */
+
+#include "Display.h"
+#include "DisplayBenchmark.h"
+#include "ExampleImages.h"
+#include "HostPanel.h"
+
+static void runMode(BufferMode mode) {
+  Serial.setEnabled(false);
+
+  DisplayManager display;
+  display.begin(BUFFER_MODE_DIRECT, SPI_FREQUENCY_FAST);
+
+  DisplayBenchmark bench(&display);
+  bench.setAssets(&heartImage, &smileImage, &heartBeatAnimation);
+
+  bool prepared = bench.prepare(mode);
+  Serial.setEnabled(true);
+  if (!prepared) {
+    printf("缓冲模式 %d 初始化失败\n", mode);
+    return;
+  }
+
+  printf("\n=== 缓冲模式 %d ===\n", mode);
+  DisplayBenchmark::printHeader();
+
+  Adafruit_ST7789* tft = display.getTFT();
+  SpiStats spi[32];
+  uint8_t count = bench.getWorkloadCount();
+
+  for (uint8_t i = 0; i < count && i < 32; i++) {
+    BenchResult result;
+    tft->resetStats();
+
+    Serial.setEnabled(false);
+    bool ok = bench.runWorkload(i, result);
+    Serial.setEnabled(true);
+
+    spi[i] = tft->getStats();
+    if (ok) {
+      DisplayBenchmark::printResult(result);
+    } else {
+      printf("%-18s skipped\n", bench.getWorkloadName(i));
+    }
+  }
+
+  printf("-- SPI 线上统计（记录型 ST7789） --\n");
+  for (uint8_t i = 0; i < count && i < 32; i++) {
+    printSpiStats(bench.getWorkloadName(i), spi[i]);
+  }
+
+  Serial.setEnabled(false);
+  bench.restore();
+  Serial.setEnabled(true);
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      runMode((BufferMode)atoi(argv[i]));
+    }
+  } else {
+    runMode(BUFFER_MODE_DIRECT);
+    runMode(BUFFER_MODE_SINGLE);
+    runMode(BUFFER_MODE_DOUBLE);
+    runMode(BUFFER_MODE_INDEXED8);
+    runMode(BUFFER_MODE_INDEXED4);
+    runMode(BUFFER_MODE_STRIP);
+  }
+  return 0;
+}
@@ -0,0 +1,2128 @@
+/*
+ * 主机端显示管线运行器
+ *
+ * 在没有开发板的情况下运行 DisplayManager / FrameBuffer：
+ * - 打印每个场景的 SPI 调用统计和 40/80 MHz 模拟传输时间
+ * - 校验缓冲模式下面板显存与帧缓冲逐像素一致
+ * - 校验直接模式与缓冲模式绘制图片的结果一致
+ * - 校验异步（DMA）刷新立即返回、与 loop 工作重叠且结果一致
+ * - 比较矩形列表与图块位图两种脏区域跟踪：推送 / 标记 / 实际变化像素
+ * - 双缓冲差分刷新：整屏重绘的时钟只发送变化的数字
+ * - 调色板索引模式：内存占用、差分刷新、自定义调色板与最近色映射
+ * - 缓冲放置：帧缓冲放 PSRAM、行缓存在内部 SRAM，容量不足时的退回
+ * - 图片缩放：越界裁剪、最近邻与双线性结果
+ * - 压缩动画：编码/解码往返一致，差分帧只刷新变化的像素
+ * - 编码图片：各种调色板 / RLE 格式绘制结果与原始图片一致
+ * - 渲染流水线：应用逻辑与渲染 / 刷新在两个线程上重叠，结果与串行一致
+ * - 二进制指令帧：任意切分与随机坏数据下的解析、分发表与解析吞吐
+ * - 文本指令：表驱动解析的结果、每条指令的堆分配次数与耗时
+ * - BLE 图片上传：模拟链路上的滑动窗口、丢包重发、速率与像素一致性
+ * - BLE 通知队列：短消息合并、超过 MTU 的分片、按连接间隔限速与丢弃计数
+ * - BLE 指令队列：高低水位背压、跨线程顺序、回调耗时与排队 / 执行 / 回复延迟
+ *
+ * 用法：display_host [--ppm 输出目录]
+ */
+
+#include "Display.h"
+#include "WidgetScreen.h"
+#include "ClockDisplay.h"
+#include "SegmentDigits.h"
+#include "TaskScheduler.h"
+#include "RenderPipeline.h"
+#include "BinaryProtocol.h"
+#include "TextCommandParser.h"
+#include "ImageReceiver.h"
+#include "NotifyQueue.h"
+#include "CommandQueue.h"
+#include "ExampleImages.h"
+#include "HostPanel.h"
+#include "AnimationEncoder.h"
+#include "ImageEncoder.h"
+#include "MockBleLink.h"
+#include <vector>
+#include <atomic>
+#include <new>
+#include <thread>
+
+static const char* ppmDir = nullptr;
+static int failures = 0;
+
+// 堆分配计数：替换全局 operator new（String 即 std::string 的分配都经过这里）
+static std::atomic<uint64_t> heapAllocations(0);
+
+void* operator new(size_t size) {
+  heapAllocations++;
+  void* p = malloc(size > 0 ? size : 1);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+static const char* modeName(BufferMode mode) {
+  switch (mode) {
+    case BUFFER_MODE_DIRECT: return "DIRECT";
+    case BUFFER_MODE_SINGLE: return "SINGLE";
+    case BUFFER_MODE_DOUBLE: return "DOUBLE";
+    case BUFFER_MODE_INDEXED8: return "INDEXED8";
+    case BUFFER_MODE_INDEXED4: return "INDEXED4";
+    case BUFFER_MODE_STRIP: return "STRIP";
+  }
+  return "?";
+}
+
+static void check(bool ok, const char* what) {
+  printf("  [%s] %s\n", ok ? "PASS" : "FAIL", what);
+  if (!ok) failures++;
+}
+
+static void dumpPanel(DisplayManager& display, const char* name) {
+  if (ppmDir == nullptr) return;
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.ppm", ppmDir, name);
+  if (writePanelPPM(display.getTFT(), path)) {
+    printf("  已导出 %s\n", path);
+  }
+}
+
+// 图片场景：原始图片、缩放图片、纯色块
+static void drawImageScene(DisplayManager& display) {
+  display.setAutoFlush(false);
+  display.drawImage(heartImage, 50, 60);
+  display.drawImage(smileImage, 50, 100);
+  display.drawImageScaled(heartImage, 80, 150, 32, 32);
+  display.drawImageScaled(smileImage, 140, 40, 64, 48);
+  // 部分超出屏幕的缩放图片（左下角裁剪、右上角双线性）
+  display.drawImageScaled(smileImage, -20, 200, 64, 64);
+  display.drawImageScaled(heartImage, 210, -12, 48, 48, SCALE_BILINEAR);
+  display.setAutoFlush(true);
+  display.flush();
+}
+
+// 文字与图形场景：缓冲模式下全部画进帧缓冲
+static void drawShapeScene(DisplayManager& display) {
+  display.setAutoFlush(false);
+  display.drawCenteredText("ESP32-S3", 20, ST77XX_CYAN, 3);
+  display.drawText("Hello, World!", 10, 60, ST77XX_WHITE, 1);
+  display.drawTextBox(10, 80, 140, 50, "Buffered text box wraps", ST77XX_YELLOW,
+                      ST77XX_BLUE);
+  display.drawCircle(190, 100, 30, ST77XX_GREEN);
+  display.fillCircle(60, 180, 25, ST77XX_RED);
+  display.drawLine(0, 239, 239, 140, ST77XX_MAGENTA);
+  display.drawRect(120, 150, 60, 40, ST77XX_WHITE);
+  display.fillRect(200, 200, 30, 30, ST77XX_ORANGE);
+  // 换行、越过右边缘自动换行、越过底边裁剪、超过屏宽的居中文字
+  display.drawText("Wrap\nacross the right edge", 150, 216, ST77XX_CYAN, 1);
+  display.drawCenteredText("Centered text wider than panel", 140, ST77XX_GREEN, 2);
+  display.setAutoFlush(true);
+  display.flush();
+}
+
+static void runBufferedScene(BufferMode mode) {
+  printf("\n== 缓冲模式 %s ==\n", modeName(mode));
+
+  DisplayManager display;
+  display.begin(mode, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = display.getTFT();
+  FrameBuffer* fb = display.getFrameBuffer();
+
+  tft->resetStats();
+  display.clear(ST77XX_BLACK);
+  printSpiStats("clear()", tft->getStats());
+
+  tft->resetStats();
+  drawImageScene(display);
+  printSpiStats("图片场景 flush()", tft->getStats());
+  check(compareWithFrameBuffer(tft, fb) == 0, "面板显存与帧缓冲一致");
+
+  tft->resetStats();
+  fb->fillRect(8, 8, 8, 8, ST77XX_RED);
+  fb->fillRect(120, 200, 8, 8, ST77XX_BLUE);
+  fb->fillRect(0, 0, SCREEN_WIDTH, 8, ST77XX_BLACK);
+  display.flush();
+  printSpiStats("小块更新 flush()", tft->getStats());
+  check(compareWithFrameBuffer(tft, fb) == 0, "小块更新后面板与帧缓冲一致");
+
+  tft->resetStats();
+  display.flushImmediate();
+  printSpiStats("flushImmediate()", tft->getStats());
+
+  tft->resetStats();
+  display.clear(ST77XX_BLACK);
+  tft->resetStats();
+  drawShapeScene(display);
+  printSpiStats("文字图形 flush()", tft->getStats());
+  check(compareWithFrameBuffer(tft, fb) == 0, "文字与图形画进帧缓冲并刷新到面板");
+
+  char name[32];
+  snprintf(name, sizeof(name), "scene_%s", modeName(mode));
+  dumpPanel(display, name);
+}
+
+static void runAsyncFlush(BufferMode mode) {
+  printf("\n== 异步刷新 %s ==\n", modeName(mode));
+
+  DisplayManager display;
+  display.begin(mode, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = display.getTFT();
+  FrameBuffer* fb = display.getFrameBuffer();
+
+  // 同步全屏刷新作为对照
+  fb->clear(ST77XX_BLUE);
+  unsigned long t0 = micros();
+  display.flush();
+  unsigned long syncMicros = micros() - t0;
+
+  // 默认关闭：flushAsync() 同步刷新并返回 false
+  fb->fillRect(0, 0, 40, 40, ST77XX_RED);
+  check(!display.getAsyncFlush() && !display.flushAsync() &&
+            !display.isFlushing() && tft->getGRAMPixel(10, 10) == ST77XX_RED,
+        "异步刷新默认关闭，flushAsync() 退回同步刷新");
+  display.setAsyncFlush(true);
+
+  // 全屏异步刷新：flushAsync() 只排队前两个行缓冲
+  tft->resetStats();
+  fb->clear(ST77XX_RED);
+  t0 = micros();
+  bool started = display.flushAsync();
+  unsigned long queueMicros = micros() - t0;
+  check(started, "DMA 可用，flushAsync() 走异步路径");
+  check(display.isFlushing(), "flushAsync() 返回时传输仍在进行");
+
+  // 模拟 loop：每轮 200us 的其他工作，期间调用 pollFlush()
+  uint32_t polls = 0;
+  while (display.isFlushing()) {
+    delayMicroseconds(200);
+    display.pollFlush();
+    polls++;
+  }
+  unsigned long asyncMicros = micros() - t0;
+  printSpiStats("flushAsync() 全屏", tft->getStats());
+  printf("  同步 flush %lu us，flushAsync 返回 %lu us，"
+         "%u 轮 loop 后完成（共 %lu us），DMA 传输 %u 次\n",
+         syncMicros, queueMicros, polls, asyncMicros,
+         tft->getStats().dmaTransfers);
+  check(queueMicros * 4 < syncMicros, "flushAsync() 返回耗时远小于同步刷新");
+  check(compareWithFrameBuffer(tft, fb) == 0, "异步全屏刷新后面板与帧缓冲一致");
+
+  // 多个脏区域，刷新进行中继续绘制，之后 waitFlush() 再刷新一次
+  tft->resetStats();
+  fb->fillRect(10, 10, 40, 40, ST77XX_GREEN);
+  fb->fillRect(150, 120, 60, 30, ST77XX_BLUE);
+  display.flushAsync();
+  fb->fillRect(100, 200, 20, 20, ST77XX_YELLOW);
+  display.waitFlush();
+  display.flushAsync();
+  display.waitFlush();
+  printSpiStats("flushAsync() 多区域", tft->getStats());
+  check(!display.isFlushing(), "waitFlush() 后没有进行中的传输");
+  check(compareWithFrameBuffer(tft, fb) == 0, "异步多区域刷新后面板与帧缓冲一致");
+
+  // 刷新进行中直接绘制会先等待 DMA 完成
+  fb->fillRect(0, 0, SCREEN_WIDTH, 60, ST77XX_WHITE);
+  display.flushAsync();
+  display.fillRect(0, 100, 30, 30, ST77XX_MAGENTA);
+  check(!display.isFlushing(), "直接绘制前已等待异步刷新完成");
+  check(tft->getGRAMPixel(0, 0) == ST77XX_WHITE &&
+        tft->getGRAMPixel(5, 105) == ST77XX_MAGENTA,
+        "异步刷新与直接绘制的结果都已写入面板");
+}
+
+static const char* trackingName(DirtyTracking tracking) {
+  return tracking == DIRTY_TRACK_TILES ? "图块位图" : "矩形列表";
+}
+
+// 贪吃蛇式更新：每步头尾各一个 8x8 格子加状态栏数字
+static void runSnakeUpdates(DisplayManager& display, const char* label) {
+  Adafruit_ST7789* tft = display.getTFT();
+  FrameBuffer* fb = display.getFrameBuffer();
+  display.clear(ST77XX_BLACK);
+  fb->resetFlushStats();
+  tft->resetStats();
+
+  const int steps = 60;
+  const int cell = 8;
+  uint64_t changed = 0;
+  std::vector<uint16_t> before;
+  for (int step = 0; step < steps; step++) {
+    before.assign(tft->getGRAM(), tft->getGRAM() + SCREEN_WIDTH * SCREEN_HEIGHT);
+
+    int head = step + 20;
+    fb->fillRect((head % 28) * cell + 8, 24 + (head / 28) * cell, cell, cell,
+                 ST77XX_GREEN);
+    fb->fillRect((step % 28) * cell + 8, 24 + (step / 28) * cell, cell, cell,
+                 ST77XX_BLACK);
+    fb->fillRect(4, 4, 36, 8, (step & 1) ? ST77XX_WHITE : ST77XX_YELLOW);
+    display.flush();
+
+    for (uint32_t i = 0; i < before.size(); i++) {
+      if (before[i] != tft->getGRAM()[i]) changed++;
+    }
+  }
+
+  const FlushStats& stats = fb->getFlushStats();
+  printSpiStats(label, tft->getStats());
+  printf("  每步推送 %.0f px / 标记 %.0f px / 实际变化 %.0f px，%.1f 个窗口\n",
+         (double)stats.pixelsPushed / steps, (double)stats.pixelsMarked / steps,
+         (double)changed / steps, (double)stats.addrWindowCount / steps);
+  check(stats.pixelsPushed < (uint64_t)steps * SCREEN_WIDTH * SCREEN_HEIGHT / 16,
+        "小块更新没有退化为全屏刷新");
+  check(compareWithFrameBuffer(tft, fb) == 0, "面板显存与帧缓冲一致");
+}
+
+// 分散的单像素更新：比较两种跟踪方式的标记耗时和刷新结果
+static void runScatteredPixels(DisplayManager& display) {
+  FrameBuffer* fb = display.getFrameBuffer();
+  Adafruit_ST7789* tft = display.getTFT();
+  const int count = 200;
+
+  unsigned long t0 = micros();
+  for (int i = 0; i < count; i++) {
+    fb->setPixel(random(SCREEN_WIDTH), random(SCREEN_HEIGHT), (uint16_t)random(0xFFFF));
+  }
+  unsigned long markMicros = micros() - t0;
+
+  FlushStats before = fb->getFlushStats();
+  display.flush();
+  const FlushStats& after = fb->getFlushStats();
+  printf("  %d 个随机像素：标记 %lu us，推送 %llu px，%u 个窗口\n", count,
+         markMicros,
+         (unsigned long long)(after.pixelsPushed - before.pixelsPushed),
+         after.addrWindowCount - before.addrWindowCount);
+  check(compareWithFrameBuffer(tft, fb) == 0, "分散更新后面板与帧缓冲一致");
+}
+
+static void runDirtyTracking(DirtyTracking tracking) {
+  printf("\n== 脏区域跟踪：%s ==\n", trackingName(tracking));
+
+  DisplayManager display;
+  display.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  FrameBuffer* fb = display.getFrameBuffer();
+  Adafruit_ST7789* tft = display.getTFT();
+  fb->setDirtyTracking(tracking);
+
+  runSnakeUpdates(display, "贪吃蛇 60 步");
+  runScatteredPixels(display);
+
+  if (tracking == DIRTY_TRACK_TILES) {
+    // 一个 8x8 格子跨越图块边界时标记 4 个图块
+    fb->fillRect(12, 12, 8, 8, ST77XX_RED);
+    check(fb->getDirtyTileCount() == 4, "跨图块边界的格子标记 4 个图块");
+    // 同一列相邻图块合并为一个窗口
+    fb->fillRect(100, 100, 10, 40, ST77XX_RED);
+    display.flush();
+    check(compareWithFrameBuffer(tft, fb) == 0, "图块行程刷新后面板与帧缓冲一致");
+
+    // 切换回矩形列表时保留未刷新的脏区域
+    fb->fillRect(200, 200, 4, 4, ST77XX_BLUE);
+    fb->setDirtyTracking(DIRTY_TRACK_REGIONS);
+    check(fb->isDirty() && fb->getDirtyRegionCount() == 1, "切换跟踪方式保留脏区域");
+    display.flush();
+    check(compareWithFrameBuffer(tft, fb) == 0, "切换后刷新结果一致");
+    return;
+  }
+
+  // 区域预算：20 个分散格子在预算 8 下合并为不超过 8 个区域
+  for (int i = 0; i < 20; i++) {
+    fb->fillRect((i % 5) * 48, (i / 5) * 60, 4, 4, ST77XX_RED);
+  }
+  printf("  预算 %u：20 个格子 -> %u 个区域\n", fb->getDirtyRegionBudget(),
+         fb->getDirtyRegionCount());
+  check(fb->getDirtyRegionCount() <= fb->getDirtyRegionBudget() &&
+        fb->getDirtyRegionCount() > 0, "脏区域数不超过预算且未退化为全屏");
+  display.flush();
+  check(compareWithFrameBuffer(tft, fb) == 0, "按预算合并后面板与帧缓冲一致");
+
+  // 预算为 1 时所有更新合并为一个外接矩形
+  fb->setDirtyRegionBudget(1);
+  fb->fillRect(10, 10, 4, 4, ST77XX_BLUE);
+  fb->fillRect(60, 30, 4, 4, ST77XX_BLUE);
+  check(fb->getDirtyRegionCount() == 1, "预算 1 时只保留一个区域");
+  const DirtyRegion& box = fb->getDirtyRegion(0);
+  check(box.x == 10 && box.y == 10 && box.width == 54 && box.height == 24,
+        "合并区域为两个更新的外接矩形");
+  display.flush();
+  check(compareWithFrameBuffer(tft, fb) == 0, "合并后面板与帧缓冲一致");
+}
+
+// 时钟式整屏重绘：每秒清屏并重画全部文字，只有秒数变化
+static uint64_t runClockRedraw(BufferMode mode, int seconds) {
+  DisplayManager display;
+  display.begin(mode, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = display.getTFT();
+  FrameBuffer* fb = display.getFrameBuffer();
+  display.setAutoFlush(false);
+
+  GFXcanvas16 line(SCREEN_WIDTH, 24);
+  line.setTextSize(3);
+  line.setTextColor(ST77XX_WHITE);
+
+  display.flush();
+  fb->resetFlushStats();
+  for (int s = 0; s < seconds; s++) {
+    char text[16];
+    snprintf(text, sizeof(text), "12:34:%02d", s % 60);
+    line.fillScreen(ST77XX_BLACK);
+    line.setCursor(48, 0);
+    line.print(text);
+
+    fb->clear(ST77XX_BLACK);
+    fb->fillRect(40, 80, 160, 1, ST77XX_BLUE);
+    fb->drawRect(0, 100, SCREEN_WIDTH, 24, line.getBuffer());
+    fb->fillRect(40, 145, 160, 1, ST77XX_BLUE);
+    display.flush();
+  }
+
+  check(compareWithFrameBuffer(tft, fb) == 0, "面板显存与帧缓冲一致");
+  return fb->getFlushStats().pixelsPushed;
+}
+
+static void runDiffFlush() {
+  printf("\n== 双缓冲差分刷新 ==\n");
+
+  const int seconds = 10;
+  uint64_t single = runClockRedraw(BUFFER_MODE_SINGLE, seconds);
+  uint64_t diff = runClockRedraw(BUFFER_MODE_DOUBLE, seconds);
+  printf("  时钟整屏重绘 %d 秒：SINGLE 推送 %llu px/秒，DOUBLE 差分 %llu px/秒\n",
+         seconds, (unsigned long long)(single / seconds),
+         (unsigned long long)(diff / seconds));
+  check(diff * 20 < single, "差分刷新只发送变化的数字");
+
+  // 直接写屏后前台缓冲失效，下一次刷新整屏发送以覆盖面板
+  DisplayManager display;
+  display.begin(BUFFER_MODE_DOUBLE, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = display.getTFT();
+  FrameBuffer* fb = display.getFrameBuffer();
+  display.clear(ST77XX_BLACK);
+  display.fillRect(20, 20, 50, 50, ST77XX_RED);
+  display.clear(ST77XX_BLACK);
+  check(tft->getGRAMPixel(30, 30) == ST77XX_BLACK, "直接写屏的内容被下一次刷新覆盖");
+
+  // 异步刷新同样只发送差异
+  fb->fillRect(100, 100, 40, 40, ST77XX_GREEN);
+  display.flush();
+  FlushStats before = fb->getFlushStats();
+  fb->fillRect(100, 100, 40, 40, ST77XX_GREEN);
+  fb->fillRect(110, 110, 4, 4, ST77XX_WHITE);
+  display.flushAsync();
+  display.waitFlush();
+  uint64_t pushed = fb->getFlushStats().pixelsPushed - before.pixelsPushed;
+  printf("  异步差分：重画 40x40，实际推送 %llu px\n", (unsigned long long)pushed);
+  check(pushed == 16, "异步刷新只发送变化的 4x4 像素");
+  check(compareWithFrameBuffer(tft, fb) == 0, "异步差分刷新后面板与帧缓冲一致");
+}
+
+static void runIndexedModes() {
+  printf("\n== 调色板索引模式 ==\n");
+
+  size_t usage[5];
+  for (int m = BUFFER_MODE_SINGLE; m <= BUFFER_MODE_INDEXED4; m++) {
+    FrameBuffer fb(SCREEN_WIDTH, SCREEN_HEIGHT);
+    fb.begin((BufferMode)m);
+    usage[m] = fb.getMemoryUsage();
+    printf("  %-8s 帧缓冲 %u KB\n", modeName((BufferMode)m),
+           (unsigned)(usage[m] / 1024));
+  }
+  check(usage[BUFFER_MODE_INDEXED8] * 2 < usage[BUFFER_MODE_DOUBLE] + 8192 &&
+        usage[BUFFER_MODE_INDEXED4] * 4 < usage[BUFFER_MODE_DOUBLE] + 16384,
+        "8 / 4 位索引双缓冲约为 RGB565 双缓冲的 1/2、1/4");
+
+  const int seconds = 10;
+  uint64_t single = runClockRedraw(BUFFER_MODE_SINGLE, seconds);
+  uint64_t indexed8 = runClockRedraw(BUFFER_MODE_INDEXED8, seconds);
+  uint64_t indexed4 = runClockRedraw(BUFFER_MODE_INDEXED4, seconds);
+  printf("  时钟整屏重绘：INDEXED8 差分 %llu px/秒，INDEXED4 差分 %llu px/秒\n",
+         (unsigned long long)(indexed8 / seconds),
+         (unsigned long long)(indexed4 / seconds));
+  check(indexed8 * 20 < single && indexed4 * 20 < single,
+        "索引模式同样只发送变化的数字");
+
+  // 自定义调色板：不在调色板中的颜色映射到最近的一项
+  DisplayManager display;
+  display.begin(BUFFER_MODE_INDEXED4, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = display.getTFT();
+  FrameBuffer* fb = display.getFrameBuffer();
+  static const uint16_t grays[4] = {0x0000, 0x52AA, 0xAD55, 0xFFFF};
+  fb->setPalette(grays, 4);
+  fb->fillRect(10, 10, 20, 20, 0x5AEB);   // 接近 0x52AA
+  fb->fillRect(40, 10, 20, 20, ST77XX_WHITE);
+  fb->setPixel(41, 11, 0x0841);           // 接近黑色
+  fb->resetFlushStats();
+  display.flush();
+  check(fb->getPixel(15, 15) == 0x52AA && fb->getPixel(41, 11) == 0x0000,
+        "颜色映射到最近的调色板项");
+  check(fb->getFlushStats().pixelsPushed == (uint64_t)SCREEN_WIDTH * SCREEN_HEIGHT,
+        "更换调色板后整屏重发");
+  check(compareWithFrameBuffer(tft, fb) == 0, "面板显存为调色板展开后的颜色");
+
+  // 4 位索引奇数列的边界：单像素宽的矩形只改写半个字节
+  fb->resetFlushStats();
+  fb->fillRect(101, 50, 1, 10, ST77XX_WHITE);
+  fb->fillRect(103, 50, 3, 10, 0xAD55);
+  display.flush();
+  check(fb->getPixel(100, 55) == 0x0000 && fb->getPixel(102, 55) == 0x0000 &&
+        fb->getPixel(106, 55) == 0x0000, "奇数列写入不影响相邻像素");
+  check(fb->getFlushStats().pixelsPushed == 50, "差分刷新只发送变化的像素");
+  check(compareWithFrameBuffer(tft, fb) == 0, "奇数列更新后面板与帧缓冲一致");
+}
+
+static void runBufferPlacement() {
+  printf("\n== 缓冲放置（模拟 160 KB 内部 SRAM + 8 MB PSRAM）==\n");
+  BufferAllocator::setHostLimits(160 * 1024, 8 * 1024 * 1024);
+
+  {
+    DisplayManager display;
+    display.begin(BUFFER_MODE_DOUBLE, SPI_FREQUENCY_FAST);
+    Adafruit_ST7789* tft = display.getTFT();
+    FrameBuffer* fb = display.getFrameBuffer();
+    printf("  DOUBLE：共 %u KB，内部 SRAM %u B，后台 %s / 前台 %s / 行缓存 %s\n",
+           (unsigned)(fb->getMemoryUsage() / 1024),
+           (unsigned)fb->getInternalMemoryUsage(),
+           BufferAllocator::regionName(fb->getBackBufferRegion()),
+           BufferAllocator::regionName(fb->getFrontBufferRegion()),
+           BufferAllocator::regionName(fb->getLineCacheRegion()));
+    check(fb->getMode() == BUFFER_MODE_DOUBLE &&
+              fb->getBackBufferRegion() == MEMORY_PSRAM &&
+              fb->getFrontBufferRegion() == MEMORY_PSRAM &&
+              fb->getLineCacheRegion() == MEMORY_INTERNAL,
+          "双缓冲放在 PSRAM，行缓存在内部 SRAM");
+    check(fb->getInternalMemoryUsage() < 8 * 1024, "内部 SRAM 只占用行缓存");
+
+    display.clear(ST77XX_BLACK);
+    drawImageScene(display);
+    check(compareWithFrameBuffer(tft, fb) == 0, "经行缓存中转后面板与帧缓冲一致");
+    fb->fillRect(30, 30, 50, 20, ST77XX_GREEN);
+    display.flushAsync();
+    display.waitFlush();
+    check(compareWithFrameBuffer(tft, fb) == 0, "异步刷新同样一致");
+  }
+
+  {
+    FrameBuffer fb(SCREEN_WIDTH, SCREEN_HEIGHT);
+    fb.setPlacement(BUFFER_PLACE_INTERNAL);
+    fb.begin(BUFFER_MODE_DOUBLE);
+    check(fb.getMode() == BUFFER_MODE_SINGLE &&
+              fb.getBackBufferRegion() == MEMORY_INTERNAL,
+          "只用内部 SRAM 时放不下前台缓冲，退回单缓冲");
+  }
+
+  BufferAllocator::setHostLimits(160 * 1024, 0);
+  {
+    FrameBuffer fb(SCREEN_WIDTH, SCREEN_HEIGHT);
+    fb.begin(BUFFER_MODE_INDEXED8);
+    check(fb.getMode() == BUFFER_MODE_INDEXED8 &&
+              fb.getBackBufferRegion() == MEMORY_INTERNAL &&
+              fb.getFrontBufferRegion() == MEMORY_INTERNAL,
+          "没有 PSRAM 时 8 位索引双缓冲放在内部 SRAM");
+  }
+  check(BufferAllocator::getFreeBytes(MEMORY_INTERNAL) == 160 * 1024,
+        "缓冲释放后内存全部归还");
+
+  BufferAllocator::setHostLimits(SIZE_MAX, 0);
+}
+
+static void runImageScaler() {
+  printf("\n== 图片缩放 ==\n");
+
+  DisplayManager display;
+  display.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  FrameBuffer* fb = display.getFrameBuffer();
+  display.setAutoFlush(false);
+
+  // 最近邻：左上角越界，可见部分与逐像素参考一致，其余像素不被改写
+  display.clear(ST77XX_BLUE);
+  fb->drawRectScaled(-24, -8, 96, 64, smileImage.data, smileImage.width,
+                     smileImage.height);
+  int mismatches = 0;
+  for (int16_t y = 0; y < 64; y++) {
+    for (int16_t x = 0; x < 96; x++) {
+      uint16_t expected = ST77XX_BLUE;
+      int16_t i = x + 24;
+      int16_t j = y + 8;
+      if (i < 96 && j < 64) {
+        expected = smileImage.data[(j * 32 / 64) * 32 + i * 32 / 96];
+      }
+      if (fb->getPixel(x, y) != expected) mismatches++;
+    }
+  }
+  check(mismatches == 0, "越界缩放只写可见部分且与参考一致");
+
+  // 双线性：纯色图片放大后仍为纯色，放大时四角与源四角一致
+  uint16_t solid[4 * 4];
+  for (int i = 0; i < 16; i++) solid[i] = ST77XX_ORANGE;
+  display.clear(ST77XX_BLACK);
+  fb->drawRectScaled(10, 10, 37, 23, solid, 4, 4, SCALE_BILINEAR);
+  bool uniform = true;
+  for (int16_t y = 10; y < 33; y++) {
+    for (int16_t x = 10; x < 47; x++) {
+      if (fb->getPixel(x, y) != ST77XX_ORANGE) uniform = false;
+    }
+  }
+  check(uniform, "纯色图片双线性缩放后颜色不变");
+
+  const uint16_t* src = heartImage.data;
+  fb->drawRectScaled(100, 100, 64, 64, src, 16, 16, SCALE_BILINEAR);
+  check(fb->getPixel(100, 100) == src[0] && fb->getPixel(163, 100) == src[15] &&
+            fb->getPixel(100, 163) == src[15 * 16] &&
+            fb->getPixel(163, 163) == src[255],
+        "双线性放大的四角取源图四角");
+
+  display.flush();
+  check(compareWithFrameBuffer(display.getTFT(), fb) == 0,
+        "缩放后面板与帧缓冲一致");
+}
+
+// 棋盘格背景上移动的方块
+static RGB565Frame makeMovingSquareFrame(uint16_t w, uint16_t h, int frame) {
+  RGB565Frame pixels((size_t)w * h);
+  for (uint16_t y = 0; y < h; y++) {
+    for (uint16_t x = 0; x < w; x++) {
+      pixels[y * w + x] = ((x / 8 + y / 8) & 1) ? 0x18E3 : ST77XX_BLACK;
+    }
+  }
+  for (int y = 20 + frame * 4; y < 32 + frame * 4; y++) {
+    for (int x = 8 + frame * 8; x < 20 + frame * 8; x++) {
+      pixels[y * w + x] = ST77XX_RED;
+    }
+  }
+  return pixels;
+}
+
+static void runCompressedAnimation(BufferMode mode) {
+  printf("\n== 压缩动画 %s ==\n", modeName(mode));
+
+  const uint16_t w = 96, h = 96;
+  const int frameCount = 8;
+  std::vector<RGB565Frame> frames;
+  for (int f = 0; f < frameCount; f++) {
+    frames.push_back(makeMovingSquareFrame(w, h, f));
+  }
+  std::vector<uint16_t> durations(frameCount, 50);
+  std::vector<uint16_t> stream = encodeAnimation(w, h, frames, durations, 0);
+  printf("  编码 %u 字节 / 原始 %u 字节\n", (unsigned)(stream.size() * 2),
+         (unsigned)(w * h * frameCount * 2));
+  check(stream.size() * 2 < (size_t)w * h * frameCount * 2 / 8,
+        "关键帧 + 差分帧编码小于原始数据的 1/8");
+
+  CompressedAnimation anim = {stream.data(), w, h, frameCount, -1, -1, true};
+  int16_t ox = (SCREEN_WIDTH - w) / 2;
+  int16_t oy = (SCREEN_HEIGHT - h) / 2;
+
+  DisplayManager display;
+  display.begin(mode, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = display.getTFT();
+  display.clear(ST77XX_BLACK);
+
+  display.playAnimation(&anim);
+  uint64_t maxDeltaPixels = 0;
+  int mismatchedFrames = 0;
+  // 多走两帧，覆盖循环回到关键帧
+  for (int i = 0; i <= frameCount + 1; i++) {
+    if (i > 0) {
+      tft->resetStats();
+      delay(50);
+      display.updateAnimation();
+      int f = i % frameCount;
+      if (f != 0 && tft->getStats().pixels > maxDeltaPixels) {
+        maxDeltaPixels = tft->getStats().pixels;
+      }
+    }
+    const RGB565Frame& expected = frames[i % frameCount];
+    for (uint16_t y = 0; y < h; y++) {
+      for (uint16_t x = 0; x < w; x++) {
+        if (tft->getGRAMPixel(ox + x, oy + y) != expected[y * w + x]) {
+          mismatchedFrames++;
+          y = h;
+          break;
+        }
+      }
+    }
+  }
+  printf("  差分帧最多推送 %llu px（整帧 %u px）\n",
+         (unsigned long long)maxDeltaPixels, (unsigned)(w * h));
+  check(mismatchedFrames == 0, "每一帧（含循环回第 0 帧）面板与源图一致");
+  check(maxDeltaPixels > 0 && maxDeltaPixels < (uint64_t)w * h / 8,
+        "差分帧只推送变化的像素");
+  check(display.isAnimationPlaying(), "循环动画持续播放");
+  display.stopAnimation();
+}
+
+static void runEncodedImages(BufferMode mode) {
+  printf("\n== 编码图片 %s ==\n", modeName(mode));
+
+  // 参考画面用缓冲模式绘制（直接模式的原始图片不做裁剪）
+  DisplayManager reference;
+  reference.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  reference.clear(ST77XX_BLACK);
+  reference.drawImage(heartImage, 20, 20);
+  reference.drawImage(smileImage, 100, 100);
+  reference.drawImage(smileImage, -10, 225);  // 左下角裁剪
+
+  RGB565Frame heart(heartImage.data,
+                    heartImage.data + heartImage.width * heartImage.height);
+  RGB565Frame smile(smileImage.data,
+                    smileImage.data + smileImage.width * smileImage.height);
+
+  static const ImageEncoding encodings[] = {IMAGE_RGB565, IMAGE_INDEXED2,
+                                            IMAGE_INDEXED4, IMAGE_INDEXED8,
+                                            IMAGE_RLE};
+  int mismatched = 0;
+  for (size_t e = 0; e < sizeof(encodings) / sizeof(encodings[0]); e++) {
+    EncodedAsset heartAsset, smileAsset;
+    if (!encodeImage(heart, heartImage.width, heartImage.height, encodings[e],
+                     heartAsset) ||
+        !encodeImage(smile, smileImage.width, smileImage.height, encodings[e],
+                     smileAsset)) {
+      printf("  %s: 颜色数超过调色板容量，跳过\n", encodingName(encodings[e]));
+      continue;
+    }
+    EncodedImage heartEncoded = heartAsset.view();
+    EncodedImage smileEncoded = smileAsset.view();
+
+    DisplayManager display;
+    display.begin(mode, SPI_FREQUENCY_FAST);
+    display.clear(ST77XX_BLACK);
+    display.drawImage(heartEncoded, 20, 20);
+    display.drawImage(smileEncoded, 100, 100);
+    display.drawImage(smileEncoded, -10, 225);
+
+    check(ImageDecoder::dataSize(smileEncoded) == smileAsset.data.size(),
+          "dataSize 与编码数据长度一致");
+    printf("  %-15s 笑脸 %u 字节（原始 %u 字节）\n", encodingName(encodings[e]),
+           smileAsset.totalBytes(), smileImage.width * smileImage.height * 2);
+    if (comparePanels(display.getTFT(), reference.getTFT()) != 0) mismatched++;
+  }
+  check(mismatched == 0, "各编码格式绘制结果与原始图片一致（含裁剪）");
+
+  EncodedAsset best = encodeImageAuto(smile, smileImage.width, smileImage.height);
+  check(best.totalBytes() < (uint32_t)smileImage.width * smileImage.height,
+        "自动选择的格式小于原始数据的一半");
+}
+
+// 条带模式：按显示列表逐条带重放，输出与单缓冲逐像素相同
+static void runStripMode() {
+  printf("\n== 条带模式 STRIP ==\n");
+
+  DisplayManager single;
+  single.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  DisplayManager strip;
+  strip.begin(BUFFER_MODE_STRIP, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = strip.getTFT();
+
+  single.clear(ST77XX_BLACK);
+  strip.clear(ST77XX_BLACK);
+  tft->resetStats();
+  drawImageScene(single);
+  drawImageScene(strip);
+  printSpiStats("STRIP 图片场景", tft->getStats());
+  check(comparePanels(single.getTFT(), tft) == 0, "图片场景与单缓冲像素一致");
+
+  single.clear(ST77XX_BLACK);
+  strip.clear(ST77XX_BLACK);
+  tft->resetStats();
+  drawShapeScene(single);
+  drawShapeScene(strip);
+  printSpiStats("STRIP 文字图形", tft->getStats());
+  check(comparePanels(single.getTFT(), tft) == 0, "文字图形场景与单缓冲像素一致");
+
+  // 自动刷新：每次调用只重绘它覆盖的条带，叠加顺序保持不变
+  DisplayManager* displays[] = {&single, &strip};
+  for (int d = 0; d < 2; d++) {
+    DisplayManager& display = *displays[d];
+    display.clear(ST77XX_BLUE);
+    display.fillRect(20, 30, 120, 60, ST77XX_GREEN);
+    display.drawText("over the fill", 24, 50, ST77XX_WHITE, 2);
+    display.fillCircle(120, 70, 20, ST77XX_RED);
+    display.drawLine(0, 0, 239, 120, ST77XX_YELLOW);
+    display.fillRect(40, 40, 30, 10, ST77XX_BLACK);
+  }
+  check(comparePanels(single.getTFT(), tft) == 0, "自动刷新的叠加结果与单缓冲一致");
+
+  // 反复重绘同一区域（时钟）：被覆盖的命令被丢弃，列表不增长
+  tft->resetStats();
+  char digits[8];
+  for (int i = 0; i < 200; i++) {
+    snprintf(digits, sizeof(digits), "%02d:%02d", i / 60, i % 60);
+    strip.fillRect(60, 200, 120, 24, ST77XX_BLACK);
+    strip.drawText(digits, 60, 200, ST77XX_WHITE, 3);
+  }
+  uint8_t commands = strip.getDisplayList()->getCount();
+  printSpiStats("STRIP 时钟 200 次", tft->getStats());
+  printf("  显示列表 %u 条命令，丢弃 %lu 条\n", commands,
+         (unsigned long)strip.getDisplayList()->getDroppedCount());
+  check(commands < 12 && strip.getDisplayList()->getDroppedCount() == 0,
+        "反复重绘不会让显示列表增长");
+  check(tft->getStats().pixels <= 200u * 2 * 120 * 24,
+        "每次只推送变化的范围");
+
+  // 编码图片按条带重新解码
+  RGB565Frame smile(smileImage.data,
+                    smileImage.data + smileImage.width * smileImage.height);
+  EncodedAsset asset;
+  encodeImage(smile, smileImage.width, smileImage.height, IMAGE_RLE, asset);
+  EncodedImage encoded = asset.view();
+  single.clear(ST77XX_BLACK);
+  strip.clear(ST77XX_BLACK);
+  single.drawImage(encoded, 30, 15);
+  strip.drawImage(encoded, 30, 15);
+  check(comparePanels(single.getTFT(), tft) == 0, "RLE 图片跨条带绘制与单缓冲一致");
+
+  size_t singleBytes = single.getBufferMemoryUsage();
+  size_t bandBytes = strip.getFrameBuffer()->getMemoryUsage();
+  size_t stripBytes = strip.getBufferMemoryUsage();
+  printf("  内存：SINGLE %u B，STRIP 条带 %u B + 显示列表 %u B\n",
+         (unsigned)singleBytes, (unsigned)bandBytes,
+         (unsigned)(stripBytes - bandBytes));
+  check(bandBytes * 10 <= singleBytes, "条带缓冲为单缓冲的 1/10");
+  check(stripBytes * 100 < singleBytes * 15, "条带 + 显示列表少于单缓冲的 15%");
+}
+
+// 保留模式界面：属性变化只重绘对应控件
+static void runWidgetScreen(BufferMode mode) {
+  printf("\n== 保留模式界面 %s ==\n", modeName(mode));
+
+  DisplayManager display;
+  display.begin(mode, SPI_FREQUENCY_FAST);
+  Adafruit_ST7789* tft = display.getTFT();
+
+  // 时钟：进入时整屏绘制，之后每秒只重绘时间与运行时间
+  ClockDisplay clock(&display);
+  clock.setTime(12, 34, 56);
+  tft->resetStats();
+  clock.show();
+  SpiStats full = tft->getStats();
+  printSpiStats("时钟整屏 show()", full);
+
+  tft->resetStats();
+  const int ticks = 10;
+  for (int i = 0; i < ticks; i++) {
+    delay(1000);
+    clock.update();
+    clock.refresh();
+  }
+  SpiStats partial = tft->getStats();
+  printSpiStats("时钟 10 次 refresh()", partial);
+  printf("  每秒 %llu 字节（整屏重绘 %llu 字节）\n",
+         (unsigned long long)(partial.totalBytes() / ticks),
+         (unsigned long long)full.totalBytes());
+  check(partial.totalBytes() / ticks * 10 < full.totalBytes(),
+        "每秒刷新的字节数少于整屏重绘的 1/10");
+
+  // 七段数字：只有秒的个位变化时只重绘一个字符位置
+  SegmentDigits digits(&display);
+  digits.setStyle(93, ST77XX_WHITE, ST77XX_BLACK);
+  check(digits.draw("12:34:59") == 8, "首次绘制全部 8 个位置");
+  tft->resetStats();
+  check(digits.draw("12:35:00") == 3, "进位时只重绘变化的 3 个数字");
+  check(digits.draw("12:35:01") == 1, "秒的个位变化时只重绘 1 个数字");
+  printSpiStats("七段数字进位 + 个位变化", tft->getStats());
+  check(digits.draw("12:35:01") == 0, "时间不变时不重绘");
+  check(digits.draw("9:05") == 4, "布局变化时全部重绘");
+  clock.show();
+
+  DisplayManager reference;
+  reference.begin(mode, SPI_FREQUENCY_FAST);
+  ClockDisplay referenceClock(&reference);
+  referenceClock.setTime(12, 35, 6);
+  referenceClock.show();
+  check(comparePanels(tft, reference.getTFT()) == 0,
+        "增量刷新后的画面与整屏绘制相同");
+
+  // 进度条、隐藏控件、重叠控件
+  WidgetScreen screen(&display);
+  screen.begin(ST77XX_BLACK);
+  screen.addCenteredLabel("OTA Updating", 40, ST77XX_YELLOW, 2);
+  uint8_t percent = screen.addCenteredLabel("0%", 80, ST77XX_WHITE, 3);
+  uint8_t bar = screen.addProgressBar(20, 120, 200, 20, ST77XX_GREEN);
+  uint8_t hint = screen.addCenteredLabel("Please wait...", 160, ST77XX_CYAN, 1);
+  screen.addRect(100, 150, 40, 30, ST77XX_RED, true);  // 与提示文字重叠
+  screen.render();
+  check(!screen.isDirty() && !screen.render(), "没有变化时不重绘");
+
+  tft->resetStats();
+  screen.setText(percent, "57%");
+  screen.setValue(bar, 57);
+  screen.setVisible(hint, false);
+  screen.render();
+  printSpiStats("进度 57% + 隐藏提示", tft->getStats());
+
+  reference.clear(ST77XX_BLACK);
+  reference.drawCenteredText("OTA Updating", 40, ST77XX_YELLOW, 2);
+  reference.drawCenteredText("57%", 80, ST77XX_WHITE, 3);
+  reference.drawRect(20, 120, 200, 20, ST77XX_WHITE);
+  reference.fillRect(22, 122, 196 * 57 / 100, 16, ST77XX_GREEN);
+  reference.fillRect(100, 150, 40, 30, ST77XX_RED);
+  check(comparePanels(tft, reference.getTFT()) == 0,
+        "进度条、文字与隐藏控件的局部重绘结果正确");
+}
+
+// 按扫描线位置逐行模拟一次推送：任何一次经过区域的扫描同时看到新旧内容即为撕裂
+// （扫描位置只读到整行，两边各留一行容差）
+static bool pushTears(FramePacer& pacer, int16_t top, int16_t bottom,
+                      uint32_t pushMicros) {
+  double period = pacer.getRefreshMicros();
+  double lineMicros = period / FramePacer::TOTAL_LINES;
+  double rowMicros = (double)pushMicros / (bottom - top);
+  double phase = (pacer.getScanLine() + FramePacer::PORCH_LINES + 0.5) * lineMicros;
+
+  for (int pass = 0; pass < 4; pass++) {
+    int seenOld = 0, seenNew = 0;
+    for (int16_t r = top; r < bottom; r++) {
+      double scan = (FramePacer::PORCH_LINES + r) * lineMicros + pass * period - phase;
+      if (scan < (r - top) * rowMicros) {
+        seenOld++;
+      } else if (scan >= (r - top + 1) * rowMicros) {
+        seenNew++;
+      }
+    }
+    if (seenOld > 1 && seenNew > 1) return true;
+  }
+  return false;
+}
+
+static void runFramePacing() {
+  printf("\n== 帧节奏与防撕裂 ==\n");
+
+  FramePacer pacer;
+  pacer.begin(nullptr);
+  check(pacer.isReady() && !pacer.hasTE(), "没有 TE 信号时使用模拟刷新时钟");
+
+  // 整屏 240 行：80 MHz 推送（11.5 ms）快于扫描，从消隐开始写即可；40 MHz（23 ms）
+  // 慢于扫描，但紧跟扫描线开始写时下一次扫描追不上写入位置；20 MHz 无法避免
+  struct Case {
+    const char* name;
+    int16_t top, bottom;
+    uint32_t spiHz;
+    bool avoidable;
+  };
+  const Case cases[] = {
+    {"整屏 @80MHz", 0, 240, SPI_FREQUENCY_FAST, true},
+    {"整屏 @40MHz", 0, 240, SPI_FREQUENCY_DEFAULT, true},
+    {"整屏 @20MHz", 0, 240, SPI_FREQUENCY_DEFAULT / 2, false},
+    {"64 行 @40MHz", 88, 152, SPI_FREQUENCY_DEFAULT, true},
+    {"底部 24 行 @40MHz", 216, 240, SPI_FREQUENCY_DEFAULT, true},
+  };
+  for (const Case& c : cases) {
+    uint32_t pushMicros =
+        (uint32_t)((uint64_t)SCREEN_WIDTH * (c.bottom - c.top) * 16 * 1000000 / c.spiHz);
+    pacer.resetStats();
+    int tears = 0;
+    uint32_t maxWait = 0;
+    for (int i = 0; i < 50; i++) {
+      delayMicroseconds(random(0, 20000));  // 任意相位
+      maxWait = max(maxWait, pacer.waitTearFree(c.top, c.bottom, pushMicros));
+      if (pushTears(pacer, c.top, c.bottom, pushMicros)) tears++;
+    }
+    const FramePacingStats& stats = pacer.getStats();
+    printf("  %-20s 推送 %5u us  最长等待 %5u us  无法避免 %2u/50  模拟撕裂 %d\n",
+           c.name, (unsigned)pushMicros, (unsigned)maxWait,
+           (unsigned)stats.tornFlushes, tears);
+    check(maxWait <= pacer.getRefreshMicros(), "等待不超过一个刷新周期");
+    if (c.avoidable) {
+      check(stats.tornFlushes == 0 && tears == 0, "可以避开扫描线的推送都不撕裂");
+    } else {
+      check(stats.tornFlushes == 50, "比刷新周期长的推送报告为无法避免");
+    }
+  }
+
+  // 固定步长调度：每 10 帧有一帧处理 45 ms，超过一个 20 ms 间隔
+  pacer.resetStats();
+  pacer.resetSchedule();
+  unsigned long start = micros();
+  const int frames = 50;
+  for (int f = 0; f < frames; f++) {
+    while (!pacer.frameDue(20000)) delayMicroseconds(100);
+    delay(f % 10 == 9 ? 45 : 5);
+  }
+  const FramePacingStats& stats = pacer.getStats();
+  unsigned long elapsed = micros() - start;
+  printf("  50 帧 @20ms：错过 %u 个时刻，延迟 平均 %u / 最大 %u us，抖动 平均 %u / 最大 %u us\n",
+         (unsigned)stats.missedDeadlines, (unsigned)stats.averageLateMicros(),
+         (unsigned)stats.maxLateMicros, (unsigned)stats.averageJitterMicros(),
+         (unsigned)stats.maxJitterMicros);
+  check(stats.frames == frames && stats.missedDeadlines == 4,
+        "超时的帧各跳过一个时刻");
+  check(stats.maxLateMicros < 20000 && stats.maxJitterMicros >= 5000,
+        "迟到与抖动被记录");
+  // 时间线不漂移：第一帧在重置后一个间隔，最后一帧开始于第 (帧数 + 跳过数) 个时刻附近
+  unsigned long expected = (frames + stats.missedDeadlines) * 20000UL;
+  check(elapsed >= expected && elapsed < expected + 45000 + 20000,
+        "截止时刻按间隔累加，不随处理延迟漂移");
+
+  // 动画接入：整屏帧在 80 MHz 下同步推送不撕裂
+  static uint16_t frameA[SCREEN_WIDTH * SCREEN_HEIGHT];
+  static uint16_t frameB[SCREEN_WIDTH * SCREEN_HEIGHT];
+  for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+    frameA[i] = ST77XX_BLUE;
+    frameB[i] = (i / SCREEN_WIDTH) % 2 ? ST77XX_YELLOW : ST77XX_RED;
+  }
+  AnimationFrame animFrames[] = {
+    {frameA, SCREEN_WIDTH, SCREEN_HEIGHT, 50},
+    {frameB, SCREEN_WIDTH, SCREEN_HEIGHT, 50},
+  };
+  Animation anim = {animFrames, 2, 0, 0, true, false};
+
+  DisplayManager display;
+  display.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  display.setFramePacing(true);
+  display.getFramePacer()->resetStats();
+  display.playAnimation(&anim);
+  for (int i = 0; i < 1000; i++) {
+    delay(1);
+    display.updateAnimation();
+  }
+  const FramePacingStats& animStats = display.getFramePacer()->getStats();
+  printf("  动画 1 s：%u 帧，同步推送 %u 次，等待共 %llu us\n",
+         (unsigned)animStats.frames, (unsigned)animStats.syncedFlushes,
+         (unsigned long long)animStats.syncWaitMicros);
+  check(animStats.frames >= 15 && animStats.syncedFlushes == animStats.frames,
+        "每一帧都在推送前与扫描同步");
+  check(animStats.tornFlushes == 0, "80 MHz 整屏动画不撕裂");
+  // playAnimation 不绘制第 0 帧，第一次更新显示第 1 帧
+  const uint16_t* last = animStats.frames % 2 ? frameB : frameA;
+  int mismatched = 0;
+  for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+    if (display.getTFT()->getGRAMPixel(i % SCREEN_WIDTH, i / SCREEN_WIDTH) != last[i]) {
+      mismatched++;
+    }
+  }
+  check(mismatched == 0, "面板显示最后一帧");
+}
+
+// 调度器测试任务：运行时按 context 指定的微秒数推进时钟，并记录运行顺序
+struct TestTask {
+  char tag;
+  uint32_t runMicros;
+  uint32_t longRunMicros;  // 每 longEvery 次运行一次长任务
+  uint32_t longEvery;
+  uint32_t count;
+};
+static std::string taskOrder;
+
+static void runTestTask(void* context) {
+  TestTask* task = (TestTask*)context;
+  task->count++;
+  if (taskOrder.size() < 16) taskOrder += task->tag;
+  bool isLong = task->longEvery > 0 && task->count % task->longEvery == 0;
+  delayMicroseconds(isLong ? task->longRunMicros : task->runMicros);
+}
+
+static uint32_t idleCalls = 0;
+static uint32_t maxIdleSleep = 0;
+static void countingIdle(uint32_t sleepMicros) {
+  idleCalls++;
+  maxIdleSleep = max(maxIdleSleep, sleepMicros);
+  delayMicroseconds(sleepMicros);
+}
+
+static void runTaskScheduler() {
+  printf("\n== 协作式任务调度 ==\n");
+
+  // 5 ms 高优先级（动画）、50 ms 低优先级（演示切换）、100 ms 中优先级（偶尔 12 ms 的重绘）
+  TestTask fast = {'F', 1000, 0, 0, 0};
+  TestTask slow = {'S', 2000, 0, 0, 0};
+  TestTask heavy = {'H', 1000, 12000, 3, 0};
+  TaskScheduler scheduler;
+  scheduler.setIdleHook(countingIdle);
+  uint8_t slowId = scheduler.addTask("slow", runTestTask, &slow, 50000, 0);
+  uint8_t fastId = scheduler.addTask("fast", runTestTask, &fast, 5000, 2);
+  uint8_t heavyId = scheduler.addTask("heavy", runTestTask, &heavy, 100000, 1);
+  taskOrder.clear();
+  idleCalls = 0;
+  maxIdleSleep = 0;
+
+  unsigned long start = micros();
+  uint32_t loops = 0;
+  while (micros() - start < 1000000) {
+    scheduler.run();
+    loops++;
+  }
+  Serial.setEnabled(true);
+  scheduler.printStats();
+  Serial.setEnabled(false);
+
+  const TaskStats& fastStats = scheduler.getStats(fastId);
+  const TaskStats& slowStats = scheduler.getStats(slowId);
+  const TaskStats& heavyStats = scheduler.getStats(heavyId);
+  printf("  loop 调用 %u 次，空闲钩子 %u 次，空闲 %llu us\n", (unsigned)loops,
+         (unsigned)idleCalls, (unsigned long long)scheduler.getIdleMicros());
+
+  check(taskOrder.compare(0, 3, "FHS") == 0, "同时释放时按优先级运行");
+  check(fastStats.runs + fastStats.skipped >= 199 && fastStats.runs + fastStats.skipped <= 201,
+        "固定速率：1 s 内 200 次释放（运行 + 跳过）");
+  check(slowStats.runs >= 20 && slowStats.runs <= 21 && heavyStats.runs >= 10 &&
+            heavyStats.runs <= 11,
+        "低频任务按周期运行");
+  check(fastStats.overruns > 0 && fastStats.maxLateMicros >= 5000 &&
+            fastStats.skipped > 0,
+        "长任务阻塞期间的超时与跳过被记录");
+  check(heavyStats.overruns == 0 && heavyStats.maxRunMicros >= 12000,
+        "运行时间统计包含长任务");
+  check(maxIdleSleep <= 5000 && idleCalls < 400 && loops < 400,
+        "空闲时睡到下一次释放，不空转");
+  uint64_t busy = fastStats.totalRunMicros + slowStats.totalRunMicros +
+                  heavyStats.totalRunMicros;
+  check(busy + scheduler.getIdleMicros() > 990000, "运行 + 空闲覆盖全部时间");
+
+  // 停用的任务不运行，重新启用后从当前时刻释放
+  scheduler.resetStats();
+  scheduler.setEnabled(fastId, false);
+  for (int i = 0; i < 20; i++) scheduler.run();
+  check(scheduler.getStats(fastId).runs == 0, "停用的任务不运行");
+  scheduler.setEnabled(heavyId, false);
+  scheduler.setEnabled(slowId, false);
+  scheduler.setEnabled(fastId, true);
+  taskOrder.clear();
+  scheduler.run();
+  printf("  重新启用后一次 run()：%s\n", taskOrder.c_str());
+  check(taskOrder == "F" && scheduler.getStats(fastId).skipped == 0,
+        "重新启用后立即释放，不补跑停用期间的周期");
+}
+
+// 流水线场景的一帧：移动的方块、帧号文字、外框
+static const int PIPELINE_FRAMES = 60;
+static const uint32_t PIPELINE_LOGIC_MICROS = 4000;  // 模拟每帧的应用逻辑
+
+static void drawPipelineFrame(DisplayManager& display, int frame) {
+  char label[16];
+  snprintf(label, sizeof(label), "Frame %d", frame);
+  display.fillRect(20, 40, 200, 120, ST77XX_BLACK);
+  display.fillRect(20 + (frame * 3) % 160, 60, 40, 40, ST77XX_GREEN);
+  display.drawRect(20, 40, 200, 120, ST77XX_WHITE);
+  display.drawText(label, 24, 140, ST77XX_YELLOW, 2);
+}
+
+static void pushPipelineFrame(RenderPipeline& pipeline, int frame) {
+  char label[16];
+  snprintf(label, sizeof(label), "Frame %d", frame);
+  pipeline.fillRect(20, 40, 200, 120, ST77XX_BLACK);
+  pipeline.fillRect(20 + (frame * 3) % 160, 60, 40, 40, ST77XX_GREEN);
+  pipeline.drawRect(20, 40, 200, 120, ST77XX_WHITE);
+  pipeline.drawText(label, 24, 140, ST77XX_YELLOW, 2);
+  pipeline.submitFrame();
+}
+
+static void runRenderPipeline() {
+  printf("\n== 双核渲染流水线 ==\n");
+
+  // 串行：逻辑、绘制、刷新依次在同一个线程
+  DisplayManager serial;
+  serial.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  serial.setAutoFlush(false);
+  serial.clear(ST77XX_BLACK);
+  serial.flush();
+  unsigned long start = micros();
+  for (int frame = 0; frame < PIPELINE_FRAMES; frame++) {
+    delayMicroseconds(PIPELINE_LOGIC_MICROS);
+    drawPipelineFrame(serial, frame);
+    serial.flush();
+  }
+  unsigned long serialMicros = micros() - start;
+
+  // 流水线：主线程只做逻辑和记录命令，渲染线程光栅化并刷新上一帧
+  DisplayManager piped;
+  piped.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  piped.clear(ST77XX_BLACK);
+  RenderPipeline pipeline(&piped);
+  check(pipeline.begin(), "渲染任务启动");
+  start = micros();
+  for (int frame = 0; frame < PIPELINE_FRAMES; frame++) {
+    delayMicroseconds(PIPELINE_LOGIC_MICROS);
+    pushPipelineFrame(pipeline, frame);
+  }
+  pipeline.waitIdle();
+  unsigned long pipedMicros = micros() - start;
+  RenderPipelineStats stats = pipeline.getStats();
+  pipeline.end();
+
+  printf("  串行 %d 帧 %lu us（%.1f fps），流水线 %lu us（%.1f fps）\n",
+         PIPELINE_FRAMES, serialMicros, PIPELINE_FRAMES * 1e6 / serialMicros,
+         pipedMicros, PIPELINE_FRAMES * 1e6 / pipedMicros);
+  printf("  命令 %u 条，渲染 %llu us，提交到刷新完成 平均 %u us / 最大 %u us，"
+         "生产端等待 %u 次\n",
+         (unsigned)stats.commands, (unsigned long long)stats.renderMicros,
+         (unsigned)stats.averageLatencyMicros(),
+         (unsigned)stats.maxLatencyMicros, (unsigned)stats.producerStalls);
+
+  check(stats.framesRendered == PIPELINE_FRAMES &&
+            stats.commands == PIPELINE_FRAMES * 4,
+        "所有提交的帧与命令都被渲染");
+  check(pipedMicros * 10 < serialMicros * 7,
+        "逻辑与渲染重叠：总时间低于串行的 70%");
+  check(stats.maxLatencyMicros < 3 * serialMicros / PIPELINE_FRAMES,
+        "提交到刷新完成的延迟不超过三帧串行时间");
+  check(comparePanels(serial.getTFT(), piped.getTFT()) == 0,
+        "流水线绘制结果与串行一致");
+  check(!pipeline.isRunning() && piped.getAutoFlush(),
+        "停止后恢复自动刷新设置");
+
+  // 命令环满：生产端等待渲染任务，不丢命令
+  piped.clear(ST77XX_BLACK);
+  pipeline.begin();
+  for (int i = 0; i < 3 * RenderPipeline::RING_SIZE; i++) {
+    pipeline.fillRect((i * 7) % 200, (i * 11) % 200, 40, 40, (uint16_t)(i * 997));
+  }
+  pipeline.submitFrame();
+  pipeline.waitIdle();
+  stats = pipeline.getStats();
+  pipeline.end();
+
+  serial.setAutoFlush(true);
+  serial.clear(ST77XX_BLACK);
+  for (int i = 0; i < 3 * RenderPipeline::RING_SIZE; i++) {
+    serial.fillRect((i * 7) % 200, (i * 11) % 200, 40, 40, (uint16_t)(i * 997));
+  }
+  serial.flush();
+  printf("  %d 条命令一次提交：生产端等待 %u 次 / %llu us\n",
+         3 * RenderPipeline::RING_SIZE, (unsigned)stats.producerStalls,
+         (unsigned long long)stats.stallMicros);
+  check(stats.producerStalls > 0 && stats.framesRendered == 1 &&
+            comparePanels(serial.getTFT(), piped.getTFT()) == 0,
+        "命令环满时生产端等待，命令不丢失");
+}
+
+// 解析器回调：按收到的顺序累计操作码与载荷的校验和
+static uint32_t frameCount = 0;
+static uint32_t frameDigest = 0;
+
+static void countFrame(uint8_t opcode, const uint8_t* payload, uint16_t length) {
+  frameCount++;
+  frameDigest = frameDigest * 31 + opcode;
+  frameDigest = frameDigest * 31 + length;
+  frameDigest = frameDigest * 31 + FrameParser::crc16(payload, length);
+}
+
+// 第 i 个测试帧：操作码与载荷由 i 决定
+static size_t makeTestFrame(uint32_t i, uint8_t* out, size_t outSize,
+                            uint32_t* digest) {
+  uint8_t payload[64];
+  uint16_t length = (i * 7) % sizeof(payload);
+  for (uint16_t k = 0; k < length; k++) payload[k] = (uint8_t)(i + k * 13);
+  uint8_t opcode = 1 + i % FRAME_OP_TASKS;
+  *digest = *digest * 31 + opcode;
+  *digest = *digest * 31 + length;
+  *digest = *digest * 31 + FrameParser::crc16(payload, length);
+  return FrameParser::encode(opcode, payload, length, out, outSize);
+}
+
+static uint8_t echoHandler(void* context, const uint8_t* payload,
+                           uint16_t length, uint8_t* reply,
+                           uint16_t* replyLength) {
+  (*(int*)context)++;
+  memcpy(reply, payload, length);
+  *replyLength = length;
+  return FRAME_STATUS_OK;
+}
+
+static void runFrameProtocol() {
+  printf("\n== 二进制指令帧 ==\n");
+
+  // 编码与 CRC：CRC-16/CCITT-FALSE 标准校验值
+  const uint8_t check123[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  check(FrameParser::crc16(check123, sizeof(check123)) == 0x29B1,
+        "CRC-16/CCITT 校验值");
+  uint8_t small[8];
+  check(FrameParser::encode(FRAME_OP_TEXT, check123, sizeof(check123), small,
+                            sizeof(small)) == 0,
+        "输出缓冲不足时编码失败");
+
+  // 吞吐：20000 个帧连成字节流，按 1~244 字节的随机写入切分
+  const uint32_t FRAMES = 20000;
+  std::vector<uint8_t> stream;
+  uint32_t expectedDigest = 0;
+  uint8_t frame[FrameParser::MAX_FRAME];
+  for (uint32_t i = 0; i < FRAMES; i++) {
+    size_t length = makeTestFrame(i, frame, sizeof(frame), &expectedDigest);
+    stream.insert(stream.end(), frame, frame + length);
+  }
+
+  FrameParser parser;
+  parser.setCallback(countFrame);
+  frameCount = 0;
+  frameDigest = 0;
+  srand(21);
+  unsigned long start = micros();
+  for (size_t pos = 0; pos < stream.size();) {
+    size_t chunk = min(stream.size() - pos, (size_t)(1 + rand() % 244));
+    parser.feed(&stream[pos], chunk);
+    pos += chunk;
+  }
+  unsigned long elapsed = max(micros() - start, 1UL);
+  printf("  %u 帧 / %u 字节，解析 %lu us：%.0f 帧/s，%.1f MB/s\n",
+         (unsigned)FRAMES, (unsigned)stream.size(), elapsed,
+         FRAMES * 1e6 / elapsed, stream.size() / (double)elapsed);
+  check(frameCount == FRAMES && frameDigest == expectedDigest &&
+            !parser.isReceiving(),
+        "任意切分的字节流：所有帧按顺序完整收到");
+  check(FRAMES * 1e6 / elapsed > 10000, "解析速度超过每秒一万帧");
+
+  // 模糊测试：帧之间插入随机坏数据，另有一部分帧被翻转一位
+  parser.reset();
+  parser.resetStats();
+  frameCount = 0;
+  frameDigest = 0;
+  expectedDigest = 0;
+  uint32_t intact = 0;
+  uint32_t corrupted = 0;
+  stream.clear();
+  srand(2024);
+  for (uint32_t i = 0; i < FRAMES; i++) {
+    size_t garbage = rand() % 24;
+    for (size_t k = 0; k < garbage; k++) {
+      // 坏数据中帧头字节出现得更频繁，制造假的帧头
+      stream.push_back(rand() % 8 == 0 ? FRAME_MAGIC : (uint8_t)rand());
+    }
+    uint32_t digest = expectedDigest;
+    size_t length = makeTestFrame(i, frame, sizeof(frame), &digest);
+    if (rand() % 10 == 0) {
+      frame[1 + rand() % (length - 1)] ^= (uint8_t)(1 << (rand() % 8));
+      corrupted++;
+    } else {
+      expectedDigest = digest;
+      intact++;
+    }
+    stream.insert(stream.end(), frame, frame + length);
+  }
+  // 结尾补足一个最大帧长度的非帧头字节，让挂起的假帧头全部判定
+  stream.insert(stream.end(), FrameParser::MAX_FRAME, 0x00);
+
+  start = micros();
+  for (size_t pos = 0; pos < stream.size();) {
+    size_t chunk = min(stream.size() - pos, (size_t)(1 + rand() % 244));
+    parser.feed(&stream[pos], chunk);
+    pos += chunk;
+  }
+  elapsed = max(micros() - start, 1UL);
+  const FrameParserStats& stats = parser.getStats();
+  printf("  模糊测试 %u 字节：完整帧 %u / 收到 %u，CRC 错误 %u，长度错误 %u，"
+         "丢弃 %u 字节，%lu us\n",
+         (unsigned)stream.size(), (unsigned)intact, (unsigned)frameCount,
+         (unsigned)stats.crcErrors, (unsigned)stats.lengthErrors,
+         (unsigned)stats.discardedBytes, elapsed);
+  check(frameCount == intact && frameDigest == expectedDigest,
+        "坏数据中的完整帧全部收到，翻转的帧全部拒绝");
+  check(stats.crcErrors >= corrupted && !parser.isReceiving(),
+        "CRC 错误被计数，解析器回到空闲");
+
+  // 分发表：长度范围与未知操作码
+  int calls = 0;
+  const FrameCommand table[] = {
+    {FRAME_OP_PING, 0, 16, echoHandler},
+    {FRAME_OP_SET_TIME, 3, 3, echoHandler}
+  };
+  uint8_t reply[32];
+  uint16_t replyLength = sizeof(reply);
+  const uint8_t hms[] = {12, 34, 56};
+  uint8_t status = FrameParser::dispatch(table, 2, &calls, FRAME_OP_SET_TIME,
+                                         hms, 3, reply, &replyLength);
+  check(status == FRAME_STATUS_OK && calls == 1 && replyLength == 3 &&
+            reply[2] == 56,
+        "分发表按操作码调用处理函数");
+  replyLength = sizeof(reply);
+  status = FrameParser::dispatch(table, 2, &calls, FRAME_OP_SET_TIME, hms, 2,
+                                 reply, &replyLength);
+  check(status == FRAME_STATUS_BAD_LENGTH && calls == 1 && replyLength == 0,
+        "载荷长度不符时不调用处理函数");
+  replyLength = sizeof(reply);
+  status = FrameParser::dispatch(table, 2, &calls, 0x7F, hms, 0, reply,
+                                 &replyLength);
+  check(status == FRAME_STATUS_UNKNOWN && calls == 1, "未知操作码");
+}
+
+// 原来的 String 解析路径（trim、大写副本、substring、回复拼接），用于对比分配次数
+static String legacyHandleCommand(String command) {
+  command.trim();
+  String cmd = command;
+  cmd.toUpperCase();
+  if (cmd.startsWith("TEXT:") || cmd.startsWith("T ") || cmd.startsWith("T:")) {
+    String param = command.substring(cmd.startsWith("TEXT:") ? 5 : 2);
+    param.trim();
+    return "OK:Text displayed " + param;
+  } else if (cmd.startsWith("BRIGHTNESS:") || cmd.startsWith("B ")) {
+    String param = command.substring(command.indexOf(cmd.startsWith("B ") ? ' ' : ':') + 1);
+    param.trim();
+    return "OK:Brightness set to " + String(param.toInt());
+  } else if (cmd.startsWith("SETTIME:") || cmd.startsWith("ST ")) {
+    String param = command.substring(cmd.startsWith("ST ") ? 3 : 8);
+    String hourStr = param.substring(0, 2);
+    String minuteStr = param.substring(3, 5);
+    String secondStr = param.substring(6);
+    return "OK:Time set to " + String(hourStr.toInt()) + ":" +
+           String(minuteStr.toInt()) + ":" + String(secondStr.toInt());
+  } else if (cmd.startsWith("MODE:") || cmd.startsWith("M ")) {
+    String param = command.substring(command.indexOf(cmd.startsWith("M ") ? ' ' : ':') + 1);
+    param.trim();
+    return "OK:Mode set to " + param;
+  }
+  return String("ERROR:Unknown command");
+}
+
+// 新路径：复制到固定指令缓冲（与 BLEManager 相同）、就地解析、回复格式化到 ReplyBuffer
+static const char* tableHandleCommand(const char* text, char* line,
+                                      ReplyBuffer& reply) {
+  size_t length = strlen(text);
+  memcpy(line, text, length + 1);
+  ParsedCommand cmd = TextCommandParser::parse(line, length);
+  switch (cmd.type) {
+    case CMD_SET_TEXT:
+      return reply.format("OK:Text displayed %s", cmd.param);
+    case CMD_SET_BRIGHTNESS:
+      return reply.format("OK:Brightness set to %ld",
+                          TextCommandParser::toNumber(cmd.param, cmd.paramLength));
+    case CMD_SET_TIME:
+      return reply.format("OK:Time set to %ld:%ld:%ld",
+                          TextCommandParser::toNumber(cmd.param, 2),
+                          TextCommandParser::toNumber(cmd.param + 3, 2),
+                          TextCommandParser::toNumber(cmd.param + 6, 2));
+    case CMD_SET_MODE:
+      return reply.format("OK:Mode set to %s", cmd.param);
+    default:
+      return reply.format("ERROR:Unknown command");
+  }
+}
+
+static void runTextCommands() {
+  printf("\n== 表驱动文本指令解析 ==\n");
+
+  struct Expected {
+    const char* text;
+    CommandType type;
+    const char* param;
+  };
+  const Expected cases[] = {
+    {"  TEXT:Hello World \r\n", CMD_SET_TEXT, "Hello World"},
+    {"t   spaced text", CMD_SET_TEXT, "spaced text"},
+    {"text:lower case", CMD_SET_TEXT, "lower case"},
+    {"B 128", CMD_SET_BRIGHTNESS, "128"},
+    {"brightness:7", CMD_SET_BRIGHTNESS, "7"},
+    {"c", CMD_CLEAR_SCREEN, ""},
+    {"CLEAR", CMD_CLEAR_SCREEN, ""},
+    {"M:clock", CMD_SET_MODE, "clock"},
+    {"D2", CMD_SET_MODE, "DEMO2"},
+    {"cl", CMD_SET_MODE, "CLOCK"},
+    {"get_status", CMD_GET_STATUS, ""},
+    {"ST 12:34:56", CMD_SET_TIME, "12:34:56"},
+    {"SETTIME:123456", CMD_SET_TIME, "123456"},
+    {"sd 2025-10-31", CMD_SET_DATE, "2025-10-31"},
+    {"OTA http://host/fw.bin", CMD_OTA_UPDATE, "http://host/fw.bin"},
+    {"BENCH:3", CMD_BENCHMARK, "3"},
+    {"bench", CMD_BENCHMARK, ""},
+    {"tasks", CMD_TASKS, ""},
+    {"T", CMD_UNKNOWN, ""},
+    {"TEXT:", CMD_SET_TEXT, ""},
+    {"CLEARX", CMD_UNKNOWN, ""},
+    {"   ", CMD_UNKNOWN, ""}
+  };
+  const size_t caseCount = sizeof(cases) / sizeof(cases[0]);
+
+  char line[TextCommandParser::MAX_COMMAND_LENGTH + 1];
+  size_t matched = 0;
+  for (size_t i = 0; i < caseCount; i++) {
+    size_t length = strlen(cases[i].text);
+    memcpy(line, cases[i].text, length + 1);
+    ParsedCommand cmd = TextCommandParser::parse(line, length);
+    if (cmd.type == cases[i].type && strcmp(cmd.param, cases[i].param) == 0 &&
+        cmd.paramLength == strlen(cases[i].param)) {
+      matched++;
+    } else {
+      printf("  不匹配: \"%s\" -> %d \"%s\"\n", cases[i].text, cmd.type, cmd.param);
+    }
+  }
+  check(matched == caseCount, "前缀 / 别名 / 大小写 / 空白按指令表解析");
+  check(TextCommandParser::toNumber("-42x", 4) == -42 &&
+            TextCommandParser::toNumber("12", 1) == 1,
+        "数字解析与 String::toInt 一致且只读给定长度");
+
+  ReplyBuffer reply;
+  reply.format("OK:%d", 1);
+  for (int i = 0; i < 100; i++) reply.append("0123456789");
+  check(reply.isTruncated() && reply.length() == ReplyBuffer::CAPACITY - 1,
+        "回复超出容量时截断");
+
+  // 每条指令的堆分配：原 String 路径与表驱动路径
+  const char* workload[] = {
+    "TEXT:Hello from the phone app", "B 128", "SETTIME:12:34:56",
+    "MODE:CLOCK", "T Scrolling message text", "brightness:200"
+  };
+  const size_t workloadCount = sizeof(workload) / sizeof(workload[0]);
+  const int ROUNDS = 20000;
+  uint64_t commands = (uint64_t)ROUNDS * workloadCount;
+
+  size_t checksum = 0;
+  uint64_t allocationsBefore = heapAllocations.load();
+  unsigned long start = micros();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (size_t i = 0; i < workloadCount; i++) {
+      checksum += legacyHandleCommand(workload[i]).length();
+    }
+  }
+  unsigned long legacyMicros = max(micros() - start, 1UL);
+  uint64_t legacyAllocations = heapAllocations.load() - allocationsBefore;
+
+  size_t tableChecksum = 0;
+  allocationsBefore = heapAllocations.load();
+  start = micros();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (size_t i = 0; i < workloadCount; i++) {
+      tableChecksum += strlen(tableHandleCommand(workload[i], line, reply));
+    }
+  }
+  unsigned long tableMicros = max(micros() - start, 1UL);
+  uint64_t tableAllocations = heapAllocations.load() - allocationsBefore;
+
+  printf("  String 路径：%.1f 次分配/指令，%.0f ns/指令\n",
+         legacyAllocations / (double)commands, legacyMicros * 1000.0 / commands);
+  printf("  表驱动路径：%.1f 次分配/指令，%.0f ns/指令\n",
+         tableAllocations / (double)commands, tableMicros * 1000.0 / commands);
+  check(legacyAllocations > 0, "分配计数有效（String 路径有分配）");
+  check(tableAllocations == 0, "表驱动解析与回复格式化不分配内存");
+  check(checksum == tableChecksum, "两条路径的回复长度一致");
+}
+
+// 上传用的测试图片：上部横条纹（RLE 友好）、中部渐变（不可压缩）、下部棋盘格
+static RGB565Frame makeUploadImage(uint16_t w, uint16_t h) {
+  RGB565Frame pixels(w * h);
+  for (uint16_t y = 0; y < h; y++) {
+    for (uint16_t x = 0; x < w; x++) {
+      uint16_t color;
+      if (y < h / 3) {
+        color = (y / 10) % 2 ? ST77XX_BLUE : ST77XX_CYAN;
+      } else if (y < h * 2 / 3) {
+        color = ((x >> 3) << 11) | ((y >> 2) << 5) | (((x + y) >> 4) & 0x1F);
+      } else {
+        color = (x / 20 + y / 20) % 2 ? ST77XX_WHITE : ST77XX_RED;
+      }
+      pixels[y * w + x] = color;
+    }
+  }
+  return pixels;
+}
+
+static BleLinkConfig makeLinkConfig(uint16_t mtu, uint32_t dropEvery) {
+  // 15 ms 连接间隔、每个事件 6 个写入（常见手机的无响应写入节奏）
+  BleLinkConfig config = {mtu, 15000, 6, dropEvery, 8};
+  return config;
+}
+
+static bool uploadAndCompare(BufferMode mode, const BleLinkConfig& config,
+                             int16_t x, int16_t y, uint16_t w, uint16_t h,
+                             ImageEncoding encoding, const char* label) {
+  RGB565Frame pixels = makeUploadImage(w, h);
+  EncodedAsset asset;
+  encodeImage(pixels, w, h, encoding, asset);
+
+  DisplayManager reference;
+  reference.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  reference.clear(ST77XX_BLACK);
+  ImageData image = {&pixels[0], w, h};
+  reference.drawImage(image, x, y);
+
+  DisplayManager display;
+  display.begin(mode, SPI_FREQUENCY_FAST);
+  display.clear(ST77XX_BLACK);
+  ImageReceiver receiver(&display);
+  BleLinkResult result;
+  bool completed = simulateImageUpload(receiver, config, x, y, w, h, encoding,
+                                       asset.data, result);
+  const ImageUploadStats& stats = receiver.getStats();
+  printf("  %-26s MTU %3u  %6u 字节 %4u 帧  写入 %4u（丢 %u，重发 %u）  "
+         "%5.0f ms  %6.1f KB/s  设备端 %5.0f ms\n",
+         label, config.mtu, (unsigned)result.imageBytes, (unsigned)result.chunks,
+         (unsigned)result.writes, (unsigned)result.dropped,
+         (unsigned)result.retransmits, result.elapsedMicros / 1000.0,
+         result.kbps(), stats.lastMicros / 1000.0);
+  return completed && stats.completed == 1 &&
+         comparePanels(display.getTFT(), reference.getTFT()) == 0;
+}
+
+static void runImageUpload() {
+  printf("\n== BLE 图片上传 ==\n");
+
+  BleLinkConfig link = makeLinkConfig(247, 0);
+  check(uploadAndCompare(BUFFER_MODE_SINGLE, link, 0, 0, SCREEN_WIDTH,
+                         SCREEN_HEIGHT, IMAGE_RGB565, "SINGLE RGB565 全屏"),
+        "RGB565 全屏上传后面板与 drawImage 一致");
+  check(uploadAndCompare(BUFFER_MODE_SINGLE, link, 0, 0, SCREEN_WIDTH,
+                         SCREEN_HEIGHT, IMAGE_RLE, "SINGLE RLE 全屏"),
+        "RLE 数据帧在包中间切开时流式解码正确");
+  check(uploadAndCompare(BUFFER_MODE_DIRECT, link, 20, 30, 100, 80, IMAGE_RLE,
+                         "DIRECT RLE 100x80"),
+        "直接模式逐段写入屏幕");
+  check(uploadAndCompare(BUFFER_MODE_DOUBLE, makeLinkConfig(247, 17), 0, 0,
+                         SCREEN_WIDTH, SCREEN_HEIGHT, IMAGE_RGB565,
+                         "DOUBLE RGB565 丢包 1/17"),
+        "丢包后按期望序号重发，结果完整");
+  check(uploadAndCompare(BUFFER_MODE_SINGLE, makeLinkConfig(23, 0), 0, 0,
+                         SCREEN_WIDTH, SCREEN_HEIGHT, IMAGE_RGB565,
+                         "SINGLE RGB565 默认 MTU"),
+        "默认 MTU 下同样完整（每帧 12 字节）");
+
+  // 速率：大 MTU 明显快于默认 MTU
+  RGB565Frame pixels = makeUploadImage(SCREEN_WIDTH, SCREEN_HEIGHT);
+  EncodedAsset raw;
+  encodeImage(pixels, SCREEN_WIDTH, SCREEN_HEIGHT, IMAGE_RGB565, raw);
+  DisplayManager display;
+  display.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  ImageReceiver receiver(&display);
+  BleLinkResult large, small;
+  simulateImageUpload(receiver, makeLinkConfig(247, 0), 0, 0, SCREEN_WIDTH,
+                      SCREEN_HEIGHT, IMAGE_RGB565, raw.data, large);
+  simulateImageUpload(receiver, makeLinkConfig(23, 0), 0, 0, SCREEN_WIDTH,
+                      SCREEN_HEIGHT, IMAGE_RGB565, raw.data, small);
+  check(large.kbps() > small.kbps() * 10, "MTU 247 的速率超过默认 MTU 的 10 倍");
+  check(large.kbps() > 50, "MTU 247 全屏上传超过 50 KB/s");
+
+  // 拒绝与中止
+  uint8_t reply[16];
+  uint16_t replyLength = sizeof(reply);
+  const uint8_t outside[9] = {200, 0, 0, 0, 64, 0, 64, 0, IMAGE_RGB565};
+  check(receiver.begin(outside, 9, reply, &replyLength) == FRAME_STATUS_BAD_VALUE,
+        "超出屏幕的区域被拒绝");
+  check(receiver.begin(outside, 8, reply, &replyLength) ==
+            FRAME_STATUS_BAD_LENGTH,
+        "IMAGE_BEGIN 载荷不足 9 字节被拒绝");
+  const uint8_t indexed[9] = {0, 0, 0, 0, 8, 0, 8, 0, IMAGE_INDEXED8};
+  check(receiver.begin(indexed, 9, reply, &replyLength) == FRAME_STATUS_BAD_VALUE,
+        "只接受 RGB565 / RLE");
+
+  const uint8_t region[9] = {0, 0, 0, 0, 8, 0, 8, 0, IMAGE_RGB565};
+  receiver.begin(region, 9, reply, &replyLength);
+  check(receiver.isActive() && replyLength == 3 &&
+            reply[0] == ImageReceiver::WINDOW,
+        "IMAGE_BEGIN 回复窗口与每帧字节数");
+  uint8_t chunk[10] = {1, 0};
+  check(receiver.receive(chunk, sizeof(chunk), reply, &replyLength) ==
+                FRAME_STATUS_OUT_OF_ORDER &&
+            reply[0] == 0,
+        "序号跳跃时回复期望的序号");
+  check(receiver.receive(chunk, sizeof(chunk), reply, &replyLength) ==
+            FRAME_STATUS_DEFERRED,
+        "同一缺口只请求一次重传");
+  receiver.end(nullptr, 0, reply, &replyLength);
+  chunk[0] = 0;
+  check(!receiver.isActive() &&
+            receiver.receive(chunk, sizeof(chunk), reply, &replyLength) ==
+                FRAME_STATUS_UNAVAILABLE,
+        "IMAGE_END 中止后数据帧被拒绝");
+
+  uint32_t abortedBefore = receiver.getStats().aborted;
+  receiver.begin(region, 9, reply, &replyLength);
+  receiver.abort();  // BLE 断开
+  check(!receiver.isActive() &&
+            receiver.getStats().aborted == abortedBefore + 1,
+        "BLE 断开时中止进行中的上传");
+
+  DisplayManager strip;
+  strip.begin(BUFFER_MODE_STRIP, SPI_FREQUENCY_FAST);
+  ImageReceiver stripReceiver(&strip);
+  check(stripReceiver.begin(region, 9, reply, &replyLength) ==
+            FRAME_STATUS_UNAVAILABLE,
+        "条带模式不支持上传");
+}
+
+static bool pushText(NotifyQueue& queue, const char* text) {
+  return queue.push((const uint8_t*)text, strlen(text));
+}
+
+static void runNotifyQueue() {
+  printf("\n== BLE 通知队列 ==\n");
+
+  // 合并：指令的 ACK 与回复进入同一个通知
+  NotifyQueue queue;
+  uint8_t packet[512];
+  pushText(queue, "ACK:STATUS");
+  pushText(queue, "OK:Brightness set");
+  size_t n = queue.take(0, packet, 182);
+  check(n == 28 && memcmp(packet, "ACK:STATUS\nOK:Brightness set", n) == 0 &&
+            queue.isEmpty(),
+        "连续的短文本以换行合并进一个通知");
+
+  // 文本与二进制帧不混合，帧之间直接拼接
+  uint8_t frame[16];
+  size_t frameLength = FrameParser::encode(FRAME_OP_PING | FRAME_REPLY_FLAG,
+                                           (const uint8_t*)"\0hi", 3, frame,
+                                           sizeof(frame));
+  pushText(queue, "OK:Text displayed");
+  queue.push(frame, frameLength);
+  queue.push(frame, frameLength);
+  n = queue.take(0, packet, 182);
+  check(n == 17 && packet[0] == 'O', "文本不与随后的二进制帧合并");
+  n = queue.take(0, packet, 182);
+  frameCount = 0;
+  frameDigest = 0;
+  FrameParser parser;
+  parser.setCallback(countFrame);
+  parser.feed(packet, n);
+  check(n == frameLength * 2 && frameCount == 2, "连续的二进制帧拼接后仍可逐帧解析");
+
+  // 分片：超过 MTU 的状态 JSON（默认 MTU 23，每个通知 20 字节）
+  char json[200];
+  int jsonLength = snprintf(json, sizeof(json),
+      "{\"mode\":\"clock\",\"brightness\":200,\"wifi\":\"connected\","
+      "\"ssid\":\"HomeNetwork-5G\",\"ip\":\"192.168.100.123\",\"rssi\":-61,"
+      "\"time\":\"12:34:56\",\"date\":\"2026-10-16\",\"uptime\":123456,"
+      "\"heap\":182344,\"psram\":8123456}");
+  pushText(queue, json);
+  std::string reassembled;
+  uint32_t fragments = 0;
+  bool headersOk = true;
+  bool last = false;
+  for (unsigned long now = 0; !last && now < 1000000; now += 15000) {
+    while (!last && (n = queue.take(now, packet, 20)) > 0) {
+      headersOk = headersOk && packet[0] == NOTIFY_FRAGMENT_MARKER &&
+                  packet[1] == 0 &&
+                  (packet[2] & 0x7F) == fragments && n <= 20;
+      last = (packet[2] & NOTIFY_FRAGMENT_LAST) != 0;
+      reassembled.append((const char*)packet + 3, n - 3);
+      fragments++;
+    }
+  }
+  printf("  %d 字节的状态 JSON：默认 MTU 下分 %u 片（原来截断为 20 字节）\n",
+         jsonLength, (unsigned)fragments);
+  check(headersOk && reassembled == json && queue.isEmpty(),
+        "超过 MTU 的消息分片发送，按分片序号拼回原文");
+
+  // 节奏：每个连接间隔最多 4 个通知
+  NotifyQueue paced;
+  paced.setPacing(15000, 4);
+  uint8_t message[100];
+  memset(message, 'x', sizeof(message));
+  for (int i = 0; i < 10; i++) paced.push(message, sizeof(message));
+  int perInterval[3] = {0, 0, 0};
+  for (int k = 0; k < 3; k++) {
+    while (paced.take(100000 + k * 15000, packet, 182) > 0) perInterval[k]++;
+  }
+  check(perInterval[0] == 4 && perInterval[1] == 4 && perInterval[2] == 2 &&
+            paced.getStats().pacedWaits == 2,
+        "每个连接间隔最多发出 4 个通知，其余留到下个间隔");
+
+  // 队列满：丢弃整条新消息并计数
+  NotifyQueue full;
+  uint32_t accepted = 0;
+  while (full.push(message, sizeof(message))) accepted++;
+  const NotifyQueueStats& fullStats = full.getStats();
+  check(accepted == NotifyQueue::CAPACITY / (sizeof(message) + 2) &&
+            fullStats.droppedMessages == 1 &&
+            fullStats.droppedBytes == sizeof(message) &&
+            fullStats.queuedBytes == accepted * (sizeof(message) + 2),
+        "队列满时丢弃新消息，计入丢弃字节");
+
+  // 50 条文本指令连续到达：原来每条 ACK + 回复各一个通知
+  NotifyQueue burst;
+  ReplyBuffer ack;
+  for (int i = 0; i < 50; i++) {
+    pushText(burst, ack.format("ACK:B:%d", 100 + i));
+    pushText(burst, ack.format("OK:Brightness set to %d", 100 + i));
+  }
+  uint32_t intervals = 0;
+  for (unsigned long now = 0; !burst.isEmpty(); now += 15000) {
+    while (burst.take(now, packet, 182) > 0) {
+    }
+    intervals++;
+  }
+  const NotifyQueueStats& burstStats = burst.getStats();
+  printf("  50 条指令的 100 条回复：%u 个通知（原来 100 个），%u 个连接间隔，"
+         "合并 %u 条，峰值排队 %u 字节\n",
+         (unsigned)burstStats.notifications, (unsigned)intervals,
+         (unsigned)burstStats.coalescedMessages,
+         (unsigned)burstStats.peakQueuedBytes);
+  check(burstStats.notifications * 5 < burstStats.messages &&
+            burstStats.droppedMessages == 0,
+        "回复合并后通知数不到消息数的五分之一");
+}
+
+static CommandPushResult pushWrite(CommandQueue& queue, const uint8_t* data,
+                                   size_t length, uint8_t* kind = nullptr,
+                                   uint8_t* frameOpcode = nullptr) {
+  uint8_t writeKind;
+  uint8_t writeOpcode;
+  CommandPushResult result = queue.push(data, length, &writeKind, &writeOpcode);
+  if (kind != nullptr) *kind = writeKind;
+  if (frameOpcode != nullptr) *frameOpcode = writeOpcode;
+  return result;
+}
+
+static CommandPushResult pushCommand(CommandQueue& queue, const char* text) {
+  return pushWrite(queue, (const uint8_t*)text, strlen(text));
+}
+
+// 与 BLEManager::executeWrite 相同：resync 时丢弃残帧，帧写入送入解析器
+static void drainCommands(CommandQueue& queue, FrameParser& parser,
+                          uint32_t* texts) {
+  const CommandQueue::Entry* entry;
+  while ((entry = queue.front()) != nullptr) {
+    if (entry->resync) parser.reset();
+    if (entry->kind == COMMAND_KIND_FRAME) {
+      parser.feed(entry->data, entry->length);
+    } else {
+      (*texts)++;
+    }
+    queue.pop();
+  }
+}
+
+// 与原来 BLE 回调中执行的 T: 指令相同：清屏并居中显示文字
+static void executeTextCommand(DisplayManager& display, const char* text,
+                               size_t length) {
+  char line[64];
+  size_t n = min(length, sizeof(line) - 1);
+  memcpy(line, text, n);
+  line[n] = '\0';
+  display.clear();
+  display.drawCenteredText(line + 2, 110, ST77XX_WHITE, 2);
+  display.flush();
+}
+
+static void runCommandQueue() {
+  printf("\n== BLE 指令队列 ==\n");
+
+  // 背压：高水位通知一次忙，满后拒绝，降到低水位恢复
+  CommandQueue queue;
+  check(queue.begin(), "指令队列分配成功");
+  ReplyBuffer text;
+  uint32_t busyCount = 0;
+  uint32_t firstBusy = 0;
+  for (uint32_t i = 0; i < CommandQueue::QUEUE_SIZE; i++) {
+    if (pushCommand(queue, text.format("B:%u", (unsigned)i)) ==
+        COMMAND_QUEUED_BUSY) {
+      if (busyCount++ == 0) firstBusy = i + 1;
+    }
+  }
+  check(busyCount == 1 && firstBusy == CommandQueue::HIGH_WATER,
+        "深度达到高水位时只发出一次忙信号");
+  check(pushCommand(queue, "B:16") == COMMAND_REJECTED &&
+            queue.getStats().rejected == 1,
+        "队列满时拒绝新写入");
+
+  bool ordered = true;
+  uint32_t resumedAt = 0;
+  for (uint32_t i = 0; i < CommandQueue::QUEUE_SIZE; i++) {
+    const CommandQueue::Entry* entry = queue.front();
+    const char* expected = text.format("B:%u", (unsigned)i);
+    ordered = ordered && entry != nullptr &&
+              entry->length == strlen(expected) &&
+              memcmp(entry->data, expected, entry->length) == 0;
+    queue.pop();
+    if (queue.checkResume()) {
+      check(resumedAt == 0, "恢复信号只发出一次");
+      resumedAt = queue.depth();
+    }
+  }
+  check(ordered && queue.front() == nullptr, "指令按写入顺序执行");
+  check(resumedAt == CommandQueue::LOW_WATER && !queue.isBusy(),
+        "深度降到低水位时恢复");
+
+  uint8_t oversized[CommandQueue::MAX_WRITE + 1];
+  memset(oversized, 'x', sizeof(oversized));
+  check(pushWrite(queue, oversized, sizeof(oversized)) == COMMAND_REJECTED,
+        "超过最大写入长度的数据被拒绝");
+
+  // 帧边界跟踪：一次写入含一个完整帧和下一帧的开头，帧头也可以被切开
+  uint8_t twoFrames[2 * FrameParser::MAX_FRAME];
+  uint32_t trackDigest = 0;
+  size_t firstLength = makeTestFrame(3, twoFrames, sizeof(twoFrames),
+                                     &trackDigest);
+  size_t secondLength = makeTestFrame(4, twoFrames + firstLength,
+                                      sizeof(twoFrames) - firstLength,
+                                      &trackDigest);
+  FrameTracker tracker;
+  tracker.feed(twoFrames, firstLength + 2);
+  bool midFrame = tracker.isReceiving() &&
+                  tracker.receivingOpcode() == twoFrames[firstLength + 1];
+  tracker.feed(twoFrames + firstLength + 2, 1);
+  bool splitHeader = tracker.isReceiving();
+  tracker.feed(twoFrames + firstLength + 3, secondLength - 3);
+  check(midFrame && splitHeader && !tracker.isReceiving(),
+        "帧边界按帧头长度跟踪（写入中的多个帧、切开的帧头）");
+
+  // 一个帧分 4 次写入，第 2 次写入时队列已满（该写入恰好以 0xA5 开头）
+  CommandQueue split;
+  split.begin();
+  uint8_t payload[300];
+  for (uint16_t k = 0; k < sizeof(payload); k++) payload[k] = (uint8_t)(k * 3);
+  payload[96] = FRAME_MAGIC;  // 帧内偏移 100：第 2 次写入的首字节
+  payload[97] = FRAME_OP_CLEAR;
+  uint8_t bigFrame[FrameParser::MAX_FRAME];
+  size_t bigLength = FrameParser::encode(FRAME_OP_PING, payload, sizeof(payload),
+                                         bigFrame, sizeof(bigFrame));
+  // 帧开始之后的写入都属于该帧，先用文本指令把队列填到只剩一格
+  for (uint32_t i = 1; i < CommandQueue::QUEUE_SIZE; i++) {
+    pushCommand(split, text.format("B:%u", (unsigned)i));
+  }
+  uint8_t kind = 0;
+  uint8_t frameOpcode = 0;
+  bool firstQueued = pushWrite(split, bigFrame, 100, &kind, &frameOpcode) !=
+                         COMMAND_REJECTED &&
+                     kind == COMMAND_KIND_FRAME && frameOpcode == FRAME_OP_PING;
+  CommandPushResult rejected = pushWrite(split, bigFrame + 100, 100, &kind,
+                                         &frameOpcode);
+  check(firstQueued && rejected == COMMAND_REJECTED &&
+            kind == COMMAND_KIND_FRAME && frameOpcode == FRAME_OP_PING,
+        "帧的后续写入被拒绝时按所属帧回复（不看写入首字节）");
+
+  frameCount = 0;
+  frameDigest = 0;
+  FrameParser device;
+  device.setCallback(countFrame);
+  uint32_t texts = 0;
+  drainCommands(split, device, &texts);
+  bool restDiscarded =
+      pushWrite(split, bigFrame + 200, 100) == COMMAND_DISCARDED &&
+      pushWrite(split, bigFrame + 300, bigLength - 300) == COMMAND_DISCARDED;
+  uint8_t nextFrame[FrameParser::MAX_FRAME];
+  uint32_t expectedDigest = 0;
+  size_t nextLength = makeTestFrame(5, nextFrame, sizeof(nextFrame),
+                                    &expectedDigest);
+  pushWrite(split, nextFrame, nextLength, &kind);
+  bool nextIsFrame = kind == COMMAND_KIND_FRAME;
+  pushCommand(split, "B:after");
+  const CommandQueue::Entry* resyncEntry = split.front();
+  bool resyncMarked = resyncEntry != nullptr && resyncEntry->resync;
+  drainCommands(split, device, &texts);
+  check(restDiscarded && nextIsFrame && resyncMarked,
+        "被拒绝的帧其余写入直接丢弃，下一条写入带 resync 标记");
+  check(frameCount == 1 && frameDigest == expectedDigest &&
+            device.getStats().crcErrors == 0 && texts == CommandQueue::QUEUE_SIZE,
+        "消费端丢弃残帧，随后的帧和文本指令不受影响");
+
+  // WiFi 凭证经队列交给主循环，不参与指令特征值的帧跟踪
+  pushWrite(split, nextFrame, 3);
+  split.pushValue(COMMAND_KIND_WIFI_SSID, (const uint8_t*)"HomeNetwork", 11);
+  pushWrite(split, nextFrame + 3, nextLength - 3, &kind);
+  bool ssidQueued = false;
+  bool frameContinued = kind == COMMAND_KIND_FRAME;
+  frameCount = 0;
+  const CommandQueue::Entry* entry;
+  while ((entry = split.front()) != nullptr) {
+    if (entry->kind == COMMAND_KIND_WIFI_SSID) {
+      ssidQueued = true;
+      frameContinued = frameContinued && entry->length == 11 &&
+                       memcmp(entry->data, "HomeNetwork", 11) == 0;
+    } else {
+      device.feed(entry->data, entry->length);
+    }
+    split.pop();
+  }
+  check(ssidQueued && frameContinued && frameCount == 1,
+        "WiFi 凭证写入按顺序入队，不打断进行中的帧");
+
+  // 连接断在帧中间（图片数据帧连发时断开），重新连接后发送文本指令
+  CommandQueue relink;
+  relink.begin();
+  FrameParser linkParser;
+  linkParser.setCallback(countFrame);
+  pushWrite(relink, bigFrame, 100);
+  uint32_t linkTexts = 0;
+  drainCommands(relink, linkParser, &linkTexts);
+  bool cutOff = linkParser.isReceiving();
+  relink.resetFrames();  // BLEManager::handleDisconnection
+  relink.resetFrames();  // BLEManager::handleConnection
+  pushCommand(relink, "STATUS");
+  const CommandQueue::Entry* statusEntry = relink.front();
+  bool statusIsText = statusEntry != nullptr &&
+                      statusEntry->kind == COMMAND_KIND_TEXT &&
+                      statusEntry->resync;
+  drainCommands(relink, linkParser, &linkTexts);
+  frameCount = 0;
+  frameDigest = 0;
+  expectedDigest = 0;
+  nextLength = makeTestFrame(6, nextFrame, sizeof(nextFrame), &expectedDigest);
+  pushWrite(relink, nextFrame, nextLength);
+  drainCommands(relink, linkParser, &linkTexts);
+  check(cutOff && statusIsText && linkTexts == 1 && !linkParser.isReceiving(),
+        "断开时的残帧被丢弃，重新连接后文本指令照常执行");
+  check(frameCount == 1 && frameDigest == expectedDigest &&
+            linkParser.getStats().crcErrors == 0,
+        "重新连接后的帧不受残帧影响");
+
+  // 跨线程：BLE 任务写入、主循环执行，顺序与内容不变
+  const uint32_t THREAD_WRITES = 2000;
+  CommandQueue shared;
+  shared.begin();
+  uint32_t producerRetries = 0;
+  std::thread producer([&shared, &producerRetries, THREAD_WRITES]() {
+    uint8_t write[64];
+    for (uint32_t i = 0; i < THREAD_WRITES; i++) {
+      // 文本写入：首字节固定，避免被当作帧头
+      uint16_t length = 5 + i % 59;
+      for (uint16_t k = 0; k < length; k++) write[k] = (uint8_t)(i * 7 + k);
+      write[0] = 'S';
+      memcpy(write + 1, &i, 4);
+      while (pushWrite(shared, write, length) == COMMAND_REJECTED) {
+        producerRetries++;
+        std::this_thread::yield();
+      }
+    }
+  });
+  uint32_t consumed = 0;
+  bool intact = true;
+  while (consumed < THREAD_WRITES) {
+    const CommandQueue::Entry* entry = shared.front();
+    if (entry == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t sequence;
+    memcpy(&sequence, entry->data + 1, 4);
+    intact = intact && sequence == consumed && entry->length == 5 + consumed % 59;
+    for (uint16_t k = 5; intact && k < entry->length; k++) {
+      intact = entry->data[k] == (uint8_t)(consumed * 7 + k);
+    }
+    shared.pop();
+    shared.checkResume();
+    consumed++;
+  }
+  producer.join();
+  printf("  跨线程 %u 条写入：峰值深度 %u/%u，队列满重试 %u 次\n",
+         (unsigned)THREAD_WRITES, (unsigned)shared.getStats().peakDepth,
+         (unsigned)CommandQueue::QUEUE_SIZE, (unsigned)producerRetries);
+  check(intact && shared.getStats().received == THREAD_WRITES,
+        "另一线程写入的指令按顺序完整取出");
+
+  // 回调耗时：原来在回调中绘图，现在只入队
+  DisplayManager display;
+  display.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  CommandQueue commands;
+  commands.begin();
+  NotifyQueue notify;
+  notify.setPacing(7500, 4);
+  const uint32_t EVENTS = 10;
+  const uint32_t WRITES_PER_EVENT = 3;
+  uint64_t pushMicros = 0;
+  uint64_t inlineMicros = 0;
+  unsigned long eventTime = micros();
+  uint8_t packet[182];
+  for (uint32_t event = 0; event < EVENTS; event++) {
+    // 连接事件：手机连续写入几条 T: 指令
+    eventTime += 30000;
+    hostWaitUntilMicros(eventTime);
+    for (uint32_t w = 0; w < WRITES_PER_EVENT; w++) {
+      const char* command = text.format("T:Line %u", (unsigned)(event * 3 + w));
+      unsigned long start = micros();
+      pushCommand(commands, command);
+      pushMicros += micros() - start;
+    }
+
+    // 主循环：执行、回复，再发出通知（同 BLEManager::processCommands / poll）
+    const CommandQueue::Entry* entry;
+    while ((entry = commands.front()) != nullptr) {
+      executeTextCommand(display, (const char*)entry->data, entry->length);
+      pushText(notify, "OK:Text displayed");
+      commands.expectReply(notify.getPushedCount());
+      commands.pop();
+    }
+    while (notify.take(micros(), packet, sizeof(packet)) > 0) {
+    }
+    commands.onRepliesSent(notify.getRetiredCount());
+  }
+
+  // 对比：同样的指令直接在回调中执行
+  for (uint32_t i = 0; i < EVENTS * WRITES_PER_EVENT; i++) {
+    const char* command = text.format("T:Line %u", (unsigned)i);
+    unsigned long start = micros();
+    executeTextCommand(display, command, strlen(command));
+    inlineMicros += micros() - start;
+  }
+
+  const uint32_t total = EVENTS * WRITES_PER_EVENT;
+  CommandQueueStats commandStats = commands.getStats();
+  const CommandLatencyStats& latency = commandStats.latency[COMMAND_KIND_TEXT];
+  printf("  回调占用：入队 %.1f us/条，原来回调中绘图 %.1f us/条\n",
+         (double)pushMicros / total, (double)inlineMicros / total);
+  Serial.setEnabled(true);
+  commands.printStats();
+  Serial.setEnabled(false);
+  check(latency.executed == total && latency.replies == total,
+        "每条指令都记录了执行与回复延迟");
+  check(latency.maxWaitMicros > 0 && latency.averageExecuteMicros() > 0 &&
+            latency.averageReplyMicros() >=
+                latency.averageWaitMicros() + latency.averageExecuteMicros(),
+        "回复延迟不小于排队加执行时间");
+  check(pushMicros * 10 < inlineMicros, "回调只入队，耗时不到直接执行的十分之一");
+}
+
+static void runDirectVsBuffered() {
+  printf("\n== 直接模式与缓冲模式输出对比 ==\n");
+
+  DisplayManager direct;
+  direct.begin(BUFFER_MODE_DIRECT, SPI_FREQUENCY_FAST);
+  direct.getTFT()->resetStats();
+  drawImageScene(direct);
+  printSpiStats("DIRECT 图片场景", direct.getTFT()->getStats());
+
+  DisplayManager buffered;
+  buffered.begin(BUFFER_MODE_SINGLE, SPI_FREQUENCY_FAST);
+  buffered.getTFT()->resetStats();
+  drawImageScene(buffered);
+  printSpiStats("SINGLE 图片场景", buffered.getTFT()->getStats());
+
+  check(comparePanels(direct.getTFT(), buffered.getTFT()) == 0,
+        "两种模式绘制的图片像素一致");
+  printf("  面板校验和: %08x\n", panelChecksum(direct.getTFT()));
+
+  direct.clear(ST77XX_BLACK);
+  direct.getTFT()->resetStats();
+  drawShapeScene(direct);
+  printSpiStats("DIRECT 文字图形", direct.getTFT()->getStats());
+
+  buffered.clear(ST77XX_BLACK);
+  buffered.getTFT()->resetStats();
+  drawShapeScene(buffered);
+  printSpiStats("SINGLE 文字图形", buffered.getTFT()->getStats());
+
+  check(comparePanels(direct.getTFT(), buffered.getTFT()) == 0,
+        "两种模式绘制的文字与图形像素一致");
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) {
+      ppmDir = argv[++i];
+    }
+  }
+
+  Serial.setEnabled(false);
+
+  runBufferedScene(BUFFER_MODE_SINGLE);
+  runBufferedScene(BUFFER_MODE_DOUBLE);
+  runAsyncFlush(BUFFER_MODE_SINGLE);
+  runAsyncFlush(BUFFER_MODE_DOUBLE);
+  runDirtyTracking(DIRTY_TRACK_REGIONS);
+  runDirtyTracking(DIRTY_TRACK_TILES);
+  runDiffFlush();
+  runBufferedScene(BUFFER_MODE_INDEXED8);
+  runBufferedScene(BUFFER_MODE_INDEXED4);
+  runAsyncFlush(BUFFER_MODE_INDEXED8);
+  runAsyncFlush(BUFFER_MODE_INDEXED4);
+  runIndexedModes();
+  runBufferPlacement();
+  runImageScaler();
+  runCompressedAnimation(BUFFER_MODE_DIRECT);
+  runCompressedAnimation(BUFFER_MODE_SINGLE);
+  runCompressedAnimation(BUFFER_MODE_DOUBLE);
+  runEncodedImages(BUFFER_MODE_DIRECT);
+  runEncodedImages(BUFFER_MODE_SINGLE);
+  runStripMode();
+  runWidgetScreen(BUFFER_MODE_SINGLE);
+  runWidgetScreen(BUFFER_MODE_INDEXED8);
+  runWidgetScreen(BUFFER_MODE_STRIP);
+  runFramePacing();
+  runTaskScheduler();
+  runRenderPipeline();
+  runFrameProtocol();
+  runTextCommands();
+  runImageUpload();
+  runNotifyQueue();
+  runCommandQueue();
+  runDirectVsBuffered();
+
+  printf("\n%s (%d 项失败)\n", failures == 0 ? "全部通过" : "存在失败",
+         failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+
+/**
+ * Adafruit GFX 主机端替身
+ * 按 Adafruit_GFX 原库的接口和算法实现草图用到的图元，
+ * 使主机上的 SPI 调用次数与真机保持一致（逐像素写入、逐行填充等）
+ * 仅支持经典 5x7 字体（不支持 GFXfont）
+ */
+
+#include "Arduino.h"
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h);
+  virtual ~Adafruit_GFX() {}
+
+  // 必须由子类实现
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  // 事务接口（子类可重写以批量处理）
+  virtual void startWrite() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color);
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color);
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         uint16_t color);
+  virtual void endWrite() {}
+
+  virtual void setRotation(uint8_t r);
+  virtual void invertDisplay(bool i) { (void)i; }
+
+  // 基础图元
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                        uint16_t color);
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color);
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners,
+                        int16_t delta, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w,
+                  int16_t h, uint16_t color);
+
+  // 文字
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size_x, uint8_t size_y);
+  void getTextBounds(const char* string, int16_t x, int16_t y, int16_t* x1,
+                     int16_t* y1, uint16_t* w, uint16_t* h);
+  void getTextBounds(const String& str, int16_t x, int16_t y, int16_t* x1,
+                     int16_t* y1, uint16_t* w, uint16_t* h) {
+    getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+  }
+  void setTextSize(uint8_t s) { setTextSize(s, s); }
+  void setTextSize(uint8_t sx, uint8_t sy) {
+    textsize_x = (sx > 0) ? sx : 1;
+    textsize_y = (sy > 0) ? sy : 1;
+  }
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+  void cp437(bool x = true) { _cp437 = x; }
+
+  using Print::write;
+  size_t write(uint8_t c) override;
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  uint8_t getRotation() const { return rotation; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+
+  // 经典字体的一列（LSB 在上），主机替身额外暴露以便调试
+  static uint8_t fontColumn(unsigned char c, uint8_t column);
+
+protected:
+  void charBounds(unsigned char c, int16_t* x, int16_t* y, int16_t* minx,
+                  int16_t* miny, int16_t* maxx, int16_t* maxy);
+
+  int16_t WIDTH;
+  int16_t HEIGHT;
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x;
+  int16_t cursor_y;
+  uint16_t textcolor;
+  uint16_t textbgcolor;
+  uint8_t textsize_x;
+  uint8_t textsize_y;
+  uint8_t rotation;
+  bool wrap;
+  bool _cp437;
+};
+
+/**
+ * 1位画布（与原库一致：每行 (w+7)/8 字节，MSB 在左）
+ */
+class GFXcanvas1 : public Adafruit_GFX {
+public:
+  GFXcanvas1(uint16_t w, uint16_t h);
+  ~GFXcanvas1();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  bool getPixel(int16_t x, int16_t y) const;
+  uint8_t* getBuffer() const { return buffer; }
+
+private:
+  uint8_t* buffer;
+};
+
+/**
+ * 16位画布
+ */
+class GFXcanvas16 : public Adafruit_GFX {
+public:
+  GFXcanvas16(uint16_t w, uint16_t h);
+  ~GFXcanvas16();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  uint16_t getPixel(int16_t x, int16_t y) const;
+  uint16_t* getBuffer() const { return buffer; }
+
+private:
+  uint16_t* buffer;
+};
+
+#endif // HOST_ADAFRUIT_GFX_H
@@ -0,0 +1,198 @@
+#include "Adafruit_ST7789.h"
+
+SPIClass SPI(FSPI);
+
+Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, SPIClass* spiClass,
+                                 int8_t cs, int8_t dc, int8_t rst)
+    : Adafruit_GFX(w, h), spi(spiClass), spiFreq(0), pinCS(cs), pinDC(dc),
+      pinRST(rst), winX0(0), winY0(0), winX1(0), winY1(0), curX(0), curY(0),
+      gram((size_t)w * h, 0x0000), logEvents(false) {
+  resetStats();
+}
+
+void Adafruit_SPITFT::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+  events.clear();
+}
+
+uint32_t Adafruit_SPITFT::getSPIFrequency() const {
+  if (spiFreq != 0) return spiFreq;
+  if (spi != nullptr && spi->getFrequency() != 0) return spi->getFrequency();
+  return 40000000;
+}
+
+uint16_t Adafruit_SPITFT::getGRAMPixel(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return 0x0000;
+  return gram[(size_t)y * WIDTH + x];
+}
+
+void Adafruit_SPITFT::advanceClock(uint64_t bytes, uint32_t calls) {
+  uint64_t ns = bytes * 8ull * 1000000000ull / getSPIFrequency() +
+                (uint64_t)calls * HOST_SPI_CALL_OVERHEAD_NS;
+  hostAdvanceMicros(ns / 1000);
+}
+
+void Adafruit_SPITFT::recordAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                                       uint16_t h) {
+  winX0 = x;
+  winY0 = y;
+  winX1 = (w > 0) ? x + w - 1 : x;
+  winY1 = (h > 0) ? y + h - 1 : y;
+  curX = winX0;
+  curY = winY0;
+
+  stats.addrWindowCount++;
+  stats.commandBytes += HOST_SPI_ADDR_WINDOW_BYTES;
+  if (logEvents) {
+    events.push_back({SPI_EVENT_ADDR_WINDOW, (int16_t)x, (int16_t)y,
+                      (int16_t)w, (int16_t)h, 0});
+  }
+  advanceClock(HOST_SPI_ADDR_WINDOW_BYTES, 1);
+}
+
+void Adafruit_SPITFT::recordPixels(const uint16_t* colors, uint32_t len,
+                                   bool bigEndian, SpiEventType type,
+                                   bool advance) {
+  for (uint32_t i = 0; i < len; i++) {
+    uint16_t c = (type == SPI_EVENT_WRITE_COLOR) ? colors[0] : colors[i];
+    if (bigEndian) c = (uint16_t)((c << 8) | (c >> 8));
+
+    if (curX < WIDTH && curY < HEIGHT) {
+      gram[(size_t)curY * WIDTH + curX] = c;
+    }
+    // 与面板一致：写满一行自动换行，写满窗口回到起点
+    if (++curX > winX1) {
+      curX = winX0;
+      if (++curY > winY1) curY = winY0;
+    }
+  }
+
+  if (type == SPI_EVENT_WRITE_COLOR) {
+    stats.writeColorCalls++;
+  } else if (type == SPI_EVENT_DMA_PIXELS) {
+    stats.dmaTransfers++;
+  } else {
+    stats.writePixelsCalls++;
+  }
+  stats.pixels += len;
+  stats.dataBytes += (uint64_t)len * 2;
+  if (logEvents) {
+    events.push_back({type, 0, 0, 0, 0, len});
+  }
+  if (advance) {
+    advanceClock((uint64_t)len * 2, 1);
+  }
+}
+
+void Adafruit_SPITFT::completeDMATransfer(const uint16_t* colors,
+                                          uint32_t len) {
+  if (len == 0) return;
+  recordPixels(colors, len, true, SPI_EVENT_DMA_PIXELS, false);
+}
+
+uint64_t Adafruit_SPITFT::transferMicros(uint64_t bytes) const {
+  return bytes * 8ull * 1000000ull / getSPIFrequency();
+}
+
+// ========== 事务 ==========
+
+void Adafruit_SPITFT::startWrite() {
+  stats.transactions++;
+}
+
+void Adafruit_SPITFT::endWrite() {
+}
+
+void Adafruit_SPITFT::writePixels(uint16_t* colors, uint32_t len, bool block,
+                                  bool bigEndian) {
+  (void)block;
+  if (len == 0) return;
+  recordPixels(colors, len, bigEndian, SPI_EVENT_WRITE_PIXELS);
+}
+
+void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len) {
+  if (len == 0) return;
+  recordPixels(&color, len, false, SPI_EVENT_WRITE_COLOR);
+}
+
+void Adafruit_SPITFT::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height)) {
+    setAddrWindow(x, y, 1, 1);
+    recordPixels(&color, 1, false, SPI_EVENT_WRITE_PIXELS);
+  }
+}
+
+void Adafruit_SPITFT::writeFillRect(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, uint16_t color) {
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _width) w = _width - x;
+  if (y + h > _height) h = _height - y;
+  if (w <= 0 || h <= 0) return;
+
+  setAddrWindow(x, y, w, h);
+  writeColor(color, (uint32_t)w * h);
+}
+
+void Adafruit_SPITFT::writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                     uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SPITFT::writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                     uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void Adafruit_SPITFT::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height)) {
+    startWrite();
+    writePixel(x, y, color);
+    endWrite();
+  }
+}
+
+void Adafruit_SPITFT::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t color) {
+  startWrite();
+  writeFillRect(x, y, w, h, color);
+  endWrite();
+}
+
+void Adafruit_SPITFT::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                    uint16_t color) {
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  endWrite();
+}
+
+void Adafruit_SPITFT::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                    uint16_t color) {
+  startWrite();
+  writeFastVLine(x, y, h, color);
+  endWrite();
+}
+
+// ========== ST77xx / ST7789 ==========
+
+void Adafruit_ST77xx::setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                                    uint16_t h) {
+  recordAddrWindow(x, y, w, h);
+}
+
+Adafruit_ST7789::Adafruit_ST7789(SPIClass* spiClass, int8_t cs, int8_t dc,
+                                 int8_t rst)
+    : Adafruit_ST77xx(240, 240, spiClass, cs, dc, rst) {}
+
+Adafruit_ST7789::Adafruit_ST7789(int8_t cs, int8_t dc, int8_t rst)
+    : Adafruit_ST77xx(240, 240, &SPI, cs, dc, rst) {}
+
+void Adafruit_ST7789::init(uint16_t width, uint16_t height, uint8_t spiMode) {
+  (void)spiMode;
+  WIDTH = _width = width;
+  HEIGHT = _height = height;
+  gram.assign((size_t)width * height, 0x0000);
+  setRotation(0);
+}
@@ -0,0 +1,155 @@
+#ifndef HOST_ADAFRUIT_ST7789_H
+#define HOST_ADAFRUIT_ST7789_H
+
+/**
+ * Adafruit ST7789 主机端记录型替身
+ *
+ * - 按原库的方式把图元拆成 setAddrWindow + writePixels/writeColor
+ * - 记录每次调用、传输字节数，并按 SPI 频率估算线上时间
+ * - 维护一份面板显存（GRAM），可与帧缓冲逐像素比对
+ * - 阻塞式传输会按当前 SPI 频率推进主机模拟时钟
+ */
+
+#include <vector>
+#include "Adafruit_GFX.h"
+#include "SPI.h"
+
+// 颜色定义（与原库一致）
+#define ST77XX_BLACK   0x0000
+#define ST77XX_WHITE   0xFFFF
+#define ST77XX_RED     0xF800
+#define ST77XX_GREEN   0x07E0
+#define ST77XX_BLUE    0x001F
+#define ST77XX_CYAN    0x07FF
+#define ST77XX_MAGENTA 0xF81F
+#define ST77XX_YELLOW  0xFFE0
+#define ST77XX_ORANGE  0xFC00
+
+// 模拟的 SPI 开销
+#define HOST_SPI_ADDR_WINDOW_BYTES 11  // CASET(1+4) + RASET(1+4) + RAMWR(1)
+#define HOST_SPI_CALL_OVERHEAD_NS  1000  // 每次 API 调用的固定软件开销
+
+// 记录的调用类型
+enum SpiEventType {
+  SPI_EVENT_ADDR_WINDOW,
+  SPI_EVENT_WRITE_PIXELS,
+  SPI_EVENT_WRITE_COLOR,
+  SPI_EVENT_DMA_PIXELS
+};
+
+// 单次调用记录
+struct SpiEvent {
+  SpiEventType type;
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+  uint32_t pixels;
+};
+
+// 累计统计
+struct SpiStats {
+  uint32_t transactions;      // startWrite/endWrite 次数
+  uint32_t addrWindowCount;   // setAddrWindow 次数
+  uint32_t writePixelsCalls;  // writePixels 次数
+  uint32_t writeColorCalls;   // writeColor 次数（纯色填充）
+  uint32_t dmaTransfers;      // DMA 传输次数（不计软件开销）
+  uint64_t pixels;            // 写入像素数
+  uint64_t commandBytes;      // 命令/地址字节
+  uint64_t dataBytes;         // 像素数据字节
+
+  uint64_t totalBytes() const { return commandBytes + dataBytes; }
+  uint32_t apiCalls() const {
+    return addrWindowCount + writePixelsCalls + writeColorCalls;
+  }
+  // 指定 SPI 时钟下的模拟线上时间（微秒）
+  double modelledMicros(uint32_t spiHz) const {
+    return totalBytes() * 8.0 * 1e6 / spiHz +
+           apiCalls() * (HOST_SPI_CALL_OVERHEAD_NS / 1000.0);
+  }
+};
+
+class Adafruit_SPITFT : public Adafruit_GFX {
+public:
+  Adafruit_SPITFT(uint16_t w, uint16_t h, SPIClass* spiClass, int8_t cs,
+                  int8_t dc, int8_t rst = -1);
+  virtual ~Adafruit_SPITFT() {}
+
+  virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                             uint16_t h) = 0;
+
+  void startWrite() override;
+  void endWrite() override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixels(uint16_t* colors, uint32_t len, bool block = true,
+                   bool bigEndian = false);
+  void writeColor(uint16_t color, uint32_t len);
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                     uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+
+  void setSPISpeed(uint32_t freq) { spiFreq = freq; }
+  void dmaWait() {}
+
+  // ===== 主机专用：记录与校验 =====
+  const SpiStats& getStats() const { return stats; }
+  void resetStats();
+  void setEventLogEnabled(bool enabled) { logEvents = enabled; }
+  const std::vector<SpiEvent>& getEvents() const { return events; }
+  uint16_t getGRAMPixel(int16_t x, int16_t y) const;
+  const uint16_t* getGRAM() const { return gram.data(); }
+  uint32_t getSPIFrequency() const;
+
+  // ===== 主机专用：DMA 模拟（由 DisplayDMA 替身调用） =====
+  // 传输完成时把大端像素写入显存，不推进时钟（时间已由 DMA 替身建模）
+  void completeDMATransfer(const uint16_t* colors, uint32_t len);
+  uint64_t transferMicros(uint64_t bytes) const;
+
+protected:
+  void recordAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void recordPixels(const uint16_t* colors, uint32_t len, bool bigEndian,
+                    SpiEventType type, bool advance = true);
+  void advanceClock(uint64_t bytes, uint32_t calls);
+
+  SPIClass* spi;
+  uint32_t spiFreq;  // 0 表示沿用 SPIClass 的频率
+  int8_t pinCS;
+  int8_t pinDC;
+  int8_t pinRST;
+
+  // 地址窗口（GRAM 写指针）
+  uint16_t winX0, winY0, winX1, winY1;
+  uint16_t curX, curY;
+
+  std::vector<uint16_t> gram;
+  SpiStats stats;
+  bool logEvents;
+  std::vector<SpiEvent> events;
+};
+
+class Adafruit_ST77xx : public Adafruit_SPITFT {
+public:
+  Adafruit_ST77xx(uint16_t w, uint16_t h, SPIClass* spiClass, int8_t cs,
+                  int8_t dc, int8_t rst = -1)
+      : Adafruit_SPITFT(w, h, spiClass, cs, dc, rst) {}
+
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void enableDisplay(bool enable) { (void)enable; }
+};
+
+class Adafruit_ST7789 : public Adafruit_ST77xx {
+public:
+  Adafruit_ST7789(SPIClass* spiClass, int8_t cs, int8_t dc, int8_t rst);
+  Adafruit_ST7789(int8_t cs, int8_t dc, int8_t rst);
+
+  void init(uint16_t width = 240, uint16_t height = 240, uint8_t spiMode = 0);
+};
+
+#endif // HOST_ADAFRUIT_ST7789_H
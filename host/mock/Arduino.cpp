@@ -0,0 +1,204 @@
+#include "Arduino.h"
+#include <chrono>
+#include <ctype.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ========== 时间 ==========
+
+static const std::chrono::steady_clock::time_point startTime =
+    std::chrono::steady_clock::now();
+// 模拟时间按线程记录：两个线程（渲染流水线）各自的等待互不叠加，真实时间共享
+static thread_local uint64_t simulatedMicros = 0;
+
+static uint64_t realMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros() {
+  return (unsigned long)(realMicros() + simulatedMicros);
+}
+
+unsigned long millis() {
+  return (unsigned long)((realMicros() + simulatedMicros) / 1000);
+}
+
+void delay(uint32_t ms) {
+  simulatedMicros += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+  simulatedMicros += us;
+}
+
+void yield() {
+}
+
+void hostAdvanceMicros(uint64_t us) {
+  simulatedMicros += us;
+}
+
+uint64_t hostSimulatedMicros() {
+  return simulatedMicros;
+}
+
+void hostWaitUntilMicros(uint64_t us) {
+  uint64_t now = realMicros() + simulatedMicros;
+  if (us > now) {
+    simulatedMicros += us - now;
+  }
+}
+
+// ========== GPIO ==========
+
+static uint8_t pinState[64];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < sizeof(pinState)) pinState[pin] = val;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < sizeof(pinState) ? pinState[pin] : LOW;
+}
+
+void analogWrite(uint8_t pin, int val) {
+  if (pin < sizeof(pinState)) pinState[pin] = val > 0 ? HIGH : LOW;
+}
+
+// ========== 随机数 ==========
+
+// 固定的线性同余发生器，保证主机上的运行结果可复现
+static uint32_t randomState = 1;
+
+static uint32_t nextRandom() {
+  randomState = randomState * 1103515245u + 12345u;
+  return randomState >> 1;
+}
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  return (long)(nextRandom() % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+  // 主机上忽略 micros() 之类的真随机种子，保持可复现
+  (void)seed;
+}
+
+// ========== String ==========
+
+String::String(float v, unsigned int decimals) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, (double)v);
+  str = buf;
+}
+
+bool String::equalsIgnoreCase(const String& rhs) const {
+  if (str.length() != rhs.str.length()) return false;
+  for (size_t i = 0; i < str.length(); i++) {
+    if (toupper((unsigned char)str[i]) != toupper((unsigned char)rhs.str[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+  return str.compare(0, prefix.str.length(), prefix.str) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+  if (suffix.str.length() > str.length()) return false;
+  return str.compare(str.length() - suffix.str.length(), suffix.str.length(),
+                     suffix.str) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t pos = str.find(c, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& s, unsigned int from) const {
+  size_t pos = str.find(s.str, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int begin) const {
+  if (begin >= str.length()) return String();
+  return String(str.substr(begin));
+}
+
+String String::substring(unsigned int begin, unsigned int end) const {
+  if (begin > end) std::swap(begin, end);
+  if (begin >= str.length()) return String();
+  return String(str.substr(begin, end - begin));
+}
+
+void String::toUpperCase() {
+  for (char& c : str) c = (char)toupper((unsigned char)c);
+}
+
+void String::toLowerCase() {
+  for (char& c : str) c = (char)tolower((unsigned char)c);
+}
+
+void String::trim() {
+  size_t first = 0;
+  while (first < str.length() && isspace((unsigned char)str[first])) first++;
+  size_t last = str.length();
+  while (last > first && isspace((unsigned char)str[last - 1])) last--;
+  str = str.substr(first, last - first);
+}
+
+// ========== Print / Serial ==========
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::print(const char* s) {
+  return write((const uint8_t*)s, strlen(s));
+}
+
+size_t Print::println() {
+  return write((const uint8_t*)"\r\n", 2);
+}
+
+size_t Print::printf(const char* format, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if ((size_t)len >= sizeof(buf)) len = sizeof(buf) - 1;
+  return write((const uint8_t*)buf, len);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (!enabled || c == '\r') return 1;
+  fputc(c, stdout);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  if (!enabled) return size;
+  for (size_t i = 0; i < size; i++) {
+    if (buffer[i] != '\r') fputc(buffer[i], stdout);
+  }
+  return size;
+}
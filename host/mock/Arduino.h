@@ -0,0 +1,174 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * 主机端 Arduino 核心替身
+ * 只实现草图源文件实际用到的部分，用于在 Linux 上编译
+ * FrameBuffer / DisplayManager 等模块
+ *
+ * 时钟模型：micros() = 真实经过时间 + 模拟等待时间
+ * - CPU 计算耗时按主机真实时间计入
+ * - delay() 和 模拟 SPI 传输 只推进模拟时间，不真正等待
+ * - 模拟时间按线程记录，多线程时各线程的 micros() 只含自己的等待
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#define IRAM_ATTR
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ========== 时间 ==========
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// 主机专用：推进/读取模拟时间（模拟时间按线程记录）
+void hostAdvanceMicros(uint64_t us);
+uint64_t hostSimulatedMicros();
+// 主机专用：本线程等到 micros() 不早于 us（跨线程传递时间戳时使用）
+void hostWaitUntilMicros(uint64_t us);
+
+// ========== GPIO ==========
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+// ========== 随机数 ==========
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// ========== String ==========
+
+class String {
+public:
+  String() {}
+  String(const char* s) : str(s ? s : "") {}
+  String(const std::string& s) : str(s) {}
+  String(char c) : str(1, c) {}
+  String(int v) : str(std::to_string(v)) {}
+  String(unsigned int v) : str(std::to_string(v)) {}
+  String(long v) : str(std::to_string(v)) {}
+  String(unsigned long v) : str(std::to_string(v)) {}
+  String(float v, unsigned int decimals = 2);
+
+  const char* c_str() const { return str.c_str(); }
+  unsigned int length() const { return (unsigned int)str.length(); }
+  char charAt(unsigned int i) const { return i < str.length() ? str[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  String& operator+=(const String& rhs) { str += rhs.str; return *this; }
+  String& operator+=(const char* rhs) { str += rhs; return *this; }
+  String& operator+=(char c) { str += c; return *this; }
+  bool concat(const String& rhs) { str += rhs.str; return true; }
+  bool concat(char c) { str += c; return true; }
+
+  bool operator==(const String& rhs) const { return str == rhs.str; }
+  bool operator==(const char* rhs) const { return str == rhs; }
+  bool operator!=(const String& rhs) const { return str != rhs.str; }
+  bool operator!=(const char* rhs) const { return str != rhs; }
+  bool equalsIgnoreCase(const String& rhs) const;
+
+  bool startsWith(const String& prefix) const;
+  bool endsWith(const String& suffix) const;
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String& s, unsigned int from = 0) const;
+  String substring(unsigned int begin) const;
+  String substring(unsigned int begin, unsigned int end) const;
+
+  void toUpperCase();
+  void toLowerCase();
+  void trim();
+  long toInt() const { return atol(str.c_str()); }
+
+  friend String operator+(const String& lhs, const String& rhs) {
+    return String(lhs.str + rhs.str);
+  }
+  friend String operator+(const String& lhs, const char* rhs) {
+    return String(lhs.str + rhs);
+  }
+  friend String operator+(const char* lhs, const String& rhs) {
+    return String(std::string(lhs) + rhs.str);
+  }
+
+private:
+  std::string str;
+};
+
+// ========== Print / Serial ==========
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+
+  size_t print(const char* s);
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned int v) { return print(String(v)); }
+  size_t print(long v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  size_t println();
+  size_t println(const char* s) { return print(s) + println(); }
+  size_t println(const String& s) { return print(s) + println(); }
+  size_t println(int v) { return print(v) + println(); }
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  operator bool() const { return true; }
+
+  // 主机专用：关闭输出（基准测试时避免日志干扰）
+  void setEnabled(bool enabled) { this->enabled = enabled; }
+
+private:
+  bool enabled = true;
+};
+
+extern HardwareSerial Serial;
+
+// ========== ESP ==========
+
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return 320 * 1024; }
+  void restart() { fprintf(stderr, "[host] ESP.restart() 被调用\n"); exit(0); }
+};
+
+extern EspClass ESP;
+
+#endif // HOST_ARDUINO_H
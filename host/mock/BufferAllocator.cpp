@@ -0,0 +1,89 @@
+/*
+ * BufferAllocator 主机端替身
+ *
+ * 用 malloc 分配，按区域记账：内部 SRAM 与 PSRAM 各有一个可设的容量，
+ * 超出容量的分配失败，从而可以在主机上测试放置策略和退回路径。
+ */
+
+#include "BufferAllocator.h"
+#include <stdint.h>
+#include <map>
+
+namespace {
+
+struct Allocation {
+  MemoryRegion region;
+  size_t bytes;
+};
+
+size_t limits[3] = {0, SIZE_MAX, 0};  // 按 MemoryRegion 索引
+size_t used[3] = {0, 0, 0};
+std::map<void*, Allocation> allocations;
+
+void* allocateIn(MemoryRegion region, size_t bytes) {
+  if (used[region] > limits[region] || bytes > limits[region] - used[region]) {
+    return nullptr;
+  }
+  void* buffer = malloc(bytes);
+  if (buffer == nullptr) return nullptr;
+  used[region] += bytes;
+  allocations[buffer] = Allocation{region, bytes};
+  return buffer;
+}
+
+}  // namespace
+
+void* BufferAllocator::allocate(size_t bytes, BufferPlacement placement,
+                                MemoryRegion* region) {
+  void* buffer = nullptr;
+  *region = MEMORY_NONE;
+
+  if (placement != BUFFER_PLACE_INTERNAL && hasPSRAM()) {
+    buffer = allocateIn(MEMORY_PSRAM, bytes);
+    if (buffer != nullptr) {
+      *region = MEMORY_PSRAM;
+      return buffer;
+    }
+  }
+  if (placement != BUFFER_PLACE_PSRAM) {
+    buffer = allocateIn(MEMORY_INTERNAL, bytes);
+    if (buffer != nullptr) *region = MEMORY_INTERNAL;
+  }
+  return buffer;
+}
+
+void* BufferAllocator::allocateLineCache(size_t bytes, MemoryRegion* region) {
+  void* buffer = allocateIn(MEMORY_INTERNAL, bytes);
+  *region = buffer != nullptr ? MEMORY_INTERNAL : MEMORY_NONE;
+  return buffer;
+}
+
+void BufferAllocator::release(void* buffer) {
+  std::map<void*, Allocation>::iterator it = allocations.find(buffer);
+  if (it == allocations.end()) return;
+  used[it->second.region] -= it->second.bytes;
+  allocations.erase(it);
+  free(buffer);
+}
+
+bool BufferAllocator::hasPSRAM() {
+  return limits[MEMORY_PSRAM] > 0;
+}
+
+size_t BufferAllocator::getFreeBytes(MemoryRegion region) {
+  if (region == MEMORY_NONE || used[region] > limits[region]) return 0;
+  return limits[region] - used[region];
+}
+
+const char* BufferAllocator::regionName(MemoryRegion region) {
+  switch (region) {
+    case MEMORY_INTERNAL: return "internal";
+    case MEMORY_PSRAM: return "PSRAM";
+    default: return "none";
+  }
+}
+
+void BufferAllocator::setHostLimits(size_t internalBytes, size_t psramBytes) {
+  limits[MEMORY_INTERNAL] = internalBytes;
+  limits[MEMORY_PSRAM] = psramBytes;
+}
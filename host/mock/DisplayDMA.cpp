@@ -0,0 +1,117 @@
+/*
+ * DisplayDMA 主机端替身
+ *
+ * 传输在 queue() 时按当前 SPI 时钟计算完成时刻（与前一个传输首尾相接），
+ * poll() 发现主机时钟越过完成时刻时模拟 DMA 完成：把像素写入面板显存。
+ * CPU 在此期间的计算照常计时，从而体现传输与计算的重叠。
+ * 总线会话映射为一次 startWrite / endWrite，地址窗口记录为 setAddrWindow。
+ */
+
+#include "DisplayDMA.h"
+
+DisplayDMA::DisplayDMA() {
+  ready = false;
+  busAcquired = false;
+  inFlight = 0;
+  completedCount = 0;
+  pTFT = nullptr;
+  pSPI = nullptr;
+  pinSCLK = pinMOSI = pinCS = pinDC = -1;
+  frequency = 0;
+  maxTransfer = 0;
+  pendingHead = 0;
+  busyUntil = 0;
+  memset(pending, 0, sizeof(pending));
+}
+
+DisplayDMA::~DisplayDMA() {
+  end();
+}
+
+bool DisplayDMA::begin(Adafruit_ST7789* tft, SPIClass* spi, int8_t sclk,
+                       int8_t mosi, int8_t cs, int8_t dc,
+                       uint32_t spiFrequency, uint32_t maxTransferBytes) {
+  if (ready) return true;
+  if (tft == nullptr || spi == nullptr || dc < 0) return false;
+  pTFT = tft;
+  pSPI = spi;
+  pinSCLK = sclk;
+  pinMOSI = mosi;
+  pinCS = cs;
+  pinDC = dc;
+  frequency = spiFrequency;
+  maxTransfer = maxTransferBytes;
+  ready = true;
+  return true;
+}
+
+void DisplayDMA::end() {
+  if (!ready) return;
+  releaseBus();
+  ready = false;
+}
+
+bool DisplayDMA::acquireBus() {
+  if (!ready) return false;
+  if (busAcquired) return true;
+  pTFT->startWrite();
+  busAcquired = true;
+  return true;
+}
+
+void DisplayDMA::releaseBus() {
+  if (!busAcquired) return;
+  wait();
+  pTFT->endWrite();
+  busAcquired = false;
+}
+
+void DisplayDMA::setWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  if (!busAcquired) return;
+  wait();
+  pTFT->setAddrWindow(x, y, w, h);
+}
+
+uint16_t* DisplayDMA::allocBuffer(size_t bytes) {
+  return (uint16_t*)malloc(bytes);
+}
+
+void DisplayDMA::freeBuffer(uint16_t* buffer) {
+  free(buffer);
+}
+
+bool DisplayDMA::queue(const uint16_t* data, uint32_t pixelCount) {
+  if (!busAcquired || inFlight >= MAX_IN_FLIGHT) return false;
+
+  uint64_t now = micros();
+  uint64_t start = busyUntil > now ? busyUntil : now;
+  busyUntil = start + pTFT->transferMicros((uint64_t)pixelCount * 2);
+
+  PendingTransfer& t = pending[(pendingHead + inFlight) % MAX_IN_FLIGHT];
+  t.data = data;
+  t.pixelCount = pixelCount;
+  t.doneAt = busyUntil;
+  inFlight++;
+  return true;
+}
+
+void DisplayDMA::poll() {
+  uint64_t now = micros();
+  while (inFlight > 0 && pending[pendingHead].doneAt <= now) {
+    PendingTransfer& t = pending[pendingHead];
+    pTFT->completeDMATransfer(t.data, t.pixelCount);
+    pendingHead = (pendingHead + 1) % MAX_IN_FLIGHT;
+    inFlight--;
+    completedCount++;
+  }
+}
+
+void DisplayDMA::wait() {
+  if (inFlight == 0) return;
+
+  uint64_t now = micros();
+  if (busyUntil > now) {
+    hostAdvanceMicros(busyUntil - now);
+  }
+  poll();
+}
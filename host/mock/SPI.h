@@ -0,0 +1,40 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+// ESP32-S3 的 SPI 主机编号
+#define FSPI 0
+#define HSPI 1
+
+/**
+ * SPIClass 替身
+ * 不产生任何传输，只记录配置的时钟频率，供 ST7789 替身计算模拟传输时间
+ */
+class SPIClass {
+public:
+  explicit SPIClass(uint8_t spiBus = FSPI) : bus(spiBus), frequency(1000000) {}
+
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1,
+             int8_t ss = -1) {
+    (void)sck; (void)miso; (void)mosi; (void)ss;
+  }
+  void end() {}
+
+  void setFrequency(uint32_t freq) { frequency = freq; }
+  uint32_t getFrequency() const { return frequency; }
+  uint8_t getBus() const { return bus; }
+
+private:
+  uint8_t bus;
+  uint32_t frequency;
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H